@@ -0,0 +1,334 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "CompiledSelection.hh"
+
+#include "TBranch.h"
+#include "TClass.h"
+#include "TInterpreter.h"
+#include "TLeaf.h"
+#include "TObjArray.h"
+#include "TTree.h"
+#include "TTreeFormula.h"
+#include "TTreeReader.h"
+#include "TTreeReaderArray.h"
+#include "TTreeReaderValue.h"
+#include "TVirtualCollectionProxy.h"
+#include "TVirtualMutex.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <regex>
+#include <set>
+#include <string>
+#include <vector>
+
+class CompiledSelectionReader::LeafReader
+{
+public:
+  virtual ~LeafReader(){;}
+  /// Fill the values of the current entry.
+  virtual void Fill(std::vector<double>& out) = 0;
+  /// Whether the leaf could be set up for reading - only valid after the first entry is read.
+  virtual bool Valid() const = 0;
+};
+
+namespace
+{
+  template <typename T>
+  class LeafReaderArray: public CompiledSelectionReader::LeafReader
+  {
+  public:
+    LeafReaderArray(TTreeReader& reader, const char* name): values(reader, name) {;}
+    virtual void Fill(std::vector<double>& out)
+    {
+      std::size_t n = values.GetSize();
+      out.resize(n);
+      for (std::size_t i = 0; i < n; i++)
+        {out[i] = (double)values[i];}
+    }
+    virtual bool Valid() const {return values.GetSetupStatus() >= 0;}
+  private:
+    TTreeReaderArray<T> values;
+  };
+
+  template <typename T>
+  class LeafReaderValue: public CompiledSelectionReader::LeafReader
+  {
+  public:
+    LeafReaderValue(TTreeReader& reader, const char* name): value(reader, name) {;}
+    virtual void Fill(std::vector<double>& out) {out.assign(1, (double)*value);}
+    virtual bool Valid() const {return value.GetSetupStatus() >= 0;}
+  private:
+    TTreeReaderValue<T> value;
+  };
+
+  /// Construct a reader of the right type. Returns nullptr if the type isn't supported.
+  template <template <typename> class R>
+  CompiledSelectionReader::LeafReader* MakeLeafReader(EDataType type, TTreeReader& reader, const char* name)
+  {
+    switch (type)
+      {
+      case kFloat_t:    {return new R<Float_t>(reader, name);}
+      case kDouble_t:   {return new R<Double_t>(reader, name);}
+      case kInt_t:      {return new R<Int_t>(reader, name);}
+      case kUInt_t:     {return new R<UInt_t>(reader, name);}
+      case kShort_t:    {return new R<Short_t>(reader, name);}
+      case kUShort_t:   {return new R<UShort_t>(reader, name);}
+      case kLong_t:     {return new R<Long_t>(reader, name);}
+      case kULong_t:    {return new R<ULong_t>(reader, name);}
+      case kLong64_t:   {return new R<Long64_t>(reader, name);}
+      case kULong64_t:  {return new R<ULong64_t>(reader, name);}
+      case kBool_t:     {return new R<Bool_t>(reader, name);}
+      case kChar_t:     {return new R<Char_t>(reader, name);}
+      case kUChar_t:    {return new R<UChar_t>(reader, name);}
+      default:          {return nullptr;}
+      }
+  }
+
+  bool SupportedType(EDataType type)
+  {
+    switch (type)
+      {
+      case kFloat_t: case kDouble_t: case kInt_t: case kUInt_t: case kShort_t: case kUShort_t:
+      case kLong_t: case kULong_t: case kLong64_t: case kULong64_t: case kBool_t: case kChar_t:
+      case kUChar_t:
+        {return true;}
+      default:
+        {return false;}
+      }
+  }
+
+  /// Unique number for each compiled function name.
+  std::atomic<int> functionCounter(0);
+}
+
+CompiledSelection::CompiledSelection(const std::string& selectionIn,
+                                     TTree* tree):
+  selection(selectionIn),
+  function(nullptr)
+{
+  if (Translate(tree))
+    {Compile();}
+}
+
+bool CompiledSelection::Translate(TTree* tree)
+{
+  if (!tree)
+    {reason = "no tree"; return false;}
+  if (selection.find_first_of("$@[\"'^?") != std::string::npos)
+    {reason = "uses syntax specific to TTreeFormula"; return false;}
+
+  // functions that have the same meaning in TTreeFormula and C++
+  static const std::set<std::string> allowedWords = {"abs", "fabs", "sqrt", "pow", "exp", "log", "log10",
+                                                     "sin", "cos", "tan", "asin", "acos", "atan", "atan2",
+                                                     "sinh", "cosh", "tanh", "floor", "ceil",
+                                                     "TMath", "true", "false"};
+
+  // match branch.leaf and any (optionally spaced) '(' following, or any other word
+  std::regex token("([A-Za-z_]\\w*)\\.([A-Za-z_]\\w*)(\\s*\\()?|((?:\\d+\\.?\\d*|\\.\\d+)(?:[eE][+-]?\\d+)?)|([A-Za-z_]\\w*)(::\\w+)?");
+  std::map<std::string, std::size_t> leafIndices;
+  std::string expression;
+  auto last = selection.cbegin();
+  for (std::sregex_iterator it(selection.cbegin(), selection.cend(), token), end; it != end; ++it)
+    {
+      const std::smatch& m = *it;
+      expression.append(last, m[0].first);
+      last = m[0].second;
+      if (m[4].matched) // a number - always a double as in TTreeFormula so 1/2 is 0.5
+        {expression += "double(" + m[0].str() + ")"; continue;}
+      if (m[5].matched) // a word that isn't a leaf
+        {
+          if (allowedWords.count(m[5].str()) == 0)
+            {reason = "unknown word \"" + m[5].str() + "\""; return false;}
+          expression += m[0].str();
+          continue;
+        }
+      if (m[3].matched)
+        {reason = "function of an object \"" + m[0].str() + "\""; return false;}
+
+      std::string name = m[1].str() + "." + m[2].str();
+      auto search = leafIndices.find(name);
+      std::size_t index = 0;
+      if (search != leafIndices.end())
+        {index = search->second;}
+      else
+        {
+          Leaf leaf;
+          if (!FindLeaf(tree, name, leaf, reason))
+            {return false;}
+          index = leaves.size();
+          leafIndices[name] = index;
+          leaves.push_back(leaf);
+        }
+      expression += "(v[" + std::to_string(index) + "][" + (leaves[index].isArray ? "i" : "0") + "])";
+    }
+  expression.append(last, selection.cend());
+  if (leaves.empty())
+    {reason = "no leaves used"; return false;}
+
+  functionName = "f" + std::to_string(functionCounter++);
+  code  = "#include <cmath>\n#include \"TMath.h\"\n";
+  code += "namespace RBDSCompiledSelection\n{\n";
+  code += "  void " + functionName + "(const double* const* v, Long64_t n, double* out)\n  {\n";
+  code += "    using namespace std;\n";
+  code += "    for (Long64_t i = 0; i < n; i++)\n";
+  code += "      {out[i] = (double)(" + expression + ");}\n";
+  code += "  }\n}\n";
+  return true;
+}
+
+bool CompiledSelection::FindLeaf(TTree*             tree,
+                                 const std::string& name,
+                                 Leaf&              result,
+                                 std::string&       reason)
+{
+  // only numbers or vectors of numbers are supported
+  TBranch* branch = tree->GetBranch(name.c_str());
+  if (!branch)
+    {reason = "no branch \"" + name + "\""; return false;}
+  if (branch->GetListOfBranches()->GetEntriesFast() > 0)
+    {reason = "\"" + name + "\" is not a leaf"; return false;}
+  TLeaf* leaf = static_cast<TLeaf*>(branch->GetListOfLeaves()->At(0));
+  if (leaf && (leaf->GetLeafCount() || leaf->GetLenStatic() > 1))
+    {reason = "\"" + name + "\" is a C array"; return false;}
+  TClass* cl = nullptr;
+  EDataType type = kNoType_t;
+  if (branch->GetExpectedType(cl, type) != 0)
+    {reason = "unknown type of \"" + name + "\""; return false;}
+  bool isArray = false;
+  if (cl)
+    {
+      TVirtualCollectionProxy* proxy = cl->GetCollectionProxy();
+      if (!proxy || proxy->GetValueClass())
+        {reason = "\"" + name + "\" is not a number or vector of numbers"; return false;}
+      type = proxy->GetType();
+      isArray = true;
+    }
+  if (!SupportedType(type))
+    {reason = "unsupported type of \"" + name + "\""; return false;}
+  result = {name, type, isArray};
+  return true;
+}
+
+bool CompiledSelection::Compile()
+{
+  R__LOCKGUARD(gInterpreterMutex);
+  if (!gInterpreter->Declare(code.c_str()))
+    {reason = "compilation failed"; return false;}
+  std::string address = "(long long)&RBDSCompiledSelection::" + functionName;
+  auto result = gInterpreter->Calc(address.c_str());
+  if (!result)
+    {reason = "compiled function not found"; return false;}
+  function = reinterpret_cast<Function>((std::uintptr_t)result);
+  return true;
+}
+
+CompiledSelectionReader::CompiledSelectionReader(const CompiledSelection* selectionIn,
+                                                 TTree* treeIn):
+  selection(selectionIn),
+  tree(treeIn),
+  reader(nullptr),
+  formula(nullptr),
+  checked(false)
+{
+  if (selection->Compiled())
+    {
+      reader = new TTreeReader(tree);
+      for (const auto& leaf : selection->Leaves())
+        {
+          LeafReader* lr = leaf.isArray ?
+            MakeLeafReader<LeafReaderArray>(leaf.type, *reader, leaf.name.c_str()) :
+            MakeLeafReader<LeafReaderValue>(leaf.type, *reader, leaf.name.c_str());
+          leafReaders.push_back(lr);
+        }
+      values.resize(leafReaders.size());
+      valuePointers.resize(leafReaders.size());
+    }
+  else
+    {UseFormula();}
+}
+
+void CompiledSelectionReader::UseFormula()
+{
+  for (auto lr : leafReaders)
+    {delete lr;}
+  leafReaders.clear();
+  delete reader;
+  reader = nullptr;
+  formula = new TTreeFormula("compiledSelectionFallback", selection->Selection().c_str(), tree);
+}
+
+CompiledSelectionReader::~CompiledSelectionReader()
+{
+  for (auto lr : leafReaders)
+    {delete lr;}
+  delete reader;
+  delete formula;
+}
+
+const std::vector<double>& CompiledSelectionReader::Evaluate(Long64_t entry)
+{
+  if (formula)
+    {
+      tree->LoadTree(entry);
+      int n = formula->GetNdata();
+      result.resize((std::size_t)n);
+      for (int i = 0; i < n; i++)
+        {result[(std::size_t)i] = formula->EvalInstance(i);}
+      return result;
+    }
+
+  reader->SetEntry(entry);
+  if (!checked)
+    {
+      checked = true;
+      bool allValid = std::all_of(leafReaders.begin(), leafReaders.end(), [](const LeafReader* lr){return lr && lr->Valid();});
+      if (!allValid)
+        {
+          UseFormula();
+          return Evaluate(entry);
+        }
+    }
+  // the number of instances is the shortest vector used
+  Long64_t n = 1;
+  bool anyArray = false;
+  const auto& leaves = selection->Leaves();
+  for (std::size_t i = 0; i < leafReaders.size(); i++)
+    {
+      leafReaders[i]->Fill(values[i]);
+      valuePointers[i] = values[i].data();
+      if (leaves[i].isArray)
+        {
+          n = anyArray ? std::min(n, (Long64_t)values[i].size()) : (Long64_t)values[i].size();
+          anyArray = true;
+        }
+    }
+  result.resize((std::size_t)n);
+  if (n > 0)
+    {selection->GetFunction()(valuePointers.data(), n, result.data());}
+  return result;
+}
+
+bool CompiledSelectionReader::Select(Long64_t entry)
+{
+  const std::vector<double>& instances = Evaluate(entry);
+  return std::any_of(instances.begin(), instances.end(), [](double v){return v != 0;});
+}
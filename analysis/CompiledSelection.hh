@@ -0,0 +1,140 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef COMPILEDSELECTION_H
+#define COMPILEDSELECTION_H
+
+#include "Rtypes.h"
+#include "TDataType.h"
+
+#include <string>
+#include <vector>
+
+class TTree;
+class TTreeFormula;
+class TTreeReader;
+
+/**
+ * @brief A selection (cut) expression compiled to a native function.
+ *
+ * The expression is written as for TTree::Draw, e.g. "Sampler1.x > 0 && Sampler1.partID == 11",
+ * and each "Branch.leaf" is a numerical leaf or a vector of them. This is translated to C++
+ * and compiled once with Cling. The compiled function is evaluated for each instance (index
+ * of the vectors) up to the shortest vector length as TTreeFormula does. If the expression
+ * uses anything that can't be translated (e.g. explicit indices, functions of objects, special
+ * variables like Entry$) or compilation fails, Compiled() is false and CompiledSelectionReader
+ * falls back to using a TTreeFormula. The compiled function has no state, so one instance of
+ * this class may be used by many threads, each with its own CompiledSelectionReader.
+ *
+ * @author Laurie Nevay
+ */
+
+class CompiledSelection
+{
+public:
+  /// The tree is only inspected for the types of the leaves used.
+  CompiledSelection(const std::string& selectionIn, TTree* tree);
+  ~CompiledSelection(){;}
+
+  /// Signature of the compiled function. The first argument is an array of
+  /// pointers to the values of each leaf, the second the number of instances and
+  /// the last the output with one value per instance.
+  typedef void (*Function)(const double* const*, Long64_t, double*);
+
+  /// Description of a leaf used.
+  struct Leaf
+  {
+    std::string name;    ///< Full name, e.g. "Sampler1.x".
+    EDataType   type;    ///< Type of the value or of the vector elements.
+    bool        isArray; ///< Whether it's a vector.
+  };
+
+  /// Find the type of a leaf that is a number or a vector of numbers. Returns false
+  /// and sets reason if it's anything else or doesn't exist.
+  static bool FindLeaf(TTree* tree, const std::string& name, Leaf& result, std::string& reason);
+
+  /// @{ Accessor.
+  inline bool Compiled() const {return function != nullptr;}
+  inline const std::string&       Selection() const {return selection;}
+  inline const std::string&       Code()      const {return code;}
+  inline const std::vector<Leaf>& Leaves()    const {return leaves;}
+  inline Function                 GetFunction() const {return function;}
+  inline const std::string&       Reason()    const {return reason;}
+  /// @}
+
+private:
+  CompiledSelection() = delete;
+
+  /// Translate the expression to C++ and record the leaves. Returns false if not possible.
+  bool Translate(TTree* tree);
+
+  /// Compile the translated code with Cling and get a pointer to the function.
+  bool Compile();
+
+  std::string selection;    ///< Original expression.
+  std::string functionName; ///< Name of the function in the generated code.
+  std::string code;         ///< Generated C++ code.
+  std::string reason;       ///< Why it wasn't compiled, if not.
+  std::vector<Leaf> leaves; ///< Leaves used in order of the index in the generated code.
+  Function function;        ///< Compiled function - nullptr if not compiled.
+};
+
+/**
+ * @brief Evaluate a CompiledSelection for entries of a tree.
+ *
+ * Only the leaves used are read with a TTreeReader. One instance should be used
+ * per tree and per thread. If the selection is not compiled, a TTreeFormula is
+ * used instead.
+ *
+ * @author Laurie Nevay
+ */
+
+class CompiledSelectionReader
+{
+public:
+  CompiledSelectionReader(const CompiledSelection* selectionIn, TTree* treeIn);
+  ~CompiledSelectionReader();
+
+  /// Whether an entry is selected, i.e. any instance of the expression is non-zero as
+  /// TTree::CopyTree would select it.
+  bool Select(Long64_t entry);
+
+  /// Value of the expression for each instance of an entry, e.g. for use as a weight.
+  const std::vector<double>& Evaluate(Long64_t entry);
+
+  /// Abstract reader of one leaf into a vector of doubles - defined in the source.
+  class LeafReader;
+
+private:
+  CompiledSelectionReader() = delete;
+
+  /// Use a TTreeFormula instead of the compiled function, e.g. if a leaf can't be read.
+  void UseFormula();
+
+  const CompiledSelection* selection;
+  TTree*        tree;
+  TTreeReader*  reader;
+  TTreeFormula* formula; ///< Only if not compiled.
+  bool          checked; ///< Whether the leaf readers have been checked after the first entry.
+  std::vector<LeafReader*> leafReaders;
+  std::vector<std::vector<double> > values;
+  std::vector<const double*> valuePointers;
+  std::vector<double> result;
+};
+
+#endif
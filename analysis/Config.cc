@@ -66,8 +66,8 @@ Config::Config(const std::string& inputFilePathIn,
   optionsString["outputfilename"] = ofn;
 
   // turn on merging only
-  branches["Event."].emplace_back("Histos");
-  branches["Run."].emplace_back("Histos");
+  SetBranchToBeActivated("Event.", "Histos");
+  SetBranchToBeActivated("Run.", "Histos");
   optionsBool["perentryevent"] = true;
 }
 
@@ -117,10 +117,12 @@ void Config::InitialiseOptions(const std::string& analysisFile)
   alternateKeys["calculateopticalfunctions"]         = "calculateoptics";
   alternateKeys["calculateopticalfunctionsfilename"] = "opticsfilename";
 
+  optionsBool["activateleavesonly"]   = true;
   optionsBool["allbranchesactivated"] = false;
   optionsBool["debug"]             = false;
   optionsBool["calculateoptics"]   = false;
   optionsBool["emittanceonthefly"] = false;
+  optionsBool["eventcachefloat"]   = true;
   optionsBool["mergehistograms"]   = true;
   optionsBool["perentrybeam"]      = false;
   optionsBool["perentryevent"]     = false;
@@ -128,6 +130,7 @@ void Config::InitialiseOptions(const std::string& analysisFile)
   optionsBool["perentryoption"]    = false;
   optionsBool["perentrymodel"]     = false;
   optionsBool["printout"]          = true;
+  optionsBool["prefetchclusters"]  = false;
   optionsBool["processsamplers"]   = false;
   optionsBool["backwardscompatible"] = false; // ignore file types for old data
   optionsBool["verbosespectra"]    = false;
@@ -136,10 +139,12 @@ void Config::InitialiseOptions(const std::string& analysisFile)
   optionsString["outputfilename"] = "";
   optionsString["opticsfilename"] = "";
   optionsString["gdmlfilename"]   = "";
+  optionsString["eventcachefile"] = "";
 
   optionsNumber["printmodulofraction"] = 0.01;
   optionsNumber["eventstart"]          = 0;
   optionsNumber["eventend"]            = -1;
+  optionsNumber["treecachesize"]       = -1;
 
   // ensure keys exist for all trees.
   for (const auto& name : treeNames)
@@ -148,6 +153,8 @@ void Config::InitialiseOptions(const std::string& analysisFile)
       histoDefsSimple[name]   = std::vector<HistogramDef*>();
       histoDefsPerEntry[name] = std::vector<HistogramDef*>();
       branches[name]          = std::vector<std::string>();
+      leaves[name]            = std::vector<std::string>();
+      branchesWhole[name]     = std::set<std::string>();
     }
 }
 
@@ -231,10 +238,11 @@ void Config::ParseInputFile()
     }
   if (optionsBool.at("mergehistograms"))
     {
-      branches["Event."].emplace_back("Histos");
-      branches["Run."].emplace_back("Histos");
+      SetBranchToBeActivated("Event.", "Histos");
+      SetBranchToBeActivated("Run.", "Histos");
       optionsBool["perentryevent"]   = true;
     }
+  BuildLeavesToBeActivated();
 
   // checks on event numbers
   double eS = optionsNumber.at("eventstart");
@@ -533,14 +541,17 @@ void Config::UpdateRequiredBranches(const std::string& treeName,
   // which makes it nigh on impossible to correctly identify the single : with
   // regex. For now, only the Options tree has this and we turn it all on, so it
   // it shouldn't be a problem (it only ever has one entry).
-  // match word; '.'; word -> here we match the token rather than the bits in-between
-  std::regex branchLeaf("(\\w+)\\.(\\w+)");
+  // match word; '.'; word; optional '(' -> here we match the token rather than the bits in-between
+  std::regex branchLeaf("(\\w+)\\.(\\w+)(\\s*\\()?");
   auto words_begin = std::sregex_iterator(var.begin(), var.end(), branchLeaf);
   auto words_end   = std::sregex_iterator();
   for (std::sregex_iterator i = words_begin; i != words_end; ++i)
     {
       std::string targetBranch = (*i)[1];
-      SetBranchToBeActivated(treeName, targetBranch);
+      if ((*i)[3].matched) // a function of the object -> we need all of it
+        {SetBranchToBeActivated(treeName, targetBranch);}
+      else
+        {SetLeafToBeActivated(treeName, targetBranch, targetBranch + "." + std::string((*i)[2]));}
     }
 }
 
@@ -550,6 +561,37 @@ void Config::SetBranchToBeActivated(const std::string& treeName,
   auto& v = branches.at(treeName);
   if (std::find(v.begin(), v.end(), branchName) == v.end())
     {v.push_back(branchName);}
+  branchesWhole.at(treeName).insert(branchName);
+}
+
+void Config::SetLeafToBeActivated(const std::string& treeName,
+                                  const std::string& branchName,
+                                  const std::string& leafName)
+{
+  auto& v = branches.at(treeName);
+  if (std::find(v.begin(), v.end(), branchName) == v.end())
+    {v.push_back(branchName);}
+  auto& l = leaves.at(treeName);
+  if (std::find(l.begin(), l.end(), leafName) == l.end())
+    {l.push_back(leafName);}
+}
+
+void Config::BuildLeavesToBeActivated()
+{
+  leavesToActivate.clear();
+  if (!optionsBool.at("activateleavesonly") || optionsBool.at("allbranchesactivated"))
+    {return;}
+  for (const auto& treeLeaves : leaves)
+    {
+      const auto& whole = branchesWhole.at(treeLeaves.first);
+      auto& result = leavesToActivate[treeLeaves.first];
+      for (const auto& leafName : treeLeaves.second)
+        {
+          std::string branchName = leafName.substr(0, leafName.find('.'));
+          if (whole.find(branchName) == whole.end())
+            {result.push_back(leafName);}
+        }
+    }
 }
 
 void Config::PrintHistogramSetDefinitions() const
@@ -109,15 +109,28 @@ public:
   inline const std::vector<std::string>& EventParticleSetNamesPerEntry() const {return eventParticleSetBranches;}
 
   /// Access all branches that are required for activation. This does not specialise on the
-  /// leaf inside the branch and if one variable is required, the whole branch will be activated
-  /// as there isn't much difference.  This can of course be revised in future.
+  /// leaf inside the branch - see LeavesToBeActivated().
   const RBDS::VectorString& BranchesToBeActivated(const std::string& treeName) const
   {return branches.at(treeName);}
 
   /// Access the map of all branches to be activated per tree.
   inline const RBDS::BranchMap& BranchesToBeActivated() const {return branches;}
 
-  /// Set a branch to be activated if not already.
+  /// Access the map of leaves (e.g. "Sampler1.x") to be activated per tree. Only
+  /// leaves of branches that are used purely in histogram expressions are included
+  /// and for these branches, only these leaves need be loaded. Empty if the option
+  /// ActivateLeavesOnly is false or all branches are activated.
+  inline const RBDS::BranchMap& LeavesToBeActivated() const {return leavesToActivate;}
+
+  /// Access all leaves (e.g. "Sampler1.x") used in histogram expressions for a tree
+  /// irrespective of whether their branch is required whole.
+  inline const RBDS::VectorString& LeavesUsed(const std::string& treeName) const {return leaves.at(treeName);}
+
+  /// Access the branches of a tree that are required whole, i.e. not just some leaves.
+  inline const std::set<std::string>& BranchesWholeToBeActivated(const std::string& treeName) const
+  {return branchesWhole.at(treeName);}
+
+  /// Set a branch to be activated if not already. The whole branch will be activated.
   void SetBranchToBeActivated(const std::string& treeName, const std::string& branchName);
 
   /// @{ Accessor.
@@ -203,9 +216,19 @@ public:
 
   /// Update the vector of required branches for a particular tree to be
   /// activated for analysis based on a single string definition such as Primary.x.
+  /// The leaf is also recorded unless it is followed by '(', i.e. a function of the
+  /// object, in which case the whole branch is required.
   void UpdateRequiredBranches(const std::string& treeName,
 			      const std::string& var);
 
+  /// Record a leaf of a branch to be activated and the branch itself if not already.
+  void SetLeafToBeActivated(const std::string& treeName,
+			    const std::string& branchName,
+			    const std::string& leafName);
+
+  /// Build leavesToActivate from the leaves for branches that are not required whole.
+  void BuildLeavesToBeActivated();
+
   /// Check if the supplied tree name is one of the static member vector of
   /// allowed tree names.
   bool InvalidTreeName(const std::string& treeName) const;
@@ -259,6 +282,15 @@ public:
   /// Cache of which branches need to be activated for this analysis.
   RBDS::BranchMap branches;
 
+  /// Cache of which leaves (e.g. "Sampler1.x") are used in expressions per tree.
+  RBDS::BranchMap leaves;
+
+  /// Branches per tree that are required in their entirety (e.g. for spectra).
+  std::map<std::string, std::set<std::string> > branchesWhole;
+
+  /// Leaves to activate for branches only required in part - built after parsing.
+  RBDS::BranchMap leavesToActivate;
+
   /// Cache of all spectra names declared to permit unique naming of histograms
   /// when there's more than one spectra per branch used.
   std::map<std::string, int> spectraNames;
@@ -49,12 +49,14 @@ DataLoader::DataLoader(const std::string& fileName,
                        bool        processSamplersIn,
                        bool        allBranchesOnIn,
                        const RBDS::BranchMap* branchesToTurnOnIn,
-                       bool        backwardsCompatibleIn):
+                       bool        backwardsCompatibleIn,
+                       const RBDS::BranchMap* leavesToTurnOnIn):
   debug(debugIn),
   processSamplers(processSamplersIn),
   allBranchesOn(allBranchesOnIn),
   branchesToTurnOn(branchesToTurnOnIn),
   backwardsCompatible(backwardsCompatibleIn),
+  leavesToTurnOn(leavesToTurnOnIn),
   parChain(nullptr),
   dataVersion(BDSIM_DATA_VERSION)
 {
@@ -103,7 +105,7 @@ void DataLoader::CommonCtor(const std::string& fileName)
   BuildTreeNameList();
   BuildEventBranchNameList();
   ChainTrees();
-  SetBranchAddress(allBranchesOn, branchesToTurnOn);
+  SetBranchAddress(allBranchesOn, branchesToTurnOn, leavesToTurnOn);
 
   if (dataVersion > 6)
     {
@@ -298,7 +300,8 @@ void DataLoader::ChainTrees()
 }
 
 void DataLoader::SetBranchAddress(bool allOn,
-                                  const RBDS::BranchMap* bToTurnOn)
+                                  const RBDS::BranchMap* bToTurnOn,
+                                  const RBDS::BranchMap* lToTurnOn)
 {
   if (dataVersion > 6)
     {par->SetBranchAddress(parChain);}
@@ -326,7 +329,13 @@ void DataLoader::SetBranchAddress(bool allOn,
             }
         }
     }
-  evt->SetBranchAddress(evtChain, &samplerNames, allOn, evtBranches, &collimatorNames, &samplerCNames, &samplerSNames);
+  const RBDS::VectorString* evtLeaves = nullptr;
+  if (lToTurnOn)
+    {
+      if (lToTurnOn->find("Event.") != lToTurnOn->end())
+        {evtLeaves = &(*lToTurnOn).at("Event.");}
+    }
+  evt->SetBranchAddress(evtChain, &samplerNames, allOn, evtBranches, &collimatorNames, &samplerCNames, &samplerSNames, evtLeaves);
 
   const RBDS::VectorString* runBranches = nullptr;
   if (bToTurnOn)
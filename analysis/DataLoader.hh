@@ -52,7 +52,8 @@ public:
 	     bool        processSamplersIn = true,
 	     bool        allBranchesOn     = true,
 	     const RBDS::BranchMap* branchesToTurnOn = nullptr,
-	     bool        backwardsCompatibleIn = true);
+	     bool        backwardsCompatibleIn = true,
+	     const RBDS::BranchMap* leavesToTurnOn = nullptr);
   virtual ~DataLoader();
 
   /// Create an instance of each class in the file to be overlaid by loading
@@ -73,8 +74,10 @@ public:
   void ChainTrees();
 
   /// Map each chain to the member instance of each storage class in this class.
+  /// If leaves are given for a tree, only those leaves of the named branches are loaded.
   void SetBranchAddress(bool allOn = true,
-                        const RBDS::BranchMap* bToTurnOn = nullptr);
+                        const RBDS::BranchMap* bToTurnOn = nullptr,
+                        const RBDS::BranchMap* lToTurnOn = nullptr);
 
   inline int DataVersion() const {return dataVersion;}
 
@@ -112,6 +115,7 @@ private:
   bool allBranchesOn;
   const RBDS::BranchMap* branchesToTurnOn;
   bool backwardsCompatible;
+  const RBDS::BranchMap* leavesToTurnOn;
 
   Header*     hea;
   ParticleData* par;
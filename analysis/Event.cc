@@ -32,10 +32,15 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "BDSOutputROOTEventSamplerC.hh"
 #include "BDSOutputROOTEventSamplerS.hh"
 
+#include <cmath>
+#include <map>
 #include <set>
+#include <string>
 #include <vector>
 
+#include "TBranch.h"
 #include "TChain.h"
+#include "TObjArray.h"
 
 ClassImp(Event)
 
@@ -209,7 +214,8 @@ void Event::SetBranchAddress(TTree* t,
                              const RBDS::VectorString* branchesToTurnOn,
                              const RBDS::VectorString* collimatorNamesIn,
                              const RBDS::VectorString* samplerCNamesIn,
-                             const RBDS::VectorString* samplerSNamesIn)
+                             const RBDS::VectorString* samplerSNamesIn,
+                             const RBDS::VectorString* leavesToTurnOn)
 {
   if (debug)
     {std::cout << "Event::SetBranchAddress" << std::endl;}
@@ -260,6 +266,30 @@ void Event::SetBranchAddress(TTree* t,
     }
   bToTurnOn = RemoveDuplicates(bToTurnOn);
 
+  // group any leaves by branch name (without the '.') - the few small branches that
+  // are always on are used in code and so are always loaded in full
+  std::map<std::string, RBDS::VectorString> leavesByBranch;
+  if (leavesToTurnOn && !allBranchesOn)
+    {
+      for (const auto& leafName : *leavesToTurnOn)
+        {leavesByBranch[leafName.substr(0, leafName.find('.'))].push_back(leafName);}
+      for (const auto& name : {"Primary", "Info", "Summary", "PrimaryFirstHit", "PrimaryLastHit", "Histos"})
+        {leavesByBranch.erase(name);}
+      if (processSamplers) // sampler analysis uses all of each sampler
+        {
+          for (const auto* names : {samplerNamesIn, samplerCNamesIn, samplerSNamesIn})
+            {
+              if (!names)
+                {continue;}
+              for (const auto& sampName : *names)
+                {leavesByBranch.erase(sampName.substr(0, sampName.find('.')));}
+            }
+        }
+    }
+  std::set<std::string> leavesOnly; // names of branches with only some leaves turned on
+  double bytesWhole  = 0;
+  double bytesLeaves = 0;
+
   // pre-count the number of collimators and create them all at once. Do this so the vector
   // is never resized and therefore the contents copied / moved in memory. SetBranchAddress
   // takes & (object*) so pointer to pointer, which would break if the contents of the vector
@@ -290,7 +320,10 @@ void Event::SetBranchAddress(TTree* t,
           continue;
         }
       
-      t->SetBranchStatus(nameStar.c_str(), true); // turn the branch loading on
+      if (SetBranchStatusLeaves(t, name, leavesByBranch, bytesWhole, bytesLeaves))
+        {leavesOnly.insert(name);}
+      else
+        {t->SetBranchStatus(nameStar.c_str(), true);} // turn the branch loading on
       
       // we can't automatically do this as SetBranchAddress must use the pointer
       // of the object type and not the base class (say TObject) so there's no
@@ -378,7 +411,8 @@ void Event::SetBranchAddress(TTree* t,
           samplerMap[sampName] = Samplers[i];// cache the sampler in a map
             
           t->SetBranchAddress(sampName.c_str(), &Samplers[i]);
-          t->SetBranchStatus((sampName+"*").c_str(), true);
+          if (leavesOnly.count(sampName.substr(0, sampName.find('.'))) == 0)
+            {t->SetBranchStatus((sampName+"*").c_str(), true);}
           if (debug)
             {std::cout << "Event::SetBranchAddress> " << (*samplerNamesIn)[i] << " " << Samplers[i] << std::endl;}
         }
@@ -396,7 +430,8 @@ void Event::SetBranchAddress(TTree* t,
           samplerCMap[sampName] = SamplersC[i];// cache the sampler in a map
           
           t->SetBranchAddress(sampName.c_str(), &SamplersC[i]);
-          t->SetBranchStatus((sampName+"*").c_str(), true);
+          if (leavesOnly.count(sampName.substr(0, sampName.find('.'))) == 0)
+            {t->SetBranchStatus((sampName+"*").c_str(), true);}
           if (debug)
             {std::cout << "Event::SetBranchAddress> " << (*samplerCNamesIn)[i] << " " << SamplersC[i] << std::endl;}
         }
@@ -414,11 +449,61 @@ void Event::SetBranchAddress(TTree* t,
           samplerSMap[sampName] = SamplersS[i];// cache the sampler in a map
           
           t->SetBranchAddress(sampName.c_str(), &SamplersS[i]);
-          t->SetBranchStatus((sampName+"*").c_str(), true);
+          if (leavesOnly.count(sampName.substr(0, sampName.find('.'))) == 0)
+            {t->SetBranchStatus((sampName+"*").c_str(), true);}
           if (debug)
             {std::cout << "Event::SetBranchAddress> " << (*samplerSNamesIn)[i] << " " << SamplersS[i] << std::endl;}
         }
     }
+
+  if (bytesWhole > 0)
+    {
+      std::cout << "Event::SetBranchAddress> Loading only the leaves used of partially used branches: "
+                << std::round(bytesWhole) << " -> " << std::round(bytesLeaves)
+                << " bytes per event (uncompressed) for these branches" << std::endl;
+    }
+}
+
+bool Event::SetBranchStatusLeaves(TTree* t,
+                                  const std::string& branchName,
+                                  const std::map<std::string, RBDS::VectorString>& leavesByBranch,
+                                  double& bytesWhole,
+                                  double& bytesLeaves) const
+{
+  std::string name = branchName.back() == '.' ? branchName.substr(0, branchName.size() - 1) : branchName;
+  auto search = leavesByBranch.find(name);
+  if (search == leavesByBranch.end())
+    {return false;}
+
+  // only a split branch has sub-branches we can choose from and each leaf must be
+  // one of them, otherwise (e.g. a member of a member) load the whole branch
+  TBranch* branch = t->GetBranch((name + ".").c_str());
+  if (!branch || branch->GetListOfBranches()->GetEntriesFast() == 0)
+    {return false;}
+  std::vector<TBranch*> leafBranches;
+  for (const auto& leafName : search->second)
+    {
+      TBranch* leafBranch = t->GetBranch(leafName.c_str());
+      if (!leafBranch)
+        {return false;}
+      leafBranches.push_back(leafBranch);
+    }
+
+  // exact names without '*' as this would also match other leaves with the same start
+  t->SetBranchStatus((name + ".").c_str(), true);
+  double entries = branch->GetEntries() > 0 ? (double)branch->GetEntries() : 1.0;
+  for (std::size_t i = 0; i < leafBranches.size(); i++)
+    {
+      const std::string& leafName = search->second[i];
+      t->SetBranchStatus(leafName.c_str(), true);
+      if (leafBranches[i]->GetListOfBranches()->GetEntriesFast() > 0)
+        {t->SetBranchStatus((leafName + ".*").c_str(), true);}
+      bytesLeaves += (double)leafBranches[i]->GetTotBytes("*") / entries;
+    }
+  bytesWhole += (double)branch->GetTotBytes("*") / entries;
+  if (debug)
+    {std::cout << "Event::SetBranchAddress> Turning on " << leafBranches.size() << " leaves of branch \"" << name << ".\"" << std::endl;}
+  return true;
 }
 
 void Event::RelinkSamplers()
@@ -110,14 +110,17 @@ public:
   inline void SetDataVersion(int dataVersionIn) {dataVersion = dataVersionIn;}
 
   /// Set the branch addresses to address the contents of the file. The vector
-  /// of sampler names is used to turn only the samplers required. 
+  /// of sampler names is used to turn only the samplers required. If leaves
+  /// (e.g. "Sampler1.x") are given for a branch, only these sub-branches of that
+  /// branch are turned on, providing the branch is split and they all exist.
   void SetBranchAddress(TTree* t,
                         const RBDS::VectorString* samplerNames      = nullptr,
                         bool                      allBranchesOn     = false,
                         const RBDS::VectorString* branchesToTurnOn  = nullptr,
                         const RBDS::VectorString* collimatorNamesIn = nullptr,
                         const RBDS::VectorString* samplerCNamesIn  = nullptr,
-                        const RBDS::VectorString* samplerSNamesIn  = nullptr);
+                        const RBDS::VectorString* samplerSNamesIn  = nullptr,
+                        const RBDS::VectorString* leavesToTurnOn   = nullptr);
 
   /// @{ Local variable ROOT data is mapped to.
 #ifdef __ROOTDOUBLE__
@@ -190,6 +193,16 @@ private:
                                          const std::string& name,
                                          int i);
   /// @}
+
+  /// Turn on only the leaves required for a branch if there are any in leavesByBranch.
+  /// Returns false if the whole branch should be turned on instead. The uncompressed
+  /// bytes per entry of the whole branch and of the chosen leaves are added to the
+  /// last two arguments.
+  bool SetBranchStatusLeaves(TTree* t,
+                             const std::string& branchName,
+                             const std::map<std::string, RBDS::VectorString>& leavesByBranch,
+                             double& bytesWhole,
+                             double& bytesLeaves) const;
   
   TTree* tree;
   bool debug;
@@ -32,13 +32,21 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "SamplerAnalysis.hh"
 #include "rebdsim.hh"
 
+#include "TBranch.h"
 #include "TChain.h"
 #include "TDirectory.h"
 #include "TFile.h"
+#include "TLeaf.h"
+#include "TObjArray.h"
+#include "TTree.h"
+#include "TTreeCache.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <iomanip>
 #include <iostream>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -53,7 +61,9 @@ EventAnalysis::EventAnalysis():
   emittanceOnTheFly(false),
   eventStart(0),
   eventEnd(-1),
-  nEventsToProcess(0)
+  nEventsToProcess(0),
+  treeCacheSize(-1),
+  prefetchClusters(false)
 {;}
 
 EventAnalysis::EventAnalysis(Event*   eventIn,
@@ -75,7 +85,9 @@ EventAnalysis::EventAnalysis(Event*   eventIn,
   emittanceOnTheFly(emittanceOnTheFlyIn),
   eventStart(eventStartIn),
   eventEnd(eventEndIn),
-  nEventsToProcess(eventEndIn - eventStartIn)
+  nEventsToProcess(eventEndIn - eventStartIn),
+  treeCacheSize(-1),
+  prefetchClusters(false)
 {
   // check we get this right for print out normalisation
   if (eventEndIn == -1)
@@ -136,6 +148,12 @@ void EventAnalysis::Execute()
   std::cout << "Analysis on \"" << treeName << "\" complete" << std::endl;
 }
 
+void EventAnalysis::SetTreeCache(double treeCacheSizeIn, bool prefetchClustersIn)
+{
+  treeCacheSize    = treeCacheSizeIn;
+  prefetchClusters = prefetchClustersIn;
+}
+
 void EventAnalysis::SetPrintModuloFraction(double fraction)
 {
   printModulo = (int)std::ceil((double)nEventsToProcess * fraction);
@@ -167,7 +185,12 @@ void EventAnalysis::Process()
                 << ") in file(s) -> curtailing to # of entries!" << std::endl;
       eventEnd = entries;
     }
+  SetupTreeCache();
+  long long bytesReadStart = (long long)TFile::GetFileBytesRead();
+  auto loopStart = std::chrono::steady_clock::now();
+
   bool firstLoop = true;
+  double totalBytesLoaded = 0;
   for (auto i = (Long64_t)eventStart; i < (Long64_t)eventEnd; ++i)
     {
       if (firstLoop) // ensure samplers setup for spectra before we load data
@@ -175,6 +198,7 @@ void EventAnalysis::Process()
 
       event->Flush();
       Int_t bytesLoaded = chain->GetEntry(i);
+      totalBytesLoaded += (double)bytesLoaded;
       if (debug)
         {std::cout << __METHOD_NAME__ << i << ": " << bytesLoaded << " bytes loaded" << std::endl;}
       // event analysis feedback
@@ -216,6 +240,88 @@ void EventAnalysis::Process()
         {firstLoop = false;} // set to false on first pass of loop
     }
   std::cout << "\rSampler analysis complete                           " << std::endl;
+  Long64_t nEventsProcessed = (Long64_t)eventEnd - (Long64_t)eventStart;
+  if (nEventsProcessed > 0)
+    {
+      std::cout << "Mean bytes loaded per event (uncompressed): "
+                << std::round(totalBytesLoaded / (double)nEventsProcessed) << std::endl;
+    }
+  PrintReadStatistics(bytesReadStart, std::chrono::duration<double>(std::chrono::steady_clock::now() - loopStart).count());
+}
+
+void EventAnalysis::SetupTreeCache()
+{
+  if (treeCacheSize == 0)
+    {
+      chain->SetCacheSize(0);
+      return;
+    }
+  Long64_t firstEntry = (Long64_t)eventStart;
+  Long64_t localEntry = chain->LoadTree(firstEntry);
+  TTree* tree = chain->GetTree();
+  if (localEntry < 0 || !tree)
+    {return;}
+
+  // only the active bottom-level branches hold data we will read
+  std::vector<std::string> activeBranches;
+  std::set<std::string> seen;
+  double zipBytesPerEntry = 0;
+  TObjArray* leaves = tree->GetListOfLeaves();
+  for (int i = 0; i < leaves->GetEntriesFast(); i++)
+    {
+      TBranch* branch = static_cast<TLeaf*>(leaves->At(i))->GetBranch();
+      std::string name = branch->GetName();
+      if (!seen.insert(name).second || !tree->GetBranchStatus(name.c_str()))
+        {continue;}
+      activeBranches.push_back(name);
+      if (branch->GetEntries() > 0)
+        {zipBytesPerEntry += (double)branch->GetZipBytes() / (double)branch->GetEntries();}
+    }
+
+  const double mb = 1024.0*1024.0;
+  Long64_t cacheSize = 0;
+  if (treeCacheSize > 0)
+    {cacheSize = (Long64_t)(treeCacheSize * mb);}
+  else
+    {// the cluster being read and the next one
+      auto clusterIterator = tree->GetClusterIterator(localEntry);
+      Long64_t clusterStart = clusterIterator();
+      Long64_t clusterEntries = std::max((Long64_t)1, clusterIterator.GetNextEntry() - clusterStart);
+      double estimate = 2.0 * (double)clusterEntries * zipBytesPerEntry;
+      cacheSize = (Long64_t)std::min(std::max(estimate, 10*mb), 1024*mb);
+    }
+
+  chain->SetCacheSize(cacheSize);
+  Long64_t lastEntry = eventEnd < 0 ? chain->GetEntries() : (Long64_t)eventEnd;
+  chain->SetCacheEntryRange(firstEntry, lastEntry);
+  for (const auto& name : activeBranches)
+    {chain->AddBranchToCache(name.c_str(), false);}
+  chain->StopCacheLearningPhase();
+  if (prefetchClusters)
+    {chain->SetClusterPrefetch(true);}
+
+  std::streamsize oldPrecision = std::cout.precision(4);
+  std::cout << "Event tree cache: " << (double)cacheSize / mb << " MB for "
+            << activeBranches.size() << " branches ("
+            << zipBytesPerEntry / 1024.0 << " kB compressed per event)"
+            << (prefetchClusters ? " with cluster prefetching" : "") << std::endl;
+  std::cout.precision(oldPrecision);
+}
+
+void EventAnalysis::PrintReadStatistics(long long bytesReadStart, double seconds) const
+{
+  const double mb = 1024.0*1024.0;
+  double mbRead = (double)((long long)TFile::GetFileBytesRead() - bytesReadStart) / mb;
+  std::streamsize oldPrecision = std::cout.precision(4);
+  std::cout << "Event tree read: " << mbRead << " MB in " << seconds << " s";
+  if (seconds > 0)
+    {std::cout << " -> " << mbRead / seconds << " MB/s";}
+  TFile* currentFile = chain->GetCurrentFile();
+  const TTreeCache* cache = currentFile ? dynamic_cast<const TTreeCache*>(currentFile->GetCacheRead(chain->GetTree())) : nullptr;
+  if (cache)
+    {std::cout << ", cache efficiency " << 100 * cache->GetEfficiency() << " %";}
+  std::cout << std::endl;
+  std::cout.precision(oldPrecision);
 }
 
 void EventAnalysis::CheckSpectraBranches()
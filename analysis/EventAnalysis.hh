@@ -76,6 +76,11 @@ public:
   /// Write analysis including optical functions to an output file.
   virtual void Write(TFile* outputFileName);
 
+  /// Set the size of the tree cache used in Process() in MB. 0 turns it off and a
+  /// negative value sizes it automatically for two clusters of the active branches.
+  /// Optionally, prefetch the next cluster while the current one is processed.
+  void SetTreeCache(double treeCacheSizeIn, bool prefetchClustersIn);
+
 protected:
   Event* event; ///< Event object that data loaded from the file will be loaded into.
   std::vector<SamplerAnalysis*> samplerAnalyses; ///< Holder for sampler analysis objects.
@@ -100,6 +105,13 @@ private:
   /// Process each sampler analysis object.
   void ProcessSamplers(bool firstTime = false);
 
+  /// Size the tree cache and add only the active branches to it so there's no
+  /// learning phase. Called before the event loop.
+  void SetupTreeCache();
+
+  /// Print the amount read from file, the rate and the cache efficiency.
+  void PrintReadStatistics(long long bytesReadStart, double seconds) const;
+
   /// The data is different for different sampler types and therefore we must
   /// specialise the PerEntryHistogramSet. This delegator function constructs
   /// the right one.
@@ -114,6 +126,8 @@ private:
   long int eventStart;    ///< Event index to start analysis from.
   long int eventEnd;      ///< Event index to end analysis at.
   long int nEventsToProcess; ///< Difference between start and stop.
+  double treeCacheSize;   ///< Tree cache size in MB (<0 automatic, 0 off).
+  bool   prefetchClusters;///< Whether to prefetch the next cluster.
 
   /// Cache of all per entry histogram sets.
   std::vector<PerEntryHistogramSet*> perEntryHistogramSets;
@@ -121,7 +135,7 @@ private:
   /// Map of simple histograms created per histogram set for writing out.
   std::map<HistogramDefSet*, std::vector<TH1*> > simpleSetHistogramOutputs;
   
-  ClassDef(EventAnalysis,2);
+  ClassDef(EventAnalysis,3);
 };
 
 #endif
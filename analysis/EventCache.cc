@@ -0,0 +1,320 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "CompiledSelection.hh"
+#include "EventCache.hh"
+
+#include "TChain.h"
+#include "TFile.h"
+#include "TNamed.h"
+#include "TSystem.h"
+#include "TTree.h"
+#include "TTreeReader.h"
+#include "TTreeReaderArray.h"
+#include "TTreeReaderValue.h"
+#include "TUUID.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+const std::string EventCache::treeName = "EventCache";
+
+namespace
+{
+  /// One leaf copied from the input to the cache.
+  class Column
+  {
+  public:
+    virtual ~Column(){;}
+    /// Copy the value(s) of the current entry to the output buffer.
+    virtual void Fill() = 0;
+    /// Whether the leaf could be set up for reading - only valid after the first entry is read.
+    virtual bool Valid() const = 0;
+  };
+
+  template <typename In, typename Out>
+  class ColumnArray: public Column
+  {
+  public:
+    ColumnArray(TTreeReader& reader, TTree* output, const std::string& name):
+      values(reader, name.c_str())
+    {output->Branch(name.c_str(), &buffer);}
+    virtual void Fill()
+    {
+      std::size_t n = values.GetSize();
+      buffer.resize(n);
+      for (std::size_t i = 0; i < n; i++)
+        {buffer[i] = (Out)values[i];}
+    }
+    virtual bool Valid() const {return values.GetSetupStatus() >= 0;}
+  private:
+    TTreeReaderArray<In> values;
+    std::vector<Out>     buffer;
+  };
+
+  template <typename In, typename Out>
+  class ColumnValue: public Column
+  {
+  public:
+    ColumnValue(TTreeReader& reader, TTree* output, const std::string& name):
+      value(reader, name.c_str()),
+      buffer(0)
+    {output->Branch(name.c_str(), &buffer);}
+    virtual void Fill() {buffer = (Out)*value;}
+    virtual bool Valid() const {return value.GetSetupStatus() >= 0;}
+  private:
+    TTreeReaderValue<In> value;
+    Out                  buffer;
+  };
+
+  /// Construct a column of the right type. Doubles are stored as floats if packFloat.
+  /// Returns nullptr if the type isn't supported.
+  template <template <typename, typename> class C>
+  Column* MakeColumn(EDataType type, bool packFloat, TTreeReader& reader, TTree* output, const std::string& name)
+  {
+    switch (type)
+      {
+      case kFloat_t:    {return new C<Float_t, Float_t>(reader, output, name);}
+      case kDouble_t:
+        {
+          if (packFloat)
+            {return new C<Double_t, Float_t>(reader, output, name);}
+          else
+            {return new C<Double_t, Double_t>(reader, output, name);}
+        }
+      case kInt_t:      {return new C<Int_t, Int_t>(reader, output, name);}
+      case kUInt_t:     {return new C<UInt_t, UInt_t>(reader, output, name);}
+      case kShort_t:    {return new C<Short_t, Short_t>(reader, output, name);}
+      case kUShort_t:   {return new C<UShort_t, UShort_t>(reader, output, name);}
+      case kLong_t:     {return new C<Long_t, Long_t>(reader, output, name);}
+      case kULong_t:    {return new C<ULong_t, ULong_t>(reader, output, name);}
+      case kLong64_t:   {return new C<Long64_t, Long64_t>(reader, output, name);}
+      case kULong64_t:  {return new C<ULong64_t, ULong64_t>(reader, output, name);}
+      case kBool_t:     {return new C<Bool_t, Bool_t>(reader, output, name);}
+      case kChar_t:     {return new C<Char_t, Char_t>(reader, output, name);}
+      case kUChar_t:    {return new C<UChar_t, UChar_t>(reader, output, name);}
+      default:          {return nullptr;}
+      }
+  }
+}
+
+EventCache::EventCache(const std::string& fileNameIn,
+                       bool               packFloatIn):
+  fileName(fileNameIn),
+  packFloat(packFloatIn)
+{;}
+
+TChain* EventCache::Open(const std::vector<std::string>& inputFiles,
+                         const std::vector<std::string>& leavesRequired)
+{
+  // the branch / leaf matching in Config also matches numbers such as "1.5" - ignore these
+  std::set<std::string> required;
+  for (const auto& name : leavesRequired)
+    {
+      if (!name.empty() && !std::isdigit((unsigned char)name[0]))
+        {required.insert(name);}
+    }
+  if (required.empty())
+    {reason = "no leaves of the Event tree are used"; return nullptr;}
+
+  std::string fingerprint;
+  if (!Fingerprint(inputFiles, fingerprint))
+    {return nullptr;}
+
+  std::string existingFingerprint;
+  std::set<std::string> existingLeaves;
+  bool exists = ReadExisting(existingFingerprint, existingLeaves);
+  bool sameInput = exists && existingFingerprint == fingerprint;
+  if (sameInput && std::includes(existingLeaves.begin(), existingLeaves.end(), required.begin(), required.end()))
+    {std::cout << "EventCache> reusing \"" << fileName << "\"" << std::endl;}
+  else
+    {
+      std::set<std::string> leaves = required;
+      if (sameInput)
+        {// keep what we had so alternating between analyses doesn't rebuild it each time
+          leaves.insert(existingLeaves.begin(), existingLeaves.end());
+          std::cout << "EventCache> adding leaves to \"" << fileName << "\"" << std::endl;
+        }
+      else if (exists)
+        {std::cout << "EventCache> input data changed - rebuilding \"" << fileName << "\"" << std::endl;}
+      else
+        {std::cout << "EventCache> building \"" << fileName << "\"" << std::endl;}
+      if (!Build(inputFiles, leaves, fingerprint))
+        {return nullptr;}
+    }
+
+  TChain* result = new TChain(treeName.c_str());
+  result->Add(fileName.c_str());
+  return result;
+}
+
+bool EventCache::Fingerprint(const std::vector<std::string>& inputFiles,
+                             std::string& result)
+{
+  std::ostringstream ss;
+  ss << "float=" << packFloat << "\n";
+  for (const auto& inputFile : inputFiles)
+    {
+      TFile* f = TFile::Open(inputFile.c_str(), "READ");
+      if (!f || f->IsZombie())
+        {
+          delete f;
+          reason = "unable to open \"" + inputFile + "\"";
+          return false;
+        }
+      TTree* eventTree = dynamic_cast<TTree*>(f->Get("Event"));
+      Long64_t entries = eventTree ? eventTree->GetEntries() : 0;
+      ss << inputFile << " " << f->GetSize() << " " << f->GetUUID().AsString() << " " << entries << "\n";
+      f->Close();
+      delete f;
+    }
+  result = ss.str();
+  return true;
+}
+
+bool EventCache::ReadExisting(std::string& fingerprint,
+                              std::set<std::string>& leaves) const
+{
+  if (gSystem->AccessPathName(fileName.c_str())) // true if it doesn't exist
+    {return false;}
+  TFile* f = TFile::Open(fileName.c_str(), "READ");
+  if (!f || f->IsZombie())
+    {delete f; return false;}
+  TNamed* fp = dynamic_cast<TNamed*>(f->Get("InputFingerprint"));
+  TNamed* ls = dynamic_cast<TNamed*>(f->Get("Leaves"));
+  TTree* tree = dynamic_cast<TTree*>(f->Get(treeName.c_str()));
+  bool valid = fp && ls && tree;
+  if (valid)
+    {
+      fingerprint = fp->GetTitle();
+      std::istringstream ss(ls->GetTitle());
+      std::string name;
+      while (ss >> name)
+        {leaves.insert(name);}
+    }
+  f->Close();
+  delete f;
+  return valid;
+}
+
+bool EventCache::Build(const std::vector<std::string>& inputFiles,
+                       const std::set<std::string>&    leaves,
+                       const std::string&              fingerprint)
+{
+  auto start = std::chrono::steady_clock::now();
+  TChain input("Event");
+  for (const auto& inputFile : inputFiles)
+    {input.Add(inputFile.c_str());}
+  Long64_t nEntries = input.GetEntries();
+  if (nEntries <= 0 || input.LoadTree(0) < 0)
+    {reason = "no events in input"; return false;}
+
+  std::vector<CompiledSelection::Leaf> leafInfo;
+  for (const auto& name : leaves)
+    {
+      CompiledSelection::Leaf leaf;
+      if (!CompiledSelection::FindLeaf(input.GetTree(), name, leaf, reason))
+        {return false;}
+      leafInfo.push_back(leaf);
+    }
+
+  // write to a temporary file so an interrupted build doesn't leave a valid looking cache
+  std::string tempFileName = fileName + ".tmp";
+  TFile* output = TFile::Open(tempFileName.c_str(), "RECREATE");
+  if (!output || output->IsZombie())
+    {
+      delete output;
+      reason = "unable to open \"" + tempFileName + "\" for writing";
+      return false;
+    }
+  output->cd();
+  TTree* tree = new TTree(treeName.c_str(), "Leaves of the Event tree used for analysis");
+  tree->SetDirectory(output);
+
+  TTreeReader reader(&input);
+  std::vector<Column*> columns;
+  for (const auto& leaf : leafInfo)
+    {
+      Column* column = leaf.isArray ?
+        MakeColumn<ColumnArray>(leaf.type, packFloat, reader, tree, leaf.name) :
+        MakeColumn<ColumnValue>(leaf.type, packFloat, reader, tree, leaf.name);
+      columns.push_back(column);
+    }
+
+  bool valid = true;
+  Long64_t printModulo = std::max((Long64_t)1, nEntries / 10);
+  while (valid && reader.Next())
+    {
+      Long64_t i = reader.GetCurrentEntry();
+      if (i == 0)
+        {
+          for (std::size_t j = 0; j < columns.size(); j++)
+            {
+              if (!columns[j]->Valid())
+                {reason = "unable to read \"" + leafInfo[j].name + "\""; valid = false;}
+            }
+          if (!valid)
+            {break;}
+        }
+      for (auto column : columns)
+        {column->Fill();}
+      tree->Fill();
+      if (i % printModulo == 0)
+        {
+          std::cout << "\rEventCache> event " << i << " of " << nEntries;
+          std::cout.flush();
+        }
+    }
+  std::cout << std::endl;
+  valid = valid && reader.GetEntryStatus() != TTreeReader::kEntryChainFileError;
+
+  std::string leafList;
+  for (const auto& name : leaves)
+    {leafList += name + " ";}
+  if (valid)
+    {
+      output->cd();
+      tree->Write("", TObject::kOverwrite);
+      TNamed("InputFingerprint", fingerprint.c_str()).Write();
+      TNamed("Leaves", leafList.c_str()).Write();
+    }
+  for (auto column : columns)
+    {delete column;}
+  output->Close();
+  delete output;
+
+  if (!valid)
+    {
+      gSystem->Unlink(tempFileName.c_str());
+      if (reason.empty())
+        {reason = "error reading input";}
+      return false;
+    }
+  gSystem->Rename(tempFileName.c_str(), fileName.c_str());
+
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  std::cout << "EventCache> " << nEntries << " events with " << leaves.size()
+            << " leaves written in " << seconds << " s" << std::endl;
+  return true;
+}
@@ -0,0 +1,89 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef EVENTCACHE_H
+#define EVENTCACHE_H
+
+#include <set>
+#include <string>
+#include <vector>
+
+class TChain;
+
+/**
+ * @brief A reduced copy of the Event tree with only the leaves used for analysis.
+ *
+ * For iterative tuning of an analysis (e.g. binning or selections) the same raw
+ * data is read many times, but typically only a handful of leaves are used. This
+ * writes those leaves (numbers or vectors of numbers) for every event to a separate
+ * file with a tree called "EventCache", with branches named exactly as the leaves
+ * (e.g. "Sampler1.x") so the same TTree::Draw expressions work with it. Doubles
+ * are optionally stored as floats to halve the size.
+ *
+ * The cache records a fingerprint of the input files (name, size, ROOT UUID and
+ * number of events) and the leaves it contains. It is reused if the fingerprint
+ * matches and it contains all the leaves required, otherwise it is rebuilt with
+ * the union of the leaves it had and those required.
+ *
+ * @author Laurie Nevay
+ */
+
+class EventCache
+{
+public:
+  EventCache(const std::string& fileNameIn,
+             bool               packFloatIn);
+  ~EventCache(){;}
+
+  /// Open the cache for these input files and leaves (re)building it if required.
+  /// Returns a chain of the cache tree that the caller owns or nullptr and the
+  /// reason is printed if it can't be used.
+  TChain* Open(const std::vector<std::string>& inputFiles,
+               const std::vector<std::string>& leavesRequired);
+
+  /// @{ Accessor.
+  inline const std::string& FileName() const {return fileName;}
+  inline const std::string& Reason()   const {return reason;}
+  /// @}
+
+  /// Name of the tree in the cache file.
+  static const std::string treeName;
+
+private:
+  EventCache() = delete;
+
+  /// Build a string identifying the input files. Returns false if a file can't be opened.
+  bool Fingerprint(const std::vector<std::string>& inputFiles,
+                   std::string& result);
+
+  /// Read the fingerprint and leaves of an existing cache file. Returns false if there
+  /// is no valid cache file.
+  bool ReadExisting(std::string& fingerprint,
+                    std::set<std::string>& leaves) const;
+
+  /// Write the cache file with these leaves from the input files.
+  bool Build(const std::vector<std::string>& inputFiles,
+             const std::set<std::string>&    leaves,
+             const std::string&              fingerprint);
+
+  std::string fileName;
+  bool        packFloat;
+  std::string reason;
+};
+
+#endif
@@ -63,6 +63,46 @@ bool RBDS::GetFileType(TFile*       file,
   return true;
 }
 
+RBDS::FileFingerprint RBDS::GetFileFingerprint(TFile* file)
+{
+  FileFingerprint result = {0, -1, 0};
+  std::string fileType;
+  GetFileType(file, fileType, &result.dataVersion);
+
+  // rebdsim output uses the name ModelTree
+  TTree* modelTree = dynamic_cast<TTree*>(file->Get("Model"));
+  if (!modelTree)
+    {modelTree = dynamic_cast<TTree*>(file->Get("ModelTree"));}
+  if (modelTree)
+    {
+      result.modelEntries = (long long)modelTree->GetEntries();
+      result.modelBytes   = (long long)modelTree->GetTotBytes();
+    }
+  return result;
+}
+
+bool RBDS::ConsistentFiles(const FileFingerprint& reference,
+			   const FileFingerprint& other,
+			   std::string&           reason)
+{
+  if (reference.dataVersion != other.dataVersion)
+    {
+      reason = "different data version (" + std::to_string(other.dataVersion) + " vs "
+	+ std::to_string(reference.dataVersion) + ")";
+      return false;
+    }
+  // only compare the model if both have one
+  if (reference.modelEntries >= 0 && other.modelEntries >= 0)
+    {
+      if (reference.modelEntries != other.modelEntries || reference.modelBytes != other.modelBytes)
+	{
+	  reason = "different model";
+	  return false;
+	}
+    }
+  return true;
+}
+
 bool RBDS::IsBDSIMOutputFile(TFile* file,
                              int* dataVersion)
 {
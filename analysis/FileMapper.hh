@@ -68,6 +68,26 @@ namespace RBDS
   void WarningMissingHistogram(const std::string& histName,
 			       const std::string& fileName);
 
+  /// Cheap summary of a file to check it is consistent with others before combining
+  /// them. Only the header entry and the model tree metadata are read - not the model
+  /// itself. The model is described by its number of entries and total (uncompressed)
+  /// size. modelEntries is -1 if there's no model tree.
+  struct FileFingerprint
+  {
+    int       dataVersion;
+    long long modelEntries;
+    long long modelBytes;
+  };
+
+  /// Get the fingerprint of an open file.
+  FileFingerprint GetFileFingerprint(TFile* file);
+
+  /// Whether two files are consistent for combining. If not, the reason is written
+  /// to the string passed by reference.
+  bool ConsistentFiles(const FileFingerprint& reference,
+		       const FileFingerprint& other,
+		       std::string&           reason);
+
   /// Basic structure for accumulating histogram from rebdsim output files.
   struct HistogramPath
   {
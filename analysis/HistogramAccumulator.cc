@@ -28,6 +28,8 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include <iostream>
 #include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
 ClassImp(HistogramAccumulator)
 
@@ -305,6 +307,21 @@ TH1* HistogramAccumulator::Terminate()
         auto mnCast   = dynamic_cast<BDSBH4DBase*>(mean);
         auto varCast  = dynamic_cast<BDSBH4DBase*>(variance);
         auto resCast  = dynamic_cast<BDSBH4DBase*>(result);
+        if (mnCast->Sparse())
+          {// only the bins with a non-zero mean or variance - the result is empty otherwise
+            std::vector<std::pair<std::size_t, double> > bins;
+            mnCast->NonZeroBins(bins);
+            varCast->NonZeroBins(bins);
+            for (const auto& bin : bins)
+              {
+                mn  = mnCast->AtIndex(bin.first);
+                var = varCast->AtIndex(bin.first);
+                err = n > 1 ? factor*std::sqrt(var) : 0;
+                resCast->SetAtIndex(bin.first, mn);
+                resCast->SetErrorAtIndex(bin.first, err);
+              }
+            break;
+          }
         int nBinsX = histCast->GetNbinsX();
         int nBinsY = histCast->GetNbinsY();
         int nBinsZ = histCast->GetNbinsZ();
@@ -24,9 +24,12 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "TH3D.h"
 #include "BDSBH4DBase.hh"
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <string>
+#include <utility>
+#include <vector>
 
 ClassImp(HistogramAccumulatorMerge)
 
@@ -146,6 +149,34 @@ void HistogramAccumulatorMerge::Accumulate(TH1* newValue)
 	BDSBH4DBase* h1  = dynamic_cast<BDSBH4DBase*>(mean);
 	BDSBH4DBase* h1e = dynamic_cast<BDSBH4DBase*>(variance);
 	BDSBH4DBase* ht  = dynamic_cast<BDSBH4DBase*>(newValue);
+	if (h1->Sparse())
+	  {
+	    // a bin that is zero in all of these stays zero, so only visit the others
+	    std::vector<std::pair<std::size_t, double> > bins;
+	    h1->NonZeroBins(bins);
+	    h1e->NonZeroBins(bins);
+	    ht->NonZeroBins(bins);
+	    ht->NonZeroErrorBins(bins);
+	    std::vector<std::size_t> indices;
+	    indices.reserve(bins.size());
+	    for (const auto& bin : bins)
+	      {indices.push_back(bin.first);}
+	    std::sort(indices.begin(), indices.end());
+	    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+	    for (std::size_t i : indices)
+	      {
+		var = std::pow(ht->AtErrorIndex(i), 2) * factor;
+		AccumulateSingleValue(h1->AtIndex(i),
+				      h1e->AtIndex(i),
+				      ht->AtIndex(i),
+				      var,
+				      oldEntries, newEntries,
+				      newMean, newVari);
+		h1->SetAtIndex(i, newMean);
+		h1e->SetAtIndex(i, newVari);
+	      }
+	    break;
+	  }
 	for (int j = -1; j <= h1->GetNbinsX(); ++j)
 	  {
 	    for (int k = -1; k <= h1->GetNbinsY(); ++k)
@@ -0,0 +1,218 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "HistogramAccumulatorSparse.hh"
+#include "RBDSException.hh"
+
+#include "TArrayD.h"
+#include "TH1.h"
+#include "BDSBH4DBase.hh"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+ClassImp(HistogramAccumulatorSparse)
+
+HistogramAccumulatorSparse::HistogramAccumulatorSparse():
+  meanValues(nullptr),
+  variValues(nullptr),
+  nBins(0),
+  sparse4D(false)
+{;}
+
+HistogramAccumulatorSparse::HistogramAccumulatorSparse(TH1*               baseHistogram,
+                                                       int                nDimensionsIn,
+                                                       const std::string& resultHistNameIn,
+                                                       const std::string& resultHistTitleIn):
+  HistogramAccumulator(baseHistogram, nDimensionsIn, resultHistNameIn, resultHistTitleIn),
+  meanValues(nullptr),
+  variValues(nullptr),
+  nBins(0),
+  sparse4D(false)
+{
+  if (nDimensions < 4)
+    {
+      // TH1D, TH2D and TH3D all store their contents in a TArrayD including
+      // the under and overflow bins, so we can work on these directly
+      TArrayD* meanArray = dynamic_cast<TArrayD*>(mean);
+      TArrayD* variArray = dynamic_cast<TArrayD*>(variance);
+      if (!meanArray || !variArray)
+        {throw RBDSException("Histogram \"" + resultHistNameIn + "\" does not have double precision bins");}
+      meanValues = meanArray->GetArray();
+      variValues = variArray->GetArray();
+      nBins      = (size_t)meanArray->GetSize();
+      lastUpdate.resize(nBins, 0);
+    }
+  else
+    {
+#ifdef USE_BOOST
+      BDSBH4DBase* h = dynamic_cast<BDSBH4DBase*>(mean);
+      nBins    = h->NBinsTotal();
+      sparse4D = h->Sparse();
+      if (!sparse4D)
+        {
+          mean4D.resize(nBins, 0);
+          vari4D.resize(nBins, 0);
+          lastUpdate.resize(nBins, 0);
+          meanValues = mean4D.data();
+          variValues = vari4D.data();
+        }
+#endif
+    }
+}
+
+void HistogramAccumulatorSparse::CatchUp(double&        mn,
+                                         double&        vr,
+                                         unsigned long& last,
+                                         unsigned long  upTo) const
+{
+  // zero entries leave a zero mean and variance exactly unchanged
+  if (upTo > last && (mn != 0 || vr != 0))
+    {
+      // replay each skipped accumulation with the same arithmetic as the base class
+      // so the result is bit-identical - entries added with AddNEmptyEntries() aren't
+      // accumulated by the base class either so they're not in the runs
+      auto run = std::upper_bound(runs.begin(), runs.end(), last,
+                                  [](unsigned long v, const std::pair<unsigned long, unsigned long>& r)
+                                  {return v < r.second;});
+      double newMean = 0;
+      double newVari = 0;
+      for (; run != runs.end() && run->first <= upTo; ++run)
+        {
+          unsigned long a = std::max(run->first, last + 1);
+          unsigned long b = std::min(run->second, upTo);
+          for (; a <= b; ++a)
+            {
+              HistogramAccumulator::AccumulateSingleValue(mn, vr, 0, 0, a, 1, newMean, newVari);
+              mn = newMean;
+              vr = newVari;
+            }
+        }
+    }
+  last = upTo;
+}
+
+void HistogramAccumulatorSparse::AccumulateBin(double&        mn,
+                                               double&        vr,
+                                               unsigned long& last,
+                                               double         x) const
+{
+  CatchUp(mn, vr, last, n - 1);
+  double newMean = 0;
+  double newVari = 0;
+  HistogramAccumulator::AccumulateSingleValue(mn, vr, x, 0, n, 1, newMean, newVari);
+  mn   = newMean;
+  vr   = newVari;
+  last = n;
+}
+
+void HistogramAccumulatorSparse::Accumulate(TH1* newValue)
+{
+  n++; // must always count even if nothing to add up
+  // consecutive accumulations are stored as one run so this only grows when
+  // AddNEmptyEntries() has been used in between
+  if (runs.empty() || runs.back().second + 1 != n)
+    {runs.emplace_back(n, n);}
+  else
+    {runs.back().second = n;}
+
+  if (nDimensions == 4)
+    {
+      Accumulate4D(newValue);
+      return;
+    }
+
+  TArrayD* newArray = dynamic_cast<TArrayD*>(newValue);
+  if (!newArray)
+    {return;}
+  const double* x = newArray->GetArray();
+  if (!x)
+    {return;}
+
+  for (size_t i = 0; i < nBins; ++i)
+    {
+      if (x[i] == 0)
+        {continue;}
+      AccumulateBin(meanValues[i], variValues[i], lastUpdate[i], x[i]);
+    }
+}
+
+void HistogramAccumulatorSparse::Accumulate4D(TH1* newValue)
+{
+#ifdef USE_BOOST
+  values4D.clear();
+  dynamic_cast<BDSBH4DBase*>(newValue)->NonZeroBins(values4D);
+  if (sparse4D)
+    {
+      for (const auto& bin : values4D)
+        {
+          BinState& state = bins4D[bin.first]; // zero initialised if new
+          AccumulateBin(state.mean, state.vari, state.lastUpdate, bin.second);
+        }
+    }
+  else
+    {
+      for (const auto& bin : values4D)
+        {
+          size_t i = bin.first;
+          AccumulateBin(meanValues[i], variValues[i], lastUpdate[i], bin.second);
+        }
+    }
+#else
+  (void)newValue;
+#endif
+}
+
+TH1* HistogramAccumulatorSparse::Terminate()
+{
+  if (!sparse4D)
+    {
+      for (size_t i = 0; i < lastUpdate.size(); ++i)
+        {CatchUp(meanValues[i], variValues[i], lastUpdate[i], n);}
+    }
+
+#ifdef USE_BOOST
+  if (nDimensions == 4)
+    {
+      BDSBH4DBase* h1  = dynamic_cast<BDSBH4DBase*>(mean);
+      BDSBH4DBase* h1e = dynamic_cast<BDSBH4DBase*>(variance);
+      if (sparse4D)
+        {
+          for (auto& bin : bins4D)
+            {
+              BinState& state = bin.second;
+              CatchUp(state.mean, state.vari, state.lastUpdate, n);
+              h1->SetAtIndex(bin.first,  state.mean);
+              h1e->SetAtIndex(bin.first, state.vari);
+            }
+        }
+      else
+        {
+          for (size_t i = 0; i < nBins; ++i)
+            {
+              h1->SetAtIndex(i,  mean4D[i]);
+              h1e->SetAtIndex(i, vari4D[i]);
+            }
+        }
+    }
+#endif
+
+  return HistogramAccumulator::Terminate();
+}
@@ -0,0 +1,113 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef HISTOGRAMACCUMULATORSPARSE_H
+#define HISTOGRAMACCUMULATORSPARSE_H
+
+#include "HistogramAccumulator.hh"
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Rtypes.h" // for classdef
+
+class TH1;
+
+/**
+ * @brief Accumulate the per-entry mean and variance only visiting non-zero bins.
+ *
+ * For large histograms filled once per event, most bins of each event's histogram
+ * are typically zero. This class iterates over the raw bin array of the new value
+ * and only updates the bins that are non-zero. For each bin, the number of entries
+ * at which it was last brought up to date is stored. When a bin is next updated (or
+ * at Terminate()), the zero-valued entries that were skipped are replayed one by one
+ * with the same arithmetic as the base class, so the result is bit-identical to
+ * HistogramAccumulator. A bin with zero mean and variance is unchanged by a zero entry,
+ * so bins that have never been filled cost nothing. The entry numbers that were
+ * accumulated are stored as runs of consecutive entries, so this only grows when
+ * AddNEmptyEntries() is used in between, and these entries are skipped in the replay
+ * as they are by the base class.
+ *
+ * For 1, 2 and 3D histograms, the raw bin arrays of the mean and variance histograms
+ * are used directly. For 4D histograms, only the non-zero bins of each new value are
+ * visited by their storage index. If the 4D histogram uses dense storage, flat arrays
+ * are used, but if it uses sparse storage, a map of only the bins that have been filled
+ * is used so the memory is proportional to the number of filled bins rather than the
+ * total number of bins. These are copied to the mean and variance histograms at
+ * Terminate(). The additional members are transient.
+ *
+ * @author Laurie Nevay
+ */
+
+class HistogramAccumulatorSparse: public HistogramAccumulator
+{
+public:
+  /// Default constructor only for ROOT reflexivity - not intended for use.
+  HistogramAccumulatorSparse();
+
+  /// Constructor passes down to base class then prepares the flat arrays.
+  HistogramAccumulatorSparse(TH1*               baseHistogram,
+			     int                nDimensionsIn,
+			     const std::string& resultHistName,
+			     const std::string& resultHistTitle);
+  virtual ~HistogramAccumulatorSparse(){;}
+
+  /// Accumulate only the non-zero bins of newValue.
+  virtual void Accumulate(TH1* newValue);
+
+  /// Bring all bins up to date with the zero entries then calculate the result
+  /// as per the base class.
+  virtual TH1* Terminate();
+
+private:
+  /// Mean, variance and number of entries last updated at for one bin.
+  struct BinState
+  {
+    double        mean;
+    double        vari;
+    unsigned long lastUpdate;
+  };
+
+  /// Accumulate the non-zero bins of a 4D histogram.
+  void Accumulate4D(TH1* newValue);
+
+  /// Bring a bin up to date with the skipped zero entries then accumulate a
+  /// non-zero value x as entry number n.
+  void AccumulateBin(double& mn, double& vr, unsigned long& last, double x) const;
+
+  /// Replay the zero-valued entries for a bin since it was last updated at entry
+  /// number last so that it is up to date with upTo entries.
+  void CatchUp(double& mn, double& vr, unsigned long& last, unsigned long upTo) const;
+
+  double*                    meanValues; //!< Raw mean per bin - not owned.
+  double*                    variValues; //!< Raw variance per bin - not owned.
+  size_t                     nBins;      //!< Total number of bins including under / overflow.
+  std::vector<unsigned long> lastUpdate; //!< Number of entries bin was last updated at.
+  bool                       sparse4D;   //!< Whether the 4D histogram uses sparse storage.
+  std::vector<double>        mean4D;     //!< Flat mean storage for dense 4D.
+  std::vector<double>        vari4D;     //!< Flat variance storage for dense 4D.
+  std::unordered_map<size_t, BinState> bins4D; //!< State of filled bins only for sparse 4D.
+  std::vector<std::pair<size_t, double> > values4D; //!< Non-zero bins of each new 4D value.
+  std::vector<std::pair<unsigned long, unsigned long> > runs; //!< First and last entry of each run of accumulations.
+
+  ClassDef(HistogramAccumulatorSparse,1);
+};
+
+#endif
@@ -16,7 +16,7 @@ GNU General Public License for more details.
 You should have received a copy of the GNU General Public License
 along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 */
-#include "HistogramAccumulator.hh"
+#include "HistogramAccumulatorSparse.hh"
 #include "HistogramMeanFromFile.hh"
 
 #include "BDSOutputROOTEventHistograms.hh"
@@ -44,28 +44,28 @@ HistogramMeanFromFile::HistogramMeanFromFile(BDSOutputROOTEventHistograms* h)
     {
       std::string name  = std::string(hist->GetName());
       std::string title = std::string(hist->GetTitle());
-      histograms1d.push_back(new HistogramAccumulator(hist, 1, name, title));
+      histograms1d.push_back(new HistogramAccumulatorSparse(hist, 1, name, title));
     }
 
   for (auto hist : h->Get2DHistograms())
     {
       std::string name  = std::string(hist->GetName());
       std::string title = std::string(hist->GetTitle());
-      histograms2d.push_back(new HistogramAccumulator(hist, 2, name, title));
+      histograms2d.push_back(new HistogramAccumulatorSparse(hist, 2, name, title));
     }
 
   for (auto hist : h->Get3DHistograms())
     {
       std::string name  = std::string(hist->GetName());
       std::string title = std::string(hist->GetTitle());
-      histograms3d.push_back(new HistogramAccumulator(hist, 3, name, title));
+      histograms3d.push_back(new HistogramAccumulatorSparse(hist, 3, name, title));
     }
 
   for (auto hist : h->Get4DHistograms())
     {
       std::string name  = hist->GetName();
       std::string title = hist->GetTitle();
-      histograms4d.push_back(new HistogramAccumulator(hist, 4, name, title));
+      histograms4d.push_back(new HistogramAccumulatorSparse(hist, 4, name, title));
     }
 
   Accumulate(h);
@@ -16,7 +16,7 @@ GNU General Public License for more details.
 You should have received a copy of the GNU General Public License
 along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 */
-#include "HistogramAccumulator.hh"
+#include "HistogramAccumulatorSparse.hh"
 #include "HistogramDef.hh"
 #include "HistogramDef1D.hh"
 #include "HistogramDef2D.hh"
@@ -104,7 +104,7 @@ PerEntryHistogram::PerEntryHistogram(const HistogramDef* definition,
       temp->SetTitle(tempName.c_str());
     }
   
-  accumulator = new HistogramAccumulator(baseHist, nDimensions, histName, histName);
+  accumulator = new HistogramAccumulatorSparse(baseHist, nDimensions, histName, histName);
 }
 
 PerEntryHistogram::~PerEntryHistogram()
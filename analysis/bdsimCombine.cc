@@ -26,25 +26,148 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "TChain.h"
 #include "TFile.h"
+#include "TFriendElement.h"
+#include "TList.h"
+#include "TROOT.h"
 #include "TTree.h"
 
+#include <algorithm>
+#include <cstdio>
 #include <exception>
+#include <fstream>
+#include <functional>
 #include <glob.h>
 #include <iostream>
+#include <set>
 #include <string>
+#include <thread>
 #include <vector>
 
+namespace
+{
+  /// Information from the header of each input file.
+  struct InputFileInfo
+  {
+    bool                   valid                = false;
+    int                    compressionSettings  = -1;
+    RBDS::FileFingerprint  fingerprint          = {0, -1, 0};
+    unsigned long long int nOriginalEvents      = 0;
+    unsigned long long int nEventsRequested     = 0;
+    unsigned long long int nEventsInFile        = 0;
+    unsigned long long int nEventsInFileSkipped = 0;
+    unsigned int           distrFileLoopNTimes  = 0;
+    bool                   skimmedFile          = false;
+    unsigned long long int nEventsResumed       = 0;
+    unsigned long long int nEvents              = 0;
+  };
+
+  /// Load the header of each file with index start, start + stride, ... This only reads
+  /// the header and tree metadata so many files can be inspected quickly in parallel.
+  void InspectFiles(const std::vector<std::string>& inputFiles,
+		    std::vector<InputFileInfo>*     infos,
+		    int                             start,
+		    int                             stride)
+  {
+    for (int j = start; j < (int)inputFiles.size(); j += stride)
+      {
+	InputFileInfo& info = (*infos)[j];
+	TFile* f = new TFile(inputFiles[j].c_str(), "READ");
+	if (!RBDS::IsBDSIMOutputFile(f))
+	  {
+	    if (!f->IsZombie())
+	      {f->Close();}
+	    delete f;
+	    continue;
+	  }
+	TTree* headerTree = dynamic_cast<TTree*>(f->Get("Header")); // should be safe given check we've just done
+	if (!headerTree)
+	  {
+	    f->Close();
+	    delete f;
+	    continue;
+	  }
+	
+	Header* headerLocal = new Header();
+	headerLocal->SetBranchAddress(headerTree);
+	Long64_t nEntriesHeader = headerTree->GetEntries();
+	headerTree->GetEntry(nEntriesHeader - 1); // get the last entry (2nd is more up to date if it exists)
+	// We also want to explicitly copy the skim variables that might only be known in the 2nd instance.
+	BDSOutputROOTEventHeader* h = headerLocal->header;
+	info.distrFileLoopNTimes  = h->distrFileLoopNTimes;
+	info.nOriginalEvents      = h->nOriginalEvents;
+	info.nEventsRequested     = h->nEventsRequested;
+	info.nEventsInFile        = h->nEventsInFile;
+	info.nEventsInFileSkipped = h->nEventsInFileSkipped;
+	info.skimmedFile          = h->skimmedFile;
+	info.nEventsResumed       = h->nEventsResumed;
+	delete headerLocal;
+
+	TTree* eventTree = dynamic_cast<TTree*>(f->Get("Event"));
+	if (eventTree)
+	  {info.nEvents = (unsigned long long int)eventTree->GetEntries();}
+	info.fingerprint         = RBDS::GetFileFingerprint(f);
+	info.compressionSettings = f->GetCompressionSettings();
+	info.valid = true;
+	f->Close();
+	delete f;
+      }
+  }
+
+  /// Read the list of files already combined into an existing bdsimCombine output.
+  std::vector<std::string> CombinedFiles(const std::string& fileName)
+  {
+    std::vector<std::string> result;
+    TFile* f = new TFile(fileName.c_str(), "READ");
+    TTree* ht = f->IsZombie() ? nullptr : dynamic_cast<TTree*>(f->Get("Header"));
+    if (ht)
+      {
+	Header* h = new Header();
+	h->SetBranchAddress(ht);
+	ht->GetEntry(ht->GetEntries() - 1);
+	result = h->header->combinedFiles;
+	delete h;
+      }
+    f->Close();
+    delete f;
+    return result;
+  }
+}
+
 int main(int argc, char* argv[])
 {
-  if (argc < 3)
+  // optional arguments first
+  int  nThreads    = 1;
+  bool incremental = false;
+  int  firstArg    = 1;
+  while (firstArg < argc && argv[firstArg][0] == '-')
+    {
+      std::string arg = std::string(argv[firstArg]);
+      if ((arg == "-j" || arg == "--threads") && firstArg + 1 < argc)
+	{
+	  nThreads = std::max(1, std::stoi(argv[firstArg + 1]));
+	  firstArg += 2;
+	}
+      else if (arg == "-i" || arg == "--incremental")
+	{
+	  incremental = true;
+	  firstArg++;
+	}
+      else
+	{
+	  std::cerr << "Unknown option \"" << arg << "\"" << std::endl;
+	  exit(1);
+	}
+    }
+  
+  if (argc - firstArg < 2)
     {
-      std::cout << "usage: bdsimCombine result.root file1.root file2.root ..." << std::endl;
+      std::cout << "usage: bdsimCombine [-j nThreads] [--incremental] result.root file1.root file2.root ..." << std::endl;
       exit(1);
     }
 
   // build input file list
   std::vector<std::string> inputFiles;
-  for (int i = 2; i < argc; ++i)
+  for (int i = firstArg + 1; i < argc; ++i)
     {inputFiles.emplace_back(std::string(argv[i]));}
   // see if we're globbing files
   if (inputFiles[0].find('*') != std::string::npos)
@@ -58,14 +181,8 @@ int main(int argc, char* argv[])
       inputFiles = fileNamesTemp;
     }
 
-  // checks
-  if (inputFiles.size() == 1)
-    {
-      std::cout << "Only one input file provided \"" << inputFiles[0] << "\" - no point." << std::endl;
-      exit(1);
-    }
   // check for wrong order of arguments which is common mistake
-  std::string outputFile = std::string(argv[1]);
+  std::string outputFile = std::string(argv[firstArg]);
   if (outputFile.find('*') != std::string::npos)
     {
       std::cerr << "First argument for output file \"" << outputFile << "\" contains an *." << std::endl;
@@ -73,21 +190,61 @@ int main(int argc, char* argv[])
       exit(1);
     }
 
-  // merge event trees - this is done by ROOT and it writes the output file and closes it
-  TChain* eventsMerged = new TChain("Event");
-  for (const auto& filename : inputFiles)
-    {eventsMerged->Add(filename.c_str());}
-  std::cout << "Beginning merge of Event Tree" << std::endl;
-  Long64_t operationCode = eventsMerged->Merge(outputFile.c_str());
-  if (operationCode == 0)
-    {// from inspection of ROOT TChain.cxx ~line 1866, it returns 0 if there's a problem
-      std::cerr << "Problem in TTree::Merge opening output file \"" << outputFile << "\"" << std::endl;
-      return 1;
+  // for incremental combination the existing output is used as the first input
+  // and only files not already combined into it are added
+  std::vector<std::string> alreadyCombinedFiles;
+  std::string outputFileWrite = outputFile;
+  bool existingOutput = incremental && std::ifstream(outputFile).good();
+  if (existingOutput)
+    {
+      alreadyCombinedFiles = CombinedFiles(outputFile);
+      if (alreadyCombinedFiles.empty())
+	{
+	  std::cerr << "\"" << outputFile << "\" is not the output of bdsimCombine - can't add to it" << std::endl;
+	  exit(1);
+	}
+      std::set<std::string> alreadyCombined = {alreadyCombinedFiles.begin(), alreadyCombinedFiles.end()};
+      std::vector<std::string> newFiles;
+      for (const auto& file : inputFiles)
+	{
+	  if (alreadyCombined.count(file) == 0)
+	    {newFiles.push_back(file);}
+	}
+      if (newFiles.empty())
+	{
+	  std::cout << "No new files to combine into \"" << outputFile << "\"" << std::endl;
+	  return 0;
+	}
+      std::cout << newFiles.size() << " new files to combine into existing \"" << outputFile << "\"" << std::endl;
+      inputFiles = newFiles;
+      inputFiles.insert(inputFiles.begin(), outputFile);
+      // write to a temporary file as we're reading the existing one
+      outputFileWrite = outputFile + ".tmp";
+    }
+  else if (inputFiles.size() == 1)
+    {
+      std::cout << "Only one input file provided \"" << inputFiles[0] << "\" - no point." << std::endl;
+      exit(1);
+    }
+
+  // Inspect the headers of all files first (in parallel) so only valid and consistent
+  // files are merged and so the number of original events can be accumulated.
+  std::cout << "Counting number of original events from headers of files" << std::endl;
+  nThreads = std::min(nThreads, (int)inputFiles.size());
+  std::vector<InputFileInfo> infos(inputFiles.size());
+  if (nThreads > 1)
+    {
+      ROOT::EnableThreadSafety();
+      std::vector<std::thread> threads;
+      for (int t = 0; t < nThreads; t++)
+	{threads.emplace_back(InspectFiles, std::cref(inputFiles), &infos, t, nThreads);}
+      for (auto& thread : threads)
+	{thread.join();}
     }
   else
-    {std::cout << "Finished merge of Event Tree" << std::endl;}
-  
-  // loop over input files loading headers to accumulate number of original events and
+    {InspectFiles(inputFiles, &infos, 0, 1);}
+
+  // loop over input files accumulating number of original events and
   // the number of input events from an optional distribution file
   unsigned long long int nOriginalEvents = 0;
   unsigned long long int nEventsRequested = 0;
@@ -95,81 +252,101 @@ int main(int argc, char* argv[])
   unsigned long long int nEventsInFileSkipped = 0;
   unsigned int distrFileLoopNTimes = 0;
   bool skimmedFile = false;
-  unsigned long int i = 0;
-  std::cout << "Counting number of original events from headers of files" << std::endl;
+  std::vector<std::string> validFiles;
   std::vector<unsigned long long int> nEventsPerTree;
-  for (const auto& filename : inputFiles)
+  std::vector<const InputFileInfo*> validInfos;
+  const InputFileInfo* reference = nullptr;
+  for (int j = 0; j < (int)inputFiles.size(); j++)
     {
-      TFile* f = new TFile(filename.c_str(), "READ");
-      if (!RBDS::IsBDSIMOutputFile(f))
-        {
-          std::cout << "File \"" << filename << "\" skipped as not a valid BDSIM file" << std::endl;
-          if (!f->IsZombie())
-            {f->Close();}
-          delete f;
-          continue;
-        }
+      const std::string& filename = inputFiles[j];
+      const InputFileInfo& info = infos[j];
+      if (!info.valid)
+	{
+	  std::cout << "File \"" << filename << "\" skipped as not a valid BDSIM file" << std::endl;
+	  continue;
+	}
+      if (!reference) // take only from the first file and assume the same for all
+	{
+	  reference = &info;
+	  distrFileLoopNTimes = info.distrFileLoopNTimes;
+	}
+      std::string reason;
+      if (!RBDS::ConsistentFiles(reference->fingerprint, info.fingerprint, reason))
+	{
+	  std::cout << "File \"" << filename << "\" skipped as inconsistent with the first file: " << reason << std::endl;
+	  continue;
+	}
       std::cout << "Accumulating> " << filename << std::endl;
-      TTree* headerTree = dynamic_cast<TTree*>(f->Get("Header")); // should be safe given check we've just done
-      if (!headerTree)
-        {
-          std::cerr << "Problem getting header from file " << filename << std::endl;
-          f->Close();
-          delete f;
-          continue;
-        }
+      nOriginalEvents += info.nOriginalEvents;
+      nEventsRequested += info.nEventsRequested;
+      nEventsInFile += info.nEventsInFile;
+      nEventsInFileSkipped += info.nEventsInFileSkipped;
+      skimmedFile = skimmedFile || info.skimmedFile;
+      nEventsPerTree.push_back(info.nEvents);
+      validFiles.push_back(filename);
+      validInfos.push_back(&info);
+    }
 
-      Header* headerLocal = new Header();
-      headerLocal->SetBranchAddress(headerTree);
-      Long64_t nEntriesHeader = headerTree->GetEntries();
-      headerTree->GetEntry(nEntriesHeader - 1); // get the last entry (2nd is more up to date if it exists)
-      // We also want to explicitly copy the skim variables that might only be known in the 2nd instance.
-      BDSOutputROOTEventHeader* h = headerLocal->header;
-      if (i == 0) // take only from the first file and assume the same for all
-        {distrFileLoopNTimes = h->distrFileLoopNTimes;}
-
-      nOriginalEvents += h->nOriginalEvents;
-      nEventsRequested += h->nEventsRequested;
-      nEventsInFile += h->nEventsInFile;
-      nEventsInFileSkipped += h->nEventsInFileSkipped;
-      skimmedFile = skimmedFile || h->skimmedFile;
-
-      unsigned long long int nEventsThisFile = 0;
-      TTree* eventTree = dynamic_cast<TTree*>(f->Get("Event"));
-      if (eventTree)
-        {nEventsThisFile = (unsigned long long int)eventTree->GetEntries();}
-      nEventsPerTree.push_back(nEventsThisFile);
-
-      delete headerLocal;
-      f->Close();
-      delete f;
-      i++;
+  // A run resumed from a checkpoint continues the file(s) before it in the list. Check the
+  // events before each resumed file match the number at the checkpoint it resumed from.
+  unsigned long long int nEventsInChain = 0;
+  for (int i = 0; i < (int)validFiles.size(); i++)
+    {
+      const InputFileInfo* info = validInfos[i];
+      if (info->nEventsResumed > 0)
+	{
+	  if (nEventsInChain != info->nEventsResumed)
+	    {
+	      std::cout << "Warning: file \"" << validFiles[i] << "\" resumes a run after " << info->nEventsResumed
+			<< " events but the files before it contain " << nEventsInChain << " events" << std::endl;
+	    }
+	  nEventsInChain += info->nEvents;
+	}
+      else
+	{nEventsInChain = info->nEvents;}
     }
 
   // checks
-  if (i == 0)
+  if (validFiles.empty())
     {std::cerr << "No valid files found" << std::endl; return 1;}
+  if (existingOutput && validFiles[0] != outputFile)
+    {std::cerr << "Existing output \"" << outputFile << "\" is not a valid BDSIM file" << std::endl; return 1;}
+
+  // the existing output is listed by the files combined into it
+  std::vector<std::string> combinedFiles = validFiles;
+  if (existingOutput)
+    {
+      combinedFiles = alreadyCombinedFiles;
+      combinedFiles.insert(combinedFiles.end(), validFiles.begin() + 1, validFiles.end());
+    }
+
+  // Merge event trees. We use the compression of the input files for the output so that
+  // the "fast" merge can copy the compressed baskets directly without decompressing and
+  // recompressing them. ROOT falls back to a normal copy if this isn't possible.
+  TFile* output = new TFile(outputFileWrite.c_str(), "RECREATE");
+  if (output->IsZombie())
+    {std::cerr << "Could not open output file \"" << outputFileWrite << "\"" << std::endl; return 1;}
+  output->SetCompressionSettings(reference->compressionSettings);
+  TChain* eventsMerged = new TChain("Event");
+  for (const auto& filename : validFiles)
+    {eventsMerged->Add(filename.c_str());}
+  std::cout << "Beginning merge of Event Tree" << std::endl;
+  Long64_t operationCode = eventsMerged->Merge(output, 0, "fast keep");
+  if (operationCode == 0)
+    {// from inspection of ROOT TChain.cxx ~line 1866, it returns 0 if there's a problem
+      std::cerr << "Problem in TTree::Merge writing output file \"" << outputFile << "\"" << std::endl;
+      return 1;
+    }
+  else
+    {std::cout << "Finished merge of Event Tree" << std::endl;}
   
   // now we produce a new header and update the file as well as copy over the other trees from the first valid
   // input file in the list (i.e. tolerate the odd zombie file from a big run)
-  TFile* input = nullptr;
-  bool validFile = false;
-  i = 0;
-  while (!validFile)
-    {// assume we have one valid file from check above
-      if (i > (unsigned long int)inputFiles.size())
-        {return 1;}
-      input = new TFile(inputFiles[i].c_str(), "READ");
-      validFile = RBDS::IsBDSIMOutputFile(input);
-      i++;
-    }
+  TFile* input = new TFile(validFiles[0].c_str(), "READ");
   
-  TFile* output = new TFile(outputFile.c_str(), "UPDATE");
-  if (output->IsZombie())
-    {std::cerr << "Could not reopen output file to add other trees"; return 1;}
   output->cd();
   BDSOutputROOTEventHeader* headerOut = new BDSOutputROOTEventHeader();
-  headerOut->Fill(std::vector<std::string>(), inputFiles); // updates time stamp
+  headerOut->Fill(std::vector<std::string>(), combinedFiles); // updates time stamp
   headerOut->SetFileType("BDSIM");
   headerOut->skimmedFile = skimmedFile;
   headerOut->nOriginalEvents = nOriginalEvents;
@@ -181,46 +358,120 @@ int main(int argc, char* argv[])
   headerTree->Branch("Header.", "BDSOutputROOTEventHeader", headerOut);
   headerTree->Fill();
 
+  // The run histograms of a resumed run include those up to the checkpoint and the interrupted
+  // file has none, so the run tree is taken from the last file of the first resumed sequence.
+  int runFileIndex = 0;
+  while (runFileIndex + 1 < (int)validFiles.size() && validInfos[runFileIndex + 1]->nEventsResumed > 0)
+    {runFileIndex++;}
+  TFile* runInput = runFileIndex > 0 ? new TFile(validFiles[runFileIndex].c_str(), "READ") : input;
+  
   // go over all other trees and copy them (in the original order) from the first file to the output
   std::cout << "Merging rest of file contents" << std::endl;
   std::vector<std::string> treeNames = {"ParticleData", "Beam", "Options", "Model", "Run"};
   for (const auto& tn : treeNames)
     {
-      TTree* original = dynamic_cast<TTree*>(input->Get(tn.c_str()));
+      TFile* source = tn == "Run" ? runInput : input;
+      TTree* original = dynamic_cast<TTree*>(source->Get(tn.c_str()));
       if (!original)
         {
           std::cerr << "Failed to load Tree named " << tn << std::endl;
           delete output;
+          if (runInput != input)
+            {delete runInput;}
           delete input;
           return 1;
         }
+      output->cd();
       original->CloneTree();
     }
 
+  output->cd();
   TTree* eventCombineInfoTree = new TTree("EventCombineInfo", "EventCombineInfo");
   UInt_t originalID = 0;
   eventCombineInfoTree->Branch("combinedFileIndex", &originalID);
-  for (int fileIndex = 0; fileIndex < (int)nEventsPerTree.size(); fileIndex++)
+  int firstNewFile = 0;
+  UInt_t indexOffset = 0;
+  if (existingOutput)
+    {// keep the index of the events already combined and number the new files after them
+      TTree* existingInfo = dynamic_cast<TTree*>(input->Get("EventCombineInfo"));
+      if (!existingInfo || (unsigned long long int)existingInfo->GetEntries() != nEventsPerTree[0])
+	{
+	  std::cerr << "EventCombineInfo in \"" << outputFile << "\" missing or inconsistent with its Event tree" << std::endl;
+	  delete output;
+	  if (runInput != input)
+	    {delete runInput;}
+	  delete input;
+	  std::remove(outputFileWrite.c_str());
+	  return 1;
+	}
+      UInt_t existingID = 0;
+      existingInfo->SetBranchAddress("combinedFileIndex", &existingID);
+      for (Long64_t j = 0; j < existingInfo->GetEntries(); j++)
+	{
+	  existingInfo->GetEntry(j);
+	  originalID = existingID;
+	  eventCombineInfoTree->Fill();
+	}
+      existingInfo->ResetBranchAddresses();
+      firstNewFile = 1;
+      indexOffset  = (UInt_t)alreadyCombinedFiles.size();
+    }
+  for (int fileIndex = firstNewFile; fileIndex < (int)nEventsPerTree.size(); fileIndex++)
     {
       unsigned long long int v = nEventsPerTree[fileIndex];
       for (unsigned long long int j = 0; j < v; j++)
         {
-          originalID = (UInt_t)fileIndex;
+          originalID = (UInt_t)(fileIndex - firstNewFile) + indexOffset;
           eventCombineInfoTree->Fill();
         }
     }
 
   TTree* eventTree = dynamic_cast<TTree*>(output->Get("Event"));
   if (eventTree)
-    {eventTree->AddFriend(eventCombineInfoTree);}
+    {
+      // an existing output's Event tree may bring its old friend with it
+      TList* friends = eventTree->GetListOfFriends();
+      if (friends)
+	{
+	  std::vector<TFriendElement*> oldFriends;
+	  for (auto obj : *friends)
+	    {
+	      auto fe = dynamic_cast<TFriendElement*>(obj);
+	      if (fe && std::string(fe->GetTreeName()) == "EventCombineInfo")
+		{oldFriends.push_back(fe);}
+	    }
+	  for (auto fe : oldFriends)
+	    {
+	      friends->Remove(fe);
+	      delete fe;
+	    }
+	}
+      eventTree->AddFriend(eventCombineInfoTree);
+    }
 
   // write only once!!
   output->Write(nullptr, TObject::kOverwrite);
   
   output->Close();
   delete output;
+  if (runInput != input)
+    {
+      runInput->Close();
+      delete runInput;
+    }
+  input->Close();
+  delete input;
+
+  if (outputFileWrite != outputFile)
+    {
+      if (std::rename(outputFileWrite.c_str(), outputFile.c_str()) != 0)
+	{
+	  std::cerr << "Unable to replace \"" << outputFile << "\" with \"" << outputFileWrite << "\"" << std::endl;
+	  return 1;
+	}
+    }
   
-  std::cout << "Combined result of " << inputFiles.size() << " files written to: " << outputFile << std::endl;
-  std::cout << "Run histograms are not summed" << std::endl; // TODO
+  std::cout << "Combined result of " << combinedFiles.size() << " files written to: " << outputFile << std::endl;
+  std::cout << "Run histograms are not summed - taken from \"" << validFiles[runFileIndex] << "\"" << std::endl; // TODO
   return 0;
 }
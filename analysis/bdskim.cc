@@ -20,6 +20,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
  * @file bdskim.cc
  */
 #include "AnalysisUtilities.hh"
+#include "CompiledSelection.hh"
 #include "FileMapper.hh"
 #include "Header.hh"
 #include "SelectionLoader.hh"
@@ -29,6 +30,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "TFile.h"
 #include "TTree.h"
 
+#include <chrono>
 #include <iostream>
 #include <stdexcept>
 #include <string>
@@ -113,7 +115,40 @@ int main(int argc, char* argv[])
       delete input;
       return 1;
     }
-  TTree* selectEvents = allEvents->CopyTree(selection.c_str());
+
+  // Compile the selection if possible. This is read with a separate instance of the file
+  // so only the leaves in the selection are read and it doesn't affect the copying.
+  auto start = std::chrono::steady_clock::now();
+  CompiledSelection compiledSelection(selection, allEvents);
+  TTree* selectEvents = nullptr;
+  if (compiledSelection.Compiled())
+    {
+      TFile* selectionInput = new TFile(inputFile.c_str(), "READ");
+      TTree* selectionEvents = dynamic_cast<TTree*>(selectionInput->Get("Event"));
+      output->cd();
+      selectEvents = allEvents->CloneTree(0);
+      {
+        CompiledSelectionReader reader(&compiledSelection, selectionEvents);
+        Long64_t nEntries = allEvents->GetEntries();
+        for (Long64_t i = 0; i < nEntries; i++)
+          {
+            if (reader.Select(i))
+              {
+                allEvents->GetEntry(i);
+                selectEvents->Fill();
+              }
+          }
+      }
+      delete selectionInput;
+    }
+  else
+    {
+      std::cout << "Selection not compiled (" << compiledSelection.Reason() << ") - using TTree::CopyTree" << std::endl;
+      selectEvents = allEvents->CopyTree(selection.c_str());
+    }
+  double duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  std::cout << "Selected " << selectEvents->GetEntries() << " of " << allEvents->GetEntries()
+            << " events in " << duration << " s" << std::endl;
   selectEvents->Write();
 
   output->Write(nullptr,TObject::kOverwrite);
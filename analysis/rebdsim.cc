@@ -25,6 +25,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include <vector>
 
 #include "TChain.h"
+#include "TEnv.h"
 #include "TFile.h"
 #include "TTree.h"
 
@@ -37,6 +38,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "Config.hh"
 #include "DataLoader.hh"
 #include "EventAnalysis.hh"
+#include "EventCache.hh"
 #include "HeaderAnalysis.hh"
 #include "ModelAnalysis.hh"
 #include "OptionsAnalysis.hh"
@@ -84,14 +86,20 @@ int main(int argc, char *argv[])
       
       bool allBranches = config->AllBranchesToBeActivated();
       const RBDS::BranchMap* branchesToActivate = &(config->BranchesToBeActivated());
+      const RBDS::BranchMap* leavesToActivate   = &(config->LeavesToBeActivated());
       
+      // asynchronous reading must be turned on before any files are opened
+      if (config->GetOptionBool("prefetchclusters"))
+        {gEnv->SetValue("TFile.AsyncPrefetching", 1);}
+
       bool debug = config->Debug();
       DataLoader* dl = new DataLoader(config->InputFilePath(),
                                       debug,
                                       config->ProcessSamplers(),
                                       allBranches,
                                       branchesToActivate,
-                                      config->GetOptionBool("backwardscompatible"));
+                                      config->GetOptionBool("backwardscompatible"),
+                                      leavesToActivate);
 
       config->FixCylindricalAndSphericalSamplerVariablesInSets(dl->GetAllCylindricalSamplerNames(),
                                                                dl->GetAllSphericalSamplerNames());
@@ -114,9 +122,39 @@ int main(int argc, char *argv[])
                                                    dl->GetBeamTree(),
                                                    config->PerEntryBeam(),
                                                    debug);
+
+      // optionally use a reduced copy of the leaves used instead of the raw Event tree
+      TChain* eventChain = dl->GetEventTree();
+      TChain* eventCacheChain = nullptr;
+      std::string eventCacheFile = config->GetOptionString("eventcachefile");
+      if (!eventCacheFile.empty())
+        {
+          std::string reason;
+          if (allBranches)
+            {reason = "all branches are activated";}
+          else if (config->ProcessSamplers())
+            {reason = "optics or sampler processing requires whole samplers";}
+          else if (!config->EventHistogramSetDefinitionsSimple().empty() ||
+                   !config->EventHistogramSetDefinitionsPerEntry().empty())
+            {reason = "histogram sets (spectra) require whole samplers";}
+          else if (!config->BranchesWholeToBeActivated("Event.").empty())
+            {reason = "whole branches are required - e.g. MergeHistograms must be false";}
+          else
+            {
+              EventCache eventCache(eventCacheFile, config->GetOptionBool("eventcachefloat"));
+              eventCacheChain = eventCache.Open(filenames, config->LeavesUsed("Event."));
+              if (eventCacheChain)
+                {eventChain = eventCacheChain;}
+              else
+                {reason = eventCache.Reason();}
+            }
+          if (!eventCacheChain)
+            {std::cout << "rebdsim> event cache not used: " << reason << std::endl;}
+        }
+
       EventAnalysis* evtAnalysis;
       evtAnalysis = new EventAnalysis(dl->GetEvent(),
-                                      dl->GetEventTree(),
+                                      eventChain,
                                       config->PerEntryEvent(),
                                       config->ProcessSamplers(),
                                       debug,
@@ -125,6 +163,8 @@ int main(int argc, char *argv[])
                                       config->EmittanceOnTheFly(),
                                       (long int) config->GetOptionNumber("eventstart"),
                                       (long int) config->GetOptionNumber("eventend"));
+      evtAnalysis->SetTreeCache(config->GetOptionNumber("treecachesize"),
+                                config->GetOptionBool("prefetchclusters"));
       
       RunAnalysis* runAnalysis = new RunAnalysis(dl->GetRun(),
                                                  dl->GetRunTree(),
@@ -188,6 +228,7 @@ int main(int argc, char *argv[])
       delete dl;
       for (auto analysis : analyses)
         {delete analysis;}
+      delete eventCacheChain;
     }
   catch (const RBDSException& error)
     {std::cerr << error.what() << std::endl; exit(1);}
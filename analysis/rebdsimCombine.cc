@@ -33,57 +33,226 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "TH2.h"
 #include "TH3.h"
 #include "BDSBH4D.hh"
+#include "TROOT.h"
 #include "TTree.h"
 
+#include <algorithm>
+#include <cstdio>
 #include <exception>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <mutex>
 #include <set>
 #include <string>
+#include <thread>
 #include <vector>
 
+namespace
+{
+  /// Partial combination of a subset of the input files by one thread.
+  struct CombineWorker
+  {
+    std::vector<std::string>           files;
+    std::vector<HistogramAccumulator*> accumulators; ///< One per histogram in the map.
+    unsigned long          nFilesAccumulated    = 0;
+    unsigned long long int nOriginalEvents      = 0;
+    unsigned long long int nEventsInFile        = 0;
+    unsigned long long int nEventsInFileSkipped = 0;
+    unsigned long long int nEventsRequested     = 0;
+    std::string            error;
+  };
+
+  std::mutex printMutex;
+
+  /// Accumulate each file of the worker into its own accumulators.
+  void AccumulateFiles(CombineWorker*                            worker,
+		       const std::vector<RBDS::HistogramPath>&   histograms,
+		       const RBDS::FileFingerprint&              reference)
+  {
+    try
+      {
+	for (const auto& file : worker->files)
+	  {
+	    TFile* f = new TFile(file.c_str(), "READ");
+	    std::string reason;
+	    if (!RBDS::IsREBDSIMOrCombineOutputFile(f))
+	      {
+		std::lock_guard<std::mutex> lock(printMutex);
+		std::cout << "Skipping " << file << " as not a rebdsim output file" << std::endl;
+	      }
+	    else if (!RBDS::ConsistentFiles(reference, RBDS::GetFileFingerprint(f), reason))
+	      {
+		std::lock_guard<std::mutex> lock(printMutex);
+		std::cout << "Skipping " << file << " as inconsistent with the first file: " << reason << std::endl;
+	      }
+	    else
+	      {
+		{
+		  std::lock_guard<std::mutex> lock(printMutex);
+		  std::cout << "Accumulating> " << file << std::endl;
+		}
+		for (int i = 0; i < (int)histograms.size(); i++)
+		  {
+		    const auto& hist = histograms[i];
+		    std::string histPath = hist.path + hist.name; // histPath has trailing '/'
+		    TH1* h = dynamic_cast<TH1*>(f->Get(histPath.c_str()));
+		    if (!h)
+		      {
+			std::lock_guard<std::mutex> lock(printMutex);
+			RBDS::WarningMissingHistogram(histPath, file);
+			continue;
+		      }
+		    worker->accumulators[i]->Accumulate(h);
+		  }
+
+		Header* h = new Header();
+		TTree* ht = (TTree*)f->Get("Header");
+		h->SetBranchAddress(ht);
+		ht->GetEntry(0);
+		worker->nOriginalEvents += h->header->nOriginalEvents;
+		// Here we exploit the fact that the 0th entry of the header tree has no data for these
+		// two variables. There may however, only ever be 1 entry for older data. We add it up anyway.
+		for (int i = 0; i < (int)ht->GetEntries(); i++)
+		  {
+		    ht->GetEntry(i);
+		    worker->nEventsInFile        += h->header->nEventsInFile;
+		    worker->nEventsInFileSkipped += h->header->nEventsInFileSkipped;
+		    worker->nEventsRequested     += h->header->nEventsRequested;
+		  }
+		delete h;
+		worker->nFilesAccumulated++;
+	      }
+	    f->Close();
+	    delete f;
+	  }
+      }
+    catch (const std::exception& e)
+      {worker->error = e.what();}
+  }
+
+  /// Read the list of files already combined into an existing rebdsimCombine output.
+  std::vector<std::string> CombinedFiles(const std::string& fileName)
+  {
+    std::vector<std::string> result;
+    TFile* f = new TFile(fileName.c_str(), "READ");
+    TTree* ht = f->IsZombie() ? nullptr : dynamic_cast<TTree*>(f->Get("Header"));
+    if (ht)
+      {
+	Header* h = new Header();
+	h->SetBranchAddress(ht);
+	ht->GetEntry(0);
+	result = h->header->combinedFiles;
+	delete h;
+      }
+    f->Close();
+    delete f;
+    return result;
+  }
+}
+
 int main(int argc, char* argv[])
 {
-  if (argc < 3)
+  // optional arguments first
+  int  nThreads    = 1;
+  bool incremental = false;
+  int  firstArg    = 1;
+  while (firstArg < argc && argv[firstArg][0] == '-')
+    {
+      std::string arg = std::string(argv[firstArg]);
+      if ((arg == "-j" || arg == "--threads") && firstArg + 1 < argc)
+	{
+	  nThreads = std::max(1, std::stoi(argv[firstArg + 1]));
+	  firstArg += 2;
+	}
+      else if (arg == "-i" || arg == "--incremental")
+	{
+	  incremental = true;
+	  firstArg++;
+	}
+      else
+	{
+	  std::cerr << "Unknown option \"" << arg << "\"" << std::endl;
+	  return 1;
+	}
+    }
+  
+  if (argc - firstArg < 2)
     {
-      std::cout << "usage: rebdsimCombine result.root file1.root file2.root ..." << std::endl;
+      std::cout << "usage: rebdsimCombine [-j nThreads] [--incremental] result.root file1.root file2.root ..." << std::endl;
       return 1;
     }
 
   // build input file list
   std::vector<std::string> inputFiles;
-  for (int i = 2; i < argc; ++i)
+  for (int i = firstArg + 1; i < argc; ++i)
     {inputFiles.emplace_back(std::string(argv[i]));}
 
-  // checks
-  if (inputFiles.size() == 1)
+  std::string outputFile = std::string(argv[firstArg]);
+  if (outputFile.find('*') != std::string::npos)
     {
-      if (inputFiles[0].find('*') != std::string::npos) // glob didn't expand in shell - infer this
-        {std::cout << "Glob with * did not match any files" << std::endl;}
-      else
-        {std::cout << "Only one input file provided \"" << inputFiles[0] << "\" - no point." << std::endl;}
+      std::cerr << "First argument for output file \"" << outputFile << "\" contains an *." << std::endl;
+      std::cerr << "Should only be a singular file - check order of arguments." << std::endl;
       return 1;
     }
+
+  // for incremental combination the existing output is used as the first input
+  // and only files not already combined into it are added
+  std::vector<std::string> combinedFiles;
+  std::string outputFileWrite = outputFile;
+  bool existingOutput = incremental && std::ifstream(outputFile).good();
+  if (existingOutput)
+    {
+      combinedFiles = CombinedFiles(outputFile);
+      std::set<std::string> alreadyCombined = {combinedFiles.begin(), combinedFiles.end()};
+      std::vector<std::string> newFiles;
+      for (const auto& file : inputFiles)
+	{
+	  if (alreadyCombined.count(file) == 0)
+	    {newFiles.push_back(file);}
+	}
+      if (newFiles.empty())
+	{
+	  std::cout << "No new files to combine into \"" << outputFile << "\"" << std::endl;
+	  return 0;
+	}
+      std::cout << newFiles.size() << " new files to combine into existing \"" << outputFile << "\"" << std::endl;
+      combinedFiles.insert(combinedFiles.end(), newFiles.begin(), newFiles.end());
+      inputFiles = newFiles;
+      inputFiles.insert(inputFiles.begin(), outputFile);
+      // write to a temporary file as we're reading the existing one
+      outputFileWrite = outputFile + ".tmp";
+    }
+  else
+    {
+      // checks
+      if (inputFiles.size() == 1)
+	{
+	  if (inputFiles[0].find('*') != std::string::npos) // glob didn't expand in shell - infer this
+	    {std::cout << "Glob with * did not match any files" << std::endl;}
+	  else
+	    {std::cout << "Only one input file provided \"" << inputFiles[0] << "\" - no point." << std::endl;}
+	  return 1;
+	}
+      combinedFiles = inputFiles;
+    }
   
   std::set<std::string> inputFilesSet = {inputFiles.begin(), inputFiles.end()};
   if (inputFiles.size() > inputFilesSet.size())
     {std::cout << "Warning: at least 1 duplicate name in list of files provided to combine." << std::endl;}
 
-  std::string outputFile = std::string(argv[1]);
-  if (outputFile.find('*') != std::string::npos)
-    {
-      std::cerr << "First argument for output file \"" << outputFile << "\" contains an *." << std::endl;
-      std::cerr << "Should only be a singular file - check order of arguments." << std::endl;
-      return 1;
-    }
+  nThreads = std::min(nThreads, (int)inputFiles.size());
+  if (nThreads > 1)
+    {ROOT::EnableThreadSafety();}
   
   // output file must be opened before histograms are created because root does
   // everything statically behind the scenes
-  TFile* output = new TFile(outputFile.c_str(), "RECREATE");
+  TFile* output = new TFile(outputFileWrite.c_str(), "RECREATE");
   
   // add header for file type and version details
   output->cd();
   BDSOutputROOTEventHeader* headerOut = new BDSOutputROOTEventHeader();
-  headerOut->Fill(std::vector<std::string>(), inputFiles); // updates time stamp
+  headerOut->Fill(std::vector<std::string>(), combinedFiles); // updates time stamp
   headerOut->SetFileType("REBDSIMCOMBINE");
   TTree* headerTree = new TTree("Header", "REBDSIM Header");
   headerTree->Branch("Header.", "BDSOutputROOTEventHeader", headerOut);
@@ -107,6 +276,9 @@ int main(int argc, char* argv[])
     {std::cerr << error.what() << std::endl; return 1;}
   catch (const std::exception& error)
     {std::cerr << error.what() << std::endl; return 1;}
+
+  // the first file is the reference all others must be consistent with
+  RBDS::FileFingerprint reference = RBDS::GetFileFingerprint(f);
   
   // copy the model tree over if it exists - expect the name to be ModelTree
   TTree* oldModelTree = dynamic_cast<TTree*>(f->Get("ModelTree"));
@@ -125,50 +297,80 @@ int main(int argc, char* argv[])
 
   std::vector<RBDS::HistogramPath> histograms = histMap->Histograms();
 
+  // Each thread accumulates an interleaved subset of the files into its own accumulators
+  // that aren't attached to the output file. The partial results are then combined in
+  // the accumulators of the output, which is the same as combining the partially combined
+  // files. With one thread, the output accumulators are used directly.
+  std::vector<CombineWorker> workers(nThreads);
+  for (int i = 0; i < (int)inputFiles.size(); i++)
+    {workers[i % nThreads].files.push_back(inputFiles[i]);}
+  if (nThreads == 1)
+    {
+      for (const auto& hist : histograms)
+	{workers[0].accumulators.push_back(hist.accumulator);}
+    }
+  else
+    {
+      TH1::AddDirectory(false);
+      for (int w = 0; w < nThreads; w++)
+	{
+	  for (const auto& hist : histograms)
+	    {
+	      TH1* base = hist.accumulator->Result();
+	      int nDim = hist.BDSBH4Dtype ? 4 : RBDS::DetermineDimensionality(base);
+	      std::string name = hist.name + "_worker" + std::to_string(w);
+	      HistogramAccumulator* acc = nullptr;
+	      if (dynamic_cast<HistogramAccumulatorMerge*>(hist.accumulator))
+		{acc = new HistogramAccumulatorMerge(base, nDim, name, base->GetTitle());}
+	      else
+		{acc = new HistogramAccumulatorSum(base, nDim, name, base->GetTitle());}
+	      workers[w].accumulators.push_back(acc);
+	    }
+	}
+      TH1::AddDirectory(true);
+    }
+  
+  std::cout << "Combination of " << inputFiles.size() << " files beginning";
+  if (nThreads > 1)
+    {std::cout << " with " << nThreads << " threads";}
+  std::cout << std::endl;
+  if (nThreads == 1)
+    {AccumulateFiles(&workers[0], histograms, reference);}
+  else
+    {
+      std::vector<std::thread> threads;
+      for (auto& worker : workers)
+	{threads.emplace_back(AccumulateFiles, &worker, std::cref(histograms), std::cref(reference));}
+      for (auto& thread : threads)
+	{thread.join();}
+    }
+
   unsigned long long int nOriginalEvents = 0;
   unsigned long long int nEventsInFile = 0;
   unsigned long long int nEventsInFileSkipped = 0;
   unsigned long long int nEventsRequested = 0;
-  
-  std::cout << "Combination of " << inputFiles.size() << " files beginning" << std::endl;
-  // loop over files and accumulate
-  for (const auto& file : inputFiles)
+  for (auto& worker : workers)
     {
-      f = new TFile(file.c_str());
-      if (RBDS::IsREBDSIMOrCombineOutputFile(f))
-        {
-          std::cout << "Accumulating> " << file << std::endl;
-          for (const auto& hist : histograms)
-            {
-              std::string histPath = hist.path + hist.name; // histPath has trailing '/'
-
-              TH1* h = dynamic_cast<TH1*>(f->Get(histPath.c_str()));
-
-              if (!h)
-                {RBDS::WarningMissingHistogram(histPath, file); continue;}
-              hist.accumulator->Accumulate(h);
-            }
-          
-          Header* h = new Header();
-          TTree* ht = (TTree*)f->Get("Header");
-          h->SetBranchAddress(ht);
-          ht->GetEntry(0);
-          nOriginalEvents += h->header->nOriginalEvents;
-          // Here we exploit the fact that the 0th entry of the header tree has no data for these
-          // two variables. There may however, only ever be 1 entry for older data. We add it up anyway.
-          for (int i = 0; i < (int)ht->GetEntries(); i++)
-            {
-              ht->GetEntry(i);
-              nEventsInFile += h->header->nEventsInFile;
-              nEventsInFileSkipped += h->header->nEventsInFileSkipped;
-              nEventsRequested += h->header->nEventsRequested;
-            }
-          delete h;
-        }
-      else
-        {std::cout << "Skipping " << file << " as not a rebdsim output file" << std::endl;}
-      f->Close();
-      delete f;
+      if (!worker.error.empty())
+	{std::cerr << worker.error << std::endl; return 1;}
+      nOriginalEvents      += worker.nOriginalEvents;
+      nEventsInFile        += worker.nEventsInFile;
+      nEventsInFileSkipped += worker.nEventsInFileSkipped;
+      nEventsRequested     += worker.nEventsRequested;
+      if (nThreads == 1)
+	{continue;}
+      // reduce the partial results into the output accumulators
+      for (int i = 0; i < (int)histograms.size(); i++)
+	{
+	  HistogramAccumulator* acc = worker.accumulators[i];
+	  if (worker.nFilesAccumulated > 0)
+	    {
+	      TH1* partial = acc->Terminate();
+	      histograms[i].accumulator->Accumulate(partial);
+	    }
+	  delete acc->Result(); // not attached to a file so we must delete it
+	  delete acc;
+	}
     }
   
   // terminate and write output
@@ -189,6 +391,15 @@ int main(int argc, char* argv[])
   output->Write(nullptr,TObject::kOverwrite);
   output->Close();
   delete output;
+
+  if (outputFileWrite != outputFile)
+    {
+      if (std::rename(outputFileWrite.c_str(), outputFile.c_str()) != 0)
+	{
+	  std::cerr << "Unable to replace \"" << outputFile << "\" with \"" << outputFileWrite << "\"" << std::endl;
+	  return 1;
+	}
+    }
   std::cout << "Combined result of " << inputFiles.size() << " files written to: " << outputFile << std::endl;
   
   return 0;
@@ -67,6 +67,7 @@ int main(int argc, char *argv[])
       
       bool allBranches = config->AllBranchesToBeActivated();
       const RBDS::BranchMap* branchesToActivate = &(config->BranchesToBeActivated());
+      const RBDS::BranchMap* leavesToActivate   = &(config->LeavesToBeActivated());
       
       bool debug = config->Debug();
       DataLoader* dl = new DataLoader(config->InputFilePath(),
@@ -74,7 +75,8 @@ int main(int argc, char *argv[])
                                       config->ProcessSamplers(),
                                       allBranches,
                                       branchesToActivate,
-                                      config->GetOptionBool("backwardscompatible"));
+                                      config->GetOptionBool("backwardscompatible"),
+                                      leavesToActivate);
       
       BeamAnalysis* beaAnalysis = new BeamAnalysis(dl->GetBeam(),
                                                    dl->GetBeamTree(),
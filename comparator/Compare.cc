@@ -20,6 +20,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "Result.hh"
 #include "ResultEvent.hh"
 #include "ResultEventTree.hh"
+#include "ResultEventTreeColumns.hh"
 #include "ResultHistogram.hh"
 #include "ResultHistogram2D.hh"
 #include "ResultSampler.hh"
@@ -35,32 +36,46 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "BDSVersionData.hh"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include "TBranch.h"
 #include "TChain.h"
 #include "TDirectory.h"
+#include "TError.h"
 #include "TFile.h"
 #include "TH1.h"
+#include "TLeaf.h"
 #include "TObjArray.h"
+#include "TROOT.h"
 #include "TTree.h"
+#include "TTreeFormula.h"
 
-std::vector<Result*> Compare::Files(TFile* f1, TFile* f2)
+std::vector<Result*> Compare::Files(TFile* f1, TFile* f2, bool skipEventTree)
 {
   std::vector<Result*> results; 
   // A TFile inherits TDirectory, so we simply use the TDirectory function.
-  Compare::Directories((TDirectory*)f1, (TDirectory*)f2, results);
+  Compare::Directories((TDirectory*)f1, (TDirectory*)f2, results, skipEventTree);
   return results;
 }
 
 void Compare::Directories(TDirectory* d1,
 			  TDirectory* d2,
-			  std::vector<Result*>& results)
+			  std::vector<Result*>& results,
+			  bool skipEventTree)
 {
   // record original directory in file.
   TDirectory* originalDirectory = TDirectory::CurrentDirectory();
@@ -98,7 +113,7 @@ void Compare::Directories(TDirectory* d1,
 	      Compare::PrintNoMatching(className, objectName);
 	      continue;
 	    }
-	  Compare::Directories(subD1, subD2, results);
+	  Compare::Directories(subD1, subD2, results, skipEventTree);
 	}
       else if(className == "TH1D")
 	{
@@ -120,7 +135,7 @@ void Compare::Directories(TDirectory* d1,
 	      Compare::PrintNoMatching(className, objectName);
 	      continue;
 	    }
-	  Compare::Trees(d1t, d2t, results);
+	  Compare::Trees(d1t, d2t, results, skipEventTree);
 	}
       else
 	{
@@ -180,7 +195,7 @@ void Compare::Histograms(TH1* h1, TH1* h2, std::vector<Result*>& results)
   results.push_back(c);
 }
 
-void Compare::Trees(TTree* t1, TTree* t2, std::vector<Result*>& results)
+void Compare::Trees(TTree* t1, TTree* t2, std::vector<Result*>& results, bool skipEventTree)
 {
   std::vector<std::string> treesToIgnore = {"Header", "Model", "Options", "Run", "Beam", "ParticleData"};
 
@@ -195,6 +210,8 @@ void Compare::Trees(TTree* t1, TTree* t2, std::vector<Result*>& results)
     }
   else if (!strcmp(treeName.c_str(), "Event"))
     {
+      if (skipEventTree)
+	{return;}
       // We need the sampler names which are in the Model tree. If we have an
       // event tree, we must have a Model tree too!
       TDirectory* dir = t1->GetDirectory();
@@ -549,6 +566,385 @@ void Compare::Sampler(BDSOutputROOTEventSampler<float>* e1,
   re->samplerResults.push_back(rs);
 }
 
+namespace
+{
+  /// Match a string to a pattern where '*' matches any number of characters.
+  bool GlobMatch(const char* pattern, const char* str)
+  {
+    if (*pattern == '\0')
+      {return *str == '\0';}
+    if (*pattern == '*')
+      {return GlobMatch(pattern + 1, str) || (*str != '\0' && GlobMatch(pattern, str + 1));}
+    return *str == *pattern && GlobMatch(pattern + 1, str + 1);
+  }
+
+  /// Escape a string for JSON output.
+  std::string JSONString(const std::string& in)
+  {
+    std::string result = "\"";
+    for (char c : in)
+      {
+	if (c == '"' || c == '\\')
+	  {result += '\\';}
+	if (c == '\n')
+	  {result += "\\n"; continue;}
+	result += c;
+      }
+    return result + "\"";
+  }
+
+  /// Print a number for JSON output - non-finite values aren't allowed so use null.
+  std::string JSONNumber(double value)
+  {
+    if (!std::isfinite(value))
+      {return "null";}
+    std::stringstream ss;
+    ss << std::setprecision(17) << value;
+    return ss.str();
+  }
+
+  /// Open a file and get its Event tree - nullptr for the tree if not possible.
+  std::pair<TFile*, TTree*> OpenEventTree(const std::string& fileName)
+  {
+    TFile* f = TFile::Open(fileName.c_str(), "READ");
+    if (!f || f->IsZombie())
+      {delete f; return {nullptr, nullptr};}
+    return {f, dynamic_cast<TTree*>(f->Get("Event"))};
+  }
+}
+
+Compare::ToleranceList Compare::DefaultTolerances()
+{
+  return {{"Summary.*", -1}, {"Info.*", -1}, {"Histos.*", -1}};
+}
+
+bool Compare::LoadTolerances(const std::string& fileName, ToleranceList& tolerances)
+{
+  std::ifstream f(fileName.c_str());
+  if (!f.is_open())
+    {
+      std::cout << "Unable to open tolerance file \"" << fileName << "\"" << std::endl;
+      return false;
+    }
+  std::string line;
+  int lineNumber = 0;
+  while (std::getline(f, line))
+    {
+      lineNumber++;
+      std::istringstream ss(line);
+      std::string pattern;
+      std::string value;
+      if (!(ss >> pattern) || pattern[0] == '#')
+	{continue;} // empty line or comment
+      if (!(ss >> value))
+	{
+	  std::cout << "No tolerance on line " << lineNumber << " of \"" << fileName << "\"" << std::endl;
+	  return false;
+	}
+      if (value == "ignore")
+	{tolerances.emplace_back(pattern, -1);}
+      else
+	{
+	  try
+	    {tolerances.emplace_back(pattern, std::stod(value));}
+	  catch (const std::exception&)
+	    {
+	      std::cout << "Invalid tolerance \"" << value << "\" on line " << lineNumber
+			<< " of \"" << fileName << "\"" << std::endl;
+	      return false;
+	    }
+	}
+    }
+  return true;
+}
+
+double Compare::ToleranceFor(const std::string& name, const ToleranceList& tolerances)
+{
+  double result = Compare::EventTreeTolerance;
+  std::size_t longest = 0;
+  for (const auto& patternTolerance : tolerances)
+    {
+      const std::string& pattern = patternTolerance.first;
+      if (pattern.size() >= longest && GlobMatch(pattern.c_str(), name.c_str()))
+	{
+	  longest = pattern.size();
+	  result  = patternTolerance.second;
+	}
+    }
+  return result;
+}
+
+std::vector<std::string> Compare::BottomBranchNames(TTree* tree)
+{
+  std::vector<std::string> names;
+  std::set<std::string> seen;
+  TObjArray* leaves = tree->GetListOfLeaves();
+  for (int i = 0; i < leaves->GetEntriesFast(); i++)
+    {
+      TBranch* branch = static_cast<TLeaf*>(leaves->At(i))->GetBranch();
+      std::string name = branch->GetName();
+      if (branch->GetListOfBranches()->GetEntriesFast() == 0 && seen.insert(name).second)
+	{names.push_back(name);}
+    }
+  return names;
+}
+
+ResultEventTreeColumns* Compare::EventTreeColumns(const std::string& fileName1,
+						  const std::string& fileName2,
+						  int nThreads,
+						  const ToleranceList& tolerances)
+{
+  auto start = std::chrono::steady_clock::now();
+  nThreads = std::max(1, nThreads);
+
+  auto ft1 = OpenEventTree(fileName1);
+  if (!ft1.second)
+    {delete ft1.first; return nullptr;}
+  auto ft2 = OpenEventTree(fileName2);
+
+  ResultEventTreeColumns* ret = new ResultEventTreeColumns();
+  ret->nThreads   = nThreads;
+  ret->t1NEntries = (long long)ft1.second->GetEntries();
+  ret->t2NEntries = ft2.second ? (long long)ft2.second->GetEntries() : 0;
+
+  // Build the list of columns from both files. Only the bottom branches hold data
+  // and only numerical ones can be compared. A column in only one file is a failure.
+  std::vector<ResultColumn>& columns = ret->columns;
+  if (ft2.second)
+    {
+      std::vector<std::string> names1 = BottomBranchNames(ft1.second);
+      std::vector<std::string> names2 = BottomBranchNames(ft2.second);
+      std::set<std::string> inFile1(names1.begin(), names1.end());
+      std::set<std::string> inFile2(names2.begin(), names2.end());
+      Int_t errorLevel = gErrorIgnoreLevel;
+      gErrorIgnoreLevel = kFatal; // formulae that don't compile are expected - don't print errors
+      for (const auto& name : names1)
+	{
+	  ResultColumn column(name);
+	  column.tolerance = ToleranceFor(name, tolerances);
+	  if (column.tolerance < 0)
+	    {column.message = "ignored";}
+	  else if (inFile2.count(name) == 0)
+	    {column.passed = false; column.message = "missing in file 2";}
+	  else
+	    {
+	      TTreeFormula formula("comparatorColumn", name.c_str(), ft1.second);
+	      if (formula.GetNdim() == 0 || formula.IsString())
+		{column.message = "not numerical";}
+	      else
+		{column.compared = true;}
+	    }
+	  columns.push_back(column);
+	}
+      for (const auto& name : names2)
+	{
+	  if (inFile1.count(name) > 0)
+	    {continue;}
+	  ResultColumn column(name);
+	  column.tolerance = ToleranceFor(name, tolerances);
+	  if (column.tolerance < 0)
+	    {column.message = "ignored";}
+	  else
+	    {column.passed = false; column.message = "missing in file 1";}
+	  columns.push_back(column);
+	}
+      gErrorIgnoreLevel = errorLevel;
+    }
+  delete ft1.first;
+  delete ft2.first;
+
+  // Don't proceed if either there's no tree or there are a different number of events.
+  if (ret->t1NEntries != ret->t2NEntries || columns.empty())
+    {
+      ret->passed = false;
+      ret->time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      return ret;
+    }
+
+  std::vector<std::size_t> toCompare;
+  for (std::size_t i = 0; i < columns.size(); i++)
+    {
+      if (columns[i].compared)
+	{toCompare.push_back(i);}
+    }
+
+  // Each column is split into one chunk per thread and all the chunks are shared
+  // between the threads. A failure anywhere in a column stops the rest of it.
+  const long long nEntries  = ret->t1NEntries;
+  const long long nChunks   = nThreads;
+  const long long chunkSize = std::max(1LL, (nEntries + nChunks - 1) / nChunks);
+  const std::size_t nItems  = toCompare.size() * (std::size_t)nChunks;
+  std::unique_ptr<std::atomic<bool>[]> failed(new std::atomic<bool>[columns.size()]);
+  for (std::size_t i = 0; i < columns.size(); i++)
+    {failed[i] = false;}
+  std::atomic<std::size_t> nextItem(0);
+  std::mutex resultMutex;
+
+  auto worker = [&]()
+  {
+    auto wft1 = OpenEventTree(fileName1);
+    auto wft2 = OpenEventTree(fileName2);
+    if (!wft1.second || !wft2.second)
+      {delete wft1.first; delete wft2.first; return;}
+    std::map<std::size_t, std::pair<std::unique_ptr<TTreeFormula>, std::unique_ptr<TTreeFormula> > > formulae;
+    for (std::size_t item = nextItem++; item < nItems; item = nextItem++)
+      {
+	std::size_t iColumn = toCompare[item / (std::size_t)nChunks];
+	if (failed[iColumn])
+	  {continue;}
+	auto itemStart = std::chrono::steady_clock::now();
+	ResultColumn& column = columns[iColumn];
+	auto& pair = formulae[iColumn];
+	if (!pair.first)
+	  {
+	    pair.first.reset(new TTreeFormula("comparatorColumn1", column.name.c_str(), wft1.second));
+	    pair.second.reset(new TTreeFormula("comparatorColumn2", column.name.c_str(), wft2.second));
+	  }
+	long long chunk      = (long long)(item % (std::size_t)nChunks);
+	long long firstEntry = chunk * chunkSize;
+	long long lastEntry  = std::min(nEntries, firstEntry + chunkSize);
+	long long nCompared  = 0;
+	long long failEntry  = -1;
+	double v1 = 0;
+	double v2 = 0;
+	std::string message;
+	for (long long i = firstEntry; i < lastEntry; i++)
+	  {
+	    if (failed[iColumn])
+	      {break;}
+	    wft1.second->LoadTree(i);
+	    wft2.second->LoadTree(i);
+	    int n1 = pair.first->GetNdata();
+	    int n2 = pair.second->GetNdata();
+	    if (n1 != n2)
+	      {
+		failEntry = i;
+		v1 = n1;
+		v2 = n2;
+		message = "different number of values";
+		break;
+	      }
+	    for (int j = 0; j < n1; j++)
+	      {
+		v1 = pair.first->EvalInstance(j);
+		v2 = pair.second->EvalInstance(j);
+		bool bothNan = std::isnan(v1) && std::isnan(v2);
+		if (!bothNan && !(std::abs(v1 - v2) <= column.tolerance))
+		  {failEntry = i; break;}
+	      }
+	    if (failEntry >= 0)
+	      {break;}
+	    nCompared++;
+	  }
+	double itemTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - itemStart).count();
+	std::lock_guard<std::mutex> lock(resultMutex);
+	column.entriesCompared += nCompared;
+	column.time += itemTime;
+	if (failEntry >= 0)
+	  {
+	    failed[iColumn] = true;
+	    column.passed = false;
+	    if (column.firstFailingEntry < 0 || failEntry < column.firstFailingEntry)
+	      {
+		column.firstFailingEntry = failEntry;
+		column.value1  = v1;
+		column.value2  = v2;
+		column.message = message;
+	      }
+	  }
+      }
+    formulae.clear(); // before the trees are deleted
+    delete wft1.first;
+    delete wft2.first;
+  };
+
+  if (nThreads > 1)
+    {
+      ROOT::EnableThreadSafety();
+      std::vector<std::thread> threads;
+      for (int t = 0; t < nThreads; t++)
+	{threads.emplace_back(worker);}
+      for (auto& thread : threads)
+	{thread.join();}
+    }
+  else
+    {worker();}
+
+  for (auto& column : columns)
+    {
+      if (column.compared && column.passed && column.entriesCompared != nEntries)
+	{column.passed = false; column.message = "not all entries could be compared";}
+      if (!column.passed)
+	{ret->passed = false;}
+    }
+  ret->time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  std::cout << "Event tree compared column-wise: " << toCompare.size() << " of " << columns.size()
+	    << " columns with " << nThreads << " thread(s) in " << ret->time << " s" << std::endl;
+  return ret;
+}
+
+bool Compare::WriteReport(const std::string& fileName,
+			  const std::vector<Result*>& results,
+			  double time)
+{
+  std::ofstream f(fileName.c_str());
+  if (!f.is_open())
+    {
+      std::cout << "Unable to write report file \"" << fileName << "\"" << std::endl;
+      return false;
+    }
+  bool allPassed = true;
+  for (const auto* result : results)
+    {allPassed = allPassed && result->passed;}
+
+  f << "{\n";
+  f << "  \"passed\": " << (allPassed ? "true" : "false") << ",\n";
+  f << "  \"time\": " << JSONNumber(time) << ",\n";
+  f << "  \"results\": [";
+  for (std::size_t i = 0; i < results.size(); i++)
+    {
+      const Result* result = results[i];
+      f << (i == 0 ? "\n" : ",\n");
+      f << "    {\"name\": " << JSONString(result->name)
+	<< ", \"type\": " << JSONString(result->objtype)
+	<< ", \"passed\": " << (result->passed ? "true" : "false");
+      if (const auto* ret = dynamic_cast<const ResultEventTreeColumns*>(result))
+	{
+	  f << ", \"entries1\": " << ret->t1NEntries
+	    << ", \"entries2\": " << ret->t2NEntries
+	    << ", \"nThreads\": " << ret->nThreads
+	    << ", \"time\": " << JSONNumber(ret->time)
+	    << ", \"columns\": [";
+	  for (std::size_t j = 0; j < ret->columns.size(); j++)
+	    {
+	      const ResultColumn& c = ret->columns[j];
+	      f << (j == 0 ? "\n" : ",\n");
+	      f << "      {\"name\": " << JSONString(c.name)
+		<< ", \"passed\": " << (c.passed ? "true" : "false")
+		<< ", \"compared\": " << (c.compared ? "true" : "false")
+		<< ", \"tolerance\": " << JSONNumber(c.tolerance)
+		<< ", \"entriesCompared\": " << c.entriesCompared
+		<< ", \"firstFailingEntry\": " << c.firstFailingEntry;
+	      if (c.firstFailingEntry >= 0)
+		{f << ", \"value1\": " << JSONNumber(c.value1) << ", \"value2\": " << JSONNumber(c.value2);}
+	      f << ", \"time\": " << JSONNumber(c.time)
+		<< ", \"message\": " << JSONString(c.message) << "}";
+	    }
+	  f << "\n    ]";
+	}
+      else if (const auto* rt = dynamic_cast<const ResultTree*>(result))
+	{
+	  f << ", \"offendingBranches\": [";
+	  for (std::size_t j = 0; j < rt->offendingBranches.size(); j++)
+	    {f << (j == 0 ? "" : ", ") << JSONString(rt->offendingBranches[j]);}
+	  f << "]";
+	}
+      f << "}";
+    }
+  f << "\n  ]\n}\n";
+  return true;
+}
+
 bool Compare::Summarise(const std::vector<Result*>& results)
 {
   bool allPassed = true;
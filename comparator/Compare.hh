@@ -19,6 +19,8 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef COMPCOMPARE_H
 #define COMPCOMPARE_H
 
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "ResultEvent.hh"
@@ -26,6 +28,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "BDSOutputROOTEventSampler.hh"
 
 class Result;
+class ResultEventTreeColumns;
 
 class TDirectory;
 class TFile;
@@ -44,21 +47,27 @@ namespace Compare
   const static double OpticsSimgaTolerance = 10;
   const static double EventTreeTolerance = 1e-10;
 
-  /// Compare two files.
-  std::vector<Result*> Files(TFile* f1, TFile* f2);
+  /// Pairs of branch name pattern ('*' as a wildcard) and absolute tolerance.
+  /// A negative tolerance means the branch is ignored.
+  typedef std::vector<std::pair<std::string, double> > ToleranceList;
+
+  /// Compare two files. Optionally skip the Event tree, e.g. if it's compared
+  /// separately with EventTreeColumns.
+  std::vector<Result*> Files(TFile* f1, TFile* f2, bool skipEventTree = false);
 
   /// Compare two directories by changing into d1 and inspecting all objects.
   /// The results are recorded via a reference to a results vector. The
   /// original directory is changed back to at the end of the method.
   void Directories(TDirectory* d1,
 		   TDirectory* d2,
-		   std::vector<Result*>& results);
+		   std::vector<Result*>& results,
+		   bool skipEventTree = false);
 
   /// Compare two histogams.
   void Histograms(TH1* h1, TH1* h2, std::vector<Result*>& results);
   
   /// Compare two TTrees.
-  void Trees(TTree* t1, TTree* t2, std::vector<Result*>& results);
+  void Trees(TTree* t1, TTree* t2, std::vector<Result*>& results, bool skipEventTree = false);
 
   /// Compare an optics TTree specifically. This relies on the known variable
   /// names in the tree and naming scheme.
@@ -90,6 +99,40 @@ namespace Compare
   template <>
   bool Diff(bool v1, bool v2) {return v1 != v2;}
 
+  /// Names of the bottom (data holding) branches of a tree in order without repeats.
+  std::vector<std::string> BottomBranchNames(TTree* tree);
+
+  /// Compare the Event tree in two files column-wise, i.e. each leaf separately for
+  /// all entries. The entries of each leaf are split into nThreads chunks and the
+  /// chunks of all leaves are shared between nThreads threads, each with the files
+  /// opened separately. Comparison of a leaf stops at the first failure found. Any
+  /// numerical leaf is compared and the tolerance is taken from the longest matching
+  /// pattern in tolerances, or EventTreeTolerance if none match. A leaf present in only
+  /// one of the files is a failure unless ignored. Returns nullptr if there is no Event
+  /// tree in file 1.
+  ResultEventTreeColumns* EventTreeColumns(const std::string& fileName1,
+					   const std::string& fileName2,
+					   int nThreads,
+					   const ToleranceList& tolerances);
+
+  /// Default tolerances for the column-wise comparison. Ignores the branches with
+  /// timing and memory information as these always differ.
+  ToleranceList DefaultTolerances();
+
+  /// Load a file where each line is a branch name pattern ('*' as a wildcard) and an
+  /// absolute tolerance or 'ignore'. Lines starting with '#' are comments. Appends to
+  /// tolerances and returns false if the file couldn't be read.
+  bool LoadTolerances(const std::string& fileName, ToleranceList& tolerances);
+
+  /// Tolerance for a branch name from the longest matching pattern (the last for equal length).
+  double ToleranceFor(const std::string& name, const ToleranceList& tolerances);
+
+  /// Write a JSON report of all results including the time taken. Returns false if
+  /// the file couldn't be written.
+  bool WriteReport(const std::string& fileName,
+		   const std::vector<Result*>& results,
+		   double time);
+
   /// Simply print out feedback warning that a matching object wasn't found and
   /// no comparison is being done.
   void PrintNoMatching(std::string className, std::string objectName);
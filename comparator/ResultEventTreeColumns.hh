@@ -0,0 +1,115 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef COMPRESULTEVENTTREECOLUMNS_H
+#define COMPRESULTEVENTTREECOLUMNS_H
+
+#include "Result.hh"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Result of comparison of one leaf (column) of the Event tree.
+ *
+ * @author Laurie Nevay
+ */
+
+class ResultColumn: public Result
+{
+public:
+  explicit ResultColumn(const std::string& nameIn):
+    Result(nameIn, "Column"),
+    compared(false),
+    tolerance(0),
+    entriesCompared(0),
+    firstFailingEntry(-1),
+    value1(0),
+    value2(0),
+    time(0)
+  {;}
+
+  virtual ~ResultColumn() {}
+
+  bool        compared;          ///< Whether it was compared (false if ignored or not numerical).
+  double      tolerance;         ///< Absolute tolerance used.
+  long long   entriesCompared;   ///< Number of entries compared before any failure.
+  long long   firstFailingEntry; ///< Lowest failing entry found (-1 if none).
+  double      value1;            ///< Value in file 1 at first failure.
+  double      value2;            ///< Value in file 2 at first failure.
+  double      time;              ///< Summed time spent comparing this column (s).
+  std::string message;           ///< Reason for failure or not comparing.
+
+  virtual std::string print() const
+  {
+    std::stringstream ss;
+    ss << Result::print();
+    if (firstFailingEntry >= 0)
+      {
+	ss << "First failing entry " << firstFailingEntry << " : " << value1 << " / " << value2
+	   << " (tolerance " << tolerance << ")";
+      }
+    if (!message.empty())
+      {ss << " " << message;}
+    ss << "\n";
+    return ss.str();
+  }
+};
+
+/**
+ * @brief Result of column-wise comparison of an Event tree in BDSIM output.
+ *
+ * @author Laurie Nevay
+ */
+
+class ResultEventTreeColumns: public Result
+{
+public:
+  ResultEventTreeColumns():
+    Result("Event", "TTree(Event) column-wise"),
+    t1NEntries(0),
+    t2NEntries(0),
+    nThreads(1),
+    time(0)
+  {;}
+
+  virtual ~ResultEventTreeColumns() {}
+
+  long long t1NEntries;
+  long long t2NEntries;
+  int       nThreads;
+  double    time;      ///< Wall time for the whole comparison (s).
+  std::vector<ResultColumn> columns;
+
+  virtual std::string print() const
+  {
+    std::stringstream ss;
+    ss << Result::print();
+    ss << "Event Tree (1/2) entries (" << t1NEntries << "/" << t2NEntries << ")\n";
+    for (const auto& column : columns)
+      {
+	if (!column.passed)
+	  {ss << column.print();}
+      }
+    ss << "\n";
+    return ss.str();
+  }
+};
+
+#endif
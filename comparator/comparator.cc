@@ -21,7 +21,10 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
  */
 
 #include "Compare.hh"
+#include "ResultEventTreeColumns.hh"
 
+#include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <iostream>
 #include <string>
@@ -47,14 +50,55 @@ enum EXIT_CODE {
 
 int main(int argc, char* argv[])
 {
-  if (argc != 3)
+  auto start = std::chrono::steady_clock::now();
+
+  // optional arguments first - only --columns compares the event tree column-wise
+  bool columns = false;
+  int  nThreads = 1;
+  std::string toleranceFile;
+  std::string reportFile;
+  std::vector<std::string> positional;
+  for (int i = 1; i < argc; i++)
+    {
+      std::string arg = std::string(argv[i]);
+      bool hasValue = i + 1 < argc;
+      if (arg == "--columns")
+	{columns = true;}
+      else if ((arg == "-j" || arg == "--threads") && hasValue)
+	{
+	  try
+	    {nThreads = std::max(1, std::stoi(argv[++i]));}
+	  catch (const std::exception&)
+	    {usage(); return EXIT_CODE::_EXIT_INCORRECT_ARGS;}
+	}
+      else if (arg == "--tolerances" && hasValue)
+	{toleranceFile = std::string(argv[++i]);}
+      else if (arg == "--report" && hasValue)
+	{reportFile = std::string(argv[++i]);}
+      else
+	{positional.push_back(arg);}
+    }
+  if (positional.size() != 2)
     { 
       usage();
       return EXIT_CODE::_EXIT_INCORRECT_ARGS;    
     }
+  if (!columns && (nThreads > 1 || !toleranceFile.empty()))
+    {
+      std::cout << "-j and --tolerances only apply with --columns" << std::endl;
+      usage();
+      return EXIT_CODE::_EXIT_INCORRECT_ARGS;
+    }
 
-  std::string fname1 = std::string(argv[1]);
-  std::string fname2 = std::string(argv[2]);
+  Compare::ToleranceList tolerances = Compare::DefaultTolerances();
+  if (!toleranceFile.empty())
+    {
+      if (!Compare::LoadTolerances(toleranceFile, tolerances))
+	{return EXIT_CODE::_EXIT_INCORRECT_ARGS;}
+    }
+
+  std::string fname1 = positional[0];
+  std::string fname2 = positional[1];
   // try to open files - check validity
   if (!FileExists(fname1))
     {
@@ -80,14 +124,26 @@ int main(int argc, char* argv[])
       return EXIT_CODE::_EXIT_FILE_NOT_FOUND;
     }
 
-  std::vector<Result*> results = Compare::Files(f1,f2);
+  std::vector<Result*> results = Compare::Files(f1, f2, columns);
 
   f1->Close();
   delete f1;
   f2->Close();
   delete f2;
+
+  if (columns)
+    {
+      ResultEventTreeColumns* ret = Compare::EventTreeColumns(fname1, fname2, nThreads, tolerances);
+      if (ret)
+	{results.push_back(ret);}
+    }
   
   bool allPassed = Compare::Summarise(results);
+  if (!reportFile.empty())
+    {
+      double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      Compare::WriteReport(reportFile, results, time);
+    }
   for (auto r : results)
     {delete r;}
   if (!allPassed)
@@ -109,8 +165,10 @@ int main(int argc, char* argv[])
 
 void usage()
 { 
-  std::cout << "Usage: comparator <rootfile1> <rootfile2>" << std::endl;
+  std::cout << "Usage: comparator [--columns] [-j nThreads] [--tolerances file] [--report file.json] <rootfile1> <rootfile2>" << std::endl;
   std::cout << "Compares <rootfile2> to <rootfile1> - ie <rootfile1> is the reference." << std::endl;
+  std::cout << "--columns compares the Event tree column-wise (all numerical leaves) in parallel" << std::endl;
+  std::cout << "with nThreads and per-branch tolerances. --report writes a JSON report in either mode." << std::endl;
 }
 
 bool FileExists(const std::string& fileName)
@@ -0,0 +1,177 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file userfile2Binary.cc
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+  const std::string headerIdentifier    = "# BDSIM binary user file";
+  const std::string headerEndIdentifier = "! binary column major doubles follow";
+  const long        rowsPerChunk        = 1000000;
+
+  /// Same as BDSBunchUserFile - empty lines or lines commented with # or ! are not coordinates.
+  bool SkippableLine(const std::string& line)
+  {
+    std::size_t first = line.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos)
+      {return true;}
+    return line[first] == '#' || line.find('!') != std::string::npos;
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  if (argc < 4 || argc > 5)
+    {
+      std::cout << "usage: userfile2binary <inputFile> <outputFile> <distrFileFormat> (<nlinesIgnore>)" << std::endl;
+      std::cout << " <inputFile>       - text file as used with a userfile distribution (not compressed)" << std::endl;
+      std::cout << " <outputFile>      - binary file for a userfilebinary distribution" << std::endl;
+      std::cout << " <distrFileFormat> - column format as used with the userfile, e.g. \"x[mm]:xp[mrad]:E[GeV]\"" << std::endl;
+      std::cout << " <nlinesIgnore>    - (optional) number of header lines to ignore" << std::endl;
+      exit(1);
+    }
+  
+  std::string inputFileName  = std::string(argv[1]);
+  std::string outputFileName = std::string(argv[2]);
+  std::string format         = std::string(argv[3]);
+  long nLinesIgnore = argc == 5 ? std::stol(std::string(argv[4])) : 0;
+
+  // columns in the text file and whether each is kept - skipped '-' columns are dropped
+  std::string formatSpaced = format;
+  std::replace(formatSpaced.begin(), formatSpaced.end(), ':', ' ');
+  std::istringstream formatStream(formatSpaced);
+  std::vector<bool> keep;
+  std::string outputFormat;
+  std::string token;
+  while (formatStream >> token)
+    {
+      bool keepIt = token != "-";
+      keep.push_back(keepIt);
+      if (keepIt)
+        {outputFormat += (outputFormat.empty() ? "" : ":") + token;}
+    }
+  std::size_t nColumnsIn  = keep.size();
+  std::size_t nColumnsOut = (std::size_t)std::count(keep.begin(), keep.end(), true);
+  if (nColumnsOut == 0)
+    {
+      std::cerr << "no columns to convert in format \"" << format << "\"" << std::endl;
+      exit(1);
+    }
+
+  std::ifstream in(inputFileName);
+  if (!in.good())
+    {
+      std::cerr << "cannot open input file \"" << inputFileName << "\"" << std::endl;
+      exit(1);
+    }
+
+  // first pass - count the rows so the columns can be placed
+  std::string line;
+  long lineNumber = 0;
+  long nRows = 0;
+  while (std::getline(in, line))
+    {
+      if (lineNumber >= nLinesIgnore && !SkippableLine(line))
+        {nRows++;}
+      lineNumber++;
+    }
+  std::cout << "userfile2binary> " << nRows << " rows of " << nColumnsOut << " columns" << std::endl;
+
+  std::ofstream out(outputFileName, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!out.good())
+    {
+      std::cerr << "cannot open output file \"" << outputFileName << "\"" << std::endl;
+      exit(1);
+    }
+  std::ostringstream header;
+  header << headerIdentifier << "\n"
+         << "version 1\n"
+         << "rows " << nRows << "\n"
+         << "format " << outputFormat << "\n"
+         << headerEndIdentifier;
+  std::string headerString = header.str();
+  // pad the last line so the doubles start on an 8 byte boundary
+  std::size_t headerSize = headerString.size() + 1;
+  if (headerSize % sizeof(double) != 0)
+    {headerString += std::string(sizeof(double) - headerSize % sizeof(double), ' ');}
+  headerString += "\n";
+  out.write(headerString.data(), (std::streamsize)headerString.size());
+  std::streamoff dataOffset = (std::streamoff)headerString.size();
+
+  // second pass - fill the columns a chunk of rows at a time
+  in.clear();
+  in.seekg(0);
+  lineNumber = 0;
+  long rowsDone = 0;
+  std::vector<std::vector<double>> chunk(nColumnsOut);
+  auto writeChunk = [&]()
+  {
+    for (std::size_t c = 0; c < nColumnsOut; c++)
+      {
+        std::streamoff position = dataOffset + (std::streamoff)(((long)c * nRows + rowsDone) * (long)sizeof(double));
+        out.seekp(position);
+        out.write(reinterpret_cast<const char*>(chunk[c].data()), (std::streamsize)(chunk[c].size() * sizeof(double)));
+      }
+    rowsDone += (long)chunk[0].size();
+    for (auto& column : chunk)
+      {column.clear();}
+  };
+  while (std::getline(in, line))
+    {
+      lineNumber++;
+      if (lineNumber <= nLinesIgnore || SkippableLine(line))
+        {continue;}
+      const char* cursor = line.c_str();
+      std::size_t cOut = 0;
+      for (std::size_t cIn = 0; cIn < nColumnsIn; cIn++)
+        {
+          char* end = nullptr;
+          double value = std::strtod(cursor, &end);
+          if (end == cursor)
+            {
+              std::cerr << "invalid line " << lineNumber << ": expected " << nColumnsIn << " columns" << std::endl;
+              exit(1);
+            }
+          cursor = end;
+          if (keep[cIn])
+            {chunk[cOut++].push_back(value);}
+        }
+      if ((long)chunk[0].size() == rowsPerChunk)
+        {writeChunk();}
+    }
+  if (!chunk[0].empty())
+    {writeChunk();}
+  out.close();
+  if (!out)
+    {
+      std::cerr << "problem writing output file \"" << outputFileName << "\"" << std::endl;
+      exit(1);
+    }
+  std::cout << "userfile2binary> written " << outputFileName << std::endl;
+  return 0;
+}
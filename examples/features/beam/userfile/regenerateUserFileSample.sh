@@ -2,3 +2,9 @@ BDSIM="bdsim"
 
 # use the loop one so we can test recreation also with a loop
 $BDSIM --file=userfile-loop.gmad --outfile=userfile-sample --batch --ngenerate=10 --seed=123
+
+# binary version of the basic user file for userfile-binary.gmad
+userfile2binary userbeamdata.dat userbeamdata.bin "x[mum]:xp[mrad]:y[mum]:yp[mrad]:z[cm]:E[GeV]"
+
+# particle type but no energy column for userfile-binary-pdgid.gmad
+userfile2binary userbeamdata-ions.dat userbeamdata-ions.bin "pdgid"
@@ -0,0 +1,56 @@
+"""
+Compare the figure of merit (FOM = 1 / (R^2 T)) of the energy deposited deep in the
+shielding wall for the analogue simulation, cell importance sampling and weight windows.
+
+R is the relative statistical error of the mean energy deposited per event beyond
+tallyZ and T is the wall clock time of the simulation. A higher FOM is better.
+
+Usage: python weightWindowBenchmark.py [nEvents]
+"""
+import math
+import subprocess
+import sys
+import time
+
+import pybdsim
+
+
+def Run(gmad, outfile, nEvents):
+    t0 = time.time()
+    subprocess.run(["bdsim", "--file="+gmad, "--batch", "--ngenerate="+str(nEvents),
+                    "--outfile="+outfile, "--seed=123"], check=True, stdout=subprocess.DEVNULL)
+    return time.time() - t0
+
+
+def Tally(filename, tallyZ=4.6):
+    d = pybdsim.Data.Load(filename)
+    values = []
+    for event in d.GetEventTree():
+        e = event.ElossWorld
+        total = 0
+        for energy, z, w in zip(e.totalEnergy, e.Z, e.weight):
+            if z > tallyZ:
+                total += energy * w
+        values.append(total)
+    n = len(values)
+    mean = sum(values) / n
+    variance = sum((v - mean)**2 for v in values) / (n - 1)
+    relError = math.sqrt(variance / n) / mean if mean > 0 else float("inf")
+    return mean, relError
+
+
+def Benchmark(nEvents=200):
+    cases = [("analogue",   "analogue.gmad"),
+             ("importance", "importanceSampling.gmad"),
+             ("weight window", "weightWindow.gmad")]
+    print("{:>14} {:>12} {:>12} {:>10} {:>10} {:>12}".format("case", "mean (GeV)", "error (GeV)", "R", "T (s)", "FOM"))
+    for name, gmad in cases:
+        outfile = "bench_" + name.replace(" ", "_")
+        t = Run(gmad, outfile, nEvents)
+        mean, relError = Tally(outfile + ".root")
+        fom = 1.0 / (relError**2 * t) if relError > 0 else float("inf")
+        print("{:>14} {:>12.4e} {:>12.4e} {:>10.4f} {:>10.1f} {:>12.4e}".format(name, mean, mean * relError, relError, t, fom))
+
+
+if __name__ == "__main__":
+    Benchmark(int(sys.argv[1]) if len(sys.argv) > 1 else 200)
@@ -29,9 +29,14 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "TH1D.h"
 #include "TTree.h"
 
+#include <cstddef>
+#include <utility>
 #include <vector>
 
 /** @brief 4D histogram classes with linear, logarithmic and user-defined energy binning.
+ *
+ * The contents may be stored densely (a vector of all bins) or sparsely (a map of only the
+ * non-zero bins) depending on the boost histogram type - see BDSBH4DTypeDefs.hh.
  *
  * @author Eliott Ramoisiaux
  */
@@ -56,11 +61,9 @@ public:
   T h;
   T h_err;
   
-  BDSBH4DBase& operator+=(const BDSBH4DBase& other) override
-  {
-    h += dynamic_cast<const BDSBH4D<T>&>(other).h;
-    return *this;
-  }
+  /// Only the non-zero bins of other are added, so this is proportional to
+  /// the number of filled bins for sparse storage.
+  BDSBH4DBase& operator+=(const BDSBH4DBase& other) override;
 
   void Reset_BDSBH4D() override;
   BDSBH4D* Clone(const char*) const override;
@@ -74,6 +77,15 @@ public:
   double HighBinEdgeAt(int, int, int, int) override;
   void Print_BDSBH4D(bool with_zero_values=true) override;
   void Print_BDSBH4D(int, int, int, int) override;
+  bool Sparse() const override;
+  std::size_t NBinsTotal() const override;
+  void NonZeroBins(std::vector<std::pair<std::size_t, double> >& bins) const override;
+  void NonZeroErrorBins(std::vector<std::pair<std::size_t, double> >& bins) const override;
+  double AtIndex(std::size_t) const override;
+  double AtErrorIndex(std::size_t) const override;
+  void SetAtIndex(std::size_t, double) override;
+  void SetErrorAtIndex(std::size_t, double) override;
+  std::size_t StorageBytes() const override;
 #endif
 
   ClassDef(BDSBH4D,1);
@@ -25,7 +25,9 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "TFile.h"
 #include "TObject.h"
 
+#include <cstddef>
 #include <string>
+#include <utility>
 #include <vector>
 
 /** @brief Base class for the 4D histogram classes.
@@ -81,6 +83,23 @@ public:
   virtual double HighBinEdgeAt(int, int, int, int) = 0;
   virtual void Print_BDSBH4D(bool with_zero_values = true) = 0;
   virtual void Print_BDSBH4D(int, int, int, int) = 0;
+
+  /// Whether only the non-zero bins are stored.
+  virtual bool Sparse() const = 0;
+  /// Total number of bins including under and overflow bins.
+  virtual std::size_t NBinsTotal() const = 0;
+  /// Append the storage index and value of each non-zero bin of the contents or the
+  /// errors. For sparse storage only the stored bins are visited.
+  virtual void NonZeroBins(std::vector<std::pair<std::size_t, double> >& bins) const = 0;
+  virtual void NonZeroErrorBins(std::vector<std::pair<std::size_t, double> >& bins) const = 0;
+  /// @{ Access by storage index as given by NonZeroBins().
+  virtual double AtIndex(std::size_t) const = 0;
+  virtual double AtErrorIndex(std::size_t) const = 0;
+  virtual void   SetAtIndex(std::size_t, double) = 0;
+  virtual void   SetErrorAtIndex(std::size_t, double) = 0;
+  /// @}
+  /// Approximate memory used by the contents and errors in bytes.
+  virtual std::size_t StorageBytes() const = 0;
   
   unsigned int h_nxbins;
   unsigned int h_nybins;
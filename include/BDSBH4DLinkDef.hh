@@ -51,6 +51,19 @@ typedef double boost_histogram_storage_type;
 #pragma link C++ class BDSBH4D<boost_histogram_linear>+;
 #pragma link C++ class BDSBH4D<boost_histogram_log>+;
 #pragma link C++ class BDSBH4D<boost_histogram_variable>+;
+// sparse storage
+#pragma link C++ class map<unsigned long,double>+;
+#pragma link C++ class boost::histogram::detail::map_impl<map<unsigned long,double> >+;
+#pragma link C++ class boost::histogram::storage_adaptor<map<unsigned long,double> >+;
+#pragma link C++ class boost::histogram::histogram<tuple<boost::histogram::axis::regular<double,boost::use_default,boost::use_default,boost::use_default>,boost::histogram::axis::regular<double,boost::use_default,boost::use_default,boost::use_default>,boost::histogram::axis::regular<double,boost::use_default,boost::use_default,boost::use_default>,boost::histogram::axis::regular<double,boost::use_default,boost::use_default,boost::use_default> >,boost::histogram::storage_adaptor<map<unsigned long,double> > >+;
+#pragma link C++ class boost::histogram::detail::mutex_base<tuple<boost::histogram::axis::regular<double,boost::use_default,boost::use_default,boost::use_default>,boost::histogram::axis::regular<double,boost::use_default,boost::use_default,boost::use_default>,boost::histogram::axis::regular<double,boost::use_default,boost::use_default,boost::use_default>,boost::histogram::axis::regular<double,boost::use_default,boost::use_default,boost::use_default> >,boost::histogram::storage_adaptor<map<unsigned long,double> >,boost::histogram::detail::null_mutex>+;
+#pragma link C++ class boost::histogram::histogram<tuple<boost::histogram::axis::regular<double,boost::use_default,boost::use_default,boost::use_default>,boost::histogram::axis::regular<double,boost::use_default,boost::use_default,boost::use_default>,boost::histogram::axis::regular<double,boost::use_default,boost::use_default,boost::use_default>,boost::histogram::axis::regular<double,boost::histogram::axis::transform::log,boost::use_default,boost::use_default> >,boost::histogram::storage_adaptor<map<unsigned long,double> > >+;
+#pragma link C++ class boost::histogram::detail::mutex_base<tuple<boost::histogram::axis::regular<double,boost::use_default,boost::use_default,boost::use_default>,boost::histogram::axis::regular<double,boost::use_default,boost::use_default,boost::use_default>,boost::histogram::axis::regular<double,boost::use_default,boost::use_default,boost::use_default>,boost::histogram::axis::regular<double,boost::histogram::axis::transform::log,boost::use_default,boost::use_default> >,boost::histogram::storage_adaptor<map<unsigned long,double> >,boost::histogram::detail::null_mutex>+;
+#pragma link C++ class boost::histogram::histogram<tuple<boost::histogram::axis::regular<double,boost::use_default,boost::use_default,boost::use_default>,boost::histogram::axis::regular<double,boost::use_default,boost::use_default,boost::use_default>,boost::histogram::axis::regular<double,boost::use_default,boost::use_default,boost::use_default>,boost::histogram::axis::variable<double,boost::use_default,boost::use_default,allocator<double> > >,boost::histogram::storage_adaptor<map<unsigned long,double> > >+;
+#pragma link C++ class boost::histogram::detail::mutex_base<tuple<boost::histogram::axis::regular<double,boost::use_default,boost::use_default,boost::use_default>,boost::histogram::axis::regular<double,boost::use_default,boost::use_default,boost::use_default>,boost::histogram::axis::regular<double,boost::use_default,boost::use_default,boost::use_default>,boost::histogram::axis::variable<double,boost::use_default,boost::use_default,allocator<double> > >,boost::histogram::storage_adaptor<map<unsigned long,double> >,boost::histogram::detail::null_mutex>+;
+#pragma link C++ class BDSBH4D<boost_histogram_linear_sparse>+;
+#pragma link C++ class BDSBH4D<boost_histogram_log_sparse>+;
+#pragma link C++ class BDSBH4D<boost_histogram_variable_sparse>+;
 
 
 #endif
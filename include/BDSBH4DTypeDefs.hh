@@ -23,6 +23,9 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include <boost/histogram.hpp>
 #include <boost/variant.hpp>
 
+#include <cstddef>
+#include <map>
+
 #ifndef __ROOTDOUBLE__
 typedef double boost_histogram_storage_type;
 #else
@@ -39,6 +42,14 @@ typedef boost::histogram::histogram<std::tuple<boost_histogram_linear_axis, boos
 typedef boost::histogram::histogram<std::tuple<boost_histogram_linear_axis, boost_histogram_linear_axis, boost_histogram_linear_axis, boost_histogram_log_axis      >, boost::histogram::storage_adaptor<std::vector<boost_histogram_storage_type, std::allocator<boost_histogram_storage_type> > > > boost_histogram_log;
 typedef boost::histogram::histogram<std::tuple<boost_histogram_linear_axis, boost_histogram_linear_axis, boost_histogram_linear_axis, boost_histogram_variable_axis >, boost::histogram::storage_adaptor<std::vector<boost_histogram_storage_type, std::allocator<boost_histogram_storage_type> > > > boost_histogram_variable;
 
+// sparse storage - only non-zero bins are stored
+typedef boost::histogram::storage_adaptor<std::vector<boost_histogram_storage_type, std::allocator<boost_histogram_storage_type> > > boost_histogram_dense_storage;
+typedef boost::histogram::storage_adaptor<std::map<std::size_t, boost_histogram_storage_type> > boost_histogram_sparse_storage;
+
+typedef boost::histogram::histogram<std::tuple<boost_histogram_linear_axis, boost_histogram_linear_axis, boost_histogram_linear_axis, boost_histogram_linear_axis   >, boost_histogram_sparse_storage> boost_histogram_linear_sparse;
+typedef boost::histogram::histogram<std::tuple<boost_histogram_linear_axis, boost_histogram_linear_axis, boost_histogram_linear_axis, boost_histogram_log_axis      >, boost_histogram_sparse_storage> boost_histogram_log_sparse;
+typedef boost::histogram::histogram<std::tuple<boost_histogram_linear_axis, boost_histogram_linear_axis, boost_histogram_linear_axis, boost_histogram_variable_axis >, boost_histogram_sparse_storage> boost_histogram_variable_sparse;
+
 #endif
 
 #endif
@@ -93,6 +93,9 @@ protected:
   G4double Rp0;
   /// @}
 
+  /// Whether to read all the events to be used into memory at the start (bdsimsampler only).
+  G4bool eventGeneratorPreload;
+
   /// Vector (sorted) of permitted particles.
   std::set<G4int> acceptedParticles;
 
@@ -54,6 +54,7 @@ public:
   unsigned long long int NEventsInFile() const {return nEventsInFile;}
   unsigned long long int NEventsInFileSkipped() const {return nEventsInFileSkipped;}
   G4int DistrFileLoopNTimes() const {return distrFileLoopNTimes;}
+  G4bool DistrFileIndex() const {return distrFileIndex;}
   /// @}
 
   void SetNEventsInFile(unsigned long long int nEventsInFileIn) {nEventsInFile = nEventsInFileIn;}
@@ -75,6 +76,7 @@ protected:
   unsigned long long int nEventsInFileSkipped; ///< Number that are skipped as we go through the file due to filters.
   G4bool distrFileLoop;
   G4int distrFileLoopNTimes;
+  G4bool distrFileIndex; ///< Whether to use a byte offset index of the file for counting and skipping.
 };
 
 #endif
@@ -0,0 +1,191 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef BDSBUNCHHALODIRECT_H
+#define BDSBUNCHHALODIRECT_H
+#include "BDSBunch.hh"
+#include "BDSBunchHaloFlatSigma.hh"
+#include "BDSBunchType.hh"
+
+#include "G4String.hh"
+#include "G4Transform3D.hh"
+#include "G4Types.hh"
+
+#include <utility>
+#include <vector>
+
+namespace GMAD
+{
+  class Beam;
+}
+
+namespace BDS
+{
+  /// Sorted disjoint angular intervals (lower, upper) in [0, 2pi).
+  typedef std::vector<std::pair<G4double, G4double> > AngleIntervals;
+
+/**
+ * @brief Direct sampler for one transverse plane of the halo distribution.
+ * 
+ * The allowed phase space for a given single particle emittance is an ellipse
+ * where the position and angle cuts remove bands of the phase angle. These bands
+ * are calculated analytically so the measure of the allowed region as a function
+ * of emittance can be tabulated once and inverted. Three cumulative distributions
+ * are prepared - weighted by the phase space weight function (w), by its complement
+ * (1-w) and unweighted - as these are required to reproduce the acceptance of both
+ * planes in BDSBunchHalo without rejection. Implementation detail.
+ */
+
+class HaloPlaneSampler
+{
+public:
+  /// Which density in emittance to sample from.
+  enum class Density {weighted, complement, unweighted};
+
+  HaloPlaneSampler(G4double emitInnerIn,
+                   G4double emitOuterIn,
+                   const TwissPair& twissIn,
+                   G4double posCutInnerIn,
+                   G4double posCutOuterIn,
+                   G4double angCutInnerIn,
+                   G4double angCutOuterIn,
+                   const G4String& weightFunctionIn,
+                   G4double weightParameterIn,
+                   G4int    nPointsIn = 2000);
+  ~HaloPlaneSampler() = default;
+
+  /// Integral of the chosen density over the allowed phase space.
+  G4double Integral(Density density) const;
+
+  /// Sample a phase space point (in metres and radians) from the chosen density.
+  PhaseSpaceCoord Sample(Density density) const;
+
+  /// Phase space weight function clipped to [0,1] as used for acceptance in BDSBunchHalo.
+  G4double Weight(G4double emittance) const;
+
+  /// Allowed phase angles on the ellipse of a given single particle emittance.
+  AngleIntervals AllowedAngles(G4double emittance) const;
+
+private:
+  /// Invert the tabulated cumulative distribution for a uniform random number.
+  G4double SampleEmittance(const std::vector<G4double>& cdf) const;
+
+  /// Select an angle uniformly from the allowed intervals.
+  static G4double SampleAngle(const AngleIntervals& intervals);
+
+  /// Angles for which cLow <= |cos(phi - shift)| <= cHigh.
+  static AngleIntervals CosineBand(G4double cLow, G4double cHigh, G4double shift);
+
+  /// Intersection of two sets of sorted disjoint intervals.
+  static AngleIntervals Intersection(const AngleIntervals& a, const AngleIntervals& b);
+
+  /// Sum of the lengths of the intervals.
+  static G4double Length(const AngleIntervals& intervals);
+
+  const std::vector<G4double>& CDF(Density density) const;
+
+  G4double emitInner;
+  G4double emitOuter;
+  TwissPair twiss;
+  G4double gamma;
+  G4double posCutInner; ///< Absolute position cut [m].
+  G4double posCutOuter;
+  G4double angCutInner; ///< Absolute angle cut [rad].
+  G4double angCutOuter;
+  G4String weightFunction;
+  G4double weightParameter;
+  G4double angleShift;  ///< Phase offset of the angle coordinate w.r.t. the position.
+
+  std::vector<G4double> emittances;
+  std::vector<G4double> cdfWeighted;
+  std::vector<G4double> cdfComplement;
+  std::vector<G4double> cdfUnweighted;
+};
+
+} // namespace BDS
+
+/**
+ * @brief Halo distribution equivalent to BDSBunchHalo but sampled directly.
+ *
+ * The same parameters, cuts and weight functions as the "halo" distribution
+ * are used, but rather than sampling a box in phase space and rejecting points,
+ * the allowed single particle emittance and phase angle are sampled by inversion
+ * of their (tabulated) cumulative distributions. The generation rate is therefore
+ * independent of how thin the halo annulus is or how much of phase space the
+ * cuts remove.
+ */
+
+class BDSBunchHaloDirect: public BDSBunch
+{
+public:
+  BDSBunchHaloDirect();
+  virtual ~BDSBunchHaloDirect();
+  /// @{ Assignment and copy constructor not implemented nor used
+  BDSBunchHaloDirect& operator=(const BDSBunchHaloDirect&) = delete;
+  BDSBunchHaloDirect(BDSBunchHaloDirect&) = delete;
+  /// @}
+  virtual void SetOptions(const BDSParticleDefinition* beamParticle,
+                          const GMAD::Beam& beam,
+                          const BDSBunchType& distrType,
+                          G4Transform3D beamlineTransformIn = G4Transform3D::Identity,
+                          const G4double beamlineS = 0);
+  virtual void CheckParameters();
+  virtual BDSParticleCoordsFull GetNextParticleLocal();
+
+private:
+  /// @{ Twiss parameter
+  G4double alphaX;
+  G4double alphaY;
+  G4double betaX;
+  G4double betaY;
+  G4double emitX;
+  G4double emitY;
+  G4double gammaX;
+  G4double gammaY;
+  G4double sigmaX;
+  G4double sigmaY;
+  G4double sigmaXp;
+  G4double sigmaYp;
+  /// @}
+
+  G4double haloNSigmaXInner;
+  G4double haloNSigmaXOuter;
+  G4double haloNSigmaYInner;
+  G4double haloNSigmaYOuter;
+  G4double haloXCutInner;
+  G4double haloYCutInner;
+  G4double haloXCutOuter;
+  G4double haloYCutOuter;
+  G4double haloXpCutInner;
+  G4double haloYpCutInner;
+  G4double haloXpCutOuter;
+  G4double haloYpCutOuter;
+  G4double haloPSWeightParameter;
+  G4String weightFunction;
+
+  /// @{ Per plane samplers.
+  BDS::HaloPlaneSampler* samplerX;
+  BDS::HaloPlaneSampler* samplerY;
+  /// @}
+
+  /// Probability of drawing x from its weighted density with y unweighted. Otherwise
+  /// x is drawn from the complement of the weight and y from its weighted density.
+  G4double probabilityXWeighted;
+};
+
+#endif
@@ -35,13 +35,36 @@ class BDSParticleDefinition;
  * to aid memory management (avoid double deletion) we have a member in this class
  * for the current particle definition that is updated each time. The accessor is
  * overloaded to access that one instead of the base class one.
+ *
+ * Alternatively, the particles can be read directly from arrays owned by the
+ * caller with SetParticleArrays. Nothing is copied and each particle is only
+ * constructed as it is generated.
  * 
  * @author Laurie Nevay
  */
 
 class BDSBunchSixTrackLink: public BDSBunch
 {
-public: 
+public:
+  /// Pointers to arrays of particle variables owned by the caller. Units are m, rad,
+  /// GeV and s. All arrays from t onwards are optional and may be nullptr.
+  struct ParticleArrays
+  {
+    G4int         n                  = 0;
+    const double* x                  = nullptr;
+    const double* y                  = nullptr;
+    const double* xp                 = nullptr;
+    const double* yp                 = nullptr;
+    const double* totalEnergy        = nullptr;
+    const int*    pdgID              = nullptr;
+    const double* t                  = nullptr;
+    const int*    ionA               = nullptr;
+    const int*    ionZ               = nullptr;
+    const double* ionCharge          = nullptr; ///< Units of e. Z if not given.
+    const int*    externalParticleID = nullptr; ///< Index in the arrays if not given.
+    const int*    externalParentID   = nullptr; ///< Index in the arrays if not given.
+  };
+
   BDSBunchSixTrackLink();
   virtual ~BDSBunchSixTrackLink();
 
@@ -54,11 +77,19 @@ public:
 		   int   externalParticleID,
 		   int   externalParentID);
 
+  /// Use the particles in arrays owned by the caller instead of any added ones. The
+  /// arrays are not copied and must remain valid until the particles are generated.
+  /// A particle that cannot be constructed (e.g. an unknown PDG ID) throws an exception
+  /// when it is generated. Any existing particles are cleared.
+  void SetParticleArrays(const ParticleArrays& arraysIn);
+
   /// Delete all particle objects in the bunch and clear the vector.
   void ClearParticles();
 
   /// @{ Accessor.
-  inline size_t Size() const {return particles.size();}
+  inline size_t Size() const {return (size_t)size;}
+  /// Number of particles that will be generated before looping to the start of the bunch.
+  inline G4int  NRemaining() const {return currentIndex >= size ? size : size - currentIndex;}
   inline int    CurrentExternalParticleID() const {return currentExternalParticleID;}
   inline int    CurrentExternalParentID()   const {return currentExternalParentID;}
   /// @}
@@ -73,6 +104,10 @@ public:
   virtual void UpdateIonDefinition();
   
 private:
+  /// Construct the particle at index i in the arrays, setting the current particle
+  /// definition and external IDs.
+  BDSParticleCoordsFull ParticleFromArrays(G4int i);
+
   G4int currentIndex;
   G4int currentExternalParticleID;
   G4int currentExternalParentID;
@@ -80,5 +115,8 @@ private:
 
   G4int size;         ///< Number of particles (1 counting).
   std::vector<BDSParticleExternal*> particles;
+
+  ParticleArrays         arrays;    ///< Only used if arrays.n > 0.
+  BDSParticleDefinition* arrayParticleDefinition; ///< Owned definition of current particle from arrays.
 };
 #endif
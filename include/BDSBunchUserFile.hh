@@ -32,6 +32,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "src-external/gzstream/gzstream.h"
 #endif
 
+class BDSFileOffsetIndex;
 class BDSParticleCoordsFull;
 class BDSParticleCoordsFullGlobal;
 
@@ -57,7 +58,8 @@ public:
   /// Advance to the correct event number in the file for recreation. The implementation
   /// is brute-force getting of the lines - this could be more efficient (certainly for
   /// a file that is looped over multiple times) but this is simple, clear and the time
-  /// penalty is on the order of 1 minute for ~100k events.
+  /// penalty is on the order of 1 minute for ~100k events. If distrFileIndex is used,
+  /// this seeks directly to the line instead.
   virtual void RecreateAdvanceToEvent(G4int eventOffset);
 
   /// Override base class method to find valid particle over rest mass. For a bunch file
@@ -133,8 +135,11 @@ private:
   /// Open the file, skip the nlinesIgnore, then count the number of valid lines in the file.
   /// A valid line is one that can be used for coordinates, so empty lines or commented lines
   /// are ignored from this count. This number should be the number of particle coordinate sets
-  /// we can read from the file.
+  /// we can read from the file. If an index is in use, the count is taken from it.
   G4long CountNLinesValidDataInFile();
+
+  /// Position the file at a given valid line (after nlinesIgnore) using the index.
+  void SeekToValidLine(G4long validLineIndex);
   
   /// Open the file and skip lines.
   virtual void Initialise();
@@ -143,6 +148,9 @@ private:
   /// lines. Put in a function as used in multiple places.
   void EndOfFileAction();
 
+  /// Byte offset index of the valid lines. Only possible for uncompressed files.
+  BDSFileOffsetIndex* fileIndex;
+
   G4double ffact; ///< Cache of flip factor from global constants.
   std::regex comment;
   G4bool   matchDistrFileLength;
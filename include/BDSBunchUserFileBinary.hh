@@ -0,0 +1,139 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef BDSBUNCHUSERFILEBINARY_H
+#define BDSBUNCHUSERFILEBINARY_H 
+
+#include "BDSBunchFileBased.hh"
+
+#include "G4String.hh"
+#include "G4Types.hh"
+
+#include <cstddef>
+#include <vector>
+
+class BDSParticleCoordsFull;
+class BDSParticleCoordsFullGlobal;
+
+/**
+ * @brief A bunch distribution that reads a binary columnar file of coordinates.
+ * 
+ * The file has a short text header followed by the coordinates as native doubles
+ * stored column by column. The header declares the number of rows and the columns
+ * with units using the same syntax as distrFileFormat for a userfile, e.g.
+ *
+ * @code
+ * # BDSIM binary user file
+ * version 1
+ * rows 1000000
+ * format x[mum]:xp[mrad]:y[mum]:yp[mrad]:z[cm]:E[MeV]
+ * ! binary column major doubles follow
+ * @endcode
+ *
+ * The last header line is padded with spaces so the data start at a multiple of
+ * 8 bytes. The file is memory mapped and each particle is read directly from the
+ * columns with unit factors worked out once, so there is no text parsing per
+ * particle and nlinesSkip is a simple offset, allowing each job to take its own
+ * range of rows. A file can be made from a userfile with the userfile2binary
+ * converter.
+ * 
+ * @author Laurie Nevay
+ */
+
+class BDSBunchUserFileBinary: public BDSBunchFileBased
+{
+public: 
+  BDSBunchUserFileBinary();
+  virtual ~BDSBunchUserFileBinary();
+  virtual void SetOptions(const BDSParticleDefinition* beamParticle,
+			  const GMAD::Beam& beam,
+			  const BDSBunchType& distrType,
+			  G4Transform3D beamlineTransformIn = G4Transform3D::Identity,
+			  const G4double beamlineS = 0);
+  virtual void CheckParameters();
+
+  /// Advance to the correct event number in the file for recreation. This is just
+  /// an offset in the columns.
+  virtual void RecreateAdvanceToEvent(G4int eventOffset);
+
+  /// Override base class method to find valid particle over rest mass. As for the
+  /// userfile, return one row each time and abort the event if it doesn't work.
+  virtual BDSParticleCoordsFullGlobal GetNextParticleValid(G4int maxTries);
+  
+  virtual G4bool DistributionIsFinished() const {return endOfFileReached;}
+
+  /// Get the next particle.
+  virtual BDSParticleCoordsFull GetNextParticleLocal();
+  
+  /// For this class we generally can expect a few extra particle types.
+  virtual G4bool ExpectChangingParticleType() const {return true;}
+
+  /// Header line that identifies the file type.
+  static const G4String headerIdentifier;
+  /// Last header line after which the binary data start.
+  static const G4String headerEndIdentifier;
+  
+private:
+  /// Quantity stored in a column.
+  enum class ColumnType {E, Ek, P, t, x, y, z, S, xp, yp, zp, pdgid, weight, skip};
+
+  /// Read the text header, check the file size matches and fill the column definitions.
+  void ReadHeader();
+
+  /// Parse the format string into column types and unit factors in Geant4 units.
+  void ParseFileFormat(const G4String& format);
+
+  /// Memory map the file and set the pointers to each column.
+  void MapFile();
+
+  /// Unmap the file if it is mapped.
+  void UnmapFile();
+
+  /// Open the file and check the contents.
+  virtual void Initialise();
+
+  /// Go back to the start (after nlinesSkip) if looping, else throw an exception.
+  void EndOfFileAction();
+
+  G4String distrFile;      ///< Bunch file.
+  G4String distrFilePath;  ///< Bunch file including absolute path.
+  G4long   nlinesSkip;     ///< Number of rows to skip at the start.
+  G4bool   matchDistrFileLength;
+  G4bool   endOfFileReached;
+  G4bool   anEnergyCoordinateInUse; ///< Whether Et, Ek or P are in the columns.
+  G4bool   changingParticleType;    ///< Whether the particle type is a column.
+  G4double ffact;          ///< Cache of flip factor from global constants.
+
+  G4long      nRows;       ///< Number of rows in the file.
+  G4long      currentRow;  ///< Index of the next row to read.
+  std::size_t dataOffset;  ///< Byte offset of the binary data in the file.
+  G4int       currentPDGID; ///< PDG ID of the current particle definition if from the file.
+
+  /// @{ Type, unit factor and data of each column.
+  std::vector<ColumnType>      columnTypes;
+  std::vector<G4double>        columnFactors;
+  std::vector<const G4double*> columnData;
+  /// @}
+
+  /// @{ Memory mapping.
+  void*       mappedData;
+  std::size_t mappedSize;
+  /// @}
+};
+
+#endif
@@ -0,0 +1,106 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef BDSCHECKPOINT_H
+#define BDSCHECKPOINT_H
+
+#include "G4String.hh"
+#include "G4Types.hh"
+
+class BDSBunch;
+class BDSOutput;
+class BDSOutputROOTEventHistograms;
+class BDSPrimaryGeneratorAction;
+
+/**
+ * @brief Periodic checkpoint of the run state and resumption of a run from one.
+ *
+ * Every N events, the output file written so far is made complete (see BDSOutput::Checkpoint)
+ * and the state required to continue the run is written to a separate small ROOT file. This
+ * is the number of events completed, the random number engine state at the end of the last
+ * event, the position in any event generator file and the run histograms. The checkpoint is
+ * written to a temporary file first and renamed so there is always one complete checkpoint.
+ *
+ * When resuming, the checkpoint is loaded on construction. The primary generator advances
+ * the distribution by the events completed, and at the start of the run the random number
+ * engine is restored and the run histograms of the checkpoint are added to those of the
+ * new run. The new output file therefore continues the old one exactly from the checkpoint.
+ *
+ * @author Laurie Nevay
+ */
+
+class BDSCheckpoint
+{
+public:
+  /// A checkpoint is written every everyNEventsIn events if it is greater than 0. If
+  /// resumeFileName isn't empty, that checkpoint is loaded to resume from.
+  BDSCheckpoint(const G4String& checkpointFileNameIn,
+                G4int           everyNEventsIn,
+                const G4String& resumeFileName,
+                BDSOutput*      outputIn,
+                BDSBunch*       bunchIn);
+  ~BDSCheckpoint();
+
+  /// Required to record the position in an event generator file.
+  inline void SetPrimaryGeneratorAction(const BDSPrimaryGeneratorAction* primaryGeneratorActionIn)
+  {primaryGeneratorAction = primaryGeneratorActionIn;}
+
+  /// @{ Accessor.
+  inline G4bool Resuming() const {return resuming;}
+  inline unsigned long long int NEventsResumed() const {return nEventsResumed;}
+  inline G4long DistrFileEventIndexResumed() const {return distrFileEventIndexResumed;}
+  /// @}
+
+  /// Restore the random number engine and the run histograms when resuming. To be
+  /// called at the start of the run after the output file is opened.
+  void BeginOfRun();
+
+  /// Count the event and write a checkpoint if required. To be called after the
+  /// event is filled to the output.
+  void EndOfEvent();
+
+private:
+  BDSCheckpoint() = delete;
+  BDSCheckpoint(const BDSCheckpoint&) = delete;
+  BDSCheckpoint& operator=(const BDSCheckpoint&) = delete;
+
+  /// Update the output file and write the checkpoint file.
+  void Write();
+
+  /// Load a checkpoint file to resume from.
+  void Load(const G4String& fileName);
+
+  G4String   checkpointFileName;
+  G4int      everyNEvents;
+  BDSOutput* output;
+  BDSBunch*  bunch;
+  const BDSPrimaryGeneratorAction* primaryGeneratorAction;
+  unsigned long long int nEventsThisRun; ///< Number of events completed in this run.
+
+  /// @{ State loaded from the checkpoint when resuming.
+  G4bool   resuming;
+  G4bool   resumeApplied;
+  unsigned long long int nEventsResumed;
+  G4long   distrFileEventIndexResumed;
+  G4String seedStateResumed;
+  G4String outputFileNameResumed;
+  BDSOutputROOTEventHistograms* runHistosResumed;
+  /// @}
+};
+
+#endif
@@ -54,6 +54,7 @@ class BDSBeamlineSet;
 class BDSComponentFactoryUser;
 class BDSFieldObjects;
 class BDSFieldQueryInfo;
+class BDSMapTransportSection;
 class BDSParticleDefinition;
 class BDSSamplerInfo;
 
@@ -213,6 +214,10 @@ private:
   /// Place beam line, tunnel beam line, end pieces and placements in world.
   void ComponentPlacement(G4VPhysicalVolume* worldPV);
 
+  /// Find the sections of the main beam line that can be transported with maps and
+  /// prepare the regions for the fast simulation model. Must be after placement.
+  void BuildMapTransportSections();
+
   /// Detect whether the first element has an angled face such that it might overlap
   /// with a previous element.  Only used in case of a circular machine.
   G4bool UnsuitableFirstElement(std::list<GMAD::Element>::const_iterator element);
@@ -286,6 +291,12 @@ private:
   
   std::vector<BDSFieldQueryInfo*> fieldQueries;
 
+  /// @{ Map transport sections, placements of their first elements and their regions.
+  std::vector<BDSMapTransportSection*> mapTransportSections;
+  std::map<const G4VPhysicalVolume*, const BDSMapTransportSection*> mapTransportEntries;
+  std::set<G4Region*> mapTransportRegions;
+  /// @}
+
   // for developer checks only
 #ifdef BDSCHECKUSERLIMITS
   void PrintUserLimitsSummary(const G4VPhysicalVolume* world) const;
@@ -32,6 +32,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include <string>
 #include <vector>
 
+class BDSCheckpoint;
 class BDSEventInfo;
 class BDSOutput;
 class BDSTrajectoriesToStore;
@@ -73,6 +74,9 @@ public:
   /// has already been constructed.
   inline void SetPrintModulo(G4int printModuloIn) {printModulo = printModuloIn;}
 
+  /// Register the optional checkpoint that is updated at the end of each event.
+  inline void SetCheckpoint(BDSCheckpoint* checkpointIn) {checkpoint = checkpointIn;}
+
 protected:
   /// Sift through all trajectories (if any) and mark for storage.
   BDSTrajectoriesToStore* IdentifyTrajectoriesForStorage(const G4Event* evt,
@@ -90,6 +94,7 @@ protected:
   
 private:
   BDSOutput* output;         ///< Cache of output instance. Not owned by this class.
+  BDSCheckpoint* checkpoint; ///< Optional checkpoint. Not owned by this class.
   G4bool verboseEventBDSIM;
   G4int  verboseEventStart;
   G4int  verboseEventStop;
@@ -114,6 +114,10 @@ public:
 				G4bool           penetrateToDaughterVolumes = true) const;
   
 private:
+  /// Construct the integration driver for the stepper - BDSIntegrationDriverExact for
+  /// analytical integrators if the option is turned on, G4MagInt_Driver otherwise.
+  G4MagInt_Driver* CreateDriver(G4double chordStepMinimum) const;
+
   /// The complete information required to build this field.
   const BDSFieldInfo* info;
   
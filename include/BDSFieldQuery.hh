@@ -24,7 +24,9 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "G4ThreeVector.hh"
 #include "G4Types.hh"
 
+#include <cstddef>
 #include <fstream>
+#include <string>
 #include <vector>
 
 class G4Navigator;
@@ -37,6 +39,10 @@ class G4VPhysicalVolume;
  *  Output is a BDSIM-format field map. Unique files for electric and magnetic
  *  field maps as would be required to read the field maps back into BDSIM.
  *
+ *  Points on a regular grid are evaluated in blocks. If a derived class supports
+ *  it, the field is evaluated in parallel using the number of threads in the query.
+ *  The text for each block is also formatted in parallel and written at once.
+ *
  *  @author Laurie Nevay
  */
 class BDSFieldQuery
@@ -65,6 +71,18 @@ protected:
                              G4double tGlobal,
                              G4double fieldValue[6]);
 
+  /// Whether GetFieldValueThread can be called concurrently from nThreads threads.
+  /// By default false as one navigator is used for the whole model.
+  virtual G4bool SupportsParallelQuery(G4int /*nThreads*/) const {return false;}
+
+  /// Version of GetFieldValue used when querying in parallel. threadIndex is in the
+  /// range [0, nThreads). By default just calls GetFieldValue.
+  virtual void GetFieldValueThread(const G4ThreeVector& globalXYZ,
+                                   const G4ThreeVector& globalDirection,
+                                   G4double tGlobal,
+                                   G4double fieldValue[6],
+                                   G4int    threadIndex);
+
   /// Warn the user if the fieldObject variable is use when it shouldn't be.
   virtual void CheckIfFieldObjectSpecified(const BDSFieldQueryInfo* query) const;
   
@@ -104,11 +122,33 @@ private:
   virtual void WriteFieldValue(const G4ThreeVector& xyzGlobal,
                                G4double tGlobal,
                                const G4double fieldValue[6]);
+
+  /// Write a block of points to the output file(s). xyzt has 4 values and fieldValues
+  /// 6 values per point. The text is formatted in nThreads threads.
+  virtual void WriteFieldValues(const std::vector<G4double>& xyzt,
+                                const std::vector<G4double>& fieldValues,
+                                std::size_t nPoints,
+                                G4int       nThreads);
+
+  /// Format the text lines for a range of points for either the magnetic or electric file.
+  void FormatFieldValues(const G4double* xyzt,
+                         const G4double* fieldValues,
+                         std::size_t     nPoints,
+                         G4bool          magnetic,
+                         std::string&    out) const;
+
+  /// Write a range of points as binary doubles in the same units as the text.
+  void WriteFieldValuesBinary(std::ofstream&  out,
+                              const G4double* xyzt,
+                              const G4double* fieldValues,
+                              std::size_t     nPoints,
+                              G4bool          magnetic) const;
   
   std::ofstream oFileMagnetic;
   std::ofstream oFileElectric;
   G4bool queryMagnetic;
   G4bool queryElectric;
+  G4bool binaryOutput;
   G4bool writeX;
   G4bool writeY;
   G4bool writeZ;
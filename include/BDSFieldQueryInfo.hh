@@ -104,6 +104,8 @@ public:
   
   G4bool overwriteExistingFiles;
   G4bool printTransform;
+  G4int  nThreads;     ///< Number of threads to use if the querier supports it. 0 for all available.
+  G4bool binaryOutput; ///< Write the values as binary doubles after the text header.
 
   G4String fieldObject; ///< Optional for use in interpolator.
   
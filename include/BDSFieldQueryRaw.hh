@@ -24,6 +24,8 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "G4ThreeVector.hh"
 #include "G4Types.hh"
 
+#include <vector>
+
 class BDSFieldQueryInfo;
 class G4Field;
 
@@ -44,6 +46,11 @@ public:
   /// Query the field in the Geant4 model according to information in query.
   void QueryFieldRaw(G4Field* field,
 		     const BDSFieldQueryInfo* query);
+
+  /// Query with one independent instance of the same field per thread. The query
+  /// is done in parallel with up to fields.size() threads. None are owned.
+  void QueryFieldRaw(const std::vector<G4Field*>& fieldsIn,
+		     const BDSFieldQueryInfo*     query);
   
 protected:
   /// Get the electric and magnetic field at the specified coordinates. The navigator requires
@@ -53,6 +60,17 @@ protected:
 			     const G4ThreeVector& globalDirection,
 			     G4double tGlobal,
 			     G4double fieldValue[6]);
+
+  /// Supported if there is a field instance for each thread as the field objects
+  /// may use internal temporary variables.
+  virtual G4bool SupportsParallelQuery(G4int nThreads) const;
+
+  /// Use the field instance for this thread.
+  virtual void GetFieldValueThread(const G4ThreeVector& globalXYZ,
+				   const G4ThreeVector& globalDirection,
+				   G4double tGlobal,
+				   G4double fieldValue[6],
+				   G4int    threadIndex);
   
   /// Do the opposite for this class as it's only used for the interpolator and we want
   /// fieldObject to be specified.
@@ -65,6 +83,7 @@ private:
   /// @}
 
   G4Field* field; ///< The field object to query.
+  std::vector<G4Field*> fields; ///< One instance per thread.
 };
 
 #endif
@@ -0,0 +1,109 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef BDSFILEOFFSETINDEX_H
+#define BDSFILEOFFSETINDEX_H
+
+#include "G4String.hh"
+#include "G4Types.hh"
+
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Byte offset index of the records in a line based text file.
+ *
+ * A record is any line for which the predicate supplied returns true, e.g. an
+ * 'E' line of a HepMC ascii file or a valid coordinate line of a user bunch file.
+ * The file is scanned once at the text level without parsing and the byte offset
+ * and line number of every stride'th record is kept. Counting is then free and
+ * a stream can be positioned at any record by seeking to the nearest preceding
+ * entry and reading at most stride - 1 records further.
+ *
+ * If requested, the index is stored in a sidecar file next to the original
+ * ("<file>.bdsidx") and is reused as long as the file size, modification time
+ * and key match, so many jobs using the same large file only pay for the scan
+ * once. The sidecar file is written to a temporary name and then renamed so
+ * that concurrent jobs never see a partially written index. If it cannot be
+ * written, the index is just kept in memory.
+ *
+ * @author Laurie Nevay
+ */
+
+class BDSFileOffsetIndex
+{
+public:
+  /// Function to decide whether a line is the start of a record.
+  typedef std::function<G4bool(const std::string&)> RecordPredicate;
+
+  /// The key should describe the predicate and nLinesIgnore so that an index
+  /// built with different settings for the same file is not reused.
+  BDSFileOffsetIndex(const G4String& filePathIn,
+                     const G4String& keyIn,
+                     RecordPredicate isRecordIn,
+                     G4long          nLinesIgnoreIn = 0,
+                     G4bool          useSidecarFileIn = true,
+                     G4long          strideIn = 100);
+  ~BDSFileOffsetIndex(){;}
+
+  /// Total number of records in the file.
+  inline G4long NRecords() const {return nRecords;}
+
+  /// Position the stream so the next line read is the first line of record index
+  /// recordIndex. The stream must be opened on the same file. Returns the number
+  /// of lines in the file before this record. Throws an exception if the index is
+  /// beyond the number of records.
+  G4long SeekToRecord(std::istream& stream, G4long recordIndex) const;
+
+  /// Name of the sidecar file used for a given file.
+  static G4String SidecarFileName(const G4String& filePath);
+
+private:
+  /// Read the size and modification time of the file. Throws an exception if
+  /// the file cannot be accessed.
+  void StatFile();
+
+  /// Try to load the sidecar file. Returns false if it doesn't exist or doesn't
+  /// match the current file.
+  G4bool ReadSidecar();
+
+  /// Scan the file and fill the offsets.
+  void Build();
+
+  /// Write the sidecar file. Failure is not an error.
+  void WriteSidecar() const;
+
+  G4String        filePath;
+  G4String        key;
+  RecordPredicate isRecord;
+  G4long          nLinesIgnore;
+  G4bool          useSidecarFile;
+  G4long          stride;
+  G4long          nRecords;
+  long long int   fileSize;
+  long long int   fileModificationTime;
+
+  /// @{ Byte offset and line number of every stride'th record.
+  std::vector<long long int> offsets;
+  std::vector<long long int> lineNumbers;
+  /// @}
+};
+
+#endif
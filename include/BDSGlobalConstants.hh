@@ -103,6 +103,13 @@ public:
   inline G4bool   OutputFileNameSet()      const {return G4bool  (options.HasBeenSet("outputFileName"));}
   inline BDSOutputType OutputFormat()      const {return outputType;}
   inline G4int    OutputCompressionLevel() const {return G4int   (options.outputCompressionLevel);}
+  inline G4String OutputCompressionAlgorithm() const {return G4String(options.outputCompressionAlgorithm);}
+  inline G4String OutputEventCompressionAlgorithm() const {return G4String(options.outputEventCompressionAlgorithm);}
+  inline G4int    OutputEventCompressionLevel() const {return G4int (options.outputEventCompressionLevel);}
+  inline G4int    OutputBasketSize()       const {return G4int   (options.outputBasketSize);}
+  inline G4long   OutputAutoFlush()        const {return G4long  (options.outputAutoFlush);}
+  inline G4bool   OutputAsynchronous()     const {return G4bool  (options.outputAsynchronous);}
+  inline G4int    OutputCompressionThreads() const {return G4int (options.outputCompressionThreads);}
   inline G4bool   Survey()                 const {return G4bool  (options.survey);}
   inline G4String SurveyFileName()         const {return G4String(options.surveyFileName);}
   inline G4bool   Batch()                  const {return G4bool  (options.batch);}
@@ -130,6 +137,10 @@ public:
   inline G4bool   WriteSeedState()         const {return G4bool  (options.writeSeedState);}
   inline G4bool   UseASCIISeedState()      const {return G4bool  (options.useASCIISeedState);}
   inline G4String SeedStateFileName()      const {return G4String(options.seedStateFileName);}
+  inline G4int    CheckpointEveryNEvents() const {return G4int   (options.checkpointEveryNEvents);}
+  inline G4String CheckpointFileName()     const {return G4String(options.checkpointFileName);}
+  inline G4String ResumeFromCheckpoint()   const {return G4String(options.resumeFromCheckpoint);}
+  inline G4bool   Resume()                 const {return !ResumeFromCheckpoint().empty();}
   inline G4String BDSIMPath()              const {return G4String(options.bdsimPath);}
   inline G4int    NGenerate()              const {return numberToGenerate;}
   inline G4bool   NGenerateSet()           const {return G4bool  (options.HasBeenSet("ngenerate"));}
@@ -176,6 +187,10 @@ public:
   inline G4bool   ProdCutElectronsSet()      const {return G4bool  (options.HasBeenSet("prodCutElectrons"));}
   inline G4bool   ProdCutPositronsSet()      const {return G4bool  (options.HasBeenSet("prodCutPositrons"));}
   inline G4bool   ProdCutProtonsSet()        const {return G4bool  (options.HasBeenSet("prodCutProtons"));}
+  inline G4String RegionCutProfileFile()     const {return G4String(options.regionCutProfileFile);}
+  inline G4double RegionCutProfileTolerance() const {return G4double(options.regionCutProfileTolerance);}
+  inline G4String RegionCutProfileScoringRegions() const {return G4String(options.regionCutProfileScoringRegions);}
+  inline G4bool   UseRegionCutProfile()      const {return !RegionCutProfileFile().empty();}
   inline G4double NeutronTimeLimit()         const {return G4double(options.neutronTimeLimit)*CLHEP::s;}
   inline G4double NeutronKineticEnergyLimit()const {return G4double(options.neutronKineticEnergyLimit)*CLHEP::GeV;}
   inline G4bool   UseLENDGammaNuclear()      const {return G4bool  (options.useLENDGammaNuclear);}
@@ -299,6 +314,11 @@ public:
   inline G4bool   StopSecondaries()          const {return G4bool  (options.stopSecondaries);}
   inline G4bool   KillNeutrinos()            const {return G4bool  (options.killNeutrinos);}
   inline G4bool   KilledParticlesMassAddedToEloss() const {return G4bool(options.killedParticlesMassAddedToEloss);}
+  inline G4double TrackingEnvelopeRadius()   const {return G4double(options.trackingEnvelopeRadius*CLHEP::m);}
+  inline G4double TrackingEnvelopeSMin()     const {return G4double(options.trackingEnvelopeSMin*CLHEP::m);}
+  inline G4double TrackingEnvelopeSMax()     const {return G4double(options.trackingEnvelopeSMax*CLHEP::m);}
+  inline G4bool   TrackingEnvelopeRecord()   const {return G4bool  (options.trackingEnvelopeRecord);}
+  inline G4bool   UseTrackingEnvelope()      const {return TrackingEnvelopeRadius() > 0 || TrackingEnvelopeSMax() > TrackingEnvelopeSMin();}
   inline G4double MinimumRadiusOfCurvature() const {return G4double(options.minimumRadiusOfCurvature*CLHEP::m);}
   inline G4double ScintYieldFactor()         const {return G4double(options.scintYieldFactor);}
   inline G4int    MaximumPhotonsPerStep()    const {return G4int   (options.maximumPhotonsPerStep);}
@@ -316,6 +336,12 @@ public:
   inline G4bool   AutoColourWorldGeometryFile()  const {return G4bool  (options.autoColourWorldGeometryFile);}
   inline G4String ImportanceWorldGeometryFile()  const {return G4String(options.importanceWorldGeometryFile);}
   inline G4String ImportanceVolumeMapFile()      const {return G4String(options.importanceVolumeMap);}
+  inline G4String WeightWindowFile()             const {return G4String(options.weightWindowFile);}
+  inline G4double WeightWindowUpperLimitFactor() const {return G4double(options.weightWindowUpperLimitFactor);}
+  inline G4double WeightWindowSurvivalFactor()   const {return G4double(options.weightWindowSurvivalFactor);}
+  inline G4int    WeightWindowMaximumSplit()     const {return G4int   (options.weightWindowMaximumSplit);}
+  inline G4String WeightWindowPlaceOfAction()    const {return G4String(options.weightWindowPlaceOfAction);}
+  inline G4bool   WeightWindowRouletteSecondaries() const {return G4bool(options.weightWindowRouletteSecondaries);}
   inline G4double WorldVolumeMargin()        const {return G4double(options.worldVolumeMargin*CLHEP::m);}
   inline G4bool   YokeFields()               const {return G4bool  (options.yokeFields);}
   inline G4bool   YokeFieldsMatchLHCGeometry()const{return G4bool  (options.yokeFieldsMatchLHCGeometry);}
@@ -356,6 +382,8 @@ public:
   inline G4double DEThresholdForScattering() const {return G4double(options.dEThresholdForScattering)*CLHEP::GeV;}
   inline G4String PTCOneTurnMapFileName()    const {return G4String (options.ptcOneTurnMapFileName);}
   inline G4double BackupStepperMomLimit()    const {return G4double(options.backupStepperMomLimit)*CLHEP::rad;}
+  inline G4bool   ExactIntegrationDriver()   const {return G4bool  (options.exactIntegrationDriver);}
+  inline G4bool   MapTransport()             const {return G4bool  (options.mapTransport);}
 
   /// @{ options that require some implementation.
   G4bool StoreTrajectoryTransportationSteps() const;
@@ -401,6 +429,9 @@ public:
   /// Is importance sampling being used
   inline G4bool UseImportanceSampling() const{return !ImportanceWorldGeometryFile().empty();}
 
+  /// Whether weight windows rather than cell importance values are used in the importance world.
+  inline G4bool UseWeightWindows() const {return UseImportanceSampling() && !WeightWindowFile().empty();}
+
 private:  
   /// Number of particles to generate can be set from outside (by e.g. BDSBunchPtc)
   G4int numberToGenerate;
@@ -0,0 +1,65 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef BDSHITSCOLLECTIONSCORERMESH_H
+#define BDSHITSCOLLECTIONSCORERMESH_H
+
+#include "G4String.hh"
+#include "G4Types.hh"
+#include "G4VHitsCollection.hh"
+
+class BDSScorerMeshStorage;
+
+/**
+ * @brief Hits collection that presents a scorer's mesh storage to the event.
+ *
+ * Geant4 deletes the hits collections of each event, so this is a light
+ * view of the BDSScorerMeshStorage that is owned by and reused by the
+ * primitive scorer. The storage is only valid until the start of the next
+ * event.
+ *
+ * @author Laurie Nevay
+ */
+
+class BDSHitsCollectionScorerMesh: public G4VHitsCollection
+{
+public:
+  BDSHitsCollectionScorerMesh(const G4String&             detectorName,
+			      const G4String&             collectionName,
+			      const BDSScorerMeshStorage* storageIn,
+			      G4bool                      rootBinIndexingIn);
+  virtual ~BDSHitsCollectionScorerMesh(){;}
+
+  /// Number of bins with a value in this event.
+  virtual size_t GetSize() const override;
+
+  /// Accessor.
+  inline const BDSScorerMeshStorage* Storage() const {return storage;}
+
+  /// Whether the storage is indexed by the ROOT global bin of the equivalent TH3D
+  /// (including under and overflow bins) or by BDSHistBinMapper's global index.
+  inline G4bool RootBinIndexing() const {return rootBinIndexing;}
+
+private:
+  BDSHitsCollectionScorerMesh() = delete;
+
+  const BDSScorerMeshStorage* storage; ///< Not owned.
+  G4bool rootBinIndexing;
+};
+
+#endif
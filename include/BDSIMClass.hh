@@ -20,12 +20,15 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #define BDSIMCLASS_H
 
 class BDSBunch;
+class BDSCheckpoint;
 class BDSComponentConstructor;
 class BDSComponentFactoryUser;
 class BDSDetectorConstruction;
 class BDSGlobalConstants;
 class BDSOutput;
 class BDSParser;
+class BDSRegionCutProfiler;
+class BDSTrackingEnvelope;
 class BDSRunManager;
 class G4VModularPhysicsList;
 
@@ -106,6 +109,9 @@ private:
   BDSComponentFactoryUser* userComponentFactory; ///< Optional user registered component factory.
   G4VModularPhysicsList* userPhysicsList;        ///< Optional user registered physics list.
   BDSDetectorConstruction* realWorld;
+  BDSRegionCutProfiler*    regionCutProfiler;      ///< Optional pilot run profiler of regions.
+  BDSTrackingEnvelope*     trackingEnvelope;       ///< Optional envelope to kill tracks outside of.
+  BDSCheckpoint*           checkpoint;             ///< Optional checkpoint / resumption of the run.
   /// @}
 };
 
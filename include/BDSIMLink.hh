@@ -26,10 +26,12 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include <vector>
 
 class BDSBunch;
+class BDSBunchSixTrackLink;
 class BDSComponentConstructor;
 class BDSComponentFactoryUser;
 class BDSLinkComponent;
 class BDSLinkDetectorConstruction;
+class BDSLinkPrimaryGeneratorAction;
 class BDSOutput;
 class BDSParser;
 class BDSParticleCoordsFull;
@@ -51,6 +53,11 @@ class G4VModularPhysicsList;
  * bds->Initialise(argc, argv);
  * bds->TrackThin(...)
  *
+ * Many particles may be tracked in one event by setting SetPrimariesPerEvent. Each
+ * returned particle is still attributed to the external particle it descends from.
+ * The arrays of particles may be passed in and out with SetParticles and
+ * GetReturnedParticles rather than one call per particle.
+ *
  * @author Laurie Nevay
  */
 
@@ -84,6 +91,52 @@ public:
   /// from the standard input e.g. the executable option ngenerate and then the one specified
   /// in the input gmad files as an option.
   void BeamOn(int nGenerate=-1);
+
+  /// Number of particles from the link bunch to inject as primaries in each event.
+  /// 1 (default) is one particle per event. 0 or less puts the whole bunch in one event.
+  void SetPrimariesPerEvent(int primariesPerEventIn);
+  inline int PrimariesPerEvent() const {return primariesPerEvent;}
+
+  /// Number of events required to track the whole link bunch once with the current
+  /// number of primaries per event. Use as the argument to BeamOn.
+  int NEventsForBunch() const;
+
+  /// Use n particles from arrays owned by the caller as the link bunch, replacing any
+  /// particles in it. The arrays are not copied so must remain valid until BeamOn has
+  /// returned. Units are m, rad, GeV and s. The arrays t, ionA, ionZ, ionCharge (units
+  /// of e), externalParticleID and externalParentID may be nullptr in which case 0 is
+  /// used or for the IDs the index in the arrays. Particles that cannot be constructed
+  /// (e.g. an unknown PDG ID) are skipped when they are generated.
+  void SetParticles(int           n,
+                    const double* x,
+                    const double* y,
+                    const double* xp,
+                    const double* yp,
+                    const double* totalEnergy,
+                    const int*    pdgID,
+                    const double* t                  = nullptr,
+                    const int*    ionA               = nullptr,
+                    const int*    ionZ               = nullptr,
+                    const double* ionCharge          = nullptr,
+                    const int*    externalParticleID = nullptr,
+                    const int*    externalParentID   = nullptr);
+
+  /// Write the returned particles (sampler link hits) into arrays owned by the caller
+  /// with at least nMax entries. Units are as for SetParticles. Any array except x may
+  /// be nullptr to skip that variable. Returns the number of particles written.
+  int GetReturnedParticles(int     nMax,
+                           double* x,
+                           double* y,
+                           double* xp,
+                           double* yp,
+                           double* totalEnergy,
+                           int*    pdgID,
+                           double* t                  = nullptr,
+                           int*    ionA               = nullptr,
+                           int*    ionZ               = nullptr,
+                           double* ionCharge          = nullptr,
+                           int*    externalParticleID = nullptr,
+                           int*    externalParentID   = nullptr) const;
   
   void SelectLinkElement(const std::string& elementName, bool debug = false);
   void SelectLinkElement(int index, bool debug = false);
@@ -133,6 +186,9 @@ private:
   /// The main function where everything is constructed.
   int Initialise(double minimumKineticEnergy = 0,
                  bool   protonsAndIonsOnly   = true);
+
+  /// Access the bunch as a link bunch. Throws an exception if it isn't one.
+  BDSBunchSixTrackLink* LinkBunch() const;
   
   bool   ignoreSIGINT;         ///< For cmake testing.
   bool   usualPrintOut;        ///< Whether to allow the usual cout output.
@@ -148,6 +204,7 @@ private:
   G4RunManager* runManager;
   BDSLinkDetectorConstruction* construction;
   BDSLinkRunAction*  runAction;
+  BDSLinkPrimaryGeneratorAction* primaryGeneratorAction;
   /// @}
   
   std::vector<BDSParticleExternal*> externalParticles;
@@ -155,6 +212,7 @@ private:
   std::map<int, int>                linkIDToBeamlineIndex;
   int                               currentElementIndex; ///< Element to track in.
   G4VModularPhysicsList*            userPhysicsList;     ///< Optional user registered physics list.
+  int                               primariesPerEvent;   ///< Number of link bunch particles per event.
 };
 
 #endif
@@ -0,0 +1,108 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef BDSINTEGRATIONDRIVEREXACT_H
+#define BDSINTEGRATIONDRIVEREXACT_H
+
+#include "G4MagIntegratorDriver.hh"
+#include "G4String.hh"
+#include "G4Types.hh"
+#include "G4Version.hh"
+
+#include <vector>
+
+class G4FieldTrack;
+class G4MagIntegratorStepper;
+
+/**
+ * @brief Integration driver that takes the whole requested step for analytical integrators.
+ *
+ * The BDSIM thick magnet integrators (e.g. quadrupole, solenoid, dipole) solve the
+ * motion exactly for paraxial particles, so the error-controlled sub-stepping and
+ * chord iterations of G4MagInt_Driver designed for Runge-Kutta steppers only repeat
+ * work. This driver calls the stepper once for the whole step and accepts the result
+ * if the error it reports is within the requested relative error and the distance of
+ * the chord from the curve is within the miss distance. Otherwise, (e.g. when the
+ * integrator used its backup stepper for a non-paraxial particle) the step is repeated
+ * with the usual G4MagInt_Driver algorithm.
+ *
+ * The number of whole steps and of steps that fell back are counted per driver and
+ * can be printed for all drivers of this thread with PrintStatistics().
+ *
+ * Requires Geant4 V10.6 onwards where the driver decides the chord limited step.
+ *
+ * @author Laurie Nevay
+ */
+
+class BDSIntegrationDriverExact: public G4MagInt_Driver
+{
+public:
+  BDSIntegrationDriverExact(G4double                hminimum,
+                            G4MagIntegratorStepper* stepper,
+                            G4int                   numberOfComponents = 6);
+  virtual ~BDSIntegrationDriverExact();
+
+#if G4VERSION_NUMBER > 1059
+  /// Take the whole step in one stepper call if accurate enough.
+  virtual G4double AdvanceChordLimited(G4FieldTrack& track,
+                                       G4double      stepMax,
+                                       G4double      epsStep,
+                                       G4double      chordDistance) override;
+
+  /// Take the whole step in one stepper call if accurate enough.
+  virtual G4bool AccurateAdvance(G4FieldTrack& track,
+                                 G4double      hstep,
+                                 G4double      eps,
+                                 G4double      hinitial = 0) override;
+#endif
+
+  /// Name used for print out - typically the volume the field is attached to.
+  inline void SetName(const G4String& nameIn) {name = nameIn;}
+  inline const G4String& Name() const {return name;}
+
+  /// @{ Accessor.
+  inline G4long NStepsWhole()    const {return nStepsWhole;}
+  inline G4long NStepsFallback() const {return nStepsFallback;}
+  /// @}
+
+  /// Print the number of steps of each driver of this thread and the total
+  /// number per second of the duration given.
+  static void PrintStatistics(G4double duration);
+
+  /// Reset the counters of each driver of this thread.
+  static void ResetStatistics();
+
+private:
+  BDSIntegrationDriverExact() = delete;
+
+  /// Try the whole step with one call to the stepper. Returns false and leaves the
+  /// track unchanged if the error or the chord distance are too large.
+  G4bool WholeStep(G4FieldTrack& track,
+                   G4double      hstep,
+                   G4double      eps,
+                   G4double      chordDistance);
+
+  G4String name;
+  G4long   nStepsWhole;
+  G4long   nStepsFallback;
+
+  /// All drivers constructed in this thread.
+  static G4ThreadLocal std::vector<BDSIntegrationDriverExact*>* drivers;
+};
+
+#endif
@@ -61,6 +61,10 @@ namespace BDS
 {
   /// Function that determines enum from string (case-insensitive).
   BDSIntegratorType DetermineIntegratorType(G4String integratorType);
+
+  /// Whether the integrator is one of the BDSIM thick element ones that solves the
+  /// motion analytically (for paraxial particles) so doesn't need sub-stepping.
+  G4bool IntegratorIsAnalytical(BDSIntegratorType integratorType);
 }
 
 #endif
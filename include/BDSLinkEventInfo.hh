@@ -23,8 +23,15 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "globals.hh" // geant4 types / globals
 
+#include <vector>
+
 /**
  * @brief Simple extension to cache extra variables through an event.
+ *
+ * When more than one external particle is injected as a primary in the same
+ * event, the external IDs of each primary are kept in order along with the
+ * index of the primary each track descends from, so that returned particles
+ * can be attributed to their external parent.
  * 
  * @author Laurie Nevay
  */
@@ -34,14 +41,36 @@ class BDSLinkEventInfo: public BDSEventInfo
 public:
   BDSLinkEventInfo():
     externalParticleIDofPrimary(0),
-    externalParentIDofPrimary(0)
+    externalParentIDofPrimary(0),
+    nPrimariesRegistered(0)
   {;}
   virtual ~BDSLinkEventInfo(){;}
 
-  void Flush() override {info->Flush(); externalParticleIDofPrimary=0; externalParentIDofPrimary=0;}
+  void Flush() override;
+
+  /// Append the external IDs of a primary in the order the vertices are generated.
+  void AddPrimary(G4int externalParticleID, G4int externalParentID);
+
+  /// Record the primary a track descends from. Must be called for every new track
+  /// in the order they are created (i.e. from the stacking action).
+  void RegisterTrack(G4int trackID, G4int parentID);
+
+  /// Index of the primary a track descends from or -1 if unknown.
+  G4int PrimaryIndex(G4int trackID) const;
+
+  inline G4int NPrimaries() const {return (G4int)externalParticleIDs.size();}
 
   G4int externalParticleIDofPrimary;
   G4int externalParentIDofPrimary;
+
+  /// @{ External IDs of each primary in the event in generation order.
+  std::vector<G4int> externalParticleIDs;
+  std::vector<G4int> externalParentIDs;
+  /// @}
+
+private:
+  G4int nPrimariesRegistered;
+  std::vector<G4int> primaryIndexOfTrack; ///< Indexed by track ID.
 };
 
 #endif
@@ -24,6 +24,8 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "G4VUserPrimaryGeneratorAction.hh"
 
 class BDSBunch;
+class BDSBunchSixTrackLink;
+class BDSLinkEventInfo;
 class BDSLinkDetectorConstruction;
 class BDSOutputLoader;
 class BDSPTCOneTurnMap;
@@ -51,14 +53,26 @@ public:
 
   /// Set the world extent that particle coordinates will be checked against.
   inline void SetWorldExtent(const BDSExtent worldExtentIn) {worldExtent = worldExtentIn;}
+
+  /// Set the number of particles from a link bunch to inject as primaries in one event.
+  /// 1 (default) is one particle per event. 0 or less means all remaining particles.
+  inline void SetPrimariesPerEvent(G4int primariesPerEventIn) {primariesPerEvent = primariesPerEventIn;}
+  inline G4int PrimariesPerEvent() const {return primariesPerEvent;}
+  
+private:
+  /// Generate one primary vertex from the next particle in the bunch. Returns false
+  /// if the particle is not valid in which case no vertex is added.
+  G4bool GeneratePrimary(G4Event* anEvent,
+                         BDSLinkEventInfo* eventInfo,
+                         BDSBunchSixTrackLink* bunchSTL);
   
-private:  
   
   BDSBunch* bunch;                ///< BDSIM particle generator. 
   int*      currentElementIndex;  ///< External integer for which element to track in.
   BDSLinkDetectorConstruction* construction; ///< Cache of detector construction for link registry of transforms.
   G4bool    debug;
   G4ParticleGun* particleGun;     ///< Geant4 particle gun that creates single particles.
+  G4int     primariesPerEvent;    ///< Number of link bunch particles per event.
   
   /// World extent that particle coordinates are checked against to ensure they're inside it.
   BDSExtent worldExtent;
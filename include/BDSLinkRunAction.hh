@@ -23,6 +23,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "G4Types.hh"
 #include "G4UserRunAction.hh"
 
+class BDSLinkEventInfo;
 class G4Run;
 
 /**
@@ -45,6 +46,12 @@ public:
 		              G4int externalParentID,
 		              const BDSHitsCollectionSamplerLink* hits);
 
+  /// Append hits from an event with several primaries where each hit is attributed
+  /// to the external particle its primary ancestor was created from.
+  void AppendHits(G4int currentEventIndex,
+                  const BDSLinkEventInfo* eventInfo,
+                  const BDSHitsCollectionSamplerLink* hits);
+
   BDSHitsCollectionSamplerLink* SamplerHits() const {return allHits;}
   void ClearSamplerHits() {delete allHits; allHits = nullptr;}
 
@@ -54,6 +61,14 @@ public:
   inline void SetMaximumExternalParticleID(G4int maxExtPartID) {maximumExternalParticleID = maxExtPartID;}
   
 private:
+  /// Copy a hit into allHits for the current event. If it is a primary, it takes the
+  /// external IDs given, else it is a new secondary with a new external ID and the
+  /// external particle ID given as its parent.
+  void AppendHit(const BDSHitSamplerLink* hitIn,
+                 G4int currentEventIndex,
+                 G4int externalParticleID,
+                 G4int externalParentID);
+
   BDSHitsCollectionSamplerLink* allHits;
   G4int nSecondariesToReturn;
   G4int nPrimariesToReturn;
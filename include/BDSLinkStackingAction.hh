@@ -25,6 +25,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include <set>
 
 class BDSGlobalConstants;
+class BDSLinkEventInfo;
 class G4Track;
 
 /**
@@ -47,6 +48,10 @@ public:
   /// the even won't conserve energy with the stopSecondaries on.
   virtual G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track* aTrack);
 
+  /// Cache the link event information if the event has more than one primary so
+  /// that the primary ancestor of each track can be recorded.
+  virtual void PrepareNewEvent();
+
   static G4double kineticEnergyKilled;
 
 private:
@@ -57,6 +62,7 @@ private:
   G4bool emptyPDGIDs;
   G4bool protonsAndIonsOnly;
   G4double minimumEK;       ///< Minimum kinetic energy to generate a hit for.
+  BDSLinkEventInfo* eventInfo; ///< Event information of a multi-primary event, else nullptr.
  };
 
 #endif
@@ -59,6 +59,7 @@ public:
   virtual ~BDSMagnet();
   
   inline const BDSMagnetStrength* MagnetStrength() const {return vacuumFieldInfo ? vacuumFieldInfo->MagnetStrength() : nullptr;}
+  inline const BDSFieldInfo* VacuumFieldInfo() const {return vacuumFieldInfo;}
 
   /// @ { Delete existing field info and replace.
   void SetOuterField(BDSFieldInfo* outerFieldInfoIn);
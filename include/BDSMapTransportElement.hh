@@ -0,0 +1,121 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef BDSMAPTRANSPORTELEMENT_H
+#define BDSMAPTRANSPORTELEMENT_H
+
+#include "BDSBeamPipeType.hh"
+
+#include "G4Types.hh"
+
+/**
+ * @brief Transverse coordinates in the curvilinear frame of the beam line.
+ *
+ * x and y are offsets from the reference trajectory and xp and yp the
+ * unit momentum components. pathLength is the length travelled so far.
+ */
+
+struct BDSMapTransportCoords
+{
+  G4double x          = 0;
+  G4double xp         = 0;
+  G4double y          = 0;
+  G4double yp         = 0;
+  G4double pathLength = 0;
+};
+
+/**
+ * @brief Thick lens linear transfer map of a single drift, quadrupole or sector bend.
+ *
+ * The map is the hard edge solution of the linear equations of motion, as used by the
+ * BDSIM matrix integrators, evaluated for the rigidity of each particle so the
+ * focusing and dispersion are correct for any momentum (chromatic) but the transverse
+ * motion is linear. Magnets are split into slices and the aperture is checked at the
+ * end of each, so a particle that would hit the aperture inside the element is found.
+ * A drift is a single slice as a straight line can't leave a convex aperture between
+ * two points that are inside it.
+ *
+ * @author Laurie Nevay
+ */
+
+class BDSMapTransportElement
+{
+public:
+  /// Curvature is of the reference trajectory (1/length) and field the dipole
+  /// field. k1 is the quadrupole strength (1/length^2) w.r.t. designBRho. The
+  /// aperture parameters are as in BDSBeamPipeInfo.
+  BDSMapTransportElement(G4double        arcLengthIn,
+			 G4double        curvatureIn,
+			 G4double        fieldIn,
+			 G4double        k1In,
+			 G4double        designBRhoIn,
+			 BDSBeamPipeType apertureTypeIn,
+			 G4double        aper1In,
+			 G4double        aper2In,
+			 G4double        aper3In,
+			 G4double        aper4In,
+			 G4double        aperOffsetXIn = 0,
+			 G4double        aperOffsetYIn = 0);
+  ~BDSMapTransportElement(){;}
+
+  /// Transport the coordinates from the start to the end of the element for a
+  /// particle with rigidity brho (signed with the charge). Returns false if the
+  /// particle is outside the aperture at the end of any slice, in which case the
+  /// coordinates are undefined.
+  G4bool Transport(BDSMapTransportCoords& coords,
+		   G4double               brho) const;
+
+  /// Whether a transverse position is inside the aperture.
+  G4bool InsideAperture(G4double x,
+			G4double y) const;
+
+  /// Whether the aperture shape is one that InsideAperture can test.
+  static G4bool ApertureSupported(BDSBeamPipeType apertureTypeIn);
+
+  inline G4double ArcLength() const {return arcLength;}
+
+  /// Maximum length of a slice in a magnet.
+  static const G4double maximumSliceLength;
+
+private:
+  BDSMapTransportElement() = delete;
+
+  /// Transport one plane through length l for u'' + K u = f.
+  static void Propagate(G4double& u,
+			G4double& up,
+			G4double  K,
+			G4double  f,
+			G4double  l);
+
+  G4double        arcLength;
+  G4double        curvature;  ///< Of the reference trajectory.
+  G4double        field;
+  G4double        k1;
+  G4double        designBRho;
+  G4int           nSlices;
+  G4double        sliceLength;
+  BDSBeamPipeType apertureType;
+  G4double        aper1;
+  G4double        aper2;
+  G4double        aper3;
+  G4double        aper4;
+  G4double        aperOffsetX;
+  G4double        aperOffsetY;
+};
+
+#endif
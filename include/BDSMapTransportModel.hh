@@ -0,0 +1,82 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef BDSMAPTRANSPORTMODEL_H
+#define BDSMAPTRANSPORTMODEL_H
+
+#include "BDSMapTransportSection.hh"
+
+#include "G4String.hh"
+#include "G4Types.hh"
+#include "G4VFastSimulationModel.hh"
+
+#include <map>
+
+class G4FastStep;
+class G4FastTrack;
+class G4ParticleDefinition;
+class G4Region;
+class G4VPhysicalVolume;
+
+/**
+ * @brief Fast simulation model that moves primaries through vacuum sections with maps.
+ *
+ * The model is attached to the region of the first element of each section. It
+ * is triggered for a primary that has just crossed into a placement of the first
+ * element of a section. The particle is transported through the section with the
+ * linear maps of BDSMapTransportSection and, if it stays inside the aperture, moved
+ * to the end of the section. If a loss is predicted, it is moved to shortly before
+ * the loss instead and tracked normally from there. The track is suspended by the
+ * fast simulation process, so it is relocated in the geometry and continues as the
+ * same track. Its energy is unchanged and the time is advanced by the path length.
+ *
+ * Nothing happens in the vacuum of a section, so this should only be used where
+ * interactions with the residual gas, synchrotron radiation and decay in flight
+ * (unstable particles are excluded) don't matter.
+ *
+ * @author Laurie Nevay
+ */
+
+class BDSMapTransportModel: public G4VFastSimulationModel
+{
+public:
+  /// The map of placements of the first element of each section is not owned.
+  BDSMapTransportModel(const G4String& modelName,
+		       G4Region*       envelope,
+		       const std::map<const G4VPhysicalVolume*, const BDSMapTransportSection*>* sectionEntriesIn);
+  virtual ~BDSMapTransportModel(){;}
+
+  /// Charged and stable particles.
+  virtual G4bool IsApplicable(const G4ParticleDefinition& particle);
+
+  /// Whether the track is a primary entering a section that it can be transported
+  /// through. The result is cached for DoIt.
+  virtual G4bool ModelTrigger(const G4FastTrack& fastTrack);
+
+  /// Move the track to the result of ModelTrigger.
+  virtual void DoIt(const G4FastTrack& fastTrack,
+		    G4FastStep&        fastStep);
+
+private:
+  BDSMapTransportModel() = delete;
+
+  const std::map<const G4VPhysicalVolume*, const BDSMapTransportSection*>* sectionEntries;
+  BDSMapTransportResult result; ///< Cache of the last triggered transport.
+};
+
+#endif
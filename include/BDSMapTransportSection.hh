@@ -0,0 +1,118 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef BDSMAPTRANSPORTSECTION_H
+#define BDSMAPTRANSPORTSECTION_H
+
+#include "BDSMapTransportElement.hh"
+
+#include "G4RotationMatrix.hh"
+#include "G4String.hh"
+#include "G4ThreeVector.hh"
+#include "G4Types.hh"
+
+#include <vector>
+
+class BDSBeamline;
+class BDSBeamlineElement;
+
+/**
+ * @brief Result of transporting a particle through a map transport section.
+ */
+
+struct BDSMapTransportResult
+{
+  G4int         nElements  = 0; ///< Number of elements the particle is moved past.
+  G4ThreeVector position;       ///< Global position.
+  G4ThreeVector direction;      ///< Global unit momentum direction.
+  G4double      pathLength = 0;
+};
+
+/**
+ * @brief A contiguous section of the beam line that can be transported with maps.
+ *
+ * Only drifts, quadrupoles and sector bends (no pole face angles, fringe or k1) with
+ * no tilt, offset or field modulation and an aperture shape that can be tested
+ * are included. A section ends after an element with a sampler so that the sampler
+ * is still used and samplers inside a section are never skipped.
+ *
+ * A particle is transported from the entrance plane of the first element. If it
+ * stays inside the aperture, it is moved to just before the end of the section. If
+ * a loss is predicted in an element, it is moved to the end of the element two
+ * before that one, so that it is fully tracked for at least one element before the
+ * loss. The result is placed slightly upstream of the exit plane so that it is
+ * inside the last element passed and crosses the boundary (and any sampler) by
+ * normal tracking.
+ *
+ * @author Laurie Nevay
+ */
+
+class BDSMapTransportSection
+{
+public:
+  explicit BDSMapTransportSection(const BDSBeamlineElement* firstElementIn);
+  ~BDSMapTransportSection();
+
+  /// Build a map for a beam line element. Returns nullptr if the element can't be
+  /// transported with a map.
+  static BDSMapTransportElement* BuildElement(const BDSBeamlineElement* element);
+
+  /// Find all sections in a beam line.
+  static std::vector<BDSMapTransportSection*> BuildSections(const BDSBeamline* beamline);
+
+  /// Add an element to the end of the section. Takes ownership of the map.
+  void Append(const BDSBeamlineElement* element,
+	      BDSMapTransportElement*   map);
+
+  /// Transport a particle at the entrance of the section. Returns false if it isn't
+  /// on the entrance plane going forwards, is outside the aperture or would be moved
+  /// past no elements.
+  G4bool Transport(const G4ThreeVector&   globalPosition,
+		   const G4ThreeVector&   globalDirection,
+		   G4double               brho,
+		   BDSMapTransportResult& result) const;
+
+  inline const BDSBeamlineElement* FirstElement() const {return firstElement;}
+  inline G4int    NElements()    const {return (G4int)maps.size();}
+  inline G4double SPositionStart() const {return sStart;}
+  inline G4double SPositionEnd()   const {return sEnd;}
+  inline const G4String& Name()  const {return name;}
+
+  /// Maximum distance from the entrance plane for a particle to be transported.
+  static const G4double entranceTolerance;
+  /// Distance before the exit plane that a particle is placed at.
+  static const G4double exitOffset;
+
+private:
+  BDSMapTransportSection() = delete;
+  BDSMapTransportSection(const BDSMapTransportSection&) = delete;
+  BDSMapTransportSection& operator=(const BDSMapTransportSection&) = delete;
+
+  const BDSBeamlineElement* firstElement;
+  G4String         name;
+  G4double         sStart;
+  G4double         sEnd;
+  G4ThreeVector    startPosition;
+  G4RotationMatrix startRotationInverse;
+
+  std::vector<BDSMapTransportElement*> maps;
+  std::vector<G4ThreeVector>           endPositions; ///< For each element.
+  std::vector<G4RotationMatrix>        endRotations; ///< For each element.
+};
+
+#endif
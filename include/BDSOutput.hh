@@ -55,7 +55,9 @@ class BDSTrajectoryPointHit;
 class BDSHitEnergyDepositionGlobal;
 typedef G4THitsCollection<BDSHitEnergyDepositionGlobal> BDSHitsCollectionEnergyDepositionGlobal;
 class BDSTrajectoriesToStore;
+class BDSHitsCollectionScorerMesh;
 template <class T> class G4THitsMap;
+class G4VHitsCollection;
 
 class G4PrimaryVertex;
 
@@ -139,7 +141,7 @@ public:
                  const BDSTrajectoriesToStore*                  trajectories,
                  const BDSHitsCollectionCollimator*             collimatorHits,
                  const BDSHitsCollectionApertureImpacts*        apertureImpactHits,
-                 const std::map<G4String, G4THitsMap<G4double>*>& scorerHitsMap,
+                 const std::map<G4String, G4VHitsCollection*>&  scorerHitsMap,
                  const G4int                                    turnsTaken);
 
   /// Close a file and open a new one.
@@ -152,6 +154,29 @@ public:
                unsigned long long int nEventsInOriginalDistrFileIn,
                unsigned long long int nEventsDistrFileSkippedIn,
                unsigned int distrFileLoopNTimesIn);
+
+  /// Make everything filled in the current file so far readable even if the program stops
+  /// abruptly afterwards. The header is updated (as an extra entry) with the numbers of
+  /// events so far. The run information and histograms are not written.
+  void Checkpoint(unsigned long long int nOriginalEventsIn,
+                  unsigned long long int nEventsRequestedIn,
+                  unsigned long long int nEventsInOriginalDistrFileIn,
+                  unsigned long long int nEventsDistrFileSkippedIn,
+                  unsigned int distrFileLoopNTimesIn);
+
+  /// Set the number of events completed before this run was resumed from a checkpoint.
+  /// This is stored in the header of each new file.
+  inline void SetNEventsResumed(unsigned long long int nEventsResumedIn) {nEventsResumed = nEventsResumedIn;}
+
+  /// Add a set of run histograms (e.g. from a checkpoint) to the ones of this run. These
+  /// must be the same histograms, i.e. from the same model and options.
+  void AccumulateRunHistograms(const BDSOutputROOTEventHistograms* otherRunHistos);
+
+  /// Access the run histograms accumulated so far.
+  inline BDSOutputROOTEventHistograms* RunHistograms() const {return runHistos;}
+
+  /// Name of the current (or last) output file including the extension.
+  inline const G4String& CurrentFileName() const {return currentFileName;}
   
   /// Test whether a sampler name is invalid or not.
   static G4bool InvalidSamplerName(const G4String& samplerName);
@@ -214,6 +239,9 @@ private:
   /// structures are copied.
   virtual void WriteFileRunLevel() = 0;
 
+  /// Write the file so far such that it is readable should the program stop abruptly.
+  virtual void WriteFileCheckpoint() = 0;
+
   /// Calculate the number of bins and required maximum s.
   void CalculateHistogramParameters();
   
@@ -266,13 +294,19 @@ private:
   /// Fill aperture impact hits.
   void FillApertureImpacts(const BDSHitsCollectionApertureImpacts* hits);
 
-  /// Fill a map of scorer hits into the output.
-  void FillScorerHits(const std::map<G4String, G4THitsMap<G4double>*>& scorerHitsMap);
+  /// Fill a map of scorer hits into the output. Each collection may be either a
+  /// G4THitsMap<G4double> or a BDSHitsCollectionScorerMesh.
+  void FillScorerHits(const std::map<G4String, G4VHitsCollection*>& scorerHitsMap);
 
   /// Fill an individual scorer hits map into a particular output histogram.
   void FillScorerHitsIndividual(const G4String& hsitogramDefName,
                                 const G4THitsMap<G4double>* hitMap);
 
+  /// Fill an individual scorer mesh storage into a particular output histogram. Only
+  /// the bins touched in this event are visited.
+  void FillScorerHitsIndividual(const G4String& histogramDefName,
+                                const BDSHitsCollectionScorerMesh* hits);
+
   void FillScorerHitsIndividualBLM(const G4String& histogramDefName,
                                    const G4THitsMap<G4double>* hitMap);
 
@@ -295,6 +329,8 @@ private:
   const G4String fileExtension; ///< File extension to add to each file.
   G4int numberEventPerFile; ///< Number of events stored per file.
   G4int outputFileNumber;   ///< Number of output file.
+  G4String currentFileName; ///< Name of the current output file.
+  unsigned long long int nEventsResumed; ///< Number of events before resuming from a checkpoint.
 
   /// Invalid names for samplers - kept here as this is where the output structures are created.
   const static std::set<G4String> protectedNames;
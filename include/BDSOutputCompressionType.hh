@@ -0,0 +1,42 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef BDSOUTPUTCOMPRESSIONTYPE_H
+#define BDSOUTPUTCOMPRESSIONTYPE_H 
+
+#include "BDSTypeSafeEnum.hh"
+#include "globals.hh" // geant4 types / globals
+
+/**
+ * @brief Type definition for compression algorithms for the output file.
+ *
+ * rootdefault means the ROOT default for the installation is used.
+ */
+
+struct outputcompressiontypes_def {
+  enum type {rootdefault, zlib, lzma, lz4, zstd};
+};
+
+typedef BDSTypeSafeEnum<outputcompressiontypes_def, int> BDSOutputCompressionType;
+
+namespace BDS {
+  /// Determine the compression algorithm to be used from the input string.
+  BDSOutputCompressionType DetermineOutputCompressionType(G4String compressionType);
+}
+
+#endif
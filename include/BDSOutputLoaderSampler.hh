@@ -40,6 +40,10 @@ public:
   const BDSOutputROOTEventSampler<float>* SamplerDataFloat(G4long eventNumber = 0);
   const BDSOutputROOTEventSampler<double>* SamplerDataDouble(G4long eventNumber = 0);
   
+  /// Prepare the ROOT tree cache to read the sampler branch for entries [firstEvent, lastEvent)
+  /// in large sequential blocks. Useful when every event in a range is going to be read.
+  void SetCacheEntryRange(G4long firstEvent, G4long lastEvent);
+
   inline G4bool DoublePrecision() const {return doublePrecision;}
   inline G4long NEventsInFile() const {return nEvents;}
   
@@ -52,6 +56,7 @@ private:
   
   G4bool doublePrecision;
   G4long nEvents;
+  G4String samplerBranchName;
   BDSOutputROOTEventSampler<float>*  localSamplerFloat;
   BDSOutputROOTEventSampler<double>* localSamplerDouble;
 };
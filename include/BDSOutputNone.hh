@@ -47,6 +47,7 @@ private:
   virtual void WriteModel(){;}
   virtual void WriteFileEventLevel(){;}
   virtual void WriteFileRunLevel(){;}
+  virtual void WriteFileCheckpoint(){;}
   /// @}
 };
 
@@ -20,16 +20,39 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #define BDSOUTPUTROOT_H
 
 #include "BDSOutput.hh"
+#include "BDSOutputCompressionType.hh"
 
 #include "globals.hh"
 
 #include "Rtypes.h"
 
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class TBranch;
 class TFile;
 class TTree;
 
 /**
  * @brief ROOT Event output class.
+ *
+ * With the option outputAsynchronous, filling (i.e. serialising and compressing)
+ * the Event tree is done in a dedicated writer thread. Each event level structure
+ * is double buffered: the branches of the Event tree read from one copy while the
+ * other is filled with the next event. At the end of each event the two are swapped
+ * and handed to the writer. Only one event may be queued, so the tracking thread
+ * waits if the writer hasn't finished the previous event. The time spent waiting
+ * (or writing in the synchronous case) is reported when the file is closed.
+ *
+ * The compression algorithm and level of the file may be chosen and the branches
+ * of the Event tree may optionally use a different algorithm and level. The basket
+ * size of each event branch and the auto flush (cluster size) of the Event tree
+ * may also be set.
  * 
  * @author Stewart Boogert
  */
@@ -79,11 +102,67 @@ private:
   /// structures are copied.
   virtual void WriteFileRunLevel();
 
+  /// Write all trees and the file keys so the file is complete up to this point.
+  virtual void WriteFileCheckpoint();
+
   /// An implementation only in this class. We need a non-virtual function to
   /// call in the class destructor.
   void Close();
+
+  /// @{ Create a branch in the event tree for an event level structure. If writing
+  /// asynchronously, a second copy of the structure is made for double buffering.
+  template <class T>
+  void EventBranch(const std::string& name,
+                   const char*        className,
+                   T*&                object,
+                   G4int              bufferSize,
+                   G4int              splitLevel);
+  template <class T>
+  void EventBranch(const std::string& name,
+                   const char*        className,
+                   std::vector<T*>&   objects,
+                   G4int              index,
+                   G4int              bufferSize,
+                   G4int              splitLevel);
+  /// @}
+
+  /// Apply the event compression settings to a newly created event branch.
+  void ConfigureEventBranch(TBranch* branch) const;
+
+  /// Basket size to use for an event branch given its default size.
+  inline G4int EventBasketSize(G4int defaultSize) const {return basketSize > 0 ? basketSize : defaultSize;}
+
+  /// Start the writer thread for the current event tree.
+  void StartWriter();
+
+  /// Wait for any queued event to be written then stop the writer thread and
+  /// delete the second set of buffers.
+  void StopWriter();
+
+  /// Wait until the writer thread has finished with the queued event. This must be
+  /// done before anything else touches the file from the tracking thread.
+  void WaitForWriter();
+
+  /// Loop run by the writer thread.
+  void WriterLoop();
+
+  /// One double buffered event level structure.
+  struct EventBuffer
+  {
+    void*                 writeObject; ///< Object the event tree branch currently reads from.
+    std::function<void()> swap;        ///< Exchange writeObject with the object being filled.
+    std::function<void()> deleteWriteObject;
+  };
   
   G4int  compressionLevel;     ///< ROOT compression level for files.
+  BDSOutputCompressionType compressionAlgorithm;      ///< Compression algorithm for the file.
+  BDSOutputCompressionType eventCompressionAlgorithm; ///< Compression algorithm for the Event tree.
+  G4bool eventCompressionAlgorithmSet; ///< Whether the Event tree uses a different algorithm.
+  G4int  eventCompressionLevel;///< Compression level for the Event tree (-1 for same as file).
+  G4int  basketSize;           ///< Basket size for event branches (0 for the per branch default).
+  G4long autoFlush;            ///< Auto flush setting for the Event tree (0 for ROOT default).
+  G4bool asynchronous;         ///< Whether to fill the event tree in a separate thread.
+  G4int  compressionThreads;   ///< Number of threads for ROOT implicit MT (0 for none).
   TFile* theRootOutputFile;    ///< Output file.
   TTree* theHeaderOutputTree;  ///< Header Tree.
   TTree* theParticleDataTree;  ///< Geant4 Data Tree.
@@ -92,6 +171,20 @@ private:
   TTree* theModelOutputTree;   ///< Model tree.
   TTree* theEventOutputTree;   ///< Event tree.
   TTree* theRunOutputTree;     ///< Output histogram tree.
+
+  /// Buffers for asynchronous writing. A deque so the address of each writeObject,
+  /// which the event tree branch is bound to, doesn't change.
+  std::deque<EventBuffer> eventBuffers;
+
+  /// @{ Writer thread and synchronisation.
+  std::thread             writerThread;
+  std::mutex              writerMutex;
+  std::condition_variable writerCondition;
+  G4bool                  eventPending;
+  G4bool                  stopWriting;
+  /// @}
+
+  G4double timeBlockedOnOutput; ///< Time (s) the tracking thread spent writing or waiting for output.
 };
 
 #endif
@@ -60,6 +60,7 @@ public:
   unsigned long long int nEventsInFile;        ///< Number of events in the input distribution file irrespective of filters.
   unsigned long long int nEventsInFileSkipped; ///< Number of events from distribution file that were skipped due to filters.
   unsigned int           distrFileLoopNTimes;  ///< Number of times a distribution file was replayed.
+  unsigned long long int nEventsResumed;       ///< Number of events completed in previous files if resumed from a checkpoint.
   
   /// Update the file type.
   void SetFileType(const std::string& fileTypeIn) {fileType = fileTypeIn;}
@@ -76,7 +77,7 @@ public:
   void FillGeant4Side();
 #endif
 
-  ClassDef(BDSOutputROOTEventHeader,5);
+  ClassDef(BDSOutputROOTEventHeader,6);
 };
 
 #endif
@@ -86,7 +86,8 @@ public:
                           unsigned int nxbins, G4double xmin, G4double xmax,
                           unsigned int nybins, G4double ymin, G4double ymax,
                           unsigned int nzbins, G4double zmin, G4double zmax,
-                          unsigned int nebins, G4double emin, G4double emax);
+                          unsigned int nebins, G4double emin, G4double emax,
+                          G4bool sparse = false);
 
   void Fill1DHistogram(G4int histoId, G4double value, G4double weight = 1.0);
   void Fill2DHistogram(G4int histoId, G4double xValue, G4double yValue, G4double weight = 1.0);
@@ -111,6 +112,10 @@ public:
 			     TH3D* otherHistogram);
   void AccumulateHistogram4D(G4int histoId,
                              BDSBH4DBase* otherHistogram);
+
+  /// Add every histogram of another instance to the corresponding one in this
+  /// instance. Returns false and adds nothing if the sets of histograms differ.
+  G4bool AccumulateHistograms(const BDSOutputROOTEventHistograms* other);
 #endif
   /// Flush the contents.
   virtual void Flush();
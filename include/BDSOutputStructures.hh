@@ -127,7 +127,8 @@ protected:
 			  G4int    nBinsX, G4double xMin, G4double xMax,
 			  G4int    nBinsY, G4double yMin, G4double yMax,
 			  G4int    nBinsZ, G4double zMin, G4double zMax,
-			  G4int    nBinsE, G4double eMin, G4double eMax);
+			  G4int    nBinsE, G4double eMin, G4double eMax,
+			  G4bool   sparse = false);
   ///@}
 
   BDSOutputROOTParticleData* particleDataOutput; ///< Geant4 information / particle tables.
@@ -25,8 +25,17 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "G4Types.hh"
 
 class BDSHistBinMapper;
+class BDSScorerMeshStorage;
+class G4HCofThisEvent;
+class G4Step;
+class G4TouchableHistory;
 
 /** @brief Primitive scorer for cell flux in a 4D mesh.
+ *
+ * The values are accumulated in a sparse BDSScorerMeshStorage indexed by the
+ * BDSHistBinMapper global index rather than the G4THitsMap of the base class.
+ * As with the G4THitsMap, the memory used is proportional to the number of bins
+ * hit rather than the size of the mesh.
  *
  * @author Eliott Ramoisiaux
  */
@@ -45,16 +54,28 @@ public:
 		  G4int ni = 1, G4int nj = 1, G4int nk = 1,
 		  G4int depi = 2, G4int depj = 1, G4int depk = 0);
   
-  virtual ~BDSPSCellFlux4D() override {;}
+  virtual ~BDSPSCellFlux4D() override;
+
+  void   Initialize(G4HCofThisEvent* HCE) override;
+  void   clear() override;
+  void   PrintAll() override;
+
+  /// Hides the base class method so we know whether to weight as the base
+  /// class member is private.
+  void Weighted(G4bool flag);
   
 protected:
-  G4int GetIndex(G4Step* aStep) override;
+  G4bool ProcessHits(G4Step* aStep, G4TouchableHistory*) override;
+  G4int  GetIndex(G4Step* aStep) override;
   
 private:
   G4int fDepthi;
   G4int fDepthj;
   G4int fDepthk;
   const BDSHistBinMapper* mapper;
+  G4int  HCID4D;                 ///< Collection ID.
+  BDSScorerMeshStorage* storage; ///< Per-event storage reused for each event.
+  G4bool weighted;
 };
 
 #endif
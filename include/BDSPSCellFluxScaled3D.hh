@@ -20,11 +20,13 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #define BDSPSCELLFLUXSCALED3D_H
 
 #include "globals.hh"
-#include "G4THitsMap.hh"
 #include "G4VPrimitiveScorer.hh"
 
+#include <map>
+
 class BDSHistBinMapper;
-class G4PhysicsVector;
+class BDSScorerConversionTable;
+class BDSScorerMeshStorage;
 
 /**
  * @brief Primitive scorer for cell flux in a 3D mesh with a conversion factor.
@@ -34,7 +36,10 @@ class G4PhysicsVector;
  * default is none and just a factor of 1.
  *
  * The implementation also differs from G4PSCellFlux3D as we cache the volume
- * to avoid repeated calculation.
+ * to avoid repeated calculation. The values are accumulated in a
+ * BDSScorerMeshStorage indexed by the ROOT global bin of the equivalent TH3D
+ * rather than a G4THitsMap so the output can use them directly. This is dense
+ * unless the mesh is very large.
  * 
  * @author Robin Tesse
  */
@@ -75,8 +80,16 @@ private:
   /// Define units -> taken from G4PSCellFlux
   void DefineUnitAndCategory() const;
 
-  G4int                 HCID3D;   ///< Collection ID.
-  G4THitsMap<G4double>* evtMap3D; ///< Hits map.
+  /// Get the replica number in each dimension. Returns false and warns if any are negative.
+  G4bool ReplicaIndices(G4Step* aStep, G4int& i, G4int& j, G4int& k) const;
+
+  /// Index in the storage, i.e. the ROOT global bin number of the equivalent TH3D.
+  G4int StorageIndex(G4int i, G4int j, G4int k) const;
+
+  G4int                 HCID3D;  ///< Collection ID.
+  BDSScorerMeshStorage* storage; ///< Per-event storage reused for each event.
+  G4int                 nBinsI;  ///< Cache of number of bins in mesh from mapper.
+  G4int                 nBinsJ;  ///< Cache of number of bins in mesh from mapper.
   
   /// @{ Depth in replica to look for each dimension.
   G4int fDepthi;
@@ -85,7 +98,7 @@ private:
   /// @}
   
   /// Conversion factor interpolator object.
-  G4PhysicsVector* conversionFactor;
+  BDSScorerConversionTable* conversionFactor;
   
   /// Mapping from coordinate systems in mesh to global replica number.
   const BDSHistBinMapper* mapper; ///< We don't own this.
@@ -25,13 +25,17 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "G4Types.hh"
 
 #include <map>
+#include <vector>
 
 class BDSHistBinMapper;
-class G4PhysicsVector;
+class BDSScorerConversionTable;
 
 /**
  * @brief Primitive scorer for a 3D mesh with a conversion factor.
  *
+ * The conversion factor table for a particle is found by indexing a vector
+ * with the PDG ID (offset by the smallest PDG ID loaded) rather than a map search.
+ *
  * @author Robin Tesse
  */
 
@@ -55,7 +59,11 @@ public:
   virtual G4double GetConversionFactor(G4int particleID, G4double kineticEnergy) const override;
   
 private:
-  std::map<G4int, G4PhysicsVector*> conversionFactors;
+  std::map<G4int, BDSScorerConversionTable*> conversionFactors;
+
+  /// Tables indexed by PDG ID - pdgIDOffset. Not owned.
+  std::vector<const BDSScorerConversionTable*> conversionFactorsByPDGID;
+  G4int pdgIDOffset;
 };
 
 #endif
@@ -0,0 +1,97 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef BDSPTCMAPEVALUATOR_H
+#define BDSPTCMAPEVALUATOR_H
+
+#include "G4Types.hh"
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Evaluate the five polynomials of a truncated power series map together.
+ *
+ * A PTC one turn map is a polynomial in (x, px, y, py, deltaP) for each of the five
+ * output coordinates and the same monomials appear in most of them. The distinct
+ * monomials are collected once with a coefficient for each output. For evaluation,
+ * a table of the integer powers of each coordinate is built by multiplication and
+ * each monomial is evaluated once and added to all five outputs. The monomials are
+ * sorted by exponent so that consecutive ones that differ only in the power of deltaP
+ * reuse the product of the powers of the transverse coordinates.
+ *
+ * The summation order and the powers by multiplication differ from the term by term
+ * std::pow evaluation only at the level of floating point rounding.
+ *
+ * @author Laurie Nevay
+ */
+
+class BDSPTCMapEvaluator
+{
+public:
+  /// One term of one polynomial as in the PTC map table.
+  struct Term
+  {
+    G4double coefficient;
+    G4int nx;
+    G4int npx;
+    G4int ny;
+    G4int npy;
+    G4int ndeltaP;
+  };
+
+  /// Number of coordinates, i.e. input variables and output polynomials.
+  static const std::size_t nCoordinates = 5;
+
+  /// Construct from the terms of the x, px, y, py and deltaP polynomials in that order.
+  explicit BDSPTCMapEvaluator(const std::array<std::vector<Term>, nCoordinates>& polynomials);
+  ~BDSPTCMapEvaluator(){;}
+
+  /// Evaluate all polynomials for one set of coordinates (x, px, y, py, deltaP).
+  void Evaluate(const G4double in[nCoordinates],
+                G4double       out[nCoordinates]) const;
+
+  /// Evaluate all polynomials for n particles. The coordinates are stored per
+  /// coordinate, i.e. in[c*n + i] is coordinate c of particle i, and likewise for out.
+  void Evaluate(const G4double* in,
+                G4double*       out,
+                std::size_t     n) const;
+
+  /// @{ Accessor.
+  inline std::size_t NMonomials() const {return exponents.size();}
+  inline std::size_t NTerms()     const {return nTerms;}
+  /// @}
+
+  /// Highest power of any coordinate that's supported.
+  static const G4int maxPower = 31;
+
+private:
+  BDSPTCMapEvaluator() = delete;
+
+  /// Number of particles evaluated together in the batch evaluation.
+  static const std::size_t blockSize = 64;
+
+  std::vector<std::array<G4int, nCoordinates> >    exponents;    ///< Per distinct monomial.
+  std::vector<std::array<G4double, nCoordinates> > coefficients; ///< Per monomial for each output.
+  std::vector<G4bool> newPrefix;      ///< Whether the transverse powers differ from the previous monomial.
+  std::array<G4int, nCoordinates> highestPower; ///< Highest power of each coordinate used.
+  std::size_t nTerms;                 ///< Number of terms in the map table.
+};
+
+#endif
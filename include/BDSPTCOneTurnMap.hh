@@ -20,10 +20,12 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #define BDSPTCONETURNMAP_H
 
 #include "BDSParticleCoordsFullGlobal.hh"
+#include "BDSPTCMapEvaluator.hh"
 
 #include "globals.hh" // Geant4 typedefs
 #include "G4Track.hh"
 
+#include <array>
 #include <vector>
 #include <set>
 
@@ -40,15 +42,7 @@ class BDSParticleDefinition;
 class BDSPTCOneTurnMap
 {
 public:
-  struct PTCMapTerm
-  {
-    G4double coefficient;
-    G4int nx;
-    G4int npx;
-    G4int ny;
-    G4int npy;
-    G4int ndeltaP;
-  };
+  typedef BDSPTCMapEvaluator::Term PTCMapTerm;
     
   BDSPTCOneTurnMap() = delete;                                   ///< Default constructor.
   BDSPTCOneTurnMap(const BDSPTCOneTurnMap &other) = default;     ///< Copy constructor.
@@ -79,14 +73,10 @@ public:
 		   G4double& pz,
 		   G4int turnstaken);
 
-private:
-  G4double Evaluate(std::vector<PTCMapTerm>& terms,
-		    G4double x,
-		    G4double px,
-            G4double y,
-		    G4double py,
-		    G4double deltaP) const;
+  /// Load the terms of the x, px, y, py and deltaP polynomials from a PTC map table file.
+  static std::array<std::vector<PTCMapTerm>, 5> LoadMapTable(const G4String& filePath);
 
+private:
   G4double initialPrimaryMomentum;
   G4bool   beamOffsetS0;
   G4double referenceMomentum;
@@ -101,11 +91,8 @@ private:
   G4double pyLastTurn;
   G4double deltaPLastTurn;
 
-  std::vector<PTCMapTerm> xTerms;
-  std::vector<PTCMapTerm> yTerms;
-  std::vector<PTCMapTerm> pxTerms;
-  std::vector<PTCMapTerm> pyTerms;
-  std::vector<PTCMapTerm> deltaPTerms;
+  /// All five polynomials of the map compiled together.
+  BDSPTCMapEvaluator evaluator;
 };
 
 #endif
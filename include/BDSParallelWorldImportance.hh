@@ -49,7 +49,8 @@ class BDSParallelWorldImportance: public G4VUserParallelWorld
 public:
   BDSParallelWorldImportance(G4String name,
 			     G4String importanceWorldGeometryFile,
-			     G4String importanceValuesFile);
+			     G4String importanceValuesFile,
+			     G4String weightWindowFileIn = "");
   virtual ~BDSParallelWorldImportance();
 
   /// Overridden Geant4 method that must be implemented. Constructs
@@ -68,6 +69,10 @@ public:
   /// Create IStore for all importance sampling geometry cells.
   void AddIStore();
 
+  /// Create weight window store for all importance sampling geometry cells. Used
+  /// instead of AddIStore when a weight window file is given.
+  void AddWeightWindowStore();
+
   virtual void ConstructSD();
 
   /// World volume getter required in parallel world utilities.
@@ -93,8 +98,13 @@ private:
   /// Container for all user placed physical volumes and corresponding importance values.
   std::map<G4String, G4double> imVolumesAndValues;
 
+  /// Container for all user placed physical volumes and corresponding weight windows
+  /// (upper kinetic energy bound to lower weight bound).
+  std::map<G4String, std::map<G4double, G4double> > imVolumesAndWindows;
+
   G4String imGeomFile;
   G4String imVolMap;
+  G4String weightWindowFile;
   const G4String componentName; ///< String preprended to geometry with preprocessGDML
 
   ///@{ Cached global constants values.
@@ -105,6 +115,13 @@ private:
 
   /// Get importance value of a given physical volume name.
   G4double GetCellImportanceValue(const G4String& cellName);
+
+  /// Get the weight window of a given physical volume name.
+  const std::map<G4double, G4double>& GetCellWeightWindow(const G4String& cellName) const;
+
+  /// Strip off the prefixes and suffixes added to the cell name in the geometry loading
+  /// so it matches the name given by the user.
+  G4String PureCellName(const G4String& cellName) const;
 };
 
 #endif
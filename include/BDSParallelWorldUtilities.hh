@@ -22,6 +22,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "BDSParallelWorldInfo.hh"
 #include "BDSParallelWorldImportance.hh"
 #include "G4GeometrySampler.hh"
+#include "G4PlaceOfAction.hh"
 #include "globals.hh"
 
 #include <vector>
@@ -53,13 +54,18 @@ namespace BDS
   void RegisterSamplerPhysics(const std::vector<G4ParallelWorldPhysics*>& processes,
 			      G4VModularPhysicsList* physicsList);
 
-  /// Get store, and prepare importance sampling for importance geometry sampler
+  /// Get store, and prepare importance sampling for importance geometry sampler. The
+  /// weight window store is filled instead if weight windows are used.
   void AddIStore(const std::vector<G4VUserParallelWorld*>& worlds);
 
-  /// Create importance geometry sampler and register importance biasing with physics list
+  /// Create importance geometry sampler and register importance biasing with physics list.
+  /// Weight window biasing is registered instead if weight windows are used.
   void RegisterImportanceBiasing(const std::vector<G4VUserParallelWorld*>& worlds,
                                  G4VModularPhysicsList* physicsList);
 
+  /// Convert the weightWindowPlaceOfAction option string to the Geant4 enum.
+  G4PlaceOfAction DeterminePlaceOfAction(const G4String& placeOfAction);
+
   /// Get importance sampling world from list of all parallel worlds
   BDSParallelWorldImportance* GetImportanceSamplingWorld(const std::vector<G4VUserParallelWorld*>& worlds);
 
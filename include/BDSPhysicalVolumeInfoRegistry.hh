@@ -101,7 +101,7 @@ public:
   friend std::ostream& operator<< (std::ostream &out, BDSPhysicalVolumeInfoRegistry const &r);
   
   /// Access a set of volumes registered for the placement of a beamline element.
-  const std::set<G4VPhysicalVolume*>* PVsForBeamlineElement(BDSBeamlineElement* element) const;
+  const std::set<G4VPhysicalVolume*>* PVsForBeamlineElement(const BDSBeamlineElement* element) const;
 
 private:
   /// Default constructor is private as singleton
@@ -116,6 +116,11 @@ namespace BDS
   /// Build muon splitting biasing and wrap the various processes in the physics list.
   void BuildMuonBiasing(G4VModularPhysicsList* physicsList);
 
+  /// Register the fast simulation process for the beam particle so the map transport
+  /// model can be triggered in vacuum sections. Requires Geant4 10.4 or later.
+  void RegisterMapTransportPhysics(G4VModularPhysicsList* physicsList,
+				   const BDSParticleDefinition* beamParticle);
+
 #if G4VERSION_NUMBER > 1039
   /// Build the physics required for channelling to work correctly.
   G4VModularPhysicsList* ChannellingPhysicsComplete(G4bool useEMD  = false,
@@ -25,6 +25,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "G4VUserPrimaryGeneratorAction.hh"
 
 class BDSBunch;
+class BDSCheckpoint;
 class BDSOutputLoader;
 class BDSPrimaryGeneratorFile;
 class BDSPTCOneTurnMap;
@@ -45,10 +46,13 @@ namespace GMAD
 class BDSPrimaryGeneratorAction: public G4VUserPrimaryGeneratorAction
 {
 public:
-  /// Bunch must have a valid particle definition (ie not nullptr).
+  /// Bunch must have a valid particle definition (ie not nullptr). If a checkpoint
+  /// that is being resumed from is given, the distribution is advanced to continue
+  /// from it.
   BDSPrimaryGeneratorAction(BDSBunch*         bunchIn,
                             const GMAD::Beam& beam,
-                            G4bool            batchMode);
+                            G4bool            batchMode,
+                            const BDSCheckpoint* resumeCheckpoint = nullptr);
   virtual ~BDSPrimaryGeneratorAction();
 
   /// Main interface for Geant4. Prepare primary(ies) for the event.
@@ -59,6 +63,9 @@ public:
   /// Register a PTC map instance used in the teleporter which this
   /// class will set initial (first turn) primary coordinates for.
   void RegisterPTCOneTurnMap(BDSPTCOneTurnMap* otmIn) {oneTurnMap = otmIn;}
+
+  /// Index of the next event in the event generator file, or -1 if none is used.
+  G4long DistrFileEventIndex() const;
   
 private:
   /// For a file-based event generator there are a few checks we have to do - put in a function to keep tidy.
@@ -70,6 +77,7 @@ private:
   BDSOutputLoader* recreateFile;  ///< Optional output handler for restoring seed state. 
   G4bool   recreate;              ///< Whether to load seed state at start of event from rootevent file.
   G4int    eventOffset;           ///< The offset in the file to read events from when setting the seed.
+  G4bool   resume;                ///< Whether continuing a run from a checkpoint.
   G4bool   useASCIISeedState;     ///< Whether to use the ascii seed state each time.
   G4bool   ionPrimary;            ///< The primary particle will be an ion.
   G4bool   distrFileMatchLength;  ///< Match external file length for event generator.
@@ -85,6 +85,9 @@ public:
 
   /// Return the offset into the file if any.
   G4long NEventsSkipped() const {return nEventsSkipped;}
+
+  /// Index of the next event to be read in the file.
+  G4long CurrentFileEventIndex() const {return currentFileEventIndex;}
   
   /// Report whether the distribution is finished generating.
   G4bool DistributionIsFinished() const {return endOfFileReached;}
@@ -29,12 +29,17 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "G4ThreeVector.hh"
 #include "G4VPrimaryGenerator.hh"
 
+#include <fstream>
+#include <memory>
+
 class BDSBunchEventGenerator;
+class BDSFileOffsetIndex;
 class G4Event;
 
 namespace HepMC3
 {
   class GenEvent;
+  class GenRunInfo;
   class Reader;
 }
 
@@ -89,9 +94,19 @@ protected:
   /// Close and delete reader. Have to delete as HepMC3 readers have no iteration
   /// or ability to loop back to the beginning.
   void CloseFile();
+
+  /// Open the file with a reader on a stream positioned at the given event using
+  /// the byte offset index. Only for the ascii HepMC formats. The reader is given
+  /// the run information parsed from the header of the file.
+  void OpenFileAtEvent(G4long eventIndex, G4bool usualPrintOut = true);
+
+  /// Parse the header before the first event (weight names, tools and run attributes)
+  /// once so it can be given to readers that start partway into the file.
+  void ReadHeader();
   
   /// Open the file, read all the events and count them. Do not apply any filters.
-  /// Therefore, this returns the maximum number of raw events.
+  /// Therefore, this returns the maximum number of raw events. If an index is in
+  /// use, the count is taken from it.
   G4long CountEventsInFile();
 
   /// Clear the hepmcEvent object, reallocate and read a single event and fill that member.
@@ -99,7 +114,7 @@ protected:
   G4bool ReadSingleEvent();
   
   /// Read events but do nothing with them. Will throw an exception if the number is greater
-  /// than the number of events in the file.
+  /// than the number of events in the file. If an index is in use, seek directly instead.
   void SkipEvents(G4int nEventsToSkip);
 
   /// Conversion from HepMC::GenEvent to G4Event.
@@ -112,6 +127,9 @@ protected:
 
 private:
   HepMC3::Reader*           reader;
+  std::ifstream*            indexedStream; ///< Stream the reader uses when the index is used.
+  BDSFileOffsetIndex*       fileIndex;     ///< Byte offset of the events if requested and possible.
+  std::shared_ptr<HepMC3::GenRunInfo> headerRunInfo; ///< Run information from the header when the index is used.
   G4String                  fileName;
   G4bool                    removeUnstableWithoutDecay;
   G4bool                    warnAboutSkippedParticles;
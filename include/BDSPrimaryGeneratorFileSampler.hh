@@ -26,17 +26,27 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "G4ThreeVector.hh"
 #include "G4Types.hh"
 
+#include <map>
 #include <vector>
 
 class BDSBunchEventGenerator;
 class BDSOutputLoaderSampler;
+template <class T> class BDSOutputROOTEventSampler;
 class G4Event;
+class G4ParticleDefinition;
 class G4PrimaryParticle;
 class G4PrimaryVertex;
 class G4VSolid;
 
 /**
  * @brief Loader to read a specific sampler from a BDSIM ROOT output file.
+ *
+ * If eventGeneratorPreload is used in the beam definition, the events that will be
+ * used in the run are read into flat arrays before the first event and particles that
+ * cannot be simulated (unknown or unstable without a decay table) are removed once there.
+ * Without looping, only the range of events from the (skipped) start to the number to
+ * generate is read, so eventGeneratorNEventsSkip and ngenerate select one shard of a
+ * file for parallel jobs.
  * 
  * @author Laurie Nevay
  */
@@ -85,6 +95,19 @@ protected:
   void ReadPrimaryParticlesFloat(G4long index);
   void ReadPrimaryParticlesDouble(G4long index);
 
+  /// Fill vertices from the preloaded arrays.
+  void ReadPrimaryParticlesPreloaded(G4long index);
+
+  /// Read events [firstEvent, lastEvent) from the file into the preloaded arrays.
+  void Preload(G4long firstEvent, G4long lastEvent);
+
+  /// Append the particles of one sampler entry to the preloaded arrays.
+  template <class U>
+  void AppendPreloaded(const BDSOutputROOTEventSampler<U>* sampler);
+
+  /// Return the particle definition for a PDG ID or nullptr if it should not be simulated.
+  const G4ParticleDefinition* PreloadDefinition(G4int pdgID);
+
 private:
   BDSOutputLoaderSampler*   reader;
   G4String                  fileName;
@@ -97,6 +120,28 @@ private:
   std::vector<DisplacedVertex> vertices;
   
   std::vector<G4PrimaryVertex*> currentVertices;
+
+  /// Events held in memory if preloading. The particles of file event j are in the range
+  /// [eventStart[j - firstEvent], eventStart[j - firstEvent + 1]) of the arrays.
+  struct PreloadedEvents
+  {
+    G4long firstEvent = 0;
+    G4long lastEvent  = 0;
+    std::vector<std::size_t> eventStart;
+    std::vector<const G4ParticleDefinition*> definition;
+    std::vector<G4double> x;
+    std::vector<G4double> y;
+    std::vector<G4double> T;
+    std::vector<G4double> px;
+    std::vector<G4double> py;
+    std::vector<G4double> pz;
+    std::vector<G4double> weight;
+  };
+  G4bool           preload;
+  G4bool           preloaded;
+  PreloadedEvents  preloadedEvents;
+  G4long           nParticlesRemovedInPreload;
+  std::map<G4int, const G4ParticleDefinition*> preloadDefinitions;
 };
 
 #endif
@@ -0,0 +1,154 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef BDSREGIONCUTPROFILER_H
+#define BDSREGIONCUTPROFILER_H
+
+#include "G4String.hh"
+#include "G4Types.hh"
+
+#include <array>
+#include <chrono>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+class G4Material;
+class G4Region;
+class G4Step;
+class G4VProcess;
+
+/**
+ * @brief Measure the cost and scored contribution of each region in a pilot run
+ * and propose production cuts.
+ *
+ * For every step the wall time since the previous step is attributed to the region
+ * of the step. Each photon, electron and positron secondary created by a process that
+ * applies production cuts (e.g. eBrem or eIoni, see CutLimitedProcess()) is the 'root'
+ * of itself and all of its descendants, and is binned by the region it was created in
+ * and its kinetic energy at creation. Secondaries of other processes, such as Compton
+ * scattering, the photoelectric effect and gamma conversion, are produced regardless
+ * of the cuts so they are not roots. The time and the scored quantity (weighted energy
+ * deposited in the scoring regions, or in sensitive volumes if none are given) of
+ * each track are added to its root. Raising the production cut in a region to the
+ * energy E would, at most, remove the roots created there below E, so this gives the
+ * time saved and the change to the scored quantity for each possible cut.
+ *
+ * At the end of the run, the cut energies are chosen greedily by time saved per
+ * scored quantity removed, keeping the total removed within a tolerance of the total
+ * scored quantity. The energies are converted to range cuts using the materials seen
+ * in each region and the current cuts are never lowered. The result is printed and
+ * written as a GMAD file that can be included after the model to apply it.
+ *
+ * @author Laurie Nevay
+ */
+
+class BDSRegionCutProfiler
+{
+public:
+  BDSRegionCutProfiler(const G4String& outputFileNameIn,
+		       G4double        toleranceIn,
+		       const G4String& scoringRegionsIn);
+  ~BDSRegionCutProfiler();
+
+  /// Accumulate the information for one step.
+  void Step(const G4Step* step);
+
+  /// Propose the cuts, print them and write the GMAD file.
+  void EndOfRun(G4int nEvents);
+
+  BDSRegionCutProfiler() = delete;
+  BDSRegionCutProfiler(const BDSRegionCutProfiler&) = delete;
+  BDSRegionCutProfiler& operator=(const BDSRegionCutProfiler&) = delete;
+
+private:
+  /// Species affected by production cuts (excluding protons) and their G4ProductionCuts index.
+  static const G4int nSpecies = 3;
+  /// Logarithmic creation kinetic energy bins from 100 eV to 100 GeV with an underflow and
+  /// overflow bin.
+  static const G4int nBins = 92;
+
+  /// Time and scored quantity for the roots in one energy bin.
+  struct BinData
+  {
+    G4double time   = 0;
+    G4double scored = 0;
+    G4long   nRoots = 0;
+  };
+
+  struct RegionData
+  {
+    const G4Region* region = nullptr;
+    G4bool   scoring = false;
+    G4long   nSteps  = 0;
+    G4double time    = 0;
+    G4double scored  = 0;
+    std::set<const G4Material*> materials;
+    std::array<std::array<BinData, nBins>, nSpecies> bins;
+  };
+
+  /// Index of the root of a track in the form (region, species, bin), or -1 for none.
+  struct Root
+  {
+    G4int region  = -1;
+    G4int species = -1;
+    G4int bin     = -1;
+  };
+
+  /// Return the index of the region data for this region, adding it if needed.
+  G4int RegionIndex(const G4Region* region);
+
+  /// Return the species index for a PDG ID or -1 if not one affected by cuts.
+  static G4int SpeciesIndex(G4int pdgID);
+
+  /// Whether secondaries of this creator process are limited by the production cuts.
+  /// These are the ionisation, bremsstrahlung and pair production processes and, if
+  /// G4EmParameters::ApplyCuts() is true, also Compton, photoelectric and conversion.
+  G4bool CutLimitedProcess(const G4VProcess* process);
+
+  /// Return the bin for a kinetic energy.
+  static G4int Bin(G4double kineticEnergy);
+  /// Upper edge of a bin.
+  static G4double BinUpperEdge(G4int bin);
+
+  /// Return the largest range whose production threshold in all materials is at most the
+  /// energy given. Never less than the current cut.
+  G4double RangeForEnergy(const RegionData& rd, G4int species, G4double energy, G4double currentCut) const;
+
+  G4String outputFileName;
+  G4double tolerance;
+  std::set<G4String> scoringRegionNames;
+
+  std::set<G4String> cutLimitedProcessNames;
+  std::unordered_map<const G4VProcess*, G4bool> cutLimitedProcesses; ///< Cache by process.
+
+  std::vector<RegionData> regions;
+  const G4Region* lastRegion;
+  G4int           lastRegionIndex;
+
+  /// Root of each track in the current event by track ID.
+  std::unordered_map<G4int, Root> roots;
+  G4int currentEventID;
+  G4int currentTrackID;
+  Root  currentRoot;
+  std::chrono::steady_clock::time_point lastStepTime;
+  G4double totalScored;
+};
+
+#endif
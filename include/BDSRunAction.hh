@@ -27,9 +27,11 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include <string>
 
 class BDSBunch;
+class BDSCheckpoint;
 class BDSEventAction;
 class BDSEventInfo;
 class BDSOutput;
+class BDSRegionCutProfiler;
 class G4Run;
 
 /**
@@ -53,6 +55,12 @@ public:
   virtual void BeginOfRunAction(const G4Run*);
   virtual void EndOfRunAction(const G4Run*);
 
+  /// Set the optional region cut profiler that is reported on at the end of the run. Not owned.
+  void SetRegionCutProfiler(BDSRegionCutProfiler* regionCutProfilerIn) {regionCutProfiler = regionCutProfilerIn;}
+
+  /// Set the optional checkpoint that restores the run state at the start of the run when resuming. Not owned.
+  void SetCheckpoint(BDSCheckpoint* checkpointIn) {checkpoint = checkpointIn;}
+
 private:
   BDSRunAction() = delete;
   
@@ -80,6 +88,8 @@ private:
   BDSEventAction* eventAction;    ///< Event action for updating information at start of run.
   G4String        trajectorySamplerID; ///< Copy of option.
   unsigned long long int nEventsRequested; ///< Cache of ngenerate.
+  BDSRegionCutProfiler*  regionCutProfiler;
+  BDSCheckpoint*         checkpoint;
 };
 
 #endif
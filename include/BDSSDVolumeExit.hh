@@ -50,8 +50,15 @@ public:
   virtual void Initialize(G4HCofThisEvent* HCE);
   virtual G4bool ProcessHits(G4Step* step,
 			     G4TouchableHistory* th);
+
+  /// Record the post step point as an exit regardless of its step status. Used for
+  /// tracks that are killed on leaving the tracking envelope.
+  void ProcessHitsForcedExit(const G4Step* step);
   
 private:
+  /// Create and store a hit at the post step point.
+  void RecordExit(const G4Step* step);
+
   /// assignment and copy constructor not implemented nor used
   BDSSDVolumeExit& operator=(const BDSSDVolumeExit&);
   BDSSDVolumeExit(BDSSDVolumeExit&);
@@ -27,6 +27,8 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "src-external/gzstream/gzstream.h"
 #endif
 
+class BDSScorerConversionTable;
+
 /**
  * @brief Loader for scoring conversion tables as function of energy.
  *
@@ -46,6 +48,10 @@ public:
   /// Load the file.
   G4PhysicsVector* Load(const G4String& fileName,
 			G4bool          silent=false);
+
+  /// Load the file and prepare a table with constant time lookup for use per step.
+  BDSScorerConversionTable* LoadTable(const G4String& fileName,
+				      G4bool          silent=false);
 private:
 
   /// Templated iostream for std::ifstream and gzstream as well
@@ -0,0 +1,103 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef BDSSCORERCONVERSIONTABLE_H
+#define BDSSCORERCONVERSIONTABLE_H
+
+#include "G4Types.hh"
+
+#include <cmath>
+#include <vector>
+
+class G4PhysicsVector;
+
+/**
+ * @brief Conversion factor vs kinetic energy with constant time lookup.
+ *
+ * The points of a loaded G4PhysicsVector are copied and a uniform grid in
+ * log(Ek) is built where each grid bin stores the index of the data interval
+ * at its lower edge. A lookup then computes the grid bin directly and only
+ * advances over the (typically zero or one) data points inside that grid bin
+ * rather than doing a binary search over the whole vector. The value is
+ * linearly interpolated between the data points as G4PhysicsVector does, so
+ * the result is the same as G4PhysicsVector::Value without spline.
+ *
+ * Below and above the range of data, the first and last values are returned.
+ * If any energy is not positive, a binary search is used instead.
+ *
+ * @author Laurie Nevay
+ */
+
+class BDSScorerConversionTable
+{
+public:
+  /// Copy the data from the vector. nGridBinsPerPoint controls how fine the log
+  /// grid is relative to the number of data points.
+  explicit BDSScorerConversionTable(const G4PhysicsVector* vector,
+				    G4int                  nGridBinsPerPoint = 4);
+  ~BDSScorerConversionTable(){;}
+
+  /// Get the linearly interpolated value for a given kinetic energy.
+  inline G4double Value(G4double eK) const
+  {
+    if (eK <= eKMin)
+      {return values.front();}
+    else if (eK >= eKMax)
+      {return values.back();}
+    std::size_t i = LowerIndex(eK);
+    G4double b = (eK - energy[i]) / (energy[i+1] - energy[i]);
+    return values[i] + b * (values[i+1] - values[i]);
+  }
+
+  /// Accessor.
+  inline std::size_t NPoints() const {return energy.size();}
+
+private:
+  BDSScorerConversionTable() = delete;
+
+  /// Index i of the data interval such that energy[i] < eK <= energy[i+1]. Only
+  /// valid for eKMin < eK < eKMax.
+  inline std::size_t LowerIndex(G4double eK) const
+  {
+    if (!useGrid)
+      {return BinarySearch(eK);}
+    G4int bin = (G4int)((std::log(eK) - logEKMin) * invGridBinWidth);
+    bin = bin < 0 ? 0 : (bin >= nGridBins ? nGridBins - 1 : bin);
+    std::size_t i = gridStartIndex[bin];
+    while (i > 0 && energy[i] >= eK) // protect against rounding in the log
+      {i--;}
+    while (energy[i+1] < eK)
+      {i++;}
+    return i;
+  }
+
+  /// Used if the grid can't be used.
+  std::size_t BinarySearch(G4double eK) const;
+
+  std::vector<G4double>    energy;
+  std::vector<G4double>    values;
+  std::vector<std::size_t> gridStartIndex; ///< Data interval at lower edge of each grid bin.
+  G4double eKMin;
+  G4double eKMax;
+  G4double logEKMin;
+  G4double invGridBinWidth;
+  G4int    nGridBins;
+  G4bool   useGrid;
+};
+
+#endif
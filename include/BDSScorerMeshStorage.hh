@@ -0,0 +1,138 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef BDSSCORERMESHSTORAGE_H
+#define BDSSCORERMESHSTORAGE_H
+
+#include "G4Types.hh"
+
+#include <cstddef>
+#include <vector>
+
+class BDSHistBinMapper;
+
+/**
+ * @brief Per-event storage for a scoring mesh.
+ *
+ * Values are indexed by global bin number with a list of the bins touched in
+ * the current event. Resetting only visits the touched bins, so the cost per
+ * event scales with the number of bins hit, not the size of the mesh. The output
+ * can then iterate over only the touched bins.
+ *
+ * If dense, a flat array of all bins is used and adding to a bin is an array
+ * access. If sparse, an open-addressing hash table with linear probing holds only
+ * the bins touched, so the memory is proportional to the largest number of bins
+ * hit in one event rather than the size of the mesh. This is used for 4D meshes
+ * and very large 3D meshes.
+ *
+ * Bin indices are G4int, so a mesh with more bins than that can hold is a fatal
+ * G4Exception.
+ *
+ * This is owned by the primitive scorer and reused for every event. It is
+ * presented to the event through BDSHitsCollectionScorerMesh.
+ *
+ * @author Laurie Nevay
+ */
+
+class BDSScorerMeshStorage
+{
+public:
+  BDSScorerMeshStorage(std::size_t nBinsIn,
+		       G4bool      sparseIn = false);
+  ~BDSScorerMeshStorage(){;}
+
+  /// Add a value to a bin.
+  inline void Add(G4int index, G4double value)
+  {
+    if (sparse)
+      {AddSparse(index, value); return;}
+    if (!touched[index])
+      {
+	touched[index] = 1;
+	touchedBins.push_back(index);
+      }
+    values[index] += value;
+  }
+
+  /// Zero the bins touched since the last reset.
+  void Reset();
+
+  /// Value of a bin - zero if not touched in this event.
+  inline G4double Value(G4int index) const
+  {
+    if (!sparse)
+      {return values[index];}
+    std::size_t slot = Slot(index);
+    return keys[slot] == index ? values[slot] : 0;
+  }
+
+  /// Index for mesh cell (i,j,k), counting from 0, in storage laid out as the
+  /// ROOT global bin of a TH3D with nBinsI x nBinsJ bins plus under and overflow
+  /// bins, i.e. TH3::GetBin(i+1, j+1, k+1).
+  static inline G4int RootGlobalBin3D(G4int i, G4int j, G4int k, G4int nBinsI, G4int nBinsJ)
+  {return (i + 1) + (nBinsI + 2) * ((j + 1) + (nBinsJ + 2) * (k + 1));}
+
+  /// Number of bins required for the ROOT global bin layout of a 3D mesh.
+  static std::size_t NBinsRoot3D(G4int nBinsI, G4int nBinsJ, G4int nBinsK);
+
+  /// Number of bins required for the BDSHistBinMapper global index layout. For a
+  /// 4D mesh, the mapper already includes the energy under and overflow bins.
+  static std::size_t NBinsMapper(const BDSHistBinMapper* mapper);
+
+  /// Largest number of bins a 3D mesh is stored densely for (~80 MB per scorer).
+  static const std::size_t maximumDenseBins = 10000000;
+
+  /// @{ Accessor.
+  inline G4int  NBins()    const {return nBins;}
+  inline G4int  NTouched() const {return (G4int)touchedBins.size();}
+  inline G4bool Sparse()   const {return sparse;}
+  inline const std::vector<G4int>& TouchedBins() const {return touchedBins;}
+  /// @}
+
+private:
+  BDSScorerMeshStorage() = delete;
+
+  /// Add a value to a bin in the hash table, growing it if more than half full.
+  void AddSparse(G4int index, G4double value);
+
+  /// Slot holding index or else the empty slot where it would be inserted.
+  inline std::size_t Slot(G4int index) const
+  {
+    // Fibonacci hashing so neighbouring bins are spread over the table
+    std::size_t slot = (std::size_t)(((unsigned long long)(unsigned int)index * 11400714819323198485ull) >> 32) & mask;
+    while (keys[slot] != index && keys[slot] != emptyKey)
+      {slot = (slot + 1) & mask;}
+    return slot;
+  }
+
+  /// Double the size of the hash table and reinsert the touched bins.
+  void Grow();
+
+  static const G4int emptyKey = -1;
+
+  G4int       nBins;                 ///< Number of bins in the mesh.
+  G4bool      sparse;                ///< Whether the hash table is used.
+  std::vector<G4double> values;      ///< Value per global bin, or per slot if sparse.
+  std::vector<char>     touched;     ///< Whether a bin is in touchedBins - dense only.
+  std::vector<G4int>    keys;        ///< Bin per slot or emptyKey - sparse only.
+  std::size_t           mask;        ///< Number of slots - 1 - sparse only.
+  std::vector<G4int>    touchedBins; ///< Bins touched in this event in order of first touch.
+  std::vector<std::size_t> resetSlots; ///< Reused when resetting the hash table.
+};
+
+#endif
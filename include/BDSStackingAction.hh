@@ -26,7 +26,10 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include <set>
 
 class BDSGlobalConstants;
+class G4Navigator;
 class G4Track;
+class G4VPhysicalVolume;
+class G4WeightWindowStore;
 
 /**
  * @brief BDSIM's Geant4 stacking action.
@@ -51,11 +54,25 @@ private:
   /// Force use of supplied constructor.
   BDSStackingAction() = delete;
 
+  /// Play Russian roulette with a new secondary if its weight is below the lower weight
+  /// bound of the weight window of the cell it is created in. Returns true if it should be
+  /// killed and otherwise updates the weight of the track if it survives. This saves tracking
+  /// low weight secondaries until they first reach a boundary or collision.
+  G4bool RouletteSecondary(const G4Track* aTrack);
+
   G4bool killNeutrinos;     ///< Local copy of whether to kill neutrinos for tracking efficiency.
   G4bool stopSecondaries;   ///< Whether particles with parentID > 0 will be killed.
   G4long maxTracksPerEvent; ///< Maximum number of tracks before start killing.
   G4double minimumEK;
   std::set<G4int> particlesToExcludeFromCuts;
+
+  /// @{ Weight window roulette of new secondaries.
+  G4bool               rouletteSecondaries;
+  G4double             weightWindowSurvivalFactor;
+  G4Navigator*         weightWindowNavigator;
+  G4VPhysicalVolume*   weightWindowWorld;
+  G4WeightWindowStore* weightWindowStore;
+  /// @}
  };
 
 #endif
@@ -22,8 +22,13 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "G4UserSteppingAction.hh"
 #include "G4Types.hh"
 
+class BDSRegionCutProfiler;
+class BDSTrackingEnvelope;
+
 /**
  * @brief Provide extra output for Geant4 through a verbose stepping action.
+ *
+ * Also passes each step to the optional region cut profiler and tracking envelope.
  */
 
 class BDSSteppingAction: public G4UserSteppingAction
@@ -32,7 +37,9 @@ public:
   BDSSteppingAction();
   BDSSteppingAction(G4bool verboseStepIn,
 		    G4int  verboseEventStartIn,
-		    G4int  verboseEventStopIn);
+		    G4int  verboseEventStopIn,
+		    BDSRegionCutProfiler* regionCutProfilerIn = nullptr,
+		    BDSTrackingEnvelope*  trackingEnvelopeIn  = nullptr);
   virtual ~BDSSteppingAction();
 
   /// If this event is verbose, then print out verbose stepping information
@@ -46,6 +53,8 @@ private:
   const G4bool verboseStep;
   const G4bool verboseEventStart;
   const G4bool verboseEventStop;
+  BDSRegionCutProfiler* regionCutProfiler; ///< Not owned.
+  BDSTrackingEnvelope*  trackingEnvelope;  ///< Not owned.
 };
 
 #endif
@@ -0,0 +1,118 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef BDSTRACKINGENVELOPE_H
+#define BDSTRACKINGENVELOPE_H
+
+#include "G4ThreeVector.hh"
+#include "G4Types.hh"
+
+#include <map>
+
+class BDSAuxiliaryNavigator;
+class BDSBeamlineElement;
+class BDSSDVolumeExit;
+class G4Step;
+class G4Track;
+class G4VPhysicalVolume;
+class G4VTouchable;
+
+/**
+ * @brief Kill tracks that leave an envelope around the beam line.
+ *
+ * The envelope is defined in curvilinear coordinates as a maximum transverse
+ * distance from the beam line axis and optionally a range in S. Anything outside
+ * the curvilinear geometry (i.e. transversely beyond it or past the ends of the beam
+ * line) is also outside the envelope. If the post step point of a step is outside,
+ * the track is killed there. This saves tracking particles through the tunnel, soil
+ * and world that will not return to the region of interest.
+ *
+ * Locating a point in the curvilinear geometry is costly, so it is avoided where
+ * possible. Steps that end in a beam line component that lies wholly inside the
+ * envelope are not checked. Otherwise, the point is located on geometry boundary
+ * steps and, within a volume, only once the track has travelled further than the
+ * distance to the radius or S limits found at the last check. Leaving the curvilinear
+ * geometry is therefore only detected on a geometry boundary.
+ *
+ * Optionally, killed tracks are recorded as world exit hits so they appear in the
+ * world exit output and the energy balance of the event. Otherwise, their energy is
+ * added to the killed energy as in BDSStackingAction.
+ *
+ * @author Laurie Nevay
+ */
+
+class BDSTrackingEnvelope
+{
+public:
+  BDSTrackingEnvelope(G4double radiusIn,
+		      G4double sMinIn,
+		      G4double sMaxIn,
+		      G4bool   recordIn);
+  ~BDSTrackingEnvelope();
+
+  /// Kill the track if the post step point of this step is outside the envelope.
+  /// Returns true if the track was killed.
+  G4bool Step(const G4Step* step);
+
+  BDSTrackingEnvelope() = delete;
+  BDSTrackingEnvelope(const BDSTrackingEnvelope&) = delete;
+  BDSTrackingEnvelope& operator=(const BDSTrackingEnvelope&) = delete;
+
+private:
+  /// Checks and caches that require the geometry to be constructed, so done on the
+  /// first step rather than at construction.
+  void Initialise();
+
+  /// Whether a global point is outside the envelope. The direction is used to
+  /// resolve the volume on a boundary. If inside, marginOut is set to the smallest
+  /// distance to the radius or S limits.
+  G4bool Outside(const G4ThreeVector& globalPosition,
+		 const G4ThreeVector& globalDirection,
+		 G4double&            marginOut) const;
+
+  /// Whether the touchable is in a beam line component that lies wholly inside
+  /// the envelope. Cached per placement of the component.
+  G4bool InComponentInside(const G4VTouchable* touchable);
+
+  /// Whether the extent of a beam line element lies wholly inside the envelope.
+  G4bool ElementInside(const BDSBeamlineElement* element) const;
+
+  G4double radius;     ///< Maximum transverse distance from the axis - 0 for no limit.
+  G4double sMin;
+  G4double sMax;
+  G4bool   useSLimits; ///< Cache of whether the S range is used.
+  G4bool   record;     ///< Record killed tracks as world exit hits.
+
+  BDSAuxiliaryNavigator* auxNavigator; ///< Navigator for the curvilinear coordinates.
+  BDSSDVolumeExit*       worldExit;    ///< Cache of world exit SD, not owned.
+  G4bool                 initialised;
+  G4double               curvilinearRadius; ///< Cache of curvilinear geometry radius.
+
+  /// Whether each component placement lies wholly inside the envelope.
+  std::map<const G4VPhysicalVolume*, G4bool> componentInside;
+
+  /// @{ State of the last check for the current track.
+  const G4Track* lastTrack;
+  G4int          lastTrackID;
+  G4bool         lastInComponentInside;
+  G4double       lastTrackLength;
+  G4double       lastMargin;
+  /// @}
+};
+
+#endif
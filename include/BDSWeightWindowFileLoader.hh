@@ -0,0 +1,52 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef BDSWEIGHTWINDOWFILELOADER_H
+#define BDSWEIGHTWINDOWFILELOADER_H
+
+#include "G4String.hh"
+#include "G4Types.hh"
+
+#include <map>
+
+/**
+ * @brief A loader for weight windows used in the importance world.
+ *
+ * Each line is a cell (physical volume) name followed by either a single lower
+ * weight bound that applies at all energies or pairs of upper kinetic energy bound
+ * (GeV) and lower weight bound followed by a final lower weight bound for all
+ * energies above the last bound. e.g. "cell1_pv 0.1 0.5 10 0.2 0.1" is a window
+ * of 0.5 below 100 MeV, 0.2 from 100 MeV to 10 GeV and 0.1 above.
+ *
+ * The returned map for each cell is from upper kinetic energy bound (Geant4 units)
+ * to lower weight bound, with the last upper bound being the maximum double.
+ * 
+ * @author Laurie Nevay
+ */
+
+template <class T>
+class BDSWeightWindowFileLoader
+{
+public:
+  BDSWeightWindowFileLoader();
+  ~BDSWeightWindowFileLoader();
+
+  std::map<G4String, std::map<G4double, G4double> > Load(const G4String& fileName);
+};
+
+#endif
@@ -36,8 +36,10 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "parser/beam.h"
 
+#include <algorithm>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 
@@ -95,13 +97,22 @@ int main(int argc, char** argv)
 	  }
 	BDSFieldInfo* recipe = BDSFieldFactory::Instance()->GetDefinition(query->fieldObject);
 	recipe->SetProvideGlobalTransform(false);
-	BDSFieldObjects* completeField = BDSFieldFactory::Instance()->CreateField(*recipe);
-	G4Field* field = nullptr;
-	if (completeField)
-	  {field = completeField->GetField();}
-	if (!field)
+	// field objects may use internal temporary variables, so make one per thread
+	// field map data is cached by the loader so is not loaded again
+	G4int nThreads = query->nThreads > 0 ? query->nThreads : (G4int)std::thread::hardware_concurrency();
+	nThreads = std::max(1, nThreads);
+	std::vector<G4Field*> fields;
+	for (G4int i = 0; i < nThreads; i++)
+	  {
+	    BDSFieldObjects* completeField = BDSFieldFactory::Instance()->CreateField(*recipe);
+	    G4Field* field = completeField ? completeField->GetField() : nullptr;
+	    if (!field)
+	      {break;}
+	    fields.push_back(field);
+	  }
+	if (fields.empty())
 	  {G4cout << "No field constructed - skipping" << G4endl; continue;}
-	querier.QueryFieldRaw(field, query);
+	querier.QueryFieldRaw(fields, query);
       }
   }
   catch (BDSException& e)
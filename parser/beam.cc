@@ -171,6 +171,7 @@ void Beam::PublishMembers()
   publish("distrFileMatchLength", &Beam::distrFileMatchLength);
   publish("distrFileLoop",        &Beam::distrFileLoop);
   publish("distrFileLoopNTimes",  &Beam::distrFileLoopNTimes);
+  publish("distrFileIndex",       &Beam::distrFileIndex);
   publish("removeUnstableWithoutDecay", &Beam::removeUnstableWithoutDecay);
   publish("nlinesIgnore",         &Beam::nlinesIgnore);
   publish("nLinesIgnore",         &Beam::nlinesIgnore); // for consistency
@@ -332,4 +333,5 @@ void Beam::PublishMembers()
   publish("eventGeneratorMaxEK",     &Beam::eventGeneratorMaxEK); // alias
   publish("eventGeneratorParticles", &Beam::eventGeneratorParticles);
   publish("eventGeneratorWarnSkippedParticles", &Beam::eventGeneratorWarnSkippedParticles);
+  publish("eventGeneratorPreload",   &Beam::eventGeneratorPreload);
 }
@@ -42,6 +42,7 @@ BeamBase::BeamBase()
   distrFileMatchLength = true;
   distrFileLoop        = false;
   distrFileLoopNTimes  = 1;
+  distrFileIndex       = false;
   removeUnstableWithoutDecay = true;
   nlinesIgnore         = 0;
   nlinesSkip           = 0;
@@ -153,4 +154,5 @@ BeamBase::BeamBase()
   eventGeneratorMaxEK = 1e50;
   eventGeneratorParticles = "";
   eventGeneratorWarnSkippedParticles = true;
+  eventGeneratorPreload = false;
 }
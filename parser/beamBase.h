@@ -55,6 +55,7 @@ namespace GMAD
       bool        distrFileMatchLength;
       bool        distrFileLoop;
       int         distrFileLoopNTimes;
+      bool        distrFileIndex;
       bool        removeUnstableWithoutDecay;
       ///@}
       int         nlinesIgnore; ///< Ignore first lines in the input bunch file.
@@ -161,6 +162,7 @@ namespace GMAD
       double eventGeneratorMaxEK;
       std::string eventGeneratorParticles;
       bool   eventGeneratorWarnSkippedParticles;
+      bool   eventGeneratorPreload;
       /// @}
   
       /// A list of all the keys that have been set in this instance.
@@ -158,6 +158,13 @@ void Options::PublishMembers()
   publish("outputFormat",          &Options::outputFormat);
   publish("outputDoublePrecision", &Options::outputDoublePrecision);
   publish("outputCompressionLevel",&Options::outputCompressionLevel);
+  publish("outputCompressionAlgorithm",      &Options::outputCompressionAlgorithm);
+  publish("outputEventCompressionAlgorithm", &Options::outputEventCompressionAlgorithm);
+  publish("outputEventCompressionLevel",     &Options::outputEventCompressionLevel);
+  publish("outputBasketSize",      &Options::outputBasketSize);
+  publish("outputAutoFlush",       &Options::outputAutoFlush);
+  publish("outputAsynchronous",    &Options::outputAsynchronous);
+  publish("outputCompressionThreads", &Options::outputCompressionThreads);
   publish("survey",                &Options::survey);
   publish("surveyFileName",        &Options::surveyFileName);
   
@@ -206,6 +213,9 @@ void Options::PublishMembers()
   publish("writeSeedState",        &Options::writeSeedState);
   publish("useASCIISeedState",     &Options::useASCIISeedState);
   publish("seedStateFileName",     &Options::seedStateFileName);
+  publish("checkpointEveryNEvents", &Options::checkpointEveryNEvents);
+  publish("checkpointFileName",    &Options::checkpointFileName);
+  publish("resumeFromCheckpoint",  &Options::resumeFromCheckpoint);
   publish("ngenerate",             &Options::nGenerate);
   publish("generatePrimariesOnly", &Options::generatePrimariesOnly);
   publish("exportGeometry",        &Options::exportGeometry);
@@ -281,6 +291,12 @@ void Options::PublishMembers()
   publish("autoColourWorldGeometryFile",    &Options::autoColourWorldGeometryFile);
   publish("importanceWorldGeometryFile",    &Options::importanceWorldGeometryFile);
   publish("importanceVolumeMap",  &Options::importanceVolumeMap);
+  publish("weightWindowFile",     &Options::weightWindowFile);
+  publish("weightWindowUpperLimitFactor",    &Options::weightWindowUpperLimitFactor);
+  publish("weightWindowSurvivalFactor",      &Options::weightWindowSurvivalFactor);
+  publish("weightWindowMaximumSplit",        &Options::weightWindowMaximumSplit);
+  publish("weightWindowPlaceOfAction",       &Options::weightWindowPlaceOfAction);
+  publish("weightWindowRouletteSecondaries", &Options::weightWindowRouletteSecondaries);
   publish("worldVolumeMargin",    &Options::worldVolumeMargin);
   publish("dontSplitSBends",      &Options::dontSplitSBends);
   publish("thinElementLength",    &Options::thinElementLength);
@@ -336,6 +352,9 @@ void Options::PublishMembers()
   publish("prodCutPositrons",            &Options::prodCutPositrons);
   publish("prodCutProtons",              &Options::prodCutProtons);
   publish("prodCutHadrons",              &Options::prodCutProtons); // backwards compatibility
+  publish("regionCutProfileFile",           &Options::regionCutProfileFile);
+  publish("regionCutProfileTolerance",      &Options::regionCutProfileTolerance);
+  publish("regionCutProfileScoringRegions", &Options::regionCutProfileScoringRegions);
   publish("neutronTimeLimit",            &Options::neutronTimeLimit);
   publish("neutronKineticEnergyLimit",   &Options::neutronKineticEnergyLimit);
   publish("useLENDGammaNuclear",         &Options::useLENDGammaNuclear);
@@ -384,12 +403,18 @@ void Options::PublishMembers()
   publish("stopSecondaries",          &Options::stopSecondaries);
   publish("killNeutrinos",            &Options::killNeutrinos);
   publish("killedParticlesMassAddedToEloss", &Options::killedParticlesMassAddedToEloss);
+  publish("trackingEnvelopeRadius",   &Options::trackingEnvelopeRadius);
+  publish("trackingEnvelopeSMin",     &Options::trackingEnvelopeSMin);
+  publish("trackingEnvelopeSMax",     &Options::trackingEnvelopeSMax);
+  publish("trackingEnvelopeRecord",   &Options::trackingEnvelopeRecord);
   publish("minimumRadiusOfCurvature", &Options::minimumRadiusOfCurvature);
   publish("sampleElementsWithPoleface",  &Options::sampleElementsWithPoleface);
   publish("nominalMatrixRelativeMomCut", &Options::nominalMatrixRelativeMomCut);
   publish("teleporterFullTransform",  &Options::teleporterFullTransform);
   publish("dEThresholdForScattering", &Options::dEThresholdForScattering);
   publish("backupStepperMomLimit",    &Options::backupStepperMomLimit);
+  publish("exactIntegrationDriver",   &Options::exactIntegrationDriver);
+  publish("mapTransport",             &Options::mapTransport);
 
   // hit generation
   publish("sensitiveOuter",              &Options::sensitiveOuter);
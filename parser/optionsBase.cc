@@ -43,6 +43,13 @@ OptionsBase::OptionsBase()
   outputDoublePrecision = false;
 #endif
   outputCompressionLevel= 5;
+  outputCompressionAlgorithm      = "default";
+  outputEventCompressionAlgorithm = "";
+  outputEventCompressionLevel     = -1;
+  outputBasketSize      = 0;
+  outputAutoFlush       = 0;
+  outputAsynchronous    = false;
+  outputCompressionThreads = 0;
   survey                = false;
   surveyFileName        = "survey.dat";
   batch                 = false;
@@ -78,6 +85,9 @@ OptionsBase::OptionsBase()
   writeSeedState        = false;
   useASCIISeedState     = false;
   seedStateFileName     = "";
+  checkpointEveryNEvents = 0;
+  checkpointFileName    = "";
+  resumeFromCheckpoint  = "";
   generatePrimariesOnly = false;
   exportGeometry        = false;
   exportType            = "gdml";
@@ -166,6 +176,12 @@ OptionsBase::OptionsBase()
   autoColourWorldGeometryFile = true;
   importanceWorldGeometryFile = "";
   importanceVolumeMap  = "";
+  weightWindowFile     = "";
+  weightWindowUpperLimitFactor = 5;
+  weightWindowSurvivalFactor   = 3;
+  weightWindowMaximumSplit     = 5;
+  weightWindowPlaceOfAction    = "boundaryandcollision";
+  weightWindowRouletteSecondaries = true;
   worldVolumeMargin = 5; //m
 
   vacuumPressure       = 1e-12;
@@ -211,6 +227,9 @@ OptionsBase::OptionsBase()
   prodCutElectrons         = 1e-3;
   prodCutPositrons         = 1e-3;
   prodCutProtons           = 1e-3;
+  regionCutProfileFile           = "";
+  regionCutProfileTolerance      = 0.01;
+  regionCutProfileScoringRegions = "";
   neutronTimeLimit         = 1e-6;
   neutronKineticEnergyLimit = 0;
   useLENDGammaNuclear      = false;
@@ -256,6 +275,8 @@ OptionsBase::OptionsBase()
   teleporterFullTransform  = true;
   dEThresholdForScattering = 1e-11; // GeV
   backupStepperMomLimit    = 0.1;   // fraction of unit momentum
+  exactIntegrationDriver   = false;
+  mapTransport             = false;
 
   // default value in Geant4, old value 0 - error must be greater than this
   minimumEpsilonStep       = 1e-12;   // used to be 1e-25 but since v11.1 this has to be greater than double precision
@@ -266,6 +287,10 @@ OptionsBase::OptionsBase()
   stopSecondaries          = false;
   killNeutrinos            = false;
   killedParticlesMassAddedToEloss = false;
+  trackingEnvelopeRadius   = 0;    // m, 0 for no envelope
+  trackingEnvelopeSMin     = 0;    // m
+  trackingEnvelopeSMax     = 0;    // m, <= sMin for no S limits
+  trackingEnvelopeRecord   = true;
   minimumRadiusOfCurvature = 0.05; // 5cm - typical aperture
 
   // hit generation
@@ -50,6 +50,13 @@ namespace GMAD
     std::string outputFormat;
     bool        outputDoublePrecision;
     int         outputCompressionLevel;
+    std::string outputCompressionAlgorithm;
+    std::string outputEventCompressionAlgorithm;
+    int         outputEventCompressionLevel;
+    int         outputBasketSize;
+    long        outputAutoFlush;
+    bool        outputAsynchronous;
+    int         outputCompressionThreads;
     ///@}
   
     ///@{ Parameter for survey
@@ -98,6 +105,9 @@ namespace GMAD
     bool writeSeedState;           ///< Write the seed state each event to a text file.
     bool useASCIISeedState;        ///< Whether to use the seed state from an ASCII file.
     std::string seedStateFileName; ///< Seed state file path.
+    int  checkpointEveryNEvents;   ///< Write a checkpoint of the run every N events (0 for never).
+    std::string checkpointFileName;   ///< Checkpoint file path - default is based on the output file name.
+    std::string resumeFromCheckpoint; ///< Checkpoint file to resume a run from.
 
     /// Whether to only generate primary coordinates and quit, or not.
     bool generatePrimariesOnly; 
@@ -201,6 +211,15 @@ namespace GMAD
     std::string importanceVolumeMap;
     // see verboseImportance
 
+    ///@{ Weight windows in the importance world.
+    std::string weightWindowFile;
+    double      weightWindowUpperLimitFactor;
+    double      weightWindowSurvivalFactor;
+    int         weightWindowMaximumSplit;
+    std::string weightWindowPlaceOfAction;
+    bool        weightWindowRouletteSecondaries;
+    ///@}
+
     double    worldVolumeMargin; ///< Padding margin for world volume size.
 
     double    vacuumPressure;
@@ -250,6 +269,9 @@ namespace GMAD
     double   prodCutElectrons;
     double   prodCutPositrons;
     double   prodCutProtons;
+    std::string regionCutProfileFile;           ///< Output file of proposed region cuts from a pilot run.
+    double      regionCutProfileTolerance;      ///< Fraction of the scored quantity allowed to change.
+    std::string regionCutProfileScoringRegions; ///< Regions whose energy deposition is the scored quantity.
     double   neutronTimeLimit;
     double   neutronKineticEnergyLimit;
     bool     useLENDGammaNuclear;
@@ -299,12 +321,18 @@ namespace GMAD
     bool     stopSecondaries;
     bool     killNeutrinos;
     bool     killedParticlesMassAddedToEloss;
+    double   trackingEnvelopeRadius;   ///< Maximum distance from the curvilinear axis before killing [m].
+    double   trackingEnvelopeSMin;     ///< Lower S limit of the tracking envelope [m].
+    double   trackingEnvelopeSMax;     ///< Upper S limit of the tracking envelope [m].
+    bool     trackingEnvelopeRecord;   ///< Record tracks killed by the envelope as world exit hits.
     double   minimumRadiusOfCurvature; ///< Minimum allowed radius of curvature.
     bool     sampleElementsWithPoleface;
     double   nominalMatrixRelativeMomCut; ///< Momentum threshold for nominal dipole matrix tracking.
     bool     teleporterFullTransform;     ///< Whether to use the new Transform3D method for the teleporter.
     double   dEThresholdForScattering;
     double   backupStepperMomLimit;    ///< Fractional momentum limit for reverting to backup steppers.
+    bool     exactIntegrationDriver;   ///< Take whole steps with analytical integrators.
+    bool     mapTransport;             ///< Transport primaries through vacuum sections with maps.
 
     // hit generation - only two parts that go in the same collection / branch
     bool      sensitiveOuter;
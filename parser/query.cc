@@ -50,6 +50,8 @@ void Query::clear()
   
   overwriteExistingFiles = true;
   printTransform = true;
+  nThreads = 1;
+  binaryOutput = false;
   
   drawArrows = true;
   drawZeroValuePoints = true;
@@ -100,6 +102,8 @@ void Query::PublishMembers()
   
   publish("overwriteExistingFiles", &Query::overwriteExistingFiles);
   publish("printTransform",         &Query::printTransform);
+  publish("nThreads",               &Query::nThreads);
+  publish("binaryOutput",           &Query::binaryOutput);
   
   publish("drawArrows",             &Query::drawArrows);
   publish("drawZeroValuePoints",    &Query::drawZeroValuePoints);
@@ -145,6 +149,8 @@ void Query::print()const
 	    << "queryElectricField: "    << queryElectricField     << std::endl
 	    << "overwriteExistingFiles " << overwriteExistingFiles << std::endl
 	    << "printTransform "         << printTransform         << std::endl
+	    << "nThreads "               << nThreads               << std::endl
+	    << "binaryOutput "           << binaryOutput           << std::endl
       << "drawArrows "             << drawArrows             << std::endl
       << "drawZeroValuePoints "    << drawZeroValuePoints    << std::endl
       << "drawBoxes "              << drawBoxes              << std::endl
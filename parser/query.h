@@ -58,6 +58,8 @@ namespace GMAD
     
     bool overwriteExistingFiles;
     bool printTransform;
+    int  nThreads;      ///< Number of threads to query with (bdsinterpolator only).
+    bool binaryOutput;  ///< Write values as binary rather than text.
     
     bool   drawArrows;
     bool   drawZeroValuePoints;
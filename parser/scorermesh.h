@@ -55,6 +55,7 @@ namespace GMAD
     double eHigh;       ///< E High limit.
     std::string eScale; ///< E scaling type.
     std::string eBinsEdgesFilenamePath; ///< E bins edges filename path.
+    bool sparseStorage; ///< Store only non-zero bins of 4D histograms.
 
     // placement stuff
     std::string sequence;     ///< Name of sequence to place.
@@ -24,11 +24,17 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "BDSBH4DTypeDefs.hh"
 #include <boost/format.hpp>
 #include <boost/histogram.hpp>
+#include <boost/histogram/literals.hpp>
+#include <boost/histogram/unsafe_access.hpp>
 #endif
 
+#include <cstddef>
 #include <iostream>
+#include <map>
 #include <sstream>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #ifdef USE_BOOST
@@ -152,6 +158,124 @@ BDSBH4D<boost_histogram_variable>::BDSBH4D(std::string& name, std::string& title
 						boost::histogram::axis::variable<double> {eBinEdgesIn, "energy"});
 }
 
+template <>
+BDSBH4D<boost_histogram_linear_sparse>::BDSBH4D():
+  BDSBH4DBase(3,3,3,3, 0,1, 0,1, 0,1, 0.1,0.230, "BDSBH4D","BDSBH4D","linear")
+{
+  h = boost::histogram::make_histogram_with(boost_histogram_sparse_storage(),
+					    boost::histogram::axis::regular<double> {3, 0.0, 1.0, "x"},
+					    boost::histogram::axis::regular<double> {3, 0.0, 1.0, "y"},
+					    boost::histogram::axis::regular<double> {3, 0.0, 1.0, "z"},
+					    boost::histogram::axis::regular<double> {3, 1.0, 230.0, "energy"});
+  
+  h_err = boost::histogram::make_histogram_with(boost_histogram_sparse_storage(),
+						boost::histogram::axis::regular<double> {3, 0.0, 1.0, "x"},
+						boost::histogram::axis::regular<double> {3, 0.0, 1.0, "y"},
+						boost::histogram::axis::regular<double> {3, 0.0, 1.0, "z"},
+						boost::histogram::axis::regular<double> {3, 1.0, 230.0, "energy"});
+}
+
+template <>
+BDSBH4D<boost_histogram_log_sparse>::BDSBH4D():
+  BDSBH4DBase(3,3,3,3, 0,1, 0,1, 0,1, 0.1,0.230, "BDSBH4D","BDSBH4D","log")
+{
+  h = boost::histogram::make_histogram_with(boost_histogram_sparse_storage(),
+					    boost::histogram::axis::regular<double> {3, 0.0, 1.0, "x"},
+					    boost::histogram::axis::regular<double> {3, 0.0, 1.0, "y"},
+					    boost::histogram::axis::regular<double> {3, 0.0, 1.0, "z"},
+					    boost::histogram::axis::regular<double, boost::histogram::axis::transform::log> {3, 1.0, 230.0, "energy"});
+  
+  h_err = boost::histogram::make_histogram_with(boost_histogram_sparse_storage(),
+						boost::histogram::axis::regular<double> {3, 0.0, 1.0, "x"},
+						boost::histogram::axis::regular<double> {3, 0.0, 1.0, "y"},
+						boost::histogram::axis::regular<double> {3, 0.0, 1.0, "z"},
+						boost::histogram::axis::regular<double, boost::histogram::axis::transform::log> {3, 1.0, 230.0, "energy"});
+}
+
+template <>
+BDSBH4D<boost_histogram_variable_sparse>::BDSBH4D():
+  BDSBH4DBase(3,3,3,0,1, 0,1, 0,1, "BDSBH4D","BDSBH4D","user",std::vector<double>{0.001,0.1,0.230})
+{
+  h = boost::histogram::make_histogram_with(boost_histogram_sparse_storage(),
+					    boost::histogram::axis::regular<double> {3, 0.0, 1.0, "x"},
+					    boost::histogram::axis::regular<double> {3, 0.0, 1.0, "y"},
+					    boost::histogram::axis::regular<double> {3, 0.0, 1.0, "z"},
+					    boost::histogram::axis::variable<double> {std::vector<double>{0.001,0.230}, "energy"});
+  
+  h_err = boost::histogram::make_histogram_with(boost_histogram_sparse_storage(),
+						boost::histogram::axis::regular<double> {3, 0.0, 1.0, "x"},
+						boost::histogram::axis::regular<double> {3, 0.0, 1.0, "y"},
+						boost::histogram::axis::regular<double> {3, 0.0, 1.0, "z"},
+						boost::histogram::axis::variable<double> {std::vector<double>{0.001,0.1,0.230}, "energy"});
+}
+
+template <>
+BDSBH4D<boost_histogram_linear_sparse>::BDSBH4D(std::string& name, std::string& title, const std::string& eScale,
+					 unsigned int nxbins, double xmin, double xmax,
+					 unsigned int nybins, double ymin, double ymax,
+					 unsigned int nzbins, double zmin, double zmax,
+					 unsigned int nebins, double emin, double emax):
+  BDSBH4DBase(nxbins, nybins, nzbins, nebins,
+	      xmin, xmax, ymin, ymax, zmin, zmax, emin, emax,
+	      name, title, eScale)
+{
+  h = boost::histogram::make_histogram_with(boost_histogram_sparse_storage(),
+					    boost::histogram::axis::regular<double> {nxbins, xmin, xmax, "x"},
+					    boost::histogram::axis::regular<double> {nybins, ymin, ymax, "y"},
+					    boost::histogram::axis::regular<double> {nzbins, zmin, zmax, "z"},
+					    boost::histogram::axis::regular<double> {nebins, emin, emax, "energy"});
+  
+  h_err = boost::histogram::make_histogram_with(boost_histogram_sparse_storage(),
+						boost::histogram::axis::regular<double> {nxbins, xmin, xmax, "x"},
+						boost::histogram::axis::regular<double> {nybins, ymin, ymax, "y"},
+						boost::histogram::axis::regular<double> {nzbins, zmin, zmax, "z"},
+						boost::histogram::axis::regular<double> {nebins, emin, emax, "energy"});
+}
+
+template <>
+BDSBH4D<boost_histogram_log_sparse>::BDSBH4D(std::string& name, std::string& title, const std::string& eScale,
+				      unsigned int nxbins, double xmin, double xmax,
+				      unsigned int nybins, double ymin, double ymax,
+				      unsigned int nzbins, double zmin, double zmax,
+				      unsigned int nebins, double emin, double emax):
+  BDSBH4DBase(nxbins, nybins, nzbins, nebins,
+	      xmin, xmax, ymin, ymax, zmin, zmax, emin, emax,
+	      name, title, eScale)
+{
+  h = boost::histogram::make_histogram_with(boost_histogram_sparse_storage(),
+					    boost::histogram::axis::regular<double> {nxbins, xmin, xmax, "x"},
+					    boost::histogram::axis::regular<double> {nybins, ymin, ymax, "y"},
+					    boost::histogram::axis::regular<double> {nzbins, zmin, zmax, "z"},
+					    boost::histogram::axis::regular<double, boost::histogram::axis::transform::log> {nebins, emin, emax, "energy"});
+  
+  h_err = boost::histogram::make_histogram_with(boost_histogram_sparse_storage(),
+						boost::histogram::axis::regular<double> {nxbins, xmin, xmax, "x"},
+						boost::histogram::axis::regular<double> {nybins, ymin, ymax, "y"},
+						boost::histogram::axis::regular<double> {nzbins, zmin, zmax, "z"},
+						boost::histogram::axis::regular<double, boost::histogram::axis::transform::log> {nebins, emin, emax, "energy"});
+}
+
+template <>
+BDSBH4D<boost_histogram_variable_sparse>::BDSBH4D(std::string& name, std::string& title, const std::string& eScale,
+					   const std::vector<double>& eBinEdgesIn,
+					   unsigned int nxbins, double xmin, double xmax,
+					   unsigned int nybins, double ymin, double ymax,
+					   unsigned int nzbins, double zmin, double zmax):
+  BDSBH4DBase(nxbins, nybins, nzbins, xmin, xmax, ymin, ymax, zmin, zmax, name, title, eScale, eBinEdgesIn)
+{
+  h = boost::histogram::make_histogram_with(boost_histogram_sparse_storage(),
+					    boost::histogram::axis::regular<double> {nxbins, xmin, xmax, "x"},
+					    boost::histogram::axis::regular<double> {nybins, ymin, ymax, "y"},
+					    boost::histogram::axis::regular<double> {nzbins, zmin, zmax, "z"},
+					    boost::histogram::axis::variable<double> {eBinEdgesIn, "energy"});
+  
+  h_err = boost::histogram::make_histogram_with(boost_histogram_sparse_storage(),
+						boost::histogram::axis::regular<double> {nxbins, xmin, xmax, "x"},
+						boost::histogram::axis::regular<double> {nybins, ymin, ymax, "y"},
+						boost::histogram::axis::regular<double> {nzbins, zmin, zmax, "z"},
+						boost::histogram::axis::variable<double> {eBinEdgesIn, "energy"});
+}
+
 template<class T>
 BDSBH4D<T>::~BDSBH4D()
 {;}
@@ -293,8 +417,121 @@ void BDSBH4D<T>::Print_BDSBH4D(int x, int y, int z, int e)
   std::cout << os4.str() << std::flush;
 }
 
+namespace
+{
+  /// @{ Append the index and value of each non-zero bin of a storage.
+  void NonZero(const boost_histogram_dense_storage& storage,
+               std::vector<std::pair<std::size_t, double> >& bins)
+  {
+    for (std::size_t i = 0; i < storage.size(); ++i)
+      {
+        if (storage[i] != 0)
+          {bins.emplace_back(i, storage[i]);}
+      }
+  }
+  void NonZero(const boost_histogram_sparse_storage& storage,
+               std::vector<std::pair<std::size_t, double> >& bins)
+  {
+    // the storage adaptor derives from the map, which only holds the non-zero bins
+    const std::map<std::size_t, boost_histogram_storage_type>& values = storage;
+    for (const auto& iv : values)
+      {
+        if (iv.second != 0)
+          {bins.emplace_back(iv.first, iv.second);}
+      }
+  }
+  /// @}
+
+  /// @{ Approximate memory used by a storage.
+  std::size_t Bytes(const boost_histogram_dense_storage& storage)
+  {return storage.size() * sizeof(boost_histogram_storage_type);}
+  std::size_t Bytes(const boost_histogram_sparse_storage& storage)
+  {
+    // each map node holds the pair, 3 pointers and a colour
+    const std::map<std::size_t, boost_histogram_storage_type>& values = storage;
+    return values.size() * (sizeof(std::pair<const std::size_t, boost_histogram_storage_type>) + 4*sizeof(void*));
+  }
+  /// @}
+}
+
+template <class T>
+BDSBH4DBase& BDSBH4D<T>::operator+=(const BDSBH4DBase& other)
+{
+  using namespace boost::histogram::literals;
+  const BDSBH4D<T>& o = dynamic_cast<const BDSBH4D<T>&>(other);
+  if (!(h.axis(0_c) == o.h.axis(0_c) && h.axis(1_c) == o.h.axis(1_c) &&
+        h.axis(2_c) == o.h.axis(2_c) && h.axis(3_c) == o.h.axis(3_c)))
+    {// let boost histogram report the incompatible axes
+      h += o.h;
+      return *this;
+    }
+  std::vector<std::pair<std::size_t, double> > bins;
+  o.NonZeroBins(bins);
+  auto& storage = boost::histogram::unsafe_access::storage(h);
+  for (const auto& bin : bins)
+    {storage[bin.first] += bin.second;}
+  return *this;
+}
+
+template <class T>
+bool BDSBH4D<T>::Sparse() const
+{
+  return std::is_same<typename T::storage_type, boost_histogram_sparse_storage>::value;
+}
+
+template <class T>
+std::size_t BDSBH4D<T>::NBinsTotal() const
+{
+  return h.size();
+}
+
+template <class T>
+void BDSBH4D<T>::NonZeroBins(std::vector<std::pair<std::size_t, double> >& bins) const
+{
+  NonZero(boost::histogram::unsafe_access::storage(h), bins);
+}
+
+template <class T>
+void BDSBH4D<T>::NonZeroErrorBins(std::vector<std::pair<std::size_t, double> >& bins) const
+{
+  NonZero(boost::histogram::unsafe_access::storage(h_err), bins);
+}
+
+template <class T>
+double BDSBH4D<T>::AtIndex(std::size_t i) const
+{
+  return boost::histogram::unsafe_access::storage(h)[i];
+}
+
+template <class T>
+double BDSBH4D<T>::AtErrorIndex(std::size_t i) const
+{
+  return boost::histogram::unsafe_access::storage(h_err)[i];
+}
+
+template <class T>
+void BDSBH4D<T>::SetAtIndex(std::size_t i, double value)
+{
+  boost::histogram::unsafe_access::storage(h)[i] = value;
+}
+
+template <class T>
+void BDSBH4D<T>::SetErrorAtIndex(std::size_t i, double value)
+{
+  boost::histogram::unsafe_access::storage(h_err)[i] = value;
+}
+
+template <class T>
+std::size_t BDSBH4D<T>::StorageBytes() const
+{
+  return Bytes(boost::histogram::unsafe_access::storage(h)) + Bytes(boost::histogram::unsafe_access::storage(h_err));
+}
+
 template class BDSBH4D<boost_histogram_linear>;
 template class BDSBH4D<boost_histogram_log>;
 template class BDSBH4D<boost_histogram_variable>;
+template class BDSBH4D<boost_histogram_linear_sparse>;
+template class BDSBH4D<boost_histogram_log_sparse>;
+template class BDSBH4D<boost_histogram_variable_sparse>;
 
 #endif
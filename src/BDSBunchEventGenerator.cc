@@ -60,6 +60,7 @@ BDSBunchEventGenerator::BDSBunchEventGenerator():
   eventGeneratorMinEK(0),
   eventGeneratorMaxEK(0),
   Rp0(0),
+  eventGeneratorPreload(false),
   firstTime(true),
   testOnParticleType(true),
   acceptedParticlesString("")
@@ -96,6 +97,7 @@ void BDSBunchEventGenerator::SetOptions(const BDSParticleDefinition* beamParticl
   eventGeneratorMinEK = beam.eventGeneratorMinEK * CLHEP::GeV;
   eventGeneratorMaxEK = beam.eventGeneratorMaxEK * CLHEP::GeV;
   acceptedParticlesString = beam.eventGeneratorParticles;
+  eventGeneratorPreload   = beam.eventGeneratorPreload;
   Rp0 = std::hypot(Xp0,Yp0);
 }
 
@@ -25,6 +25,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "BDSBunchEventGenerator.hh"
 #include "BDSBunchFactory.hh"
 #include "BDSBunchHalo.hh"
+#include "BDSBunchHaloDirect.hh"
 #include "BDSBunchHaloFlatSigma.hh"
 #include "BDSBunchPtc.hh"
 #include "BDSBunchRing.hh"
@@ -35,6 +36,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "BDSBunchTwiss.hh"
 #include "BDSBunchType.hh"
 #include "BDSBunchUserFile.hh"
+#include "BDSBunchUserFileBinary.hh"
 #include "BDSDebug.hh"
 #include "BDSException.hh"
 #include "BDSUtilities.hh"
@@ -121,6 +123,8 @@ BDSBunch* BDSBunchFactory::CreateBunch(const BDSParticleDefinition* beamParticle
           {bdsBunch = new BDSBunchUserFile<std::ifstream>();}
         break;
       }
+    case BDSBunchType::userfilebinary:
+      {bdsBunch = new BDSBunchUserFileBinary(); break;}
     case BDSBunchType::ptc:
       {bdsBunch = new BDSBunchPtc(); break;}
     case BDSBunchType::sixtrack:
@@ -134,6 +138,8 @@ BDSBunch* BDSBunchFactory::CreateBunch(const BDSParticleDefinition* beamParticle
       {bdsBunch = new BDSBunchBox(); break;}
     case BDSBunchType::halosigma:
       {bdsBunch = new BDSBunchHaloFlatSigma(); break;}
+    case BDSBunchType::halodirect:
+      {bdsBunch = new BDSBunchHaloDirect(); break;}
     default:
       {bdsBunch = new BDSBunch(); break;}
     }
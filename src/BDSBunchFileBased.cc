@@ -26,7 +26,8 @@ BDSBunchFileBased::BDSBunchFileBased(const G4String& distributionName):
   nEventsInFile(0),
   nEventsInFileSkipped(0),
   distrFileLoop(false),
-  distrFileLoopNTimes(0)
+  distrFileLoopNTimes(0),
+  distrFileIndex(false)
 {;}
 
 BDSBunchFileBased::~BDSBunchFileBased() 
@@ -41,6 +42,7 @@ void BDSBunchFileBased::SetOptions(const BDSParticleDefinition* beamParticle,
   BDSBunch::SetOptions(beamParticle, beam, distrType, beamlineTransformIn, beamlineSIn);
   distrFileLoop = beam.distrFileLoop || beam.distrFileLoopNTimes > 1;
   distrFileLoopNTimes = beam.distrFileLoopNTimes;
+  distrFileIndex = beam.distrFileIndex;
 }
 
 void BDSBunchFileBased::BeginOfRunAction(G4int /*numberOfEvents*/,
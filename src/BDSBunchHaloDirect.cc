@@ -0,0 +1,438 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "BDSBunchHaloDirect.hh"
+#include "BDSDebug.hh"
+#include "BDSException.hh"
+#include "BDSParticleCoordsFull.hh"
+
+#include "parser/beam.h"
+
+#include "globals.hh" // geant4 types / globals
+
+#include "CLHEP/Random/RandFlat.h"
+#include "CLHEP/Units/PhysicalConstants.h"
+#include "CLHEP/Units/SystemOfUnits.h"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace BDS
+{
+  HaloPlaneSampler::HaloPlaneSampler(G4double emitInnerIn,
+                                     G4double emitOuterIn,
+                                     const TwissPair& twissIn,
+                                     G4double posCutInnerIn,
+                                     G4double posCutOuterIn,
+                                     G4double angCutInnerIn,
+                                     G4double angCutOuterIn,
+                                     const G4String& weightFunctionIn,
+                                     G4double weightParameterIn,
+                                     G4int    nPointsIn):
+    emitInner(emitInnerIn),
+    emitOuter(emitOuterIn),
+    twiss(twissIn),
+    gamma((1.0 + twissIn.alpha*twissIn.alpha) / twissIn.beta),
+    posCutInner(posCutInnerIn),
+    posCutOuter(posCutOuterIn),
+    angCutInner(angCutInnerIn),
+    angCutOuter(angCutOuterIn),
+    weightFunction(weightFunctionIn),
+    weightParameter(weightParameterIn),
+    angleShift(CLHEP::halfpi - std::atan(twissIn.alpha))
+  {
+    // |x'| = sqrt(emittance * gamma) * |sin(phi + atan(alpha))|, which is expressed
+    // as a cosine band shifted by angleShift so both cuts are treated the same way.
+    
+    G4int nPoints = std::max(nPointsIn, 2);
+    if (emitOuter > emitInner)
+      {
+        // geometric spacing resolves the weight functions that fall steeply from the
+        // inner edge even when the outer edge is very large
+        G4double ratio = emitOuter / emitInner;
+        for (G4int i = 0; i < nPoints; i++)
+          {emittances.push_back(emitInner * std::pow(ratio, (G4double)i / (G4double)(nPoints - 1)));}
+        emittances.back() = emitOuter;
+      }
+    else
+      {emittances = {emitInner, emitInner};}
+
+    std::vector<G4double> gWeighted;
+    std::vector<G4double> gComplement;
+    std::vector<G4double> gUnweighted;
+    for (const auto& emittance : emittances)
+      {
+        G4double length = Length(AllowedAngles(emittance));
+        G4double w = Weight(emittance);
+        gWeighted.push_back(w * length);
+        gComplement.push_back((1.0 - w) * length);
+        gUnweighted.push_back(length);
+      }
+
+    auto cumulate = [&](const std::vector<G4double>& g, std::vector<G4double>& cdf)
+    {
+      cdf.push_back(0);
+      for (G4int i = 1; i < (G4int)emittances.size(); i++)
+        {
+          G4double de = emittances[i] - emittances[i-1];
+          // degenerate (single ellipse) case - all probability at one emittance
+          G4double increment = de > 0 ? 0.5 * (g[i-1] + g[i]) * de : g[i];
+          cdf.push_back(cdf.back() + increment);
+        }
+    };
+    cumulate(gWeighted,   cdfWeighted);
+    cumulate(gComplement, cdfComplement);
+    cumulate(gUnweighted, cdfUnweighted);
+  }
+
+  G4double HaloPlaneSampler::Integral(Density density) const
+  {
+    return CDF(density).back();
+  }
+
+  PhaseSpaceCoord HaloPlaneSampler::Sample(Density density) const
+  {
+    const std::vector<G4double>& cdf = CDF(density);
+    // The allowed angular range can vanish exactly at a tabulated edge (e.g. where a cut
+    // first intersects the ellipse) so we redraw in that rare case.
+    for (G4int i = 0; i < 100; i++)
+      {
+        G4double emittance = SampleEmittance(cdf);
+        AngleIntervals intervals = AllowedAngles(emittance);
+        if (Length(intervals) <= 0)
+          {continue;}
+        ActionAngleCoord aa = {0.5 * emittance, SampleAngle(intervals)};
+        return PhaseSpaceCoordFromActionAngle(aa, twiss);
+      }
+    throw BDSException(__METHOD_NAME__, "unable to sample an allowed phase space point");
+  }
+
+  G4double HaloPlaneSampler::Weight(G4double emittance) const
+  {
+    G4double w = 1.0;
+    if (weightFunction == "oneoverr")
+      {w = std::pow(std::abs(emitInner / emittance), weightParameter);}
+    else if (weightFunction == "oneoverrsqrd")
+      {w = std::pow(std::abs((emitInner * emitInner) / (emittance * emittance)), weightParameter);}
+    else if (weightFunction == "exp")
+      {w = std::exp(-(emittance * weightParameter) / emitInner);}
+    // as an acceptance probability it saturates at 1
+    return std::min(std::max(w, 0.0), 1.0);
+  }
+
+  AngleIntervals HaloPlaneSampler::AllowedAngles(G4double emittance) const
+  {
+    if (emittance <= 0)
+      {return AngleIntervals();}
+    G4double xMax  = std::sqrt(emittance * twiss.beta);
+    G4double xpMax = std::sqrt(emittance * gamma);
+    AngleIntervals position = CosineBand(posCutInner / xMax, posCutOuter / xMax, 0);
+    AngleIntervals angle    = CosineBand(angCutInner / xpMax, angCutOuter / xpMax, angleShift);
+    return Intersection(position, angle);
+  }
+
+  G4double HaloPlaneSampler::SampleEmittance(const std::vector<G4double>& cdf) const
+  {
+    G4double u = cdf.back() * G4RandFlat::shoot();
+    auto it = std::upper_bound(cdf.begin(), cdf.end(), u);
+    if (it == cdf.end())
+      {return emittances.back();}
+    auto n = std::distance(cdf.begin(), it); // >= 1 as cdf[0] = 0 <= u
+    G4double c0 = cdf[n-1];
+    G4double c1 = cdf[n];
+    G4double f  = c1 > c0 ? (u - c0) / (c1 - c0) : 0;
+    return emittances[n-1] + f * (emittances[n] - emittances[n-1]);
+  }
+
+  G4double HaloPlaneSampler::SampleAngle(const AngleIntervals& intervals)
+  {
+    G4double remainder = Length(intervals) * G4RandFlat::shoot();
+    for (const auto& interval : intervals)
+      {
+        G4double width = interval.second - interval.first;
+        if (remainder <= width)
+          {return interval.first + remainder;}
+        remainder -= width;
+      }
+    return intervals.back().second;
+  }
+
+  AngleIntervals HaloPlaneSampler::CosineBand(G4double cLow, G4double cHigh, G4double shift)
+  {
+    // angle of the first quadrant with the same |cos|
+    G4double a = std::acos(std::min(std::max(cHigh, 0.0), 1.0));
+    G4double b = std::acos(std::min(std::max(cLow,  0.0), 1.0));
+    AngleIntervals result;
+    if (b <= a)
+      {return result;}
+
+    const G4double pi    = CLHEP::pi;
+    const G4double twopi = CLHEP::twopi;
+    AngleIntervals base = {{a, b}, {pi - b, pi - a}, {pi + a, pi + b}, {twopi - b, twopi - a}};
+    for (const auto& interval : base)
+      {
+        G4double lower = std::fmod(interval.first + shift, twopi);
+        if (lower < 0)
+          {lower += twopi;}
+        G4double upper = lower + (interval.second - interval.first);
+        if (upper > twopi)
+          {// split across the wrap around
+            result.emplace_back(lower, twopi);
+            result.emplace_back(0, upper - twopi);
+          }
+        else
+          {result.emplace_back(lower, upper);}
+      }
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+
+  AngleIntervals HaloPlaneSampler::Intersection(const AngleIntervals& a, const AngleIntervals& b)
+  {
+    AngleIntervals result;
+    auto ia = a.begin();
+    auto ib = b.begin();
+    while (ia != a.end() && ib != b.end())
+      {
+        G4double lower = std::max(ia->first,  ib->first);
+        G4double upper = std::min(ia->second, ib->second);
+        if (upper > lower)
+          {result.emplace_back(lower, upper);}
+        if (ia->second < ib->second)
+          {++ia;}
+        else
+          {++ib;}
+      }
+    return result;
+  }
+
+  G4double HaloPlaneSampler::Length(const AngleIntervals& intervals)
+  {
+    G4double result = 0;
+    for (const auto& interval : intervals)
+      {result += interval.second - interval.first;}
+    return result;
+  }
+
+  const std::vector<G4double>& HaloPlaneSampler::CDF(Density density) const
+  {
+    switch (density)
+      {
+      case Density::weighted:
+        {return cdfWeighted;}
+      case Density::complement:
+        {return cdfComplement;}
+      default:
+        {return cdfUnweighted;}
+      }
+  }
+}
+
+BDSBunchHaloDirect::BDSBunchHaloDirect():
+  BDSBunch("halodirect"),
+  alphaX(0.0), alphaY(0.0),
+  betaX(0.0), betaY(0.0),
+  emitX(0.0), emitY(0.0),
+  gammaX(0.0), gammaY(0.0),
+  sigmaX(0.0), sigmaY(0.0),
+  sigmaXp(0.0), sigmaYp(0.0),
+  haloNSigmaXInner(0.0), haloNSigmaXOuter(0.0),
+  haloNSigmaYInner(0.0), haloNSigmaYOuter(0.0),
+  haloXCutInner(0.0),
+  haloYCutInner(0.0),
+  haloXCutOuter(0.0),
+  haloYCutOuter(0.0),
+  haloXpCutInner(0.0),
+  haloYpCutInner(0.0),
+  haloXpCutOuter(0.0),
+  haloYpCutOuter(0.0),
+  haloPSWeightParameter(0.0),
+  weightFunction(""),
+  samplerX(nullptr),
+  samplerY(nullptr),
+  probabilityXWeighted(1.0)
+{;}
+
+BDSBunchHaloDirect::~BDSBunchHaloDirect()
+{
+  delete samplerX;
+  delete samplerY;
+}
+
+void BDSBunchHaloDirect::SetOptions(const BDSParticleDefinition* beamParticle,
+                                    const GMAD::Beam& beam,
+                                    const BDSBunchType& distrType,
+                                    G4Transform3D beamlineTransformIn,
+                                    const G4double beamlineSIn)
+{
+  BDSBunch::SetOptions(beamParticle, beam, distrType, beamlineTransformIn, beamlineSIn);
+  alphaX                = G4double(beam.alfx);
+  alphaY                = G4double(beam.alfy);
+  betaX                 = G4double(beam.betx);
+  betaY                 = G4double(beam.bety);
+  gammaX                = (1.0+alphaX*alphaX)/betaX;
+  gammaY                = (1.0+alphaY*alphaY)/betaY;
+  haloNSigmaXInner      = G4double(beam.haloNSigmaXInner);
+  haloNSigmaXOuter      = G4double(beam.haloNSigmaXOuter);
+  haloNSigmaYInner      = G4double(beam.haloNSigmaYInner);
+  haloNSigmaYOuter      = G4double(beam.haloNSigmaYOuter);
+  haloXCutInner         = G4double(beam.haloXCutInner);
+  haloYCutInner         = G4double(beam.haloYCutInner);
+  haloXCutOuter         = G4double(beam.haloXCutOuter);
+  haloYCutOuter         = G4double(beam.haloYCutOuter);
+  haloXpCutInner        = G4double(beam.haloXpCutInner);
+  haloYpCutInner        = G4double(beam.haloYpCutInner);
+  haloXpCutOuter        = G4double(beam.haloXpCutOuter);
+  haloYpCutOuter        = G4double(beam.haloYpCutOuter);
+  haloPSWeightParameter = G4double(beam.haloPSWeightParameter);
+  weightFunction = G4String(beam.haloPSWeightFunction);
+
+  G4double ex,ey; // dummy variables we don't need
+  SetEmittances(beamParticle, beam, emitX, emitY, ex, ey);
+
+  sigmaX                = std::sqrt(emitX * betaX);
+  sigmaY                = std::sqrt(emitY * betaY);
+  sigmaXp               = std::sqrt(gammaX * emitX);
+  sigmaYp               = std::sqrt(gammaY * emitY);
+
+  CheckParameters();
+
+  delete samplerX;
+  delete samplerY;
+  samplerX = new BDS::HaloPlaneSampler(std::pow(haloNSigmaXInner, 2) * emitX,
+                                       std::pow(haloNSigmaXOuter, 2) * emitX,
+                                       {alphaX, betaX},
+                                       haloXCutInner  * sigmaX,
+                                       haloXCutOuter  * sigmaX,
+                                       haloXpCutInner * sigmaXp,
+                                       haloXpCutOuter * sigmaXp,
+                                       weightFunction,
+                                       haloPSWeightParameter);
+  samplerY = new BDS::HaloPlaneSampler(std::pow(haloNSigmaYInner, 2) * emitY,
+                                       std::pow(haloNSigmaYOuter, 2) * emitY,
+                                       {alphaY, betaY},
+                                       haloYCutInner  * sigmaY,
+                                       haloYCutOuter  * sigmaY,
+                                       haloYpCutInner * sigmaYp,
+                                       haloYpCutOuter * sigmaYp,
+                                       weightFunction,
+                                       haloPSWeightParameter);
+
+  // BDSBunchHalo rejects a point only if it fails the weight test in both planes, so the
+  // acceptance is 1 - (1-wx)(1-wy) = wx + (1-wx)wy. This is a mixture of two separable
+  // densities that we can choose between up front.
+  using Density = BDS::HaloPlaneSampler::Density;
+  G4double massXWeighted = samplerX->Integral(Density::weighted)   * samplerY->Integral(Density::unweighted);
+  G4double massYWeighted = samplerX->Integral(Density::complement) * samplerY->Integral(Density::weighted);
+  G4double total = massXWeighted + massYWeighted;
+  if (total <= 0)
+    {throw BDSException(__METHOD_NAME__, "no phase space remains after applying the halo emittance limits and cuts");}
+  probabilityXWeighted = massXWeighted / total;
+}
+
+BDSParticleCoordsFull BDSBunchHaloDirect::GetNextParticleLocal()
+{
+  using Density = BDS::HaloPlaneSampler::Density;
+  G4bool xWeighted = G4RandFlat::shoot() < probabilityXWeighted;
+  BDS::PhaseSpaceCoord xps = samplerX->Sample(xWeighted ? Density::weighted   : Density::complement);
+  BDS::PhaseSpaceCoord yps = samplerY->Sample(xWeighted ? Density::unweighted : Density::weighted);
+
+#ifdef BDSDEBUG
+  G4cout << __METHOD_NAME__ << "selected> " << xps.position << " " << yps.position << " "
+         << xps.momentum << " " << yps.momentum << G4endl;
+#endif
+  
+  // add to reference orbit
+  G4double x  = X0  + xps.position * CLHEP::m;
+  G4double y  = Y0  + yps.position * CLHEP::m;
+  G4double xp = Xp0 + xps.momentum * CLHEP::rad;
+  G4double yp = Yp0 + yps.momentum * CLHEP::rad;
+  G4double z  = 0;
+  G4double zp = CalculateZp(xp, yp, Zp0);
+
+  // E0 and T0 from base class and already in G4 units
+  BDSParticleCoordsFull result(x,y,z,xp,yp,zp,T0,S0+z,E0,/*weight=*/1.0);
+  return result;
+}
+
+void BDSBunchHaloDirect::CheckParameters()
+{
+  BDSBunch::CheckParameters();
+  
+  if (emitX <= 0)
+    {throw BDSException(__METHOD_NAME__, "emitx must be finite!");}
+  if (emitY <= 0)
+    {throw BDSException(__METHOD_NAME__, "emity must be finite!");}
+  
+  if (betaX <= 0)
+    {throw BDSException(__METHOD_NAME__, "betx must be finite!");}
+  if (betaY <= 0)
+    {throw BDSException(__METHOD_NAME__, "bety must be finite!");}
+
+  std::vector<G4String> weightFunctions = {"", "one", "flat","oneoverr", "oneoverrsqrd", "exp"};
+  auto search = std::find(weightFunctions.begin(), weightFunctions.end(), weightFunction);
+  if (search == weightFunctions.end())
+    {
+      G4cerr << __METHOD_END__ << "invalid haloPSWeightFunction \"" << weightFunction << "\"" << G4endl;
+      G4cout << "Available weight functions are:" << G4endl;
+      for (const auto& w : weightFunctions)
+        {G4cout << w << G4endl;}
+      throw BDSException(__METHOD_END__, "");
+    }
+  
+  if (haloNSigmaXInner <= 0)
+    {throw BDSException(__METHOD_NAME__, "haloNSigmaXInner <= 0");}
+  
+  if (haloNSigmaYInner <= 0)
+    {throw BDSException(__METHOD_NAME__, "haloNSigmaYInner <= 0");}
+  
+  if (haloNSigmaXInner > haloNSigmaXOuter)
+    {throw BDSException(__METHOD_NAME__, "haloNSigmaXInner cannot be less than haloNSigmaXOuter");}
+  
+  if (haloNSigmaYInner > haloNSigmaYOuter)
+    {throw BDSException(__METHOD_NAME__, "haloNSigmaYInner cannot be less than haloNSigmaYOuter");}
+
+  if (haloXCutInner < 0)
+    {throw BDSException(__METHOD_NAME__, "haloXCutInner < 0");}
+
+  if (haloYCutInner < 0)
+    {throw BDSException(__METHOD_NAME__, "haloYCutInner < 0");}
+
+  if (haloXCutOuter <= haloXCutInner)
+    {throw BDSException(__METHOD_NAME__, "haloXCutOuter must be greater than haloXCutInner!");}
+
+  if (haloYCutOuter <= haloYCutInner)
+    {throw BDSException(__METHOD_NAME__, "haloYCutOuter must be greater than haloYCutInner!");}
+
+  if (haloXpCutInner < 0)
+    {throw BDSException(__METHOD_NAME__, "haloXpCutInner < 0");}
+
+  if (haloYpCutInner < 0)
+    {throw BDSException(__METHOD_NAME__, "haloYpCutInner < 0");}
+
+  if (haloXpCutOuter <= haloXpCutInner)
+    {throw BDSException(__METHOD_NAME__, "haloXpCutOuter must be greater than haloXpCutInner!");}
+
+  if (haloYpCutOuter <= haloYpCutInner)
+    {throw BDSException(__METHOD_NAME__, "haloYpCutOuter must be greater than haloYpCutInner!");}
+}
@@ -19,8 +19,11 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "BDSBunchSixTrackLink.hh"
 #include "BDSDebug.hh"
 #include "BDSException.hh"
+#include "BDSGlobalConstants.hh"
 #include "BDSIonDefinition.hh"
+#include "BDSParticleCoordsFull.hh"
 #include "BDSParticleDefinition.hh"
+#include "BDSPhysicsUtilities.hh"
 
 #include "globals.hh"
 #include "G4IonTable.hh"
@@ -28,6 +31,9 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "G4ParticleTable.hh"
 #include "G4String.hh"
 
+#include "CLHEP/Units/SystemOfUnits.h"
+
+#include <string>
 #include <vector>
 
 BDSBunchSixTrackLink::BDSBunchSixTrackLink():
@@ -36,11 +42,14 @@ BDSBunchSixTrackLink::BDSBunchSixTrackLink():
   currentExternalParticleID(0),
   currentExternalParentID(0),
   currentParticleDefinition(nullptr),
-  size(0)
+  size(0),
+  arrayParticleDefinition(nullptr)
 {;}
 
 BDSBunchSixTrackLink::~BDSBunchSixTrackLink()
-{;}
+{
+  delete arrayParticleDefinition;
+}
 
 BDSParticleCoordsFull BDSBunchSixTrackLink::GetNextParticleLocal()
 {
@@ -52,6 +61,9 @@ BDSParticleCoordsFull BDSBunchSixTrackLink::GetNextParticleLocal()
 
   G4int ci = currentIndex;
   currentIndex++;
+
+  if (arrays.n > 0)
+    {return ParticleFromArrays(ci);}
   
   auto particle = particles[ci];
   currentParticleDefinition = particle->particleDefinition;
@@ -70,10 +82,21 @@ void BDSBunchSixTrackLink::AddParticle(BDSParticleDefinition*       particleDefi
                                        int   externalParticleID,
                                        int   externalParentID)
 {
+  if (arrays.n > 0)
+    {throw BDSException(__METHOD_NAME__, "particle arrays are in use - call ClearParticles first");}
   particles.emplace_back(new BDSParticleExternal(particleDefinitionIn, coordsIn, externalParticleID, externalParentID));
   size = (G4int)particles.size();
 }
 
+void BDSBunchSixTrackLink::SetParticleArrays(const ParticleArrays& arraysIn)
+{
+  if (arraysIn.n > 0 && (!arraysIn.x || !arraysIn.y || !arraysIn.xp || !arraysIn.yp || !arraysIn.totalEnergy || !arraysIn.pdgID))
+    {throw BDSException(__METHOD_NAME__, "x, y, xp, yp, totalEnergy and pdgID arrays are required");}
+  ClearParticles();
+  arrays = arraysIn;
+  size = arrays.n;
+}
+
 void BDSBunchSixTrackLink::ClearParticles()
 {
   currentIndex = 0;
@@ -81,6 +104,61 @@ void BDSBunchSixTrackLink::ClearParticles()
   for (auto p : particles)
     {delete p;}
   particles.clear();
+  arrays = ParticleArrays();
+}
+
+BDSParticleCoordsFull BDSBunchSixTrackLink::ParticleFromArrays(G4int i)
+{
+  G4int pdgID = arrays.pdgID[i];
+  G4bool ionInfo = arrays.ionA && arrays.ionZ;
+  G4ParticleTable* particleTable = G4ParticleTable::GetParticleTable();
+  G4ParticleDefinition* particleDef = nullptr;
+  if (ionInfo && arrays.ionZ[i] > 1)
+    {particleDef = particleTable->GetIonTable()->GetIon(arrays.ionZ[i], arrays.ionA[i]);}
+  else
+    {particleDef = particleTable->FindParticle(pdgID);}
+  if (!particleDef)
+    {throw BDSException(__METHOD_NAME__, "particle with PDG ID " + std::to_string(pdgID) + " not found");}
+
+  BDSIonDefinition* ionDef = nullptr;
+  if (BDS::IsIon(particleDef) && ionInfo)
+    {
+      G4double q = arrays.ionCharge ? arrays.ionCharge[i] : (G4double)arrays.ionZ[i];
+      ionDef = new BDSIonDefinition(arrays.ionA[i], arrays.ionZ[i], q * CLHEP::eplus);
+    }
+
+  G4double totalEnergy = arrays.totalEnergy[i] * CLHEP::GeV;
+  G4double ffact = BDSGlobalConstants::Instance()->FFact();
+  BDSParticleDefinition* newDefinition = nullptr;
+  try
+    {newDefinition = new BDSParticleDefinition(particleDef, totalEnergy, 0, 0, ffact, ionDef);}
+  catch (const BDSException&)
+    {
+      delete ionDef;
+      throw;
+    }
+  delete ionDef; // copied by the particle definition
+  delete arrayParticleDefinition;
+  arrayParticleDefinition   = newDefinition;
+  currentParticleDefinition = arrayParticleDefinition;
+  particleDefinitionHasBeenUpdated = true;
+  UpdateIonDefinition();
+
+  currentExternalParticleID = arrays.externalParticleID ? arrays.externalParticleID[i] : i;
+  currentExternalParentID   = arrays.externalParentID   ? arrays.externalParentID[i]   : i;
+
+  G4double xp = arrays.xp[i];
+  G4double yp = arrays.yp[i];
+  return BDSParticleCoordsFull(arrays.x[i] * CLHEP::m,
+                               arrays.y[i] * CLHEP::m,
+                               0,
+                               xp,
+                               yp,
+                               BDSBunch::CalculateZp(xp, yp, 1),
+                               arrays.t ? arrays.t[i] * CLHEP::s : 0,
+                               0,
+                               totalEnergy,
+                               1);
 }
 
 void BDSBunchSixTrackLink::UpdateGeant4ParticleDefinition(G4int pdgID)
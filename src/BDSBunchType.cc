@@ -42,6 +42,7 @@ std::map<BDSBunchType, std::string>* BDSBunchType::dictionary =
       {BDSBunchType::halo,        "halo"},
       {BDSBunchType::composite,   "composite"},
       {BDSBunchType::userfile,    "userfile"},
+      {BDSBunchType::userfilebinary, "userfilebinary"},
       {BDSBunchType::ptc,         "ptc"},
       {BDSBunchType::sixtrack,    "sixtrack"},
       {BDSBunchType::eventgeneratorfile, "eventgeneratorfile"},
@@ -49,6 +50,7 @@ std::map<BDSBunchType, std::string>* BDSBunchType::dictionary =
       {BDSBunchType::compositesde,"compositespacedirectionenergy"},
       {BDSBunchType::box,         "box"},
       {BDSBunchType::halosigma,   "halosigma"},
+      {BDSBunchType::halodirect,  "halodirect"},
       {BDSBunchType::bdsimsampler, "bdsimsampler"}
 });
 
@@ -67,6 +69,7 @@ BDSBunchType BDS::DetermineBunchType(G4String distrType)
   types["halo"]           = BDSBunchType::halo;
   types["composite"]      = BDSBunchType::composite;
   types["userfile"]       = BDSBunchType::userfile;
+  types["userfilebinary"] = BDSBunchType::userfilebinary;
   types["ptc"]            = BDSBunchType::ptc;
   types["sixtrack"]       = BDSBunchType::sixtrack;
   types["eventgeneratorfile"] = BDSBunchType::eventgeneratorfile;
@@ -75,6 +78,7 @@ BDSBunchType BDS::DetermineBunchType(G4String distrType)
   types["compositesde"]   = BDSBunchType::compositesde;
   types["box"]            = BDSBunchType::box;
   types["halosigma"]      = BDSBunchType::halosigma;
+  types["halodirect"]     = BDSBunchType::halodirect;
   types["bdsimsampler"]   = BDSBunchType::bdsimsampler;
 
   distrType = BDS::LowerCase(distrType);
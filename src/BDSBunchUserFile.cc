@@ -19,6 +19,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "BDSBunchUserFile.hh"
 #include "BDSDebug.hh"
 #include "BDSException.hh"
+#include "BDSFileOffsetIndex.hh"
 #include "BDSGlobalConstants.hh"
 #include "BDSIonDefinition.hh"
 #include "BDSParticleDefinition.hh"
@@ -42,6 +43,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include <set>
 #include <string>
 #include <sstream>
+#include <type_traits>
 #include <vector>
 
 template <class T>
@@ -56,6 +58,7 @@ BDSBunchUserFile<T>::BDSBunchUserFile():
   anEnergyCoordinateInUse(false),
   changingParticleType(false),
   endOfFileReached(false),
+  fileIndex(nullptr),
   matchDistrFileLength(false)
 {
   ffact = BDSGlobalConstants::Instance()->FFact();
@@ -74,6 +77,7 @@ template<class T>
 BDSBunchUserFile<T>::~BDSBunchUserFile()
 {
   CloseBunchFile();
+  delete fileIndex;
 }
 
 template<class T>
@@ -261,6 +265,11 @@ void BDSBunchUserFile<T>::SkipNLinesIgnoreIntoFile(G4bool usualPrintOut)
     {
       if (usualPrintOut)
         {G4cout << "BDSBunchUserFile> ignoring " << nlinesIgnore << " lines" << G4endl;}
+      if (fileIndex)
+        {
+          SeekToValidLine(0);
+          return;
+        }
       std::string line;
       for (G4int i = 0; i < (G4int)nlinesIgnore; i++)
         {
@@ -284,6 +293,12 @@ void BDSBunchUserFile<T>::SkipNLinesSkip(G4bool usualPrintOut)
     {
       if (usualPrintOut)
         {G4cout << "BDSBunchUserFile> skipping " << nlinesSkip << " valid lines" << G4endl;}
+      if (fileIndex)
+        {
+          SeekToValidLine(nlinesSkip);
+          IncrementNEventsInFileSkipped((unsigned long long int)nlinesSkip);
+          return;
+        }
       
       // We can read into the file safely without checking eof() because we know from earlier
       // counting of the number of valid lines in the file that nlinesSkip is not beyond the
@@ -325,9 +340,23 @@ G4bool BDSBunchUserFile<T>::SkippableLine(const std::string& line) const
   return std::all_of(line.begin(), line.end(), isspace) || std::regex_search(line, comment);
 }
 
+template<class T>
+void BDSBunchUserFile<T>::SeekToValidLine(G4long validLineIndex)
+{
+  if (validLineIndex < fileIndex->NRecords())
+    {lineCounter = (G4int)fileIndex->SeekToRecord(InputBunchFile, validLineIndex);}
+  else
+    {// no more valid data - let the usual end of file handling happen on the next read
+      InputBunchFile.clear();
+      InputBunchFile.seekg(0, std::ios::end);
+    }
+}
+
 template<class T>
 G4long BDSBunchUserFile<T>::CountNLinesValidDataInFile()
 {
+  if (fileIndex)
+    {return fileIndex->NRecords();}
   OpenBunchFile();
   SkipNLinesIgnoreIntoFile(false);
 
@@ -346,6 +375,17 @@ G4long BDSBunchUserFile<T>::CountNLinesValidDataInFile()
 template<class T>
 void BDSBunchUserFile<T>::Initialise()
 {
+  if (DistrFileIndex())
+    {
+      // offsets in a compressed file don't correspond to the stream so only plain files
+      if (std::is_same<T, std::ifstream>::value)
+        {
+          auto isValidLine = [this](const std::string& line){return !SkippableLine(line);};
+          fileIndex = new BDSFileOffsetIndex(distrFilePath, "userfile-valid-line", isValidLine, nlinesIgnore);
+        }
+      else
+        {BDS::Warning(__METHOD_NAME__, "distrFileIndex is not possible for compressed files - ignoring");}
+    }
   nLinesValidData = CountNLinesValidDataInFile();
 
   if (nLinesValidData < nlinesSkip)
@@ -462,6 +502,12 @@ void BDSBunchUserFile<T>::RecreateAdvanceToEvent(G4int eventOffset)
   // generator action in the start of the event after BeamOn(nEvents) has been called
   // therefore this adjustment for recreation + match is done earlier in this class
 
+  if (fileIndex)
+    {// this is called before any coordinates are read so the file is just after nlinesSkip
+      SeekToValidLine(nlinesSkip + eventOffset);
+      return;
+    }
+
   // we should now be completely safe to read into the file ignoring comment lines and
   // without checking eof()
   std::string line;
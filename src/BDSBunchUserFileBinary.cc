@@ -0,0 +1,467 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "BDSBunchUserFile.hh"
+#include "BDSBunchUserFileBinary.hh"
+#include "BDSDebug.hh"
+#include "BDSException.hh"
+#include "BDSGlobalConstants.hh"
+#include "BDSIonDefinition.hh"
+#include "BDSParticleCoordsFull.hh"
+#include "BDSParticleCoordsFullGlobal.hh"
+#include "BDSParticleDefinition.hh"
+#include "BDSUtilities.hh"
+
+#include "parser/beam.h"
+
+#include "G4IonTable.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4ParticleTable.hh"
+#include "G4String.hh"
+#include "G4Types.hh"
+
+#include "CLHEP/Units/SystemOfUnits.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const G4String BDSBunchUserFileBinary::headerIdentifier    = "# BDSIM binary user file";
+const G4String BDSBunchUserFileBinary::headerEndIdentifier = "! binary column major doubles follow";
+
+BDSBunchUserFileBinary::BDSBunchUserFileBinary():
+  BDSBunchFileBased("userfilebinary"),
+  nlinesSkip(0),
+  matchDistrFileLength(false),
+  endOfFileReached(false),
+  anEnergyCoordinateInUse(false),
+  changingParticleType(false),
+  nRows(0),
+  currentRow(0),
+  dataOffset(0),
+  currentPDGID(0),
+  mappedData(nullptr),
+  mappedSize(0)
+{
+  ffact = BDSGlobalConstants::Instance()->FFact();
+}
+
+BDSBunchUserFileBinary::~BDSBunchUserFileBinary()
+{
+  UnmapFile();
+}
+
+void BDSBunchUserFileBinary::SetOptions(const BDSParticleDefinition* beamParticle,
+                                        const GMAD::Beam& beam,
+                                        const BDSBunchType& distrType,
+                                        G4Transform3D beamlineTransformIn,
+                                        const G4double beamlineSIn)
+{
+  BDSBunchFileBased::SetOptions(beamParticle, beam, distrType, beamlineTransformIn, beamlineSIn);
+  distrFile     = beam.distrFile;
+  distrFilePath = BDS::GetFullPath(beam.distrFile);
+  nlinesSkip    = (G4long)beam.nlinesSkip;
+  matchDistrFileLength = beam.distrFileMatchLength;
+}
+
+void BDSBunchUserFileBinary::CheckParameters()
+{
+  BDSBunch::CheckParameters();
+  if (distrFile.empty())
+    {throw BDSException(__METHOD_NAME__, "No input file specified for userfilebinary distribution");}
+  if (nlinesSkip < 0)
+    {throw BDSException(__METHOD_NAME__, "nlinesSkip < 0");}
+}
+
+void BDSBunchUserFileBinary::ReadHeader()
+{
+  std::ifstream in(distrFilePath, std::ios::binary);
+  if (!in.good())
+    {throw BDSException(__METHOD_NAME__, "Cannot open bunch file " + distrFilePath);}
+
+  std::string line;
+  std::getline(in, line);
+  if (line != headerIdentifier)
+    {throw BDSException(__METHOD_NAME__, "\"" + distrFilePath + "\" is not a BDSIM binary user file");}
+
+  G4int  version = 0;
+  G4bool foundEnd = false;
+  G4String format;
+  nRows = -1;
+  // the header is only a few lines - limit the search in case of a bad file
+  for (G4int i = 0; i < 100 && std::getline(in, line); i++)
+    {
+      if (BDS::StrContains(line, headerEndIdentifier))
+        {
+          foundEnd = true;
+          break;
+        }
+      std::istringstream ss(line);
+      std::string key;
+      ss >> key;
+      if (key == "version")
+        {ss >> version;}
+      else if (key == "rows")
+        {ss >> nRows;}
+      else if (key == "format")
+        {ss >> format;}
+    }
+  if (!foundEnd)
+    {throw BDSException(__METHOD_NAME__, "no end of header found in \"" + distrFilePath + "\"");}
+  if (version != 1)
+    {throw BDSException(__METHOD_NAME__, "unsupported version " + std::to_string(version) + " in \"" + distrFilePath + "\"");}
+  if (nRows < 0 || format.empty())
+    {throw BDSException(__METHOD_NAME__, "incomplete header in \"" + distrFilePath + "\"");}
+  dataOffset = (std::size_t)in.tellg();
+  if (dataOffset % sizeof(G4double) != 0)
+    {throw BDSException(__METHOD_NAME__, "binary data in \"" + distrFilePath + "\" are not aligned");}
+  
+  ParseFileFormat(format);
+
+  std::size_t expectedSize = dataOffset + (std::size_t)nRows * columnTypes.size() * sizeof(G4double);
+  struct stat sb;
+  if (stat(distrFilePath.c_str(), &sb) != 0 || (std::size_t)sb.st_size != expectedSize)
+    {
+      G4String msg = "size of \"" + distrFilePath + "\" doesn't match the header - expected ";
+      msg += std::to_string(expectedSize) + " bytes";
+      throw BDSException(__METHOD_NAME__, msg);
+    }
+}
+
+void BDSBunchUserFileBinary::ParseFileFormat(const G4String& format)
+{
+  columnTypes.clear();
+  columnFactors.clear();
+  G4String formatSpaced = format;
+  std::replace(formatSpaced.begin(), formatSpaced.end(), ':', ' ');
+  std::vector<G4String> tokens = BDS::SplitOnWhiteSpace(formatSpaced);
+  for (const auto& token : tokens)
+    {
+      G4String name = token;
+      G4String unit = "";
+      std::size_t pos1 = token.find('[');
+      if (pos1 != std::string::npos)
+        {
+          std::size_t pos2 = token.find(']', pos1);
+          if (pos2 == std::string::npos)
+            {throw BDSException(__METHOD_NAME__, "Missing bracket [] in units of column \"" + token + "\"");}
+          name = token.substr(0, pos1);
+          unit = token.substr(pos1 + 1, pos2 - pos1 - 1);
+        }
+      
+      ColumnType type = ColumnType::skip;
+      G4double factor = 1.0;
+      if (name == "E" || name == "Ek" || name == "P")
+        {
+          type = name == "E" ? ColumnType::E : (name == "Ek" ? ColumnType::Ek : ColumnType::P);
+          factor = CLHEP::GeV * (unit.empty() ? 1.0 : BDS::ParseEnergyUnit(unit));
+          anEnergyCoordinateInUse = true;
+        }
+      else if (name == "t")
+        {
+          type = ColumnType::t;
+          factor = CLHEP::s * (unit.empty() ? 1.0 : BDS::ParseTimeUnit(unit));
+        }
+      else if (name == "x" || name == "y" || name == "z" || name == "S")
+        {
+          type = name == "x" ? ColumnType::x : (name == "y" ? ColumnType::y : (name == "z" ? ColumnType::z : ColumnType::S));
+          factor = CLHEP::m * (unit.empty() ? 1.0 : BDS::ParseLengthUnit(unit));
+          if (name == "S")
+            {useCurvilinear = true;}
+        }
+      else if (name == "xp" || name == "yp" || name == "zp")
+        {
+          type = name == "xp" ? ColumnType::xp : (name == "yp" ? ColumnType::yp : ColumnType::zp);
+          factor = CLHEP::radian * (unit.empty() ? 1.0 : BDS::ParseAngleUnit(unit));
+        }
+      else if (name == "pdgid")
+        {
+          type = ColumnType::pdgid;
+          changingParticleType = true;
+        }
+      else if (name == "w" || name == "weight")
+        {type = ColumnType::weight;}
+      else if (name == "-")
+        {type = ColumnType::skip;}
+      else
+        {throw BDSException(__METHOD_NAME__, "Cannot determine bunch data format. Failed at token: " + token);}
+      columnTypes.push_back(type);
+      columnFactors.push_back(factor);
+    }
+
+  auto count = [&](const std::vector<ColumnType>& types)
+  {
+    G4int n = 0;
+    for (auto ct : columnTypes)
+      {
+        for (auto t : types)
+          {n += ct == t ? 1 : 0;}
+      }
+    return n;
+  };
+  if (count({ColumnType::E, ColumnType::Ek, ColumnType::P}) > 1)
+    {throw BDSException(__METHOD_NAME__, "More than one of E, Ek, P in the columns of \"" + distrFilePath + "\"");}
+  if (count({ColumnType::z, ColumnType::S}) > 1)
+    {throw BDSException(__METHOD_NAME__, "More than one of z, S in the columns of \"" + distrFilePath + "\"");}
+}
+
+void BDSBunchUserFileBinary::MapFile()
+{
+  UnmapFile();
+  int fd = open(distrFilePath.c_str(), O_RDONLY);
+  if (fd < 0)
+    {throw BDSException(__METHOD_NAME__, "Cannot open bunch file " + distrFilePath);}
+  mappedSize = dataOffset + (std::size_t)nRows * columnTypes.size() * sizeof(G4double);
+  mappedData = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd); // the mapping stays valid
+  if (mappedData == MAP_FAILED)
+    {
+      mappedData = nullptr;
+      throw BDSException(__METHOD_NAME__, "Cannot memory map bunch file " + distrFilePath);
+    }
+  // each column is read in order so let the kernel read ahead
+  madvise(mappedData, mappedSize, MADV_SEQUENTIAL);
+
+  const G4double* data = reinterpret_cast<const G4double*>(static_cast<const char*>(mappedData) + dataOffset);
+  columnData.clear();
+  for (std::size_t i = 0; i < columnTypes.size(); i++)
+    {columnData.push_back(data + i * (std::size_t)nRows);}
+}
+
+void BDSBunchUserFileBinary::UnmapFile()
+{
+  if (mappedData)
+    {munmap(mappedData, mappedSize);}
+  mappedData = nullptr;
+  mappedSize = 0;
+  columnData.clear();
+}
+
+void BDSBunchUserFileBinary::Initialise()
+{
+  G4cout << "BDSBunchUserFileBinary::Initialise> opening " << distrFilePath << G4endl;
+  ReadHeader();
+  if (nRows < nlinesSkip)
+    {
+      G4String msg = "nlinesSkip is greater than the number of rows (" + std::to_string(nRows);
+      msg += ") in the file \"" + distrFilePath + "\"";
+      throw BDSException(__METHOD_NAME__, msg);
+    }
+  if (nRows > 0)
+    {MapFile();}
+
+  auto g = BDSGlobalConstants::Instance();
+  G4bool nGenerateHasBeenSet = g->NGenerateSet();
+  G4int nEventsPerLoop = (G4int)(nRows - nlinesSkip);
+  nEventsInFile = nEventsPerLoop;
+  G4int nAvailable = nEventsPerLoop * distrFileLoopNTimes;
+  G4int nGenerate  = g->NGenerate();
+  if (matchDistrFileLength)
+    {
+      if (!nGenerateHasBeenSet)
+        {
+          g->SetNumberToGenerate(nAvailable);
+          G4cout << __METHOD_NAME__ << "distrFileMatchLength is true -> simulating " << nEventsPerLoop << " events";
+          if (distrFileLoopNTimes > 1)
+            {G4cout << " " << distrFileLoopNTimes << " times";}
+          G4cout << G4endl;
+          if (g->Recreate())
+            {// have to do this now before the primary generator action is called already in the run
+              G4int nEventsRemaining = nAvailable - g->StartFromEvent();
+              g->SetNumberToGenerate(nEventsRemaining);
+              G4cout << __METHOD_NAME__ << "distrFileMatchLength + recreation -> simulate the "
+                     << nEventsRemaining << " rows left given startFromEvent including possible looping" << G4endl;
+            }
+        }
+      else if (nGenerate > nAvailable)
+        {
+          G4String msg = "ngenerate (" + std::to_string(nGenerate) + ") is greater than the number of rows (";
+          msg += std::to_string(nRows) + ") and distrFileMatchLength is on.\nChange ngenerate to <= # rows";
+          msg += ", or don't specify ngenerate.\nThis includes nlinesSkip.";
+          throw BDSException(__METHOD_NAME__, msg);
+        }
+    }
+  else if ((nGenerate > nEventsPerLoop) && !distrFileLoop)
+    {
+      G4String msg = "ngenerate (" + std::to_string(nGenerate) + ") is greater than the number of rows (";
+      msg += std::to_string(nRows) + ") but distrFileLoop is false in the beam command";
+      throw BDSException(__METHOD_NAME__, msg);
+    }
+
+  currentRow = nlinesSkip;
+  if (nlinesSkip > 0)
+    {
+      G4cout << __METHOD_NAME__ << "skipping " << nlinesSkip << " rows" << G4endl;
+      IncrementNEventsInFileSkipped((unsigned long long int)nlinesSkip);
+    }
+}
+
+void BDSBunchUserFileBinary::EndOfFileAction()
+{
+  G4cout << "BDSBunchUserFileBinary> End of file reached." << G4endl;
+  endOfFileReached = true;
+  if (distrFileLoop && nRows > nlinesSkip)
+    {
+      G4cout << "BDSBunchUserFileBinary> Returning to beginning of file (including nlinesSkip) for next event." << G4endl;
+      currentRow = nlinesSkip;
+      endOfFileReached = false;
+    }
+  else
+    {throw BDSException(__METHOD_NAME__, "distrFileLoop off but requesting another set of coordinates.");}
+}
+
+void BDSBunchUserFileBinary::RecreateAdvanceToEvent(G4int eventOffset)
+{
+  BDSBunch::RecreateAdvanceToEvent(eventOffset);
+  G4cout << __METHOD_NAME__ << "Advancing file to event: " << eventOffset << G4endl;
+  G4long nEventsPerLoop = nRows - nlinesSkip;
+  if (eventOffset > nEventsPerLoop)
+    {
+      if (distrFileLoop)
+        {eventOffset = (G4int)(eventOffset % nEventsPerLoop);}
+      else
+        {
+          G4String msg = "eventOffset (" + std::to_string(eventOffset) + ") is greater than the number of rows in this file.\n";
+          msg += "This includes nlinesSkip.";
+          throw BDSException(__METHOD_NAME__, msg);
+        }
+    }
+  
+  G4long nEventsRemaining = nEventsPerLoop * distrFileLoopNTimes - eventOffset;
+  G4int nGenerate = BDSGlobalConstants::Instance()->NGenerate();
+  if (nGenerate > nEventsRemaining && !distrFileLoop)
+    {
+      G4String msg = "ngenerate (" + std::to_string(nGenerate) + ") requested in recreate mode is greater than number\n";
+      msg += "of remaining rows in file (" + std::to_string(nEventsRemaining) + ") and distrFileLoop is turned off.";
+      throw BDSException(__METHOD_NAME__, msg);
+    }
+  currentRow = nlinesSkip + eventOffset;
+}
+
+BDSParticleCoordsFullGlobal BDSBunchUserFileBinary::GetNextParticleValid(G4int /*maxTries*/)
+{
+  // no looping - just read one particle from file
+  return GetNextParticle();
+}
+
+BDSParticleCoordsFull BDSBunchUserFileBinary::GetNextParticleLocal()
+{
+  if (currentRow >= nRows)
+    {EndOfFileAction();}
+
+  G4double E = 0, Ek = 0, P = 0, x = 0, y = 0, z = 0, xp = 0, yp = 0, zp = 0, t = 0;
+  G4double weight = 1;
+  G4int type = 0;
+  G4bool zpdef = false;
+  
+  for (std::size_t i = 0; i < columnTypes.size(); i++)
+    {
+      G4double value = columnData[i][currentRow];
+      switch (columnTypes[i])
+        {
+        case ColumnType::E:
+          {E = value * columnFactors[i]; break;}
+        case ColumnType::Ek:
+          {Ek = value * columnFactors[i]; break;}
+        case ColumnType::P:
+          {P = value * columnFactors[i]; break;}
+        case ColumnType::t:
+          {t = value * columnFactors[i]; break;}
+        case ColumnType::x:
+          {x = value * columnFactors[i]; break;}
+        case ColumnType::y:
+          {y = value * columnFactors[i]; break;}
+        case ColumnType::z:
+        case ColumnType::S:
+          {z = value * columnFactors[i]; break;}
+        case ColumnType::xp:
+          {xp = value * columnFactors[i]; break;}
+        case ColumnType::yp:
+          {yp = value * columnFactors[i]; break;}
+        case ColumnType::zp:
+          {zp = value * columnFactors[i]; zpdef = true; break;}
+        case ColumnType::pdgid:
+          {type = (G4int)value; break;}
+        case ColumnType::weight:
+          {weight = value; break;}
+        case ColumnType::skip:
+        default:
+          {break;}
+        }
+    }
+  currentRow++;
+
+  // If energy isn't specified, use the central beam energy. This must be set before
+  // a new particle definition is made as that requires one of E, Ek or P.
+  if (!anEnergyCoordinateInUse)
+    {E = E0;}
+
+  if (changingParticleType && (!particleDefinition || type != currentPDGID))
+    {
+      // type is an int so FindParticle(int) is used here
+      G4ParticleTable* particleTable = G4ParticleTable::GetParticleTable();
+      G4ParticleDefinition* particleDef = nullptr;
+      BDSIonDefinition* ionDef = nullptr;
+      if (type < 1e9) // not a pdg ion
+        {particleDef = particleTable->FindParticle(type);}
+      else
+        {
+          G4IonTable* ionTable = particleTable->GetIonTable();
+          G4int ionA, ionZ, ionLevel;
+          G4double ionE;
+          G4IonTable::GetNucleusByEncoding(type, ionZ, ionA, ionE, ionLevel);
+          ionDef = new BDSIonDefinition(ionA, ionZ, ionZ);
+          particleDef = ionTable->GetIon(ionDef->Z(), ionDef->A(), ionDef->ExcitationEnergy());
+        }
+      
+      if (!particleDef)
+        {throw BDSException("BDSBunchUserFileBinary> Particle \"" + std::to_string(type) + "\" not found");}
+      delete particleDefinition;
+      try
+        {
+          particleDefinition = new BDSParticleDefinition(particleDef, E, Ek, P, ffact, ionDef);
+          E = particleDefinition->TotalEnergy();
+          particleDefinitionHasBeenUpdated = true;
+          currentPDGID = type;
+        }
+      catch (const BDSException& e)
+        {// if we throw an exception the object is invalid for the delete on the next loop
+          particleDefinition = nullptr;
+          throw e;
+        }
+    }
+  else if (anEnergyCoordinateInUse)
+    {// same particle type - only the energy changes
+      particleDefinition->SetEnergies(E, Ek, P);
+      E = particleDefinition->TotalEnergy();
+    }
+  
+  xp += Xp0;
+  yp += Yp0;
+  if (!zpdef)
+    {zp = CalculateZp(xp,yp,1);}
+
+  return BDSParticleCoordsFull(X0+x,Y0+y,Z0+z,xp,yp,zp,t,z,E,weight);
+}
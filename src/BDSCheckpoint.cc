@@ -0,0 +1,200 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "BDSBunch.hh"
+#include "BDSBunchFileBased.hh"
+#include "BDSCheckpoint.hh"
+#include "BDSDebug.hh"
+#include "BDSException.hh"
+#include "BDSGlobalConstants.hh"
+#include "BDSOutput.hh"
+#include "BDSOutputROOTEventHistograms.hh"
+#include "BDSPrimaryGeneratorAction.hh"
+#include "BDSRandom.hh"
+
+#include "globals.hh" // geant4 types / globals
+
+#include "TDirectory.h"
+#include "TFile.h"
+#include "TTree.h"
+
+#include <cstdio>
+#include <string>
+
+BDSCheckpoint::BDSCheckpoint(const G4String& checkpointFileNameIn,
+                             G4int           everyNEventsIn,
+                             const G4String& resumeFileName,
+                             BDSOutput*      outputIn,
+                             BDSBunch*       bunchIn):
+  checkpointFileName(checkpointFileNameIn),
+  everyNEvents(everyNEventsIn),
+  output(outputIn),
+  bunch(bunchIn),
+  primaryGeneratorAction(nullptr),
+  nEventsThisRun(0),
+  resuming(!resumeFileName.empty()),
+  resumeApplied(false),
+  nEventsResumed(0),
+  distrFileEventIndexResumed(-1),
+  runHistosResumed(nullptr)
+{
+  if (!output)
+    {throw BDSException(__METHOD_NAME__, "valid BDSOutput required");}
+  const BDSGlobalConstants* globals = BDSGlobalConstants::Instance();
+  if (checkpointFileName.empty())
+    {checkpointFileName = globals->OutputFileName() + "_checkpoint.root";}
+
+  if (resuming)
+    {
+      Load(resumeFileName);
+      // the output of the checkpointed run is the first part of the data so must not be overwritten
+      G4String previousBaseName = outputFileNameResumed.substr(0, outputFileNameResumed.rfind('.'));
+      if (globals->OutputFileNameSet() && globals->OutputFileName() == previousBaseName)
+        {
+          G4String msg = "the output file name is the same as that of the checkpointed run \"";
+          msg += outputFileNameResumed + "\" which would be overwritten - use a different --outfile";
+          throw BDSException(__METHOD_NAME__, msg);
+        }
+      if (resumeFileName == checkpointFileName && everyNEvents > 0)
+        {G4cout << __METHOD_NAME__ << "the checkpoint resumed from will be updated by this run" << G4endl;}
+      output->SetNEventsResumed(nEventsResumed);
+    }
+}
+
+BDSCheckpoint::~BDSCheckpoint()
+{
+  delete runHistosResumed;
+}
+
+void BDSCheckpoint::BeginOfRun()
+{
+  nEventsThisRun = 0;
+  if (!resuming || resumeApplied)
+    {return;}
+
+  output->AccumulateRunHistograms(runHistosResumed);
+  BDSRandom::SetSeedState(seedStateResumed);
+  resumeApplied = true;
+  G4cout << __METHOD_NAME__ << "resuming after " << nEventsResumed << " events from the checkpoint of \""
+         << outputFileNameResumed << "\"" << G4endl;
+}
+
+void BDSCheckpoint::EndOfEvent()
+{
+  nEventsThisRun++;
+  if (everyNEvents > 0 && nEventsThisRun % (unsigned long long int)everyNEvents == 0)
+    {Write();}
+}
+
+void BDSCheckpoint::Write()
+{
+  // header numbers as they would be if the run ended now - see BDSRunAction::EndOfRunAction
+  unsigned long long int nOriginalEvents = nEventsThisRun;
+  unsigned long long int nEventsInOriginalDistrFile = 0;
+  unsigned long long int nEventsDistrFileSkipped = 0;
+  unsigned int distrFileLoopNTimes = 1;
+  if (auto beg = dynamic_cast<BDSBunchFileBased*>(bunch))
+    {
+      nOriginalEvents = beg->NOriginalEvents();
+      nEventsInOriginalDistrFile = beg->NEventsInFile();
+      nEventsDistrFileSkipped = beg->NEventsInFileSkipped();
+      distrFileLoopNTimes = (unsigned int)beg->DistrFileLoopNTimes();
+    }
+  output->Checkpoint(nOriginalEvents, nEventsThisRun, nEventsInOriginalDistrFile, nEventsDistrFileSkipped, distrFileLoopNTimes);
+
+  unsigned long long int nEventsCompleted = nEventsResumed + nEventsThisRun;
+  unsigned long long int nEventsInOutputFile = nEventsThisRun;
+  Long64_t    distrFileEventIndex = primaryGeneratorAction ? (Long64_t)primaryGeneratorAction->DistrFileEventIndex() : -1;
+  std::string seedState      = BDSRandom::GetSeedState();
+  std::string outputFileName = output->CurrentFileName();
+  BDSOutputROOTEventHistograms* runHistos = output->RunHistograms();
+
+  // write to a temporary file and rename so a complete checkpoint always exists
+  TDirectory* previousDirectory = gDirectory;
+  G4String temporaryFileName = checkpointFileName + ".tmp";
+  TFile* file = new TFile(temporaryFileName.c_str(), "RECREATE", "BDSIM checkpoint");
+  if (file->IsZombie())
+    {
+      delete file;
+      previousDirectory->cd();
+      throw BDSException(__METHOD_NAME__, "unable to open checkpoint file \"" + temporaryFileName + "\"");
+    }
+  file->cd();
+  TTree* tree = new TTree("Checkpoint", "BDSIM run checkpoint");
+  tree->Branch("nEventsCompleted",    &nEventsCompleted);
+  tree->Branch("nEventsInOutputFile", &nEventsInOutputFile);
+  tree->Branch("distrFileEventIndex", &distrFileEventIndex);
+  tree->Branch("seedState",           &seedState);
+  tree->Branch("outputFileName",      &outputFileName);
+  tree->Branch("Histos.", "BDSOutputROOTEventHistograms", &runHistos, 32000, 1);
+  tree->Fill();
+  file->Write(nullptr, TObject::kOverwrite);
+  file->Close();
+  delete file; // also deletes the tree
+  previousDirectory->cd();
+
+  if (std::rename(temporaryFileName.c_str(), checkpointFileName.c_str()) != 0)
+    {throw BDSException(__METHOD_NAME__, "unable to rename \"" + temporaryFileName + "\" to \"" + checkpointFileName + "\"");}
+  G4cout << __METHOD_NAME__ << "checkpoint after " << nEventsCompleted << " events written to \""
+         << checkpointFileName << "\"" << G4endl;
+}
+
+void BDSCheckpoint::Load(const G4String& fileName)
+{
+  G4cout << __METHOD_NAME__ << "Loading checkpoint: " << fileName << G4endl;
+  TDirectory* previousDirectory = gDirectory;
+  TFile* file = new TFile(fileName.c_str(), "READ");
+  if (file->IsZombie())
+    {
+      delete file;
+      previousDirectory->cd();
+      throw BDSException(__METHOD_NAME__, "No such file \"" + fileName + "\"");
+    }
+  TTree* tree = dynamic_cast<TTree*>(file->Get("Checkpoint"));
+  if (!tree || tree->GetEntries() < 1)
+    {
+      delete file;
+      previousDirectory->cd();
+      throw BDSException(__METHOD_NAME__, "\"" + fileName + "\" is not a BDSIM checkpoint file");
+    }
+
+  unsigned long long int nEventsCompleted = 0;
+  Long64_t     distrFileEventIndex = -1;
+  std::string* seedState      = new std::string();
+  std::string* outputFileName = new std::string();
+  runHistosResumed = new BDSOutputROOTEventHistograms();
+  tree->SetBranchAddress("nEventsCompleted",    &nEventsCompleted);
+  tree->SetBranchAddress("distrFileEventIndex", &distrFileEventIndex);
+  tree->SetBranchAddress("seedState",           &seedState);
+  tree->SetBranchAddress("outputFileName",      &outputFileName);
+  tree->SetBranchAddress("Histos.",             &runHistosResumed);
+  tree->GetEntry(0);
+
+  nEventsResumed             = nEventsCompleted;
+  distrFileEventIndexResumed = (G4long)distrFileEventIndex;
+  seedStateResumed           = G4String(*seedState);
+  outputFileNameResumed      = G4String(*outputFileName);
+  tree->ResetBranchAddresses();
+  delete seedState;
+  delete outputFileName;
+  delete file; // closes if open
+  previousDirectory->cd();
+
+  if (seedStateResumed.empty())
+    {throw BDSException(__METHOD_NAME__, "no random number engine state in checkpoint \"" + fileName + "\"");}
+}
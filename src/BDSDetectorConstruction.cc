@@ -52,6 +52,8 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "BDSHistBinMapper.hh"
 #include "BDSIntegratorSet.hh"
 #include "BDSLine.hh"
+#include "BDSMapTransportModel.hh"
+#include "BDSMapTransportSection.hh"
 #include "BDSMaterials.hh"
 #include "BDSParser.hh"
 #include "BDSPhysicalVolumeInfo.hh"
@@ -92,6 +94,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "G4PVPlacement.hh"
 #include "G4VPrimitiveScorer.hh"
 #include "G4Region.hh"
+#include "G4RegionStore.hh"
 #include "G4ScoringManager.hh"
 #include "G4String.hh"
 #include "G4Transform3D.hh"
@@ -270,6 +273,9 @@ G4VPhysicalVolume* BDSDetectorConstruction::Construct()
 
   // placement procedure - put everything in the world
   ComponentPlacement(worldPV);
+
+  if (BDSGlobalConstants::Instance()->MapTransport())
+    {BuildMapTransportSections();}
   
   if (verbose || debug)
     {G4cout << __METHOD_NAME__ << "detector Construction done" << G4endl;}
@@ -298,6 +304,8 @@ BDSDetectorConstruction::~BDSDetectorConstruction()
 #endif
   for (auto q : fieldQueries)
     {delete q;}
+  for (auto s : mapTransportSections)
+    {delete s;}
 }
 
 void BDSDetectorConstruction::InitialiseRegions()
@@ -1310,6 +1318,65 @@ void BDSDetectorConstruction::ConstructSDandField()
   acceleratorModel->RegisterFields(flds);
 
   ConstructScoringMeshes();
+
+  // fast simulation models are per thread so are made here
+  for (auto region : mapTransportRegions)
+    {new BDSMapTransportModel("mapTransport_" + region->GetName(), region, &mapTransportEntries);}
+}
+
+void BDSDetectorConstruction::BuildMapTransportSections()
+{
+  const BDSBeamline* mainBeamLine = BDSAcceleratorModel::Instance()->BeamlineMain();
+  mapTransportSections = BDSMapTransportSection::BuildSections(mainBeamLine);
+
+  // The model is attached to the region of the first element of each section. If
+  // it has no region, it's put in a new one with the default cuts, so the physics
+  // is unchanged. The same logical volume may be used elsewhere, so the placements
+  // of the first element are used to identify the entrance of a section.
+  G4Region* mapTransportRegion = nullptr;
+  G4double mapLength = 0;
+  for (auto section : mapTransportSections)
+    {
+      const BDSBeamlineElement* firstElement = section->FirstElement();
+      G4LogicalVolume* containerLV = firstElement->GetAcceleratorComponent()->GetContainerLogicalVolume();
+      G4Region* region = containerLV->GetRegion();
+      if (!region)
+	{
+	  if (!mapTransportRegion)
+	    {
+	      mapTransportRegion = new G4Region("mapTransport");
+	      G4Region* defaultRegion = G4RegionStore::GetInstance()->GetRegion("DefaultRegionForTheWorld", false);
+	      mapTransportRegion->SetProductionCuts(defaultRegion->GetProductionCuts());
+	    }
+	  containerLV->SetRegion(mapTransportRegion);
+	  mapTransportRegion->AddRootLogicalVolume(containerLV);
+	  region = mapTransportRegion;
+	}
+      mapTransportRegions.insert(region);
+
+      const auto pvs = BDSPhysicalVolumeInfoRegistry::Instance()->PVsForBeamlineElement(firstElement);
+      if (pvs)
+	{
+	  for (auto pv : *pvs)
+	    {mapTransportEntries[pv] = section;}
+	}
+      mapLength += section->SPositionEnd() - section->SPositionStart();
+    }
+
+  G4double totalLength = mainBeamLine ? mainBeamLine->GetTotalArcLength() : 0;
+  G4cout << __METHOD_NAME__ << mapTransportSections.size() << " sections covering "
+	 << mapLength / CLHEP::m << " m of " << totalLength / CLHEP::m << " m of the beam line" << G4endl;
+  if (mapTransportSections.empty())
+    {BDS::Warning(__METHOD_NAME__, "no sections of the beam line can be transported with maps");}
+  if (verbose)
+    {
+      for (auto section : mapTransportSections)
+	{
+	  G4cout << "Map transport section from \"" << section->Name() << "\" S = "
+		 << section->SPositionStart() / CLHEP::m << " to " << section->SPositionEnd() / CLHEP::m
+		 << " m with " << section->NElements() << " elements" << G4endl;
+	}
+    }
 }
 
 G4bool BDSDetectorConstruction::UnsuitableFirstElement(GMAD::FastList<GMAD::Element>::FastListConstIterator element)
@@ -1489,6 +1556,8 @@ std::vector<BDSFieldQueryInfo*> BDSDetectorConstruction::PrepareFieldQueries(con
                                                     def.drawBoxes,
                                                     def.boxAlpha));
         }
+      result.back()->nThreads     = def.nThreads;
+      result.back()->binaryOutput = def.binaryOutput;
     }
   return result;
 }
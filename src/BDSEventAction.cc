@@ -17,6 +17,7 @@ You should have received a copy of the GNU General Public License
 along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "BDSAuxiliaryNavigator.hh"
+#include "BDSCheckpoint.hh"
 #include "BDSDebug.hh"
 #include "BDSEventAction.hh"
 #include "BDSEventInfo.hh"
@@ -61,7 +62,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "G4Run.hh"
 #include "G4SDManager.hh"
 #include "G4StackManager.hh"
-#include "G4THitsMap.hh"
+#include "G4VHitsCollection.hh"
 #include "G4TrajectoryContainer.hh"
 #include "G4TrajectoryPoint.hh"
 #include "G4TransportationManager.hh"
@@ -80,6 +81,7 @@ G4bool FireLaserCompton;  // bool to ensure that Laserwire can only occur once i
 
 BDSEventAction::BDSEventAction(BDSOutput* outputIn):
   output(outputIn),
+  checkpoint(nullptr),
   samplerCollID_plane(-1),
   samplerCollID_cylin(-1),
   samplerCollID_sphere(-1),
@@ -331,11 +333,11 @@ void BDSEventAction::EndOfEventAction(const G4Event* evt)
   typedef BDSHitsCollectionThinThing tthc;
   tthc* thinThingHits = HCE ? dynamic_cast<tthc*>(HCE->GetHC(thinThingCollID)) : nullptr;
   
-  std::map<G4String, G4THitsMap<G4double>*> scorerHits;
+  std::map<G4String, G4VHitsCollection*> scorerHits;
   if (HCE)
     {
       for (const auto& nameIndex : scorerCollectionIDs)
-        {scorerHits[nameIndex.first] = dynamic_cast<G4THitsMap<G4double>*>(HCE->GetHC(nameIndex.second));}
+        {scorerHits[nameIndex.first] = HCE->GetHC(nameIndex.second);}
     }
   // primary hit something? we infer this by seeing if there are any energy
   // deposition hits at all - if there are, the primary must have 'hit' something.
@@ -426,6 +428,9 @@ void BDSEventAction::EndOfEventAction(const G4Event* evt)
                     apertureImpactHits,
                     scorerHits,
                     BDSGlobalConstants::Instance()->TurnsTaken());
+
+  if (checkpoint)
+    {checkpoint->EndOfEvent();}
   
   // if events per ntuples not set (default 0) - only write out at end
   G4int evntsPerNtuple = BDSGlobalConstants::Instance()->NumberOfEventsPerNtuple();
@@ -119,6 +119,7 @@ void BDSExecOptions::Parse(int argc, char **argv)
                                         { "circular", 0, 0, 0 },
                                         { "seed",           1, 0, 0},
                                         { "recreate",       1, 0, 0},
+                                        { "resume",         1, 0, 0},
                                         { "startFromEvent", 1, 0, 0},
                                         { "writeSeedState", 0, 0, 0},
                                         { "seedState",      1, 0, 0},
@@ -335,6 +336,8 @@ void BDSExecOptions::Parse(int argc, char **argv)
                 options.set_value("recreate", true);
                 options.set_value("recreateFileName", std::string(optarg));
               }
+            else if ( !strcmp(optionName, "resume") )
+              {options.set_value("resumeFromCheckpoint", std::string(optarg));}
             else if ( !strcmp(optionName, "startFromEvent") )
               {
                 int result = 0;
@@ -470,6 +473,7 @@ void BDSExecOptions::Usage() const
         <<"                               their processes - depends on physics list in input"<< G4endl
         <<"--P0=N                       : set P0 for the bunch for this run (GeV only)"      << G4endl
         <<"--recreate=<file>            : the rootevent file to recreate events from"        << G4endl
+        <<"--resume=<file>              : checkpoint file to resume an interrupted run from" << G4endl
         <<"--seed=N                     : the seed to use for the random number generator"   << G4endl
         <<"--seedStateFileName=<file>   : use this ASCII file seed state to run an event"    << G4endl
         <<"--startFromEvent=N           : event offset to start from when recreating events" << G4endl
@@ -20,6 +20,8 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "BDSGlobalConstants.hh"
 #include "BDSFieldInfo.hh"
 #include "BDSFieldObjects.hh"
+#include "BDSIntegrationDriverExact.hh"
+#include "BDSIntegratorType.hh"
 
 #include "G4ChordFinder.hh"
 #include "G4ElectroMagneticField.hh"
@@ -61,9 +63,7 @@ BDSFieldObjects::BDSFieldObjects(const BDSFieldInfo*     infoIn,
   if (chordStepMinimum <= 0)
     {chordStepMinimum = BDSGlobalConstants::Instance()->ChordStepMinimum();}
   
-  magIntDriver = new G4MagInt_Driver(chordStepMinimum,
-				     magIntegratorStepper,
-				     magIntegratorStepper->GetNumberOfVariables());
+  magIntDriver = CreateDriver(chordStepMinimum);
 
   chordFinder  = new G4ChordFinder(magIntDriver);
 
@@ -90,9 +90,7 @@ BDSFieldObjects::BDSFieldObjects(const BDSFieldInfo*     infoIn,
   if (chordStepMinimum <= 0)
     {chordStepMinimum = BDSGlobalConstants::Instance()->ChordStepMinimum();}
   
-  magIntDriver = new G4MagInt_Driver(chordStepMinimum,
-				     magIntegratorStepper,
-				     magIntegratorStepper->GetNumberOfVariables());
+  magIntDriver = CreateDriver(chordStepMinimum);
 
   chordFinder  = new G4ChordFinder(magIntDriver);
   fieldManager = new G4FieldManager(field, chordFinder);
@@ -114,10 +112,26 @@ BDSFieldObjects::~BDSFieldObjects()
   //delete magIntDriver; // not needed since deleted by chordFinder
 }
 
+G4MagInt_Driver* BDSFieldObjects::CreateDriver(G4double chordStepMinimum) const
+{
+  G4int nVariables = magIntegratorStepper->GetNumberOfVariables();
+#if G4VERSION_NUMBER > 1059
+  if (BDSGlobalConstants::Instance()->ExactIntegrationDriver() && info && !info->IsThin() &&
+      BDS::IntegratorIsAnalytical(info->IntegratorType()))
+    {return new BDSIntegrationDriverExact(chordStepMinimum, magIntegratorStepper, nVariables);}
+#endif
+  return new G4MagInt_Driver(chordStepMinimum, magIntegratorStepper, nVariables);
+}
+
 void BDSFieldObjects::AttachToVolume(G4LogicalVolume* volume,
 				     G4bool penetrateToDaughterVolumes) const
 {
   volume->SetFieldManager(fieldManager, penetrateToDaughterVolumes);
+  if (auto exactDriver = dynamic_cast<BDSIntegrationDriverExact*>(magIntDriver))
+    {
+      if (exactDriver->Name().empty())
+	{exactDriver->SetName(volume->GetName());}
+    }
   if (!info) // may not always exist
     {return;}
 
@@ -36,9 +36,14 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "CLHEP/Units/SystemOfUnits.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstdio>
 #include <fstream>
 #include <iomanip>
+#include <string>
+#include <thread>
 #include <vector>
 
 G4Navigator* BDSFieldQuery::navigator = new G4Navigator();
@@ -46,6 +51,7 @@ G4Navigator* BDSFieldQuery::navigator = new G4Navigator();
 BDSFieldQuery::BDSFieldQuery():
   queryMagnetic(false),
   queryElectric(false),
+  binaryOutput(false),
   writeX(false),
   writeY(false),
   writeZ(false),
@@ -67,6 +73,7 @@ void BDSFieldQuery::CleanUp()
   CloseFiles();
   queryMagnetic = false;
   queryElectric = false;
+  binaryOutput  = false;
   writeX = false;
   writeY = false;
   writeZ = false;
@@ -131,13 +138,12 @@ void BDSFieldQuery::QueryField(const BDSFieldQueryInfo* query)
   CheckNStepsAndRange(query->zInfo, "z", query->name);
   
   G4double tMin    = query->tInfo.min;
-  G4double nStepsT = query->yInfo.n == 1 ? 1 : (G4double)query->tInfo.n-1;
+  G4double nStepsT = query->tInfo.n == 1 ? 1 : (G4double)query->tInfo.n-1;
   G4double tStep   = (query->tInfo.max - query->tInfo.min) / nStepsT;
   if (std::isnan(tStep))
     {tStep = 1.0;}
   CheckNStepsAndRange(query->tInfo, "t", query->name);
   
-  G4ThreeVector xyzGlobal = G4ThreeVector();
   const G4AffineTransform& localToGlobalTransform = query->globalTransform;
   G4AffineTransform globalToLocalTransform = localToGlobalTransform.Inverse();
   
@@ -145,40 +151,87 @@ void BDSFieldQuery::QueryField(const BDSFieldQueryInfo* query)
   localToGlobalTransform.ApplyAxisTransform(generalUnitZ);
   
   OpenFiles(query);
-  
-  G4double globalFieldValue[6];
-  G4double localFieldValue[6];
-  
-  G4double tLocal = tMin;
-  for (G4int i = 0; i < query->tInfo.n; i++)
+
+  G4int nThreads = query->nThreads > 0 ? query->nThreads : (G4int)std::thread::hardware_concurrency();
+  nThreads = std::max(1, nThreads);
+  G4bool parallel = nThreads > 1 && SupportsParallelQuery(nThreads);
+  if (nThreads > 1)
+    {G4cout << "FieldQuery> using " << nThreads << " threads" << (parallel ? "" : " for output only") << G4endl;}
+
+  // x varies fastest, then y, z and t as required for the field map format
+  const std::size_t nX = (std::size_t)query->xInfo.n;
+  const std::size_t nY = (std::size_t)query->yInfo.n;
+  const std::size_t nZ = (std::size_t)query->zInfo.n;
+  const std::size_t nTotal = nX * nY * nZ * (std::size_t)query->tInfo.n;
+  const std::size_t blockSize = std::min(nTotal, (std::size_t)65536 * (std::size_t)nThreads);
+  std::vector<G4double> xyzt(4 * blockSize);
+  std::vector<G4double> localFieldValues(6 * blockSize);
+
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t first = 0; first < nTotal; first += blockSize)
     {
-      G4double zLocal = zMin;
-      for (G4int j = 0; j < query->zInfo.n; j++)
+      std::size_t nPoints = std::min(blockSize, nTotal - first);
+      auto evaluate = [&](std::size_t begin, std::size_t end, G4int threadIndex)
+      {
+        G4double globalFieldValue[6];
+        for (std::size_t p = begin; p < end; p++)
+          {
+            std::size_t index = first + p;
+            std::size_t l = index % nX;
+            index /= nX;
+            std::size_t k = index % nY;
+            index /= nY;
+            std::size_t j = index % nZ;
+            std::size_t i = index / nZ;
+            G4double xLocal = xMin + (G4double)l * xStep;
+            G4double yLocal = yMin + (G4double)k * yStep;
+            G4double zLocal = zMin + (G4double)j * zStep;
+            G4double tLocal = tMin + (G4double)i * tStep;
+            G4ThreeVector xyzGlobal = LocalToGlobalPoint(localToGlobalTransform, xLocal, yLocal, zLocal);
+            if (parallel)
+              {GetFieldValueThread(xyzGlobal, generalUnitZ, tLocal, globalFieldValue, threadIndex);}
+            else
+              {GetFieldValue(xyzGlobal, generalUnitZ, tLocal, globalFieldValue);}
+            GlobalToLocalAxisField(globalToLocalTransform, globalFieldValue, &localFieldValues[6*p]);
+            xyzt[4*p]     = xLocal;
+            xyzt[4*p + 1] = yLocal;
+            xyzt[4*p + 2] = zLocal;
+            xyzt[4*p + 3] = tLocal;
+          }
+      };
+      if (parallel)
         {
-          G4double yLocal = yMin;
-          for (G4int k = 0; k < query->yInfo.n; k++)
+          std::vector<std::thread> threads;
+          std::size_t chunk = (nPoints + (std::size_t)nThreads - 1) / (std::size_t)nThreads;
+          for (G4int t = 0; t < nThreads; t++)
             {
-              G4double xLocal = xMin;
-              for (G4int l = 0; l < query->xInfo.n; l++)
-                {
-                  xyzGlobal = LocalToGlobalPoint(localToGlobalTransform, xLocal, yLocal, zLocal);
-                  GetFieldValue(xyzGlobal, generalUnitZ, tLocal, globalFieldValue);
-                  GlobalToLocalAxisField(globalToLocalTransform,
-                                         globalFieldValue,
-                                         localFieldValue);
-                  WriteFieldValue({xLocal, yLocal, zLocal}, tLocal, localFieldValue);
-                  
-                  xLocal += xStep;
-                }
-              yLocal += yStep;
+              std::size_t begin = std::min(nPoints, (std::size_t)t * chunk);
+              std::size_t end   = std::min(nPoints, begin + chunk);
+              threads.emplace_back(evaluate, begin, end, t);
             }
-          zLocal += zStep;
+          for (auto& thread : threads)
+            {thread.join();}
         }
-      tLocal += tStep;
+      else
+        {evaluate(0, nPoints, 0);}
+      WriteFieldValues(xyzt, localFieldValues, nPoints, nThreads);
     }
-  
+  std::chrono::duration<G4double> duration = std::chrono::steady_clock::now() - start;
+
   CloseFiles();
-  G4cout << "FieldQuery> Complete" << G4endl;
+  G4cout << "FieldQuery> Complete - " << nTotal << " points in " << duration.count() << " s";
+  if (duration.count() > 0)
+    {G4cout << " (" << (G4double)nTotal / duration.count() << " points / s)";}
+  G4cout << G4endl;
+}
+
+void BDSFieldQuery::GetFieldValueThread(const G4ThreeVector& globalXYZ,
+                                        const G4ThreeVector& globalDirection,
+                                        G4double tGlobal,
+                                        G4double fieldValue[6],
+                                        G4int  /*threadIndex*/)
+{
+  GetFieldValue(globalXYZ, globalDirection, tGlobal, fieldValue);
 }
 
 void BDSFieldQuery::CheckNStepsAndRange(const BDSFieldQueryInfo::QueryDimensionInfo& dimensionInfo,
@@ -262,6 +315,8 @@ void BDSFieldQuery::OpenFiles(const BDSFieldQueryInfo* query)
       writeZ = query->zInfo.n > 1;
       writeT = query->tInfo.n > 1;
     }
+  binaryOutput = query->binaryOutput;
+  std::ios_base::openmode mode = binaryOutput ? std::ios::out | std::ios::binary : std::ios::out;
   
   if (query->queryMagnetic)
     {
@@ -272,7 +327,7 @@ void BDSFieldQuery::OpenFiles(const BDSFieldQueryInfo* query)
 	  throw BDSException(__METHOD_NAME__, msg);
 	}
       queryMagnetic = true;
-      oFileMagnetic.open(query->outfileMagnetic);
+      oFileMagnetic.open(query->outfileMagnetic, mode);
       WriteHeader(oFileMagnetic, query);
     }
   
@@ -285,7 +340,7 @@ void BDSFieldQuery::OpenFiles(const BDSFieldQueryInfo* query)
 	  throw BDSException(__METHOD_NAME__, msg);
 	}
       queryElectric = true;
-      oFileElectric.open(query->outfileElectric);
+      oFileElectric.open(query->outfileElectric, mode);
       WriteHeader(oFileElectric, query);
     }
 }
@@ -324,6 +379,11 @@ void BDSFieldQuery::WriteHeader(std::ofstream& out,
     }
   columns += "          Fx            Fy            Fz\n";
   out << columns;
+  if (binaryOutput)
+    {
+      G4int nColumns = (G4int)writeX + (G4int)writeY + (G4int)writeZ + (G4int)writeT + 3;
+      out << "! binary " << nColumns << " doubles per point follow\n";
+    }
 }
 
 void BDSFieldQuery::CloseFiles()
@@ -385,6 +445,15 @@ void BDSFieldQuery::WriteFieldValue(const G4ThreeVector& xyzLocal,
                                     G4double tLocal,
                                     const G4double fieldValue[6])
 {
+  if (binaryOutput)
+    {
+      G4double xyzt[4] = {xyzLocal.x(), xyzLocal.y(), xyzLocal.z(), tLocal};
+      if (queryMagnetic)
+        {WriteFieldValuesBinary(oFileMagnetic, xyzt, fieldValue, 1, true);}
+      if (queryElectric)
+        {WriteFieldValuesBinary(oFileElectric, xyzt, fieldValue, 1, false);}
+      return;
+    }
   if (queryMagnetic)
     {
       if (writeX)
@@ -414,3 +483,111 @@ void BDSFieldQuery::WriteFieldValue(const G4ThreeVector& xyzLocal,
       oFileElectric << "\n";
    }
 }
+
+void BDSFieldQuery::WriteFieldValues(const std::vector<G4double>& xyzt,
+                                     const std::vector<G4double>& fieldValues,
+                                     std::size_t nPoints,
+                                     G4int       nThreads)
+{
+  if (!queryMagnetic && !queryElectric)
+    {return;}
+  
+  if (binaryOutput)
+    {
+      if (queryMagnetic)
+        {WriteFieldValuesBinary(oFileMagnetic, xyzt.data(), fieldValues.data(), nPoints, true);}
+      if (queryElectric)
+        {WriteFieldValuesBinary(oFileElectric, xyzt.data(), fieldValues.data(), nPoints, false);}
+      return;
+    }
+
+  // format contiguous chunks of points in parallel then write them in order
+  std::size_t nChunks = std::max((std::size_t)1, std::min((std::size_t)nThreads, nPoints / 1024));
+  std::size_t chunk   = (nPoints + nChunks - 1) / nChunks;
+  std::vector<std::string> textMagnetic(nChunks);
+  std::vector<std::string> textElectric(nChunks);
+  auto format = [&](std::size_t c)
+  {
+    std::size_t begin = std::min(nPoints, c * chunk);
+    std::size_t end   = std::min(nPoints, begin + chunk);
+    if (queryMagnetic)
+      {FormatFieldValues(&xyzt[4*begin], &fieldValues[6*begin], end - begin, true, textMagnetic[c]);}
+    if (queryElectric)
+      {FormatFieldValues(&xyzt[4*begin], &fieldValues[6*begin], end - begin, false, textElectric[c]);}
+  };
+  if (nChunks > 1)
+    {
+      std::vector<std::thread> threads;
+      for (std::size_t c = 0; c < nChunks; c++)
+        {threads.emplace_back(format, c);}
+      for (auto& thread : threads)
+        {thread.join();}
+    }
+  else
+    {format(0);}
+  
+  for (std::size_t c = 0; c < nChunks; c++)
+    {
+      if (queryMagnetic)
+        {oFileMagnetic.write(textMagnetic[c].data(), (std::streamsize)textMagnetic[c].size());}
+      if (queryElectric)
+        {oFileElectric.write(textElectric[c].data(), (std::streamsize)textElectric[c].size());}
+    }
+}
+
+void BDSFieldQuery::FormatFieldValues(const G4double* xyzt,
+                                      const G4double* fieldValues,
+                                      std::size_t     nPoints,
+                                      G4bool          magnetic,
+                                      std::string&    out) const
+{
+  // same as std::setprecision(6) << std::setw(10 or 15) in WriteFieldValue
+  const G4double fieldUnit = magnetic ? CLHEP::tesla : CLHEP::volt/CLHEP::m;
+  const G4int    offset    = magnetic ? 0 : 3;
+  const G4double coordUnit[4] = {CLHEP::cm, CLHEP::cm, CLHEP::cm, CLHEP::s};
+  const G4bool   writeCoord[4] = {writeX, writeY, writeZ, writeT};
+  char buffer[32];
+  out.reserve(out.size() + nPoints * 80);
+  for (std::size_t p = 0; p < nPoints; p++)
+    {
+      for (G4int i = 0; i < 4; i++)
+        {
+          if (writeCoord[i])
+            {
+              std::snprintf(buffer, sizeof(buffer), "%10.6g  ", xyzt[4*p + i] / coordUnit[i]);
+              out += buffer;
+            }
+        }
+      for (G4int i = 0; i < 3; i++)
+        {
+          std::snprintf(buffer, sizeof(buffer), "%15.6g  ", fieldValues[6*p + offset + i] / fieldUnit);
+          out += buffer;
+        }
+      out += "\n";
+    }
+}
+
+void BDSFieldQuery::WriteFieldValuesBinary(std::ofstream&  out,
+                                           const G4double* xyzt,
+                                           const G4double* fieldValues,
+                                           std::size_t     nPoints,
+                                           G4bool          magnetic) const
+{
+  const G4double fieldUnit = magnetic ? CLHEP::tesla : CLHEP::volt/CLHEP::m;
+  const G4int    offset    = magnetic ? 0 : 3;
+  const G4double coordUnit[4] = {CLHEP::cm, CLHEP::cm, CLHEP::cm, CLHEP::s};
+  const G4bool   writeCoord[4] = {writeX, writeY, writeZ, writeT};
+  std::vector<G4double> row;
+  row.reserve(nPoints * 7);
+  for (std::size_t p = 0; p < nPoints; p++)
+    {
+      for (G4int i = 0; i < 4; i++)
+        {
+          if (writeCoord[i])
+            {row.push_back(xyzt[4*p + i] / coordUnit[i]);}
+        }
+      for (G4int i = 0; i < 3; i++)
+        {row.push_back(fieldValues[6*p + offset + i] / fieldUnit);}
+    }
+  out.write(reinterpret_cast<const char*>(row.data()), (std::streamsize)(row.size() * sizeof(G4double)));
+}
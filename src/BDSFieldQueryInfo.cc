@@ -48,6 +48,8 @@ BDSFieldQueryInfo::BDSFieldQueryInfo(const G4String& nameIn,
   globalTransform(globalTransformIn),
   overwriteExistingFiles(overwriteExistingFilesIn),
   printTransform(printTransformIn),
+  nThreads(1),
+  binaryOutput(false),
   fieldObject(fieldObjectIn),
   checkParameters(checkParametersIn),
   drawArrows(drawArrowsIn),
@@ -79,6 +81,8 @@ BDSFieldQueryInfo::BDSFieldQueryInfo(const G4String& nameIn,
   pointsColumnNames(pointsColumnNamesIn),
   overwriteExistingFiles(overwriteExistingFilesIn),
   printTransform(false),
+  nThreads(1),
+  binaryOutput(false),
   fieldObject(fieldObjectIn),
   checkParameters(checkParametersIn),
   drawArrows(drawArrowsIn),
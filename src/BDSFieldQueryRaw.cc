@@ -25,6 +25,8 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "G4ThreeVector.hh"
 #include "G4Types.hh"
 
+#include <vector>
+
 BDSFieldQueryRaw::BDSFieldQueryRaw():
   field(nullptr)
 {;}
@@ -36,7 +38,37 @@ void BDSFieldQueryRaw::QueryFieldRaw(G4Field* fieldIn,
 				     const BDSFieldQueryInfo* query)
 {
   field = fieldIn;
+  fields.clear();
+  QueryField(query);
+}
+
+void BDSFieldQueryRaw::QueryFieldRaw(const std::vector<G4Field*>& fieldsIn,
+				     const BDSFieldQueryInfo*     query)
+{
+  fields = fieldsIn;
+  field  = fields.empty() ? nullptr : fields[0];
   QueryField(query);
+  fields.clear();
+}
+
+G4bool BDSFieldQueryRaw::SupportsParallelQuery(G4int nThreads) const
+{
+  return (G4int)fields.size() >= nThreads;
+}
+
+void BDSFieldQueryRaw::GetFieldValueThread(const G4ThreeVector& globalXYZ,
+					   const G4ThreeVector& /*globalDirection*/,
+					   G4double tGlobal,
+					   G4double fieldValue[6],
+					   G4int    threadIndex)
+{
+  for (G4int i = 0; i < 6; i++)
+    {fieldValue[i] = 0;}
+  G4Field* threadField = fields[threadIndex];
+  if (!threadField)
+    {return;}
+  G4double position[4] = {globalXYZ.x(), globalXYZ.y(),globalXYZ.z(), tGlobal};
+  threadField->GetFieldValue(position, fieldValue);
 }
 
 void BDSFieldQueryRaw::GetFieldValue(const G4ThreeVector& globalXYZ,
@@ -0,0 +1,247 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "BDSDebug.hh"
+#include "BDSException.hh"
+#include "BDSFileOffsetIndex.hh"
+#include "BDSWarning.hh"
+
+#include "G4String.hh"
+#include "G4Types.hh"
+#include "globals.hh"
+
+#include <cstdio>
+#include <fstream>
+#include <istream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+  const std::string sidecarHeader = "# BDSIM file offset index v1";
+}
+
+BDSFileOffsetIndex::BDSFileOffsetIndex(const G4String& filePathIn,
+                                       const G4String& keyIn,
+                                       RecordPredicate isRecordIn,
+                                       G4long          nLinesIgnoreIn,
+                                       G4bool          useSidecarFileIn,
+                                       G4long          strideIn):
+  filePath(filePathIn),
+  key(keyIn),
+  isRecord(isRecordIn),
+  nLinesIgnore(nLinesIgnoreIn),
+  useSidecarFile(useSidecarFileIn),
+  stride(strideIn > 0 ? strideIn : 1),
+  nRecords(0),
+  fileSize(0),
+  fileModificationTime(0)
+{
+  StatFile();
+  if (useSidecarFile && ReadSidecar())
+    {
+      G4cout << __METHOD_NAME__ << "using index " << SidecarFileName(filePath) << " -> "
+             << nRecords << " records" << G4endl;
+      return;
+    }
+  G4cout << __METHOD_NAME__ << "indexing " << filePath << G4endl;
+  Build();
+  G4cout << __METHOD_NAME__ << nRecords << " records found in file" << G4endl;
+  if (useSidecarFile)
+    {WriteSidecar();}
+}
+
+G4String BDSFileOffsetIndex::SidecarFileName(const G4String& filePath)
+{
+  return filePath + ".bdsidx";
+}
+
+void BDSFileOffsetIndex::StatFile()
+{
+  struct stat sb;
+  if (stat(filePath.c_str(), &sb) != 0)
+    {throw BDSException(__METHOD_NAME__, "cannot access file \"" + filePath + "\"");}
+  fileSize = (long long int)sb.st_size;
+  fileModificationTime = (long long int)sb.st_mtime;
+}
+
+G4bool BDSFileOffsetIndex::ReadSidecar()
+{
+  std::ifstream in(SidecarFileName(filePath));
+  if (!in.good())
+    {return false;}
+
+  std::string header;
+  std::getline(in, header);
+  if (header != sidecarHeader)
+    {return false;}
+
+  std::string name;
+  std::string keyIn;
+  long long int sizeIn = -1;
+  long long int timeIn = -1;
+  G4long nLinesIgnoreIn = -1;
+  G4long strideIn = 0;
+  G4long nRecordsIn = -1;
+  in >> name >> keyIn;
+  if (name != "key" || keyIn != key)
+    {return false;}
+  in >> name >> sizeIn;
+  if (name != "size" || sizeIn != fileSize)
+    {return false;}
+  in >> name >> timeIn;
+  if (name != "mtime" || timeIn != fileModificationTime)
+    {return false;}
+  in >> name >> nLinesIgnoreIn;
+  if (name != "nlinesignore" || nLinesIgnoreIn != nLinesIgnore)
+    {return false;}
+  in >> name >> strideIn;
+  if (name != "stride" || strideIn < 1)
+    {return false;}
+  in >> name >> nRecordsIn;
+  if (name != "nrecords" || nRecordsIn < 0)
+    {return false;}
+
+  G4long nEntries = nRecordsIn == 0 ? 0 : (nRecordsIn - 1) / strideIn + 1;
+  std::vector<long long int> offsetsIn((std::size_t)nEntries);
+  std::vector<long long int> lineNumbersIn((std::size_t)nEntries);
+  for (G4long i = 0; i < nEntries; i++)
+    {in >> offsetsIn[i] >> lineNumbersIn[i];}
+  if (in.fail())
+    {return false;} // truncated or corrupt - rebuild
+
+  stride      = strideIn;
+  nRecords    = nRecordsIn;
+  offsets     = std::move(offsetsIn);
+  lineNumbers = std::move(lineNumbersIn);
+  return true;
+}
+
+void BDSFileOffsetIndex::Build()
+{
+  std::ifstream in(filePath);
+  if (!in.good())
+    {throw BDSException(__METHOD_NAME__, "cannot open file \"" + filePath + "\"");}
+
+  offsets.clear();
+  lineNumbers.clear();
+  nRecords = 0;
+  long long int position   = 0;
+  long long int lineNumber = 0;
+  std::string line;
+  while (std::getline(in, line))
+    {
+      // position is accumulated rather than queried with tellg as that is slow for
+      // every line - '\r' of windows line endings is left in the line so is counted
+      if (lineNumber >= nLinesIgnore && isRecord(line))
+        {
+          if (nRecords % stride == 0)
+            {
+              offsets.push_back(position);
+              lineNumbers.push_back(lineNumber);
+            }
+          nRecords++;
+        }
+      position += (long long int)line.size() + 1;
+      lineNumber++;
+    }
+  if (lineNumber < nLinesIgnore)
+    {
+      G4String msg = "end of file reached after line " + std::to_string(lineNumber);
+      msg += " before nlinesIgnore (" + std::to_string(nLinesIgnore) + ") was reached.";
+      throw BDSException(__METHOD_NAME__, msg);
+    }
+}
+
+void BDSFileOffsetIndex::WriteSidecar() const
+{
+  G4String sidecarName = SidecarFileName(filePath);
+  G4String tempName = sidecarName + ".tmp" + std::to_string((long)getpid());
+  {
+    std::ofstream out(tempName);
+    if (!out.good())
+      {
+        BDS::Warning(__METHOD_NAME__, "cannot write index \"" + sidecarName + "\" - keeping it in memory only");
+        return;
+      }
+    out << sidecarHeader << "\n"
+        << "key "          << key                  << "\n"
+        << "size "         << fileSize             << "\n"
+        << "mtime "        << fileModificationTime << "\n"
+        << "nlinesignore " << nLinesIgnore         << "\n"
+        << "stride "       << stride               << "\n"
+        << "nrecords "     << nRecords             << "\n";
+    for (std::size_t i = 0; i < offsets.size(); i++)
+      {out << offsets[i] << " " << lineNumbers[i] << "\n";}
+    if (!out.good())
+      {
+        out.close();
+        std::remove(tempName.c_str());
+        BDS::Warning(__METHOD_NAME__, "problem writing index \"" + sidecarName + "\" - keeping it in memory only");
+        return;
+      }
+  }
+  // rename is atomic so another job reading the index sees either the old or the new one
+  if (std::rename(tempName.c_str(), sidecarName.c_str()) != 0)
+    {
+      std::remove(tempName.c_str());
+      BDS::Warning(__METHOD_NAME__, "cannot write index \"" + sidecarName + "\" - keeping it in memory only");
+    }
+  else
+    {G4cout << __METHOD_NAME__ << "wrote index " << sidecarName << G4endl;}
+}
+
+G4long BDSFileOffsetIndex::SeekToRecord(std::istream& stream, G4long recordIndex) const
+{
+  if (recordIndex < 0 || recordIndex >= nRecords)
+    {
+      G4String msg = "record index " + std::to_string(recordIndex) + " is beyond the ";
+      msg += std::to_string(nRecords) + " records in file \"" + filePath + "\"";
+      throw BDSException(__METHOD_NAME__, msg);
+    }
+
+  std::size_t   entry      = (std::size_t)(recordIndex / stride);
+  long long int position   = offsets[entry];
+  long long int lineNumber = lineNumbers[entry];
+  G4long        current    = (G4long)entry * stride;
+  stream.clear();
+  stream.seekg((std::streamoff)position);
+
+  // the line at this position is the start of record 'current' - read forward
+  // line by line counting the starts of subsequent records
+  std::string line;
+  std::getline(stream, line);
+  while (current < recordIndex)
+    {
+      position += (long long int)line.size() + 1;
+      lineNumber++;
+      if (!std::getline(stream, line))
+        {throw BDSException(__METHOD_NAME__, "index does not match file \"" + filePath + "\"");}
+      if (isRecord(line))
+        {current++;}
+    }
+  stream.clear();
+  stream.seekg((std::streamoff)position);
+  if (stream.fail())
+    {throw BDSException(__METHOD_NAME__, "unable to seek in file \"" + filePath + "\"");}
+  return (G4long)lineNumber;
+}
@@ -0,0 +1,37 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "BDSHitsCollectionScorerMesh.hh"
+#include "BDSScorerMeshStorage.hh"
+
+#include "G4String.hh"
+#include "G4Types.hh"
+
+BDSHitsCollectionScorerMesh::BDSHitsCollectionScorerMesh(const G4String&             detectorName,
+                                                         const G4String&             collectionName,
+                                                         const BDSScorerMeshStorage* storageIn,
+                                                         G4bool                      rootBinIndexingIn):
+  G4VHitsCollection(detectorName, collectionName),
+  storage(storageIn),
+  rootBinIndexing(rootBinIndexingIn)
+{;}
+
+size_t BDSHitsCollectionScorerMesh::GetSize() const
+{
+  return storage ? (size_t)storage->NTouched() : 0;
+}
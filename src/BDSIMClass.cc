@@ -46,6 +46,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "BDSBunch.hh"
 #include "BDSBunchFactory.hh"
 #include "BDSCavityFactory.hh"
+#include "BDSCheckpoint.hh"
 #include "BDSColours.hh"
 #include "BDSComponentFactoryUser.hh"
 #include "BDSDebug.hh"
@@ -67,6 +68,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "BDSPhysicsUtilities.hh"
 #include "BDSPrimaryGeneratorAction.hh"
 #include "BDSRandom.hh" // for random number generator from CLHEP
+#include "BDSRegionCutProfiler.hh"
 #include "BDSRunAction.hh"
 #include "BDSRunManager.hh"
 #include "BDSSamplerRegistry.hh"
@@ -75,6 +77,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "BDSStackingAction.hh"
 #include "BDSTemporaryFiles.hh"
 #include "BDSTrackingAction.hh"
+#include "BDSTrackingEnvelope.hh"
 #include "BDSUtilities.hh"
 #include "BDSVisManager.hh"
 #include "BDSWarning.hh"
@@ -92,7 +95,10 @@ BDSIM::BDSIM():
   runManager(nullptr),
   userComponentFactory(nullptr),
   userPhysicsList(nullptr),
-  realWorld(nullptr)
+  realWorld(nullptr),
+  regionCutProfiler(nullptr),
+  trackingEnvelope(nullptr),
+  checkpoint(nullptr)
 {;}
 
 BDSIM::BDSIM(int argc, char** argv, bool usualPrintOutIn):
@@ -108,7 +114,10 @@ BDSIM::BDSIM(int argc, char** argv, bool usualPrintOutIn):
   runManager(nullptr),
   userComponentFactory(nullptr),
   userPhysicsList(nullptr),
-  realWorld(nullptr)
+  realWorld(nullptr),
+  regionCutProfiler(nullptr),
+  trackingEnvelope(nullptr),
+  checkpoint(nullptr)
 {
   initialisationResult = Initialise();
 }
@@ -247,6 +256,10 @@ int BDSIM::Initialise()
   
   // Muon splitting - optional - should be done *after* biasing to work with it - TBC it's before...
   BDS::BuildMuonBiasing(physList);
+
+  // Map transport through vacuum sections - optional - primary particle type only
+  if (globals->MapTransport())
+    {BDS::RegisterMapTransportPhysics(physList, beamParticle);}
   
   BDS::RegisterSamplerPhysics(parallelWorldPhysics, physList);
   auto biasPhysics = BDS::BuildAndAttachBiasWrapper(parser->GetBiasing());
@@ -297,16 +310,52 @@ int BDSIM::Initialise()
                                              eventAction,
                                              globals->StoreTrajectorySamplerID());
   runManager->SetUserAction(runAction);
+
+  if (globals->CheckpointEveryNEvents() > 0 || globals->Resume())
+    {
+      if (globals->NumberOfEventsPerNtuple() > 0)
+        {throw BDSException(__METHOD_NAME__, "checkpointing or resuming a run cannot be used with the option nperfile");}
+      if (globals->Recreate() && globals->Resume())
+        {throw BDSException(__METHOD_NAME__, "recreate and resumeFromCheckpoint cannot be used together");}
+      checkpoint = new BDSCheckpoint(globals->CheckpointFileName(),
+                                     globals->CheckpointEveryNEvents(),
+                                     globals->ResumeFromCheckpoint(),
+                                     bdsOutput,
+                                     bdsBunch);
+      eventAction->SetCheckpoint(checkpoint);
+      runAction->SetCheckpoint(checkpoint);
+      if (checkpoint->Resuming())
+        {// only the remaining events are simulated - may be updated by the primary generator action
+          G4int nRemaining = globals->NGenerate() - (G4int)checkpoint->NEventsResumed();
+          globals->SetNumberToGenerate(std::max(0, nRemaining));
+        }
+    }
   
   // Only add stepping action if it is actually used, so do check here (for performance reasons)
   G4int verboseSteppingEventStart = globals->VerboseSteppingEventStart();
   G4int verboseSteppingEventStop  = BDS::VerboseEventStop(verboseSteppingEventStart,
                                                           globals->VerboseSteppingEventContinueFor());
-  if (globals->VerboseSteppingBDSIM())
+  if (globals->UseRegionCutProfile())
+    {
+      regionCutProfiler = new BDSRegionCutProfiler(globals->RegionCutProfileFile(),
+                                                   globals->RegionCutProfileTolerance(),
+                                                   globals->RegionCutProfileScoringRegions());
+      runAction->SetRegionCutProfiler(regionCutProfiler);
+    }
+  if (globals->UseTrackingEnvelope())
+    {
+      trackingEnvelope = new BDSTrackingEnvelope(globals->TrackingEnvelopeRadius(),
+                                                 globals->TrackingEnvelopeSMin(),
+                                                 globals->TrackingEnvelopeSMax(),
+                                                 globals->TrackingEnvelopeRecord());
+    }
+  if (globals->VerboseSteppingBDSIM() || regionCutProfiler || trackingEnvelope)
     {
-      runManager->SetUserAction(new BDSSteppingAction(true,
+      runManager->SetUserAction(new BDSSteppingAction(globals->VerboseSteppingBDSIM(),
                                                       verboseSteppingEventStart,
-                                                      verboseSteppingEventStop));
+                                                      verboseSteppingEventStop,
+                                                      regionCutProfiler,
+                                                      trackingEnvelope));
     }
   
   runManager->SetUserAction(new BDSTrackingAction(globals->Batch(),
@@ -320,7 +369,9 @@ int BDSIM::Initialise()
 
   runManager->SetUserAction(new BDSStackingAction(globals));
   
-  auto primaryGeneratorAction = new BDSPrimaryGeneratorAction(bdsBunch, parser->GetBeam(), globals->Batch());
+  auto primaryGeneratorAction = new BDSPrimaryGeneratorAction(bdsBunch, parser->GetBeam(), globals->Batch(), checkpoint);
+  if (checkpoint)
+    {checkpoint->SetPrimaryGeneratorAction(primaryGeneratorAction);}
   // possibly updated after the primary generator as loaded a beam file
   eventAction->SetPrintModulo(BDSGlobalConstants::Instance()->PrintModuloEvents());
   runManager->SetUserAction(primaryGeneratorAction);
@@ -449,6 +500,9 @@ BDSIM::~BDSIM()
   
   delete runManager;
   delete bdsBunch;
+  delete regionCutProfiler;
+  delete trackingEnvelope;
+  delete checkpoint;
   delete parser;
 
   if (usualPrintOut)
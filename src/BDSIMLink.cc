@@ -46,6 +46,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "BDSGeometryFactorySQL.hh"
 #include "BDSGeometryWriter.hh"
 #include "BDSGlobalConstants.hh"
+#include "BDSHitSamplerLink.hh"
 #include "BDSLinkComponent.hh"
 #include "BDSLinkDetectorConstruction.hh"
 #include "BDSLinkEventAction.hh"
@@ -59,6 +60,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "BDSOutputFactory.hh"
 #include "BDSParallelWorldUtilities.hh"
 #include "BDSParser.hh"
+#include "BDSParticleCoordsFull.hh"
 #include "BDSParticleExternal.hh"
 #include "BDSParticleDefinition.hh"
 #include "BDSPhysicsUtilities.hh"
@@ -69,6 +71,9 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "BDSUtilities.hh"
 #include "BDSVisManager.hh"
 
+#include "CLHEP/Units/SystemOfUnits.h"
+
+#include <algorithm>
 #include <map>
 #include <set>
 
@@ -85,8 +90,10 @@ BDSIMLink::BDSIMLink(BDSBunch* bunchIn):
   runManager(nullptr),
   construction(nullptr),
   runAction(nullptr),
+  primaryGeneratorAction(nullptr),
   currentElementIndex(0),
-  userPhysicsList(nullptr)
+  userPhysicsList(nullptr),
+  primariesPerEvent(1)
 {;}
 
 BDSIMLink::BDSIMLink(int argc, char** argv, bool usualPrintOutIn):
@@ -102,8 +109,10 @@ BDSIMLink::BDSIMLink(int argc, char** argv, bool usualPrintOutIn):
   runManager(nullptr),
   construction(nullptr),
   runAction(nullptr),
+  primaryGeneratorAction(nullptr),
   currentElementIndex(0),
-  userPhysicsList(nullptr)
+  userPhysicsList(nullptr),
+  primariesPerEvent(1)
 {
   initialisationResult = Initialise();
 }
@@ -297,7 +306,8 @@ int BDSIMLink::Initialise(double minimumKineticEnergy,
     }
   */
   
-  auto primaryGeneratorAction = new BDSLinkPrimaryGeneratorAction(bdsBunch, &currentElementIndex, construction, trackerDebug);
+  primaryGeneratorAction = new BDSLinkPrimaryGeneratorAction(bdsBunch, &currentElementIndex, construction, trackerDebug);
+  primaryGeneratorAction->SetPrimariesPerEvent(primariesPerEvent);
   construction->SetPrimaryGeneratorAction(primaryGeneratorAction);
   runManager->SetUserAction(primaryGeneratorAction);
   //BDSFieldFactory::SetPrimaryGeneratorAction(primaryGeneratorAction);
@@ -567,3 +577,112 @@ void BDSIMLink::SetCurrentMaximumExternalParticleID(int currentMaximumExternalPa
   if (runAction)
     {runAction->SetMaximumExternalParticleID(currentMaximumExternalParticleID);}
 }
+
+void BDSIMLink::SetPrimariesPerEvent(int primariesPerEventIn)
+{
+  primariesPerEvent = primariesPerEventIn;
+  if (primaryGeneratorAction)
+    {primaryGeneratorAction->SetPrimariesPerEvent(primariesPerEvent);}
+}
+
+int BDSIMLink::NEventsForBunch() const
+{
+  auto bunchSTL = dynamic_cast<BDSBunchSixTrackLink*>(bdsBunch);
+  if (!bunchSTL)
+    {return 0;}
+  int nParticles = (int)bunchSTL->Size();
+  if (primariesPerEvent == 1)
+    {return nParticles;}
+  else if (primariesPerEvent <= 0)
+    {return nParticles > 0 ? 1 : 0;}
+  else
+    {return (nParticles + primariesPerEvent - 1) / primariesPerEvent;}
+}
+
+BDSBunchSixTrackLink* BDSIMLink::LinkBunch() const
+{
+  auto bunchSTL = dynamic_cast<BDSBunchSixTrackLink*>(bdsBunch);
+  if (!bunchSTL)
+    {throw BDSException(__METHOD_NAME__, "the bunch is not a BDSBunchSixTrackLink");}
+  return bunchSTL;
+}
+
+void BDSIMLink::SetParticles(int           n,
+                             const double* x,
+                             const double* y,
+                             const double* xp,
+                             const double* yp,
+                             const double* totalEnergy,
+                             const int*    pdgID,
+                             const double* t,
+                             const int*    ionA,
+                             const int*    ionZ,
+                             const double* ionCharge,
+                             const int*    externalParticleID,
+                             const int*    externalParentID)
+{
+  BDSBunchSixTrackLink::ParticleArrays arrays;
+  arrays.n                  = std::max(0, n);
+  arrays.x                  = x;
+  arrays.y                  = y;
+  arrays.xp                 = xp;
+  arrays.yp                 = yp;
+  arrays.totalEnergy        = totalEnergy;
+  arrays.pdgID              = pdgID;
+  arrays.t                  = t;
+  arrays.ionA               = ionA;
+  arrays.ionZ               = ionZ;
+  arrays.ionCharge          = ionCharge;
+  arrays.externalParticleID = externalParticleID;
+  arrays.externalParentID   = externalParentID;
+  LinkBunch()->SetParticleArrays(arrays);
+}
+
+int BDSIMLink::GetReturnedParticles(int     nMax,
+                                    double* x,
+                                    double* y,
+                                    double* xp,
+                                    double* yp,
+                                    double* totalEnergy,
+                                    int*    pdgID,
+                                    double* t,
+                                    int*    ionA,
+                                    int*    ionZ,
+                                    double* ionCharge,
+                                    int*    externalParticleID,
+                                    int*    externalParentID) const
+{
+  const BDSHitsCollectionSamplerLink* hits = SamplerHits();
+  if (!hits || !x)
+    {return 0;}
+  int n = std::min(nMax, (int)hits->entries());
+  for (int i = 0; i < n; i++)
+    {
+      const BDSHitSamplerLink* hit = (*hits)[i];
+      const BDSParticleCoordsFull& c = hit->coords;
+      x[i] = c.x / CLHEP::m;
+      if (y)
+        {y[i] = c.y / CLHEP::m;}
+      if (xp)
+        {xp[i] = c.xp;}
+      if (yp)
+        {yp[i] = c.yp;}
+      if (totalEnergy)
+        {totalEnergy[i] = c.totalEnergy / CLHEP::GeV;}
+      if (pdgID)
+        {pdgID[i] = hit->pdgID;}
+      if (t)
+        {t[i] = c.T / CLHEP::s;}
+      if (ionA)
+        {ionA[i] = hit->A;}
+      if (ionZ)
+        {ionZ[i] = hit->Z;}
+      if (ionCharge)
+        {ionCharge[i] = hit->charge;}
+      if (externalParticleID)
+        {externalParticleID[i] = hit->externalParticleID;}
+      if (externalParentID)
+        {externalParentID[i] = hit->externalParentID;}
+    }
+  return n;
+}
@@ -0,0 +1,152 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "BDSDebug.hh"
+#include "BDSIntegrationDriverExact.hh"
+
+#include "G4FieldTrack.hh"
+#include "G4MagIntegratorDriver.hh"
+#include "G4MagIntegratorStepper.hh"
+#include "G4String.hh"
+#include "G4Types.hh"
+#include "G4Version.hh"
+
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <utility>
+#include <vector>
+
+G4ThreadLocal std::vector<BDSIntegrationDriverExact*>* BDSIntegrationDriverExact::drivers = nullptr;
+
+BDSIntegrationDriverExact::BDSIntegrationDriverExact(G4double                hminimum,
+                                                     G4MagIntegratorStepper* stepper,
+                                                     G4int                   numberOfComponents):
+  G4MagInt_Driver(hminimum, stepper, numberOfComponents),
+  name(""),
+  nStepsWhole(0),
+  nStepsFallback(0)
+{
+  if (!drivers)
+    {drivers = new std::vector<BDSIntegrationDriverExact*>();}
+  drivers->push_back(this);
+}
+
+BDSIntegrationDriverExact::~BDSIntegrationDriverExact()
+{
+  if (drivers)
+    {drivers->erase(std::remove(drivers->begin(), drivers->end(), this), drivers->end());}
+}
+
+#if G4VERSION_NUMBER > 1059
+G4double BDSIntegrationDriverExact::AdvanceChordLimited(G4FieldTrack& track,
+                                                        G4double      stepMax,
+                                                        G4double      epsStep,
+                                                        G4double      chordDistance)
+{
+  if (WholeStep(track, stepMax, epsStep, chordDistance))
+    {return stepMax;}
+  nStepsFallback++;
+  return G4MagInt_Driver::AdvanceChordLimited(track, stepMax, epsStep, chordDistance);
+}
+
+G4bool BDSIntegrationDriverExact::AccurateAdvance(G4FieldTrack& track,
+                                                  G4double      hstep,
+                                                  G4double      eps,
+                                                  G4double      hinitial)
+{
+  // no chord limit here as this is used to advance to a known point
+  if (hstep > 0 && WholeStep(track, hstep, eps, std::numeric_limits<G4double>::max()))
+    {return true;}
+  nStepsFallback++;
+  return G4MagInt_Driver::AccurateAdvance(track, hstep, eps, hinitial);
+}
+
+G4bool BDSIntegrationDriverExact::WholeStep(G4FieldTrack& track,
+                                            G4double      hstep,
+                                            G4double      eps,
+                                            G4double      chordDistance)
+{
+  G4double yIn[G4FieldTrack::ncompSVEC];
+  G4double yOut[G4FieldTrack::ncompSVEC];
+  G4double yErr[G4FieldTrack::ncompSVEC];
+  G4double dydx[G4FieldTrack::ncompSVEC];
+  track.DumpToArray(yIn);
+  GetDerivatives(track, dydx);
+
+  G4MagIntegratorStepper* stepper = GetStepper();
+  stepper->Stepper(yIn, dydx, hstep, yOut, yErr);
+
+  // same error norm as G4MagInt_Driver - position relative to the step length
+  // and momentum relative to the momentum
+  G4double epsPosition = eps * hstep;
+  G4double errPositionSq = (yErr[0]*yErr[0] + yErr[1]*yErr[1] + yErr[2]*yErr[2]) / (epsPosition*epsPosition);
+  G4double momentumSq = yIn[3]*yIn[3] + yIn[4]*yIn[4] + yIn[5]*yIn[5];
+  G4double errMomentumSq = 0;
+  if (momentumSq > 0)
+    {errMomentumSq = (yErr[3]*yErr[3] + yErr[4]*yErr[4] + yErr[5]*yErr[5]) / (eps*eps*momentumSq);}
+  if (std::max(errPositionSq, errMomentumSq) > 1 || stepper->DistChord() > chordDistance)
+    {return false;}
+
+  G4double curveLength = track.GetCurveLength();
+  track.LoadFromArray(yOut, stepper->GetNumberOfVariables());
+  track.SetCurveLength(curveLength + hstep);
+  nStepsWhole++;
+  return true;
+}
+#endif
+
+void BDSIntegrationDriverExact::PrintStatistics(G4double duration)
+{
+  if (!drivers || drivers->empty())
+    {return;}
+  // several drivers may be attached to volumes of the same name
+  std::map<G4String, std::pair<G4long, G4long> > steps;
+  G4long total = 0;
+  for (const auto driver : *drivers)
+    {
+      auto& s = steps[driver->Name()];
+      s.first  += driver->NStepsWhole();
+      s.second += driver->NStepsFallback();
+      total += driver->NStepsWhole() + driver->NStepsFallback();
+    }
+  if (total == 0)
+    {return;}
+  G4cout << __METHOD_NAME__ << "steps by exact integration driver (whole step / fall back):" << G4endl;
+  for (const auto& s : steps)
+    {
+      if (s.second.first + s.second.second > 0)
+        {G4cout << std::setw(40) << std::left << s.first << " " << s.second.first << " / " << s.second.second << G4endl;}
+    }
+  G4cout << __METHOD_NAME__ << total << " steps in total";
+  if (duration > 0)
+    {G4cout << " -> " << (G4double)total / duration << " steps / s";}
+  G4cout << std::right << G4endl;
+}
+
+void BDSIntegrationDriverExact::ResetStatistics()
+{
+  if (!drivers)
+    {return;}
+  for (auto driver : *drivers)
+    {
+      driver->nStepsWhole    = 0;
+      driver->nStepsFallback = 0;
+    }
+}
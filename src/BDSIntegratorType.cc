@@ -158,3 +158,18 @@ BDSIntegratorType BDS::DetermineIntegratorType(G4String integratorType)
 #endif
   return result->second;
 }
+
+G4bool BDS::IntegratorIsAnalytical(BDSIntegratorType integratorType)
+{
+  switch (integratorType.underlying())
+    {
+    case BDSIntegratorType::solenoid:
+    case BDSIntegratorType::dipolerodrigues:
+    case BDSIntegratorType::dipolerodrigues2:
+    case BDSIntegratorType::dipolematrix:
+    case BDSIntegratorType::quadrupole:
+      {return true;}
+    default:
+      {return false;}
+    }
+}
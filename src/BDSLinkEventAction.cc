@@ -36,7 +36,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "G4PropagatorInField.hh"
 #include "G4Run.hh"
 #include "G4SDManager.hh"
-#include "G4THitsMap.hh"
+#include "G4VHitsCollection.hh"
 #include "G4TransportationManager.hh"
 #include "G4VUserEventInformation.hh"
 
@@ -124,6 +124,8 @@ void BDSLinkEventAction::EndOfEventAction(const G4Event* evt)
     {return;}
   if (samplerLink->entries() <= 0)
     {return;}
+  else if (evtInfo && evtInfo->NPrimaries() > 1)
+    {runAction->AppendHits(currentEventIndex, evtInfo, samplerLink);}
   else
     {runAction->AppendHits(currentEventIndex, primaryExternalParticleID, primaryExternalParentID, samplerLink);}
 
@@ -145,6 +147,6 @@ void BDSLinkEventAction::EndOfEventAction(const G4Event* evt)
                     nullptr,
                     nullptr,
                     nullptr,
-                    std::map<G4String, G4THitsMap<G4double>*>(),
+                    std::map<G4String, G4VHitsCollection*>(),
                     BDSGlobalConstants::Instance()->TurnsTaken());
 }
@@ -0,0 +1,63 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "BDSLinkEventInfo.hh"
+
+#include "globals.hh" // geant4 types / globals
+
+#include <vector>
+
+void BDSLinkEventInfo::Flush()
+{
+  info->Flush();
+  externalParticleIDofPrimary = 0;
+  externalParentIDofPrimary   = 0;
+  externalParticleIDs.clear();
+  externalParentIDs.clear();
+  nPrimariesRegistered = 0;
+  primaryIndexOfTrack.clear();
+}
+
+void BDSLinkEventInfo::AddPrimary(G4int externalParticleID,
+                                  G4int externalParentID)
+{
+  if (externalParticleIDs.empty())
+    {
+      externalParticleIDofPrimary = externalParticleID;
+      externalParentIDofPrimary   = externalParentID;
+    }
+  externalParticleIDs.push_back(externalParticleID);
+  externalParentIDs.push_back(externalParentID);
+}
+
+void BDSLinkEventInfo::RegisterTrack(G4int trackID,
+                                     G4int parentID)
+{
+  // primaries are stacked in the order their vertices were generated
+  G4int index = parentID == 0 ? nPrimariesRegistered++ : PrimaryIndex(parentID);
+  if (trackID >= (G4int)primaryIndexOfTrack.size())
+    {primaryIndexOfTrack.resize(trackID + 1, -1);}
+  primaryIndexOfTrack[trackID] = index;
+}
+
+G4int BDSLinkEventInfo::PrimaryIndex(G4int trackID) const
+{
+  if (trackID < 0 || trackID >= (G4int)primaryIndexOfTrack.size())
+    {return -1;}
+  return primaryIndexOfTrack[trackID];
+}
@@ -35,6 +35,8 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "G4ParticleGun.hh"
 #include "G4Types.hh"
 
+#include <algorithm>
+
 BDSLinkPrimaryGeneratorAction::BDSLinkPrimaryGeneratorAction(BDSBunch* bunchIn,
 							     int*      currentElementIndexIn,
 							     BDSLinkDetectorConstruction* constructionIn,
@@ -43,7 +45,8 @@ BDSLinkPrimaryGeneratorAction::BDSLinkPrimaryGeneratorAction(BDSBunch* bunchIn,
   currentElementIndex(currentElementIndexIn),
   construction(constructionIn),
   debug(debugIn),
-  particleGun(nullptr)
+  particleGun(nullptr),
+  primariesPerEvent(1)
 {
   particleGun = new G4ParticleGun(1); // 1-particle gun
   
@@ -64,24 +67,51 @@ void BDSLinkPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
   anEvent->SetUserInformation(eventInfo);
   eventInfo->SetSeedStateAtStart(BDSRandom::GetSeedState());
 
+  auto bunchSTL = dynamic_cast<BDSBunchSixTrackLink*>(bunch);
+  G4int nPrimaries = 1;
+  if (bunchSTL && primariesPerEvent != 1)
+    {
+      G4int nRemaining = bunchSTL->NRemaining();
+      nPrimaries = primariesPerEvent > 0 ? std::min(primariesPerEvent, nRemaining) : nRemaining;
+    }
+
+  if (nPrimaries <= 1)
+    {
+      if (!GeneratePrimary(anEvent, eventInfo, bunchSTL))
+        {anEvent->SetEventAborted();}
+      return;
+    }
+
+  // With many primaries in one event, an invalid particle is skipped rather than
+  // aborting the whole event and losing all the others.
+  for (G4int i = 0; i < nPrimaries; i++)
+    {GeneratePrimary(anEvent, eventInfo, bunchSTL);}
+  if (anEvent->GetNumberOfPrimaryVertex() == 0)
+    {anEvent->SetEventAborted();}
+}
+
+G4bool BDSLinkPrimaryGeneratorAction::GeneratePrimary(G4Event* anEvent,
+                                                      BDSLinkEventInfo* eventInfo,
+                                                      BDSBunchSixTrackLink* bunchSTL)
+{
   BDSParticleCoordsFull coords;
+  G4int externalParticleID = 0;
+  G4int externalParentID   = 0;
   try
     {
       coords = bunch->GetNextParticleLocal();
-      auto bunchSTL = dynamic_cast<BDSBunchSixTrackLink*>(bunch);
       if (bunchSTL)
 	{
-	  eventInfo->externalParticleIDofPrimary = bunchSTL->CurrentExternalParticleID();
-	  eventInfo->externalParentIDofPrimary   = bunchSTL->CurrentExternalParentID();
+	  externalParticleID = bunchSTL->CurrentExternalParticleID();
+	  externalParentID   = bunchSTL->CurrentExternalParentID();
 	}
     }
   catch (const BDSException& exception)
     {// we couldn't safely generate a particle -> abort
       // could be because of user input file
-      anEvent->SetEventAborted();
       G4cout << exception.what() << G4endl;
-      G4cout << "Aborting this event (#" << anEvent->GetEventID() << ")" << G4endl;
-      return;
+      G4cout << "Aborting this particle in event (#" << anEvent->GetEventID() << ")" << G4endl;
+      return false;
     }
 
   BDSParticleCoordsFullGlobal cg;
@@ -117,8 +147,7 @@ void BDSLinkPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
       G4cout << __METHOD_NAME__ << "Event #" << anEvent->GetEventID()
 	     << " - Particle kinetic energy smaller than 0! "
 	     << "This will not be tracked." << G4endl;
-      anEvent->SetEventAborted();
-      return;
+      return false;
     }
 
   // check the coordinates are valid
@@ -126,8 +155,8 @@ void BDSLinkPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
     {
       G4cerr << __METHOD_NAME__ << "point: " << cg.global
 	     << "mm lies outside the world volume with extent ("
-	     << worldExtent << " - event aborted!" << G4endl << G4endl;
-      anEvent->SetEventAborted();
+	     << worldExtent << " - particle not tracked!" << G4endl << G4endl;
+      return false;
     }
 
 #ifdef BDSDEBUG
@@ -144,8 +173,8 @@ void BDSLinkPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 
   particleGun->GeneratePrimaryVertex(anEvent);
 
-  // set the weight
-  auto vertex = anEvent->GetPrimaryVertex();
+  // set the weight of the vertex just added
+  auto vertex = anEvent->GetPrimaryVertex(anEvent->GetNumberOfPrimaryVertex() - 1);
   vertex->SetWeight(cg.local.weight);
   //vertex->Print();
 
@@ -153,7 +182,10 @@ void BDSLinkPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
   //vertex->SetUserInformation(new BDSPrimaryVertexInformation(coords,
   //							     bunch->ParticleDefinition()));
 
+  eventInfo->AddPrimary(externalParticleID, externalParentID);
+
 #ifdef BDSDEBUG
   vertex->Print();
 #endif
+  return true;
 }
@@ -19,6 +19,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "BDSAuxiliaryNavigator.hh"
 #include "BDSHitSamplerLink.hh"
 #include "BDSLinkEventAction.hh"
+#include "BDSLinkEventInfo.hh"
 #include "BDSLinkRunAction.hh"
 
 BDSLinkRunAction::BDSLinkRunAction():
@@ -63,23 +64,47 @@ void BDSLinkRunAction::AppendHits(G4int currentEventIndex,
 {
   if (!hits)
     {return;}
+  for (G4int i = 0; i < (G4int)hits->entries(); i++)
+    {AppendHit((*hits)[i], currentEventIndex, externalParticleID, externalParentID);}
+}
+
+void BDSLinkRunAction::AppendHits(G4int currentEventIndex,
+                                  const BDSLinkEventInfo* eventInfo,
+                                  const BDSHitsCollectionSamplerLink* hits)
+{
+  if (!hits || !eventInfo)
+    {return;}
+  G4int nPrimaries = eventInfo->NPrimaries();
   for (G4int i = 0; i < (G4int)hits->entries(); i++)
     {
-      auto hit = new BDSHitSamplerLink(*(*hits)[i]);
-      hit->eventID = currentEventIndex;
-      if (hit->parentID == 0)
-	{// use same ones from event which are the original ones for this primary
-	  hit->externalParticleID = externalParticleID;
-	  hit->externalParentID   = externalParentID;
-	  nPrimariesToReturn++;
-	}
-      else
-	{// new secondary - give it a new index (caching that), and new parentID
-	  maximumExternalParticleID++;
-	  hit->externalParticleID = maximumExternalParticleID;
-	  hit->externalParentID   = externalParticleID;
-	  nSecondariesToReturn++;
-	}
-      allHits->insert(hit);
+      const BDSHitSamplerLink* hit = (*hits)[i];
+      G4int primaryIndex = eventInfo->PrimaryIndex(hit->trackID);
+      G4bool known = primaryIndex >= 0 && primaryIndex < nPrimaries;
+      G4int externalParticleID = known ? eventInfo->externalParticleIDs[primaryIndex] : 0;
+      G4int externalParentID   = known ? eventInfo->externalParentIDs[primaryIndex]   : 0;
+      AppendHit(hit, currentEventIndex, externalParticleID, externalParentID);
+    }
+}
+
+void BDSLinkRunAction::AppendHit(const BDSHitSamplerLink* hitIn,
+                                 G4int currentEventIndex,
+                                 G4int externalParticleID,
+                                 G4int externalParentID)
+{
+  auto hit = new BDSHitSamplerLink(*hitIn);
+  hit->eventID = currentEventIndex;
+  if (hit->parentID == 0)
+    {// use same ones from event which are the original ones for this primary
+      hit->externalParticleID = externalParticleID;
+      hit->externalParentID   = externalParentID;
+      nPrimariesToReturn++;
+    }
+  else
+    {// new secondary - give it a new index (caching that), and new parentID
+      maximumExternalParticleID++;
+      hit->externalParticleID = maximumExternalParticleID;
+      hit->externalParentID   = externalParticleID;
+      nSecondariesToReturn++;
     }
+  allHits->insert(hit);
 }
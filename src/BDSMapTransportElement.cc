@@ -0,0 +1,190 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "BDSMapTransportElement.hh"
+#include "BDSUtilities.hh"
+
+#include "G4Types.hh"
+
+#include "CLHEP/Units/SystemOfUnits.h"
+
+#include <algorithm>
+#include <cmath>
+
+const G4double BDSMapTransportElement::maximumSliceLength = 10*CLHEP::cm;
+
+BDSMapTransportElement::BDSMapTransportElement(G4double        arcLengthIn,
+					       G4double        curvatureIn,
+					       G4double        fieldIn,
+					       G4double        k1In,
+					       G4double        designBRhoIn,
+					       BDSBeamPipeType apertureTypeIn,
+					       G4double        aper1In,
+					       G4double        aper2In,
+					       G4double        aper3In,
+					       G4double        aper4In,
+					       G4double        aperOffsetXIn,
+					       G4double        aperOffsetYIn):
+  arcLength(arcLengthIn),
+  curvature(curvatureIn),
+  field(fieldIn),
+  k1(k1In),
+  designBRho(designBRhoIn),
+  nSlices(1),
+  apertureType(apertureTypeIn),
+  aper1(aper1In),
+  aper2(aper2In),
+  aper3(aper3In),
+  aper4(aper4In),
+  aperOffsetX(aperOffsetXIn),
+  aperOffsetY(aperOffsetYIn)
+{
+  if (BDS::IsFinite(curvature) || BDS::IsFinite(k1))
+    {nSlices = std::max(1, (G4int)std::ceil(arcLength / maximumSliceLength));}
+  sliceLength = arcLength / (G4double)nSlices;
+}
+
+G4bool BDSMapTransportElement::Transport(BDSMapTransportCoords& coords,
+					 G4double               brho) const
+{
+  // x'' + Kx x = fx and y'' + Ky y = 0
+  // quadrupole: Kx = -Ky = k1 scaled to this rigidity, as in BDSIntegratorQuadrupole
+  // sector bend: the particle curvature hp = B / brho about a reference of curvature h
+  // gives x'' = h(1 + hx) - hp(1 + hx)^2 to first order in x
+  G4double kx = 0;
+  G4double ky = 0;
+  G4double fx = 0;
+  if (BDS::IsFinite(k1))
+    {
+      kx = k1 * std::abs(designBRho) / brho;
+      ky = -kx;
+    }
+  if (BDS::IsFinite(curvature))
+    {
+      G4double hp = field / brho;
+      kx += curvature * (2*hp - curvature);
+      fx  = curvature - hp;
+    }
+
+  for (G4int i = 0; i < nSlices; i++)
+    {
+      G4double x0 = coords.x;
+      G4double xp0 = coords.xp;
+      G4double yp0 = coords.yp;
+      Propagate(coords.x, coords.xp, kx, fx, sliceLength);
+      Propagate(coords.y, coords.yp, ky, 0,  sliceLength);
+
+      // path length from the mean angle and the mean offset in a bend
+      G4double xpm = 0.5*(xp0 + coords.xp);
+      G4double ypm = 0.5*(yp0 + coords.yp);
+      G4double xm  = 0.5*(x0  + coords.x);
+      coords.pathLength += sliceLength * std::sqrt(1 + xpm*xpm + ypm*ypm) * (1 + curvature*xm);
+
+      if (!InsideAperture(coords.x, coords.y))
+	{return false;}
+    }
+  return true;
+}
+
+void BDSMapTransportElement::Propagate(G4double& u,
+				       G4double& up,
+				       G4double  K,
+				       G4double  f,
+				       G4double  l)
+{
+  G4double c  = 1; // cosine-like
+  G4double s  = l; // sine-like
+  G4double cp = 0; // derivative of the cosine-like
+  G4double d  = 0.5*f*l*l; // particular solution for u'' + K u = f
+  G4double phi2 = K*l*l;
+  if (phi2 > 1e-12)
+    {
+      G4double rk  = std::sqrt(K);
+      G4double phi = rk*l;
+      G4double sn  = std::sin(phi);
+      G4double sh  = std::sin(0.5*phi);
+      c  = std::cos(phi);
+      s  = sn / rk;
+      cp = -rk * sn;
+      d  = 2*f*sh*sh / K; // f(1 - cos(phi))/K
+    }
+  else if (phi2 < -1e-12)
+    {
+      G4double rk  = std::sqrt(-K);
+      G4double phi = rk*l;
+      G4double sn  = std::sinh(phi);
+      G4double sh  = std::sinh(0.5*phi);
+      c  = std::cosh(phi);
+      s  = sn / rk;
+      cp = rk * sn;
+      d  = -2*f*sh*sh / K; // f(1 - cosh(phi))/K
+    }
+  G4double u1  = c*u  + s*up + d;
+  G4double up1 = cp*u + c*up + f*s;
+  u  = u1;
+  up = up1;
+}
+
+G4bool BDSMapTransportElement::InsideAperture(G4double x,
+					      G4double y) const
+{
+  x = std::abs(x - aperOffsetX);
+  y = std::abs(y - aperOffsetY);
+  switch (apertureType.underlying())
+    {
+    case BDSBeamPipeType::circular:
+    case BDSBeamPipeType::circularvacuum:
+      {return x*x + y*y < aper1*aper1;}
+    case BDSBeamPipeType::elliptical:
+      {return (x*x)/(aper1*aper1) + (y*y)/(aper2*aper2) < 1;}
+    case BDSBeamPipeType::rectangular:
+      {return x < aper1 && y < aper2;}
+    case BDSBeamPipeType::lhc:
+    case BDSBeamPipeType::lhcdetailed:
+      {return x < aper1 && y < aper2 && x*x + y*y < aper3*aper3;}
+    case BDSBeamPipeType::rectellipse:
+      {return x < aper1 && y < aper2 && (x*x)/(aper3*aper3) + (y*y)/(aper4*aper4) < 1;}
+    case BDSBeamPipeType::racetrack:
+      {
+	// rectangle of half widths aper1 and aper2 with rounded corners of radius aper3
+	G4double dx = std::max(0.0, x - aper1);
+	G4double dy = std::max(0.0, y - aper2);
+	return dx*dx + dy*dy < aper3*aper3;
+      }
+    default:
+      {return false;}
+    }
+}
+
+G4bool BDSMapTransportElement::ApertureSupported(BDSBeamPipeType apertureTypeIn)
+{
+  switch (apertureTypeIn.underlying())
+    {
+    case BDSBeamPipeType::circular:
+    case BDSBeamPipeType::circularvacuum:
+    case BDSBeamPipeType::elliptical:
+    case BDSBeamPipeType::rectangular:
+    case BDSBeamPipeType::lhc:
+    case BDSBeamPipeType::lhcdetailed:
+    case BDSBeamPipeType::rectellipse:
+    case BDSBeamPipeType::racetrack:
+      {return true;}
+    default:
+      {return false;}
+    }
+}
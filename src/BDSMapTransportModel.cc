@@ -0,0 +1,96 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "BDSMapTransportModel.hh"
+#include "BDSMapTransportSection.hh"
+#include "BDSUtilities.hh"
+
+#include "G4DynamicParticle.hh"
+#include "G4FastStep.hh"
+#include "G4FastTrack.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4Region.hh"
+#include "G4Step.hh"
+#include "G4StepPoint.hh"
+#include "G4StepStatus.hh"
+#include "G4String.hh"
+#include "G4ThreeVector.hh"
+#include "G4Track.hh"
+#include "G4Types.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VTouchable.hh"
+
+#include "CLHEP/Units/PhysicalConstants.h"
+#include "CLHEP/Units/SystemOfUnits.h"
+
+#include <map>
+
+BDSMapTransportModel::BDSMapTransportModel(const G4String& modelName,
+					   G4Region*       envelope,
+					   const std::map<const G4VPhysicalVolume*, const BDSMapTransportSection*>* sectionEntriesIn):
+  G4VFastSimulationModel(modelName, envelope),
+  sectionEntries(sectionEntriesIn)
+{;}
+
+G4bool BDSMapTransportModel::IsApplicable(const G4ParticleDefinition& particle)
+{
+  return BDS::IsFinite(particle.GetPDGCharge()) && particle.GetPDGStable();
+}
+
+G4bool BDSMapTransportModel::ModelTrigger(const G4FastTrack& fastTrack)
+{
+  const G4Track* track = fastTrack.GetPrimaryTrack();
+  if (track->GetParentID() != 0)
+    {return false;}
+
+  // only on the step after crossing into a volume - the pre step point is the
+  // post step point of the previous step at this point
+  const G4Step* step = track->GetStep();
+  if (!step || step->GetPreStepPoint()->GetStepStatus() != fGeomBoundary)
+    {return false;}
+
+  // the placement of the beam line element in the world
+  const G4VTouchable* touchable = track->GetTouchable();
+  G4int depth = touchable->GetHistoryDepth();
+  if (depth < 1)
+    {return false;}
+  auto search = sectionEntries->find(touchable->GetVolume(depth - 1));
+  if (search == sectionEntries->end())
+    {return false;}
+
+  G4double charge = track->GetDynamicParticle()->GetCharge() / CLHEP::eplus;
+  G4double brho   = BDS::Rigidity(track->GetMomentum().mag(), charge) * CLHEP::tesla * CLHEP::m;
+  return search->second->Transport(track->GetPosition(), track->GetMomentumDirection(), brho, result);
+}
+
+void BDSMapTransportModel::DoIt(const G4FastTrack& fastTrack,
+				G4FastStep&        fastStep)
+{
+  const G4Track* track = fastTrack.GetPrimaryTrack();
+  G4double dt = result.pathLength / track->GetVelocity();
+  const G4DynamicParticle* dynamicParticle = track->GetDynamicParticle();
+  G4double properDt = dt * dynamicParticle->GetMass() / dynamicParticle->GetTotalEnergy();
+
+  // global coordinates
+  fastStep.ProposePrimaryTrackFinalPosition(result.position, false);
+  fastStep.ProposePrimaryTrackFinalMomentumDirection(result.direction, false);
+  fastStep.ProposePrimaryTrackFinalTime(track->GetGlobalTime() + dt);
+  fastStep.ProposePrimaryTrackFinalProperTime(track->GetProperTime() + properDt);
+  fastStep.ProposePrimaryTrackPathLength(result.pathLength);
+  fastStep.ProposeTotalEnergyDeposited(0);
+}
@@ -0,0 +1,198 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "BDSAcceleratorComponent.hh"
+#include "BDSBeamline.hh"
+#include "BDSBeamlineElement.hh"
+#include "BDSBeamPipeInfo.hh"
+#include "BDSFieldInfo.hh"
+#include "BDSFieldType.hh"
+#include "BDSMagnet.hh"
+#include "BDSMagnetStrength.hh"
+#include "BDSMapTransportElement.hh"
+#include "BDSMapTransportSection.hh"
+#include "BDSSamplerType.hh"
+#include "BDSTiltOffset.hh"
+#include "BDSUtilities.hh"
+
+#include "G4RotationMatrix.hh"
+#include "G4String.hh"
+#include "G4ThreeVector.hh"
+#include "G4Types.hh"
+
+#include "CLHEP/Units/SystemOfUnits.h"
+
+#include <cmath>
+#include <vector>
+
+const G4double BDSMapTransportSection::entranceTolerance = 1*CLHEP::um;
+const G4double BDSMapTransportSection::exitOffset        = 1*CLHEP::um;
+
+BDSMapTransportSection::BDSMapTransportSection(const BDSBeamlineElement* firstElementIn):
+  firstElement(firstElementIn),
+  name(firstElementIn->GetName()),
+  sStart(firstElementIn->GetSPositionStart()),
+  sEnd(firstElementIn->GetSPositionStart()),
+  startPosition(firstElementIn->GetReferencePositionStart()),
+  startRotationInverse(firstElementIn->GetReferenceRotationStart()->inverse())
+{;}
+
+BDSMapTransportSection::~BDSMapTransportSection()
+{
+  for (auto map : maps)
+    {delete map;}
+}
+
+BDSMapTransportElement* BDSMapTransportSection::BuildElement(const BDSBeamlineElement* element)
+{
+  const BDSAcceleratorComponent* component = element->GetAcceleratorComponent();
+  const BDSTiltOffset* tiltOffset = element->GetTiltOffset();
+  if (tiltOffset && (tiltOffset->HasFiniteTilt() || tiltOffset->HasFiniteOffset()))
+    {return nullptr;}
+  if (component->AngledInputFace() || component->AngledOutputFace())
+    {return nullptr;} // includes pole face angles
+  const BDSBeamPipeInfo* beamPipeInfo = component->GetBeamPipeInfo();
+  if (!beamPipeInfo || !BDSMapTransportElement::ApertureSupported(beamPipeInfo->beamPipeType))
+    {return nullptr;}
+  G4double arcLength = component->GetArcLength();
+  if (!BDS::IsFinite(arcLength))
+    {return nullptr;}
+
+  G4double curvature  = 0;
+  G4double field      = 0;
+  G4double k1         = 0;
+  G4double designBRho = 0;
+  const G4String type = component->GetType();
+  if (type == "drift")
+    {;}
+  else if (const BDSMagnet* magnet = dynamic_cast<const BDSMagnet*>(component))
+    {
+      if (type != "quadrupole" && type != "sbend")
+	{return nullptr;}
+      const BDSFieldInfo* fieldInfo = magnet->VacuumFieldInfo();
+      if (fieldInfo) // no field info for a zero strength magnet that is then a drift
+	{
+	  if (fieldInfo->ModulatorInfo())
+	    {return nullptr;}
+	  const BDSMagnetStrength* st = fieldInfo->MagnetStrength();
+	  designBRho = fieldInfo->BRho();
+	  if (type == "quadrupole" && fieldInfo->FieldType() == BDSFieldType::quadrupole)
+	    {k1 = (*st)["k1"] / CLHEP::m2;}
+	  else if (type == "sbend" && fieldInfo->FieldType() == BDSFieldType::dipole)
+	    {
+	      curvature = -component->GetAngle() / arcLength; // minus as stored for 3d cartesian
+	      field     = (*st)["field"];
+	    }
+	  else
+	    {return nullptr;} // e.g. a field map or a combined function dipole
+	}
+    }
+  else
+    {return nullptr;}
+
+  return new BDSMapTransportElement(arcLength, curvature, field, k1, designBRho,
+				    beamPipeInfo->beamPipeType,
+				    beamPipeInfo->aper1,
+				    beamPipeInfo->aper2,
+				    beamPipeInfo->aper3,
+				    beamPipeInfo->aper4,
+				    beamPipeInfo->aperOffsetX,
+				    beamPipeInfo->aperOffsetY);
+}
+
+std::vector<BDSMapTransportSection*> BDSMapTransportSection::BuildSections(const BDSBeamline* beamline)
+{
+  std::vector<BDSMapTransportSection*> result;
+  if (!beamline)
+    {return result;}
+  BDSMapTransportSection* current = nullptr;
+  for (const auto element : *beamline)
+    {
+      BDSMapTransportElement* map = BuildElement(element);
+      if (!map)
+	{// end the section
+	  current = nullptr;
+	  continue;
+	}
+      if (!current)
+	{
+	  current = new BDSMapTransportSection(element);
+	  result.push_back(current);
+	}
+      current->Append(element, map);
+      // the sampler is at the end of the element - the particle must cross it normally
+      if (element->GetSamplerType() != BDSSamplerType::none)
+	{current = nullptr;}
+    }
+  return result;
+}
+
+void BDSMapTransportSection::Append(const BDSBeamlineElement* element,
+				    BDSMapTransportElement*   map)
+{
+  maps.push_back(map);
+  endPositions.push_back(element->GetReferencePositionEnd());
+  endRotations.push_back(*(element->GetReferenceRotationEnd()));
+  sEnd = element->GetSPositionEnd();
+}
+
+G4bool BDSMapTransportSection::Transport(const G4ThreeVector&   globalPosition,
+					 const G4ThreeVector&   globalDirection,
+					 G4double               brho,
+					 BDSMapTransportResult& result) const
+{
+  G4ThreeVector localPosition  = startRotationInverse * (globalPosition - startPosition);
+  G4ThreeVector localDirection = startRotationInverse * globalDirection;
+  if (localDirection.z() <= 0 || std::abs(localPosition.z()) > entranceTolerance)
+    {return false;}
+  if (!maps[0]->InsideAperture(localPosition.x(), localPosition.y()))
+    {return false;}
+
+  BDSMapTransportCoords current;
+  current.x  = localPosition.x();
+  current.xp = localDirection.x() / localDirection.z();
+  current.y  = localPosition.y();
+  current.yp = localDirection.y() / localDirection.z();
+  BDSMapTransportCoords previous = current; // at the end of the element before the current one
+
+  G4int nElements = NElements();
+  G4int nPassed = 0;
+  for (const auto map : maps)
+    {
+      BDSMapTransportCoords trial = current;
+      if (!map->Transport(trial, brho))
+	{break;}
+      previous = current;
+      current  = trial;
+      nPassed++;
+    }
+
+  // for a loss, go back one element so it's tracked fully before the predicted loss
+  const BDSMapTransportCoords& exit = nPassed == nElements ? current : previous;
+  G4int nMoved = nPassed == nElements ? nElements : nPassed - 1;
+  if (nMoved < 1)
+    {return false;}
+
+  const G4RotationMatrix& rotation = endRotations[nMoved - 1];
+  G4ThreeVector direction = rotation * G4ThreeVector(exit.xp, exit.yp, 1).unit();
+  result.nElements  = nMoved;
+  result.direction  = direction;
+  result.position   = endPositions[nMoved - 1] + rotation * G4ThreeVector(exit.x, exit.y, 0) - exitOffset * direction;
+  result.pathLength = exit.pathLength - exitOffset;
+  return true;
+}
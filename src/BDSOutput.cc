@@ -33,6 +33,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "BDSHitSamplerCylinder.hh"
 #include "BDSHitSamplerSphere.hh"
 #include "BDSHitSamplerLink.hh"
+#include "BDSHitsCollectionScorerMesh.hh"
 #include "BDSOutput.hh"
 #include "BDSOutputROOTEventAperture.hh"
 #include "BDSOutputROOTEventBeam.hh"
@@ -57,6 +58,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "BDSPrimaryVertexInformation.hh"
 #include "BDSPrimaryVertexInformationV.hh"
 #include "BDSScorerHistogramDef.hh"
+#include "BDSScorerMeshStorage.hh"
 #include "BDSSDManager.hh"
 #include "BDSStackingAction.hh"
 #include "BDSTrajectoriesToStore.hh"
@@ -69,6 +71,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "G4PrimaryParticle.hh"
 #include "G4PrimaryVertex.hh"
 #include "G4THitsMap.hh"
+#include "G4VHitsCollection.hh"
 #include "G4Version.hh"
 
 #include "TH1D.h"
@@ -101,6 +104,8 @@ BDSOutput::BDSOutput(const G4String& baseFileNameIn,
   baseFileName(baseFileNameIn),
   fileExtension(fileExtensionIn),
   outputFileNumber(fileNumberOffset),
+  currentFileName(""),
+  nEventsResumed(0),
   sMinHistograms(0),
   sMaxHistograms(0),
   nbins(0),
@@ -185,6 +190,7 @@ void BDSOutput::FillHeader()
 {
   headerOutput->Flush();
   headerOutput->Fill(); // updates time stamp
+  headerOutput->nEventsResumed = nEventsResumed;
   WriteHeader();
   // we purposively don't call ClearStructuresHeader() as we may yet update and overwrite the header info
 }
@@ -313,7 +319,7 @@ void BDSOutput::FillEvent(const BDSEventInfo*                            info,
                           const BDSTrajectoriesToStore*                  trajectories,
                           const BDSHitsCollectionCollimator*             collimatorHits,
                           const BDSHitsCollectionApertureImpacts*        apertureImpactHits,
-                          const std::map<G4String, G4THitsMap<G4double>*>& scorerHits,
+                          const std::map<G4String, G4VHitsCollection*>&  scorerHits,
                           const G4int                                    turnsTaken)
 {
   // Clear integrals in this class -> here instead of BDSOutputStructures as
@@ -391,6 +397,26 @@ void BDSOutput::FillRun(const BDSEventInfo* info,
   ClearStructuresRunLevel();
 }
 
+void BDSOutput::Checkpoint(unsigned long long int nOriginalEventsIn,
+                           unsigned long long int nEventsRequestedIn,
+                           unsigned long long int nEventsInOriginalDistrFileIn,
+                           unsigned long long int nEventsDistrFileSkippedIn,
+                           unsigned int distrFileLoopNTimesIn)
+{
+  FillRunInfoAndUpdateHeader(nullptr, nOriginalEventsIn, nEventsRequestedIn, nEventsInOriginalDistrFileIn, nEventsDistrFileSkippedIn, distrFileLoopNTimesIn);
+  WriteHeaderEndOfFile(); // readers use the last entry of the header
+  WriteFileCheckpoint();
+}
+
+void BDSOutput::AccumulateRunHistograms(const BDSOutputROOTEventHistograms* otherRunHistos)
+{
+  if (!otherRunHistos)
+    {return;}
+  G4bool compatible = runHistos->AccumulateHistograms(otherRunHistos);
+  if (!compatible)
+    {throw BDSException(__METHOD_NAME__, "different run histograms - the input model or output options are not the same as the checkpointed run.");}
+}
+
 G4bool BDSOutput::InvalidSamplerName(const G4String& samplerName)
 {
   return protectedNames.find(samplerName) != protectedNames.end();
@@ -431,6 +457,7 @@ G4String BDSOutput::GetNextFileName()
 
   // add extension now we've got the base part fixed
   newFileName += fileExtension;
+  currentFileName = newFileName;
   
   G4cout << __METHOD_NAME__ << "Setting up new file: " << newFileName << G4endl;
 
@@ -620,7 +647,8 @@ void BDSOutput::CreateHistograms()
                                              def.nBinsX, def.xLow/CLHEP::m, def.xHigh/CLHEP::m,
                                              def.nBinsY, def.yLow/CLHEP::m, def.yHigh/CLHEP::m,
                                              def.nBinsZ, def.zLow/CLHEP::m, def.zHigh/CLHEP::m,
-                                             def.nBinsE, def.eLow/CLHEP::GeV, def.eHigh/CLHEP::GeV);
+                                             def.nBinsE, def.eLow/CLHEP::GeV, def.eHigh/CLHEP::GeV,
+                                             def.sparseStorage);
                 }
               else if (def.geometryType == "cylindrical")
                 {
@@ -628,7 +656,8 @@ void BDSOutput::CreateHistograms()
                                              def.nBinsZ, def.zLow/CLHEP::m, def.zHigh/CLHEP::m,
                                              def.nBinsPhi, 0, CLHEP::twopi,
                                              def.nBinsR, def.rLow/CLHEP::m, def.rHigh/CLHEP::m,
-                                             def.nBinsE, def.eLow/CLHEP::GeV, def.eHigh/CLHEP::GeV);
+                                             def.nBinsE, def.eLow/CLHEP::GeV, def.eHigh/CLHEP::GeV,
+                                             def.sparseStorage);
                 }
               
               histIndices4D[def.uniqueName] = histID;
@@ -1124,21 +1153,31 @@ void BDSOutput::FillApertureImpacts(const BDSHitsCollectionApertureImpacts* hits
     }
 }
 
-void BDSOutput::FillScorerHits(const std::map<G4String, G4THitsMap<G4double>*>& scorerHitsMap)
+void BDSOutput::FillScorerHits(const std::map<G4String, G4VHitsCollection*>& scorerHitsMap)
 {
   for (const auto& nameHitsMap : scorerHitsMap)
     {
+      if (const auto meshHits = dynamic_cast<const BDSHitsCollectionScorerMesh*>(nameHitsMap.second))
+        {
+          if (meshHits->GetSize() == 0)
+            {continue;}
+          FillScorerHitsIndividual(nameHitsMap.first, meshHits);
+          continue;
+        }
+      const auto hitMap = dynamic_cast<const G4THitsMap<G4double>*>(nameHitsMap.second);
+      if (!hitMap)
+        {continue;}
 #if G4VERSION < 1039
-      if (nameHitsMap.second->GetSize() == 0)
+      if (hitMap->GetSize() == 0)
 #else
-      if (nameHitsMap.second->size() == 0)
+      if (hitMap->size() == 0)
 #endif
 #ifdef BDSDEBUG
         {G4cout << nameHitsMap.first << " empty" << G4endl; continue;}
 #else
         {continue;}
 #endif
-      FillScorerHitsIndividual(nameHitsMap.first, nameHitsMap.second);
+      FillScorerHitsIndividual(nameHitsMap.first, hitMap);
     }
 }
 
@@ -1191,6 +1230,51 @@ void BDSOutput::FillScorerHitsIndividual(const G4String& histogramDefName,
     }
 }
 
+void BDSOutput::FillScorerHitsIndividual(const G4String& histogramDefName,
+                                         const BDSHitsCollectionScorerMesh* hits)
+{
+  const BDSScorerMeshStorage* storage = hits->Storage();
+
+  if (!(histIndices3D.find(histogramDefName) == histIndices3D.end()))
+    {
+      G4int histIndex = histIndices3D[histogramDefName];
+      G4double unit   = BDS::MapGetWithDefault(histIndexToUnits3D, histIndex, 1.0);
+      if (hits->RootBinIndexing())
+        {// storage index is already the root global bin
+          for (G4int bin : storage->TouchedBins())
+            {evtHistos->Set3DHistogramBinContent(histIndex, bin, storage->Value(bin) / unit);}
+        }
+      else
+        {
+          const BDSHistBinMapper& mapper = scorerCoordinateMaps.at(histogramDefName);
+          TH3D* hist = evtHistos->Get3DHistogram(histIndex);
+          G4int x,y,z,e;
+          for (G4int bin : storage->TouchedBins())
+            {
+              mapper.IJKLFromGlobal(bin, x,y,z,e);
+              G4int rootGlobalIndex = (hist->GetBin(x + 1, y + 1, z + 1)); // convert to root system (add 1 to avoid underflow bin)
+              evtHistos->Set3DHistogramBinContent(histIndex, rootGlobalIndex, storage->Value(bin) / unit);
+            }
+        }
+      runHistos->AccumulateHistogram3D(histIndex, evtHistos->Get3DHistogram(histIndex));
+    }
+
+  if (!(histIndices4D.find(histogramDefName) == histIndices4D.end()))
+    {
+      G4int histIndex = histIndices4D[histogramDefName];
+      G4double unit   = BDS::MapGetWithDefault(histIndexToUnits4D, histIndex, 1.0);
+      const BDSHistBinMapper& mapper = scorerCoordinateMaps.at(histogramDefName);
+      G4int x,y,z,e;
+      for (G4int bin : storage->TouchedBins())
+        {
+          // boost histogram storage isn't exposed so go via the i,j,k,e index
+          mapper.IJKLFromGlobal(bin, x,y,z,e);
+          evtHistos->Set4DHistogramBinContent(histIndex, x, y, z, e - 1, storage->Value(bin) / unit); // - 1 to go back to the Boost Histogram indexing (-1 for the underflow bin)
+        }
+      runHistos->AccumulateHistogram4D(histIndex, evtHistos->Get4DHistogram(histIndex));
+    }
+}
+
 void BDSOutput::FillScorerHitsIndividualBLM(const G4String& histogramDefName,
                                             const G4THitsMap<G4double>* hitMap)
 {
@@ -0,0 +1,65 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "BDSDebug.hh"
+#include "BDSException.hh"
+#include "BDSOutputCompressionType.hh"
+#include "BDSUtilities.hh"
+
+#include "globals.hh"
+#include "G4String.hh"
+
+#include <map>
+#include <string>
+
+template<>
+std::map<BDSOutputCompressionType,std::string>* BDSOutputCompressionType::dictionary=
+  new std::map<BDSOutputCompressionType,std::string> ({
+      {BDSOutputCompressionType::rootdefault,"default"},
+      {BDSOutputCompressionType::zlib,       "zlib"},
+      {BDSOutputCompressionType::lzma,       "lzma"},
+      {BDSOutputCompressionType::lz4,        "lz4"},
+      {BDSOutputCompressionType::zstd,       "zstd"}
+    });
+
+BDSOutputCompressionType BDS::DetermineOutputCompressionType(G4String compressionType)
+{
+  std::map<G4String, BDSOutputCompressionType> types;
+  types["default"] = BDSOutputCompressionType::rootdefault;
+  types["zlib"]    = BDSOutputCompressionType::zlib;
+  types["lzma"]    = BDSOutputCompressionType::lzma;
+  types["lz4"]     = BDSOutputCompressionType::lz4;
+  types["zstd"]    = BDSOutputCompressionType::zstd;
+
+  compressionType = BDS::LowerCase(compressionType);
+
+  auto result = types.find(compressionType);
+  if (result == types.end())
+    {// it's not a valid key
+      G4String msg = "\"" + compressionType + "\" is not a valid output compression algorithm\n";
+      msg += "Available algorithms are:\n";
+      for (const auto& it : types)
+	{msg += "\"" + it.first + "\"\n";}
+      throw BDSException(__METHOD_NAME__, msg);
+    }
+  
+#ifdef BDSDEBUG
+  G4cout << __METHOD_NAME__ << "determined compression \"" << compressionType << "\" to be " << result->first << G4endl;
+#endif
+  return result->second;
+}
@@ -36,6 +36,7 @@ BDSOutputLoaderSampler::BDSOutputLoaderSampler(const G4String& filePath,
   BDSOutputLoader(filePath),
   doublePrecision(false),
   nEvents(0),
+  samplerBranchName(""),
   localSamplerFloat(nullptr),
   localSamplerDouble(nullptr)
 {
@@ -47,6 +48,12 @@ BDSOutputLoaderSampler::BDSOutputLoaderSampler(const G4String& filePath,
   if (!search)
     {throw BDSException(__METHOD_NAME__, "no such sampler name \"" + samplerName + "\"");}
   
+  samplerBranchName = samplerNameLocal;
+
+  // only read the one sampler branch - the rest of the event is not used here
+  eventTree->SetBranchStatus("*", 0);
+  eventTree->SetBranchStatus((samplerNameLocal + "*").c_str(), 1);
+  
   localSamplerDouble = new BDSOutputROOTEventSampler<double>();
   localSamplerFloat = new BDSOutputROOTEventSampler<float>();
   doublePrecision = localOptions->outputDoublePrecision;
@@ -77,6 +84,15 @@ const BDSOutputROOTEventSampler<double>* BDSOutputLoaderSampler::SamplerDataDoub
   return localSamplerDouble;
 }
 
+void BDSOutputLoaderSampler::SetCacheEntryRange(G4long firstEvent, G4long lastEvent)
+{
+  file->cd();
+  eventTree->SetCacheSize(100*1024*1024); // 100MB
+  eventTree->AddBranchToCache((samplerBranchName + "*").c_str(), true);
+  eventTree->SetCacheEntryRange((Long64_t)firstEvent, (Long64_t)lastEvent);
+  eventTree->StopCacheLearningPhase();
+}
+
 void BDSOutputLoaderSampler::Common(G4long eventNumber)
 {
   if (eventNumber > nEvents)
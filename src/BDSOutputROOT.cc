@@ -19,6 +19,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "BDSDebug.hh"
 #include "BDSException.hh"
 #include "BDSGlobalConstants.hh"
+#include "BDSOutputCompressionType.hh"
 #include "BDSOutputROOT.hh"
 #include "BDSOutputROOTEventAperture.hh"
 #include "BDSOutputROOTEventBeam.hh"
@@ -40,15 +41,90 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "parser/options.h"
 
+#include "Compression.h"
+#include "RConfigure.h"
+#include "RVersion.h"
+#include "TBranch.h"
 #include "TFile.h"
 #include "TObject.h"
+#include "TROOT.h"
 #include "TTree.h"
 
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace
+{
+  /// Make the second copy of an event level structure for double buffering. The
+  /// structures are empty (flushed) at this point so a copy has the same settings.
+  template <class T>
+  T* NewEventBuffer(const T* object) {return new T(*object);}
+
+  /// The trajectory owns a navigator that must not be shared, so make a new one.
+  BDSOutputROOTEventTrajectory* NewEventBuffer(const BDSOutputROOTEventTrajectory*)
+  {return new BDSOutputROOTEventTrajectory();}
+
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,20,0)
+  /// ROOT's numbering of the compression algorithms (ROOT::RCompressionSetting::EAlgorithm).
+  Int_t ROOTCompressionAlgorithm(BDSOutputCompressionType type)
+  {
+    switch (type.underlying())
+      {
+      case BDSOutputCompressionType::zlib:
+	{return ROOT::RCompressionSetting::EAlgorithm::kZLIB;}
+      case BDSOutputCompressionType::lzma:
+	{return ROOT::RCompressionSetting::EAlgorithm::kLZMA;}
+      case BDSOutputCompressionType::lz4:
+	{return ROOT::RCompressionSetting::EAlgorithm::kLZ4;}
+      case BDSOutputCompressionType::zstd:
+	{return ROOT::RCompressionSetting::EAlgorithm::kZSTD;}
+      default:
+	{return ROOT::RCompressionSetting::EAlgorithm::kUseGlobal;}
+      }
+  }
+#else
+  /// ROOT's numbering of the compression algorithms. Before ROOT 6.20 there is no
+  /// RCompressionSetting and the enum names vary between versions, but the values
+  /// stored in the file are the same. ZSTD is not available.
+  Int_t ROOTCompressionAlgorithm(BDSOutputCompressionType type)
+  {
+    switch (type.underlying())
+      {
+      case BDSOutputCompressionType::zlib:
+	{return 1;}
+      case BDSOutputCompressionType::lzma:
+	{return 2;}
+      case BDSOutputCompressionType::lz4:
+	{return 4;}
+      case BDSOutputCompressionType::zstd:
+	{throw BDSException(__METHOD_NAME__, "\"zstd\" compression requires ROOT 6.20 or later.");}
+      default:
+	{return 0;}
+      }
+  }
+#endif
+
+  void CheckCompressionLevel(G4int level)
+  {
+    if (level > 9 || level < -1)
+      {throw BDSException(__METHOD_NAME__, "invalid ROOT compression level (" + std::to_string(level) + ") must be 0 - 9.");}
+  }
+}
+
 BDSOutputROOT::BDSOutputROOT(const G4String& fileName,
 			     G4int           fileNumberOffset,
 			     G4int           compressionLevelIn):
   BDSOutput(fileName, ".root", fileNumberOffset),
   compressionLevel(compressionLevelIn),
+  compressionAlgorithm(BDSOutputCompressionType::rootdefault),
+  eventCompressionAlgorithm(BDSOutputCompressionType::rootdefault),
+  eventCompressionAlgorithmSet(false),
+  eventCompressionLevel(-1),
+  basketSize(0),
+  autoFlush(0),
+  asynchronous(false),
+  compressionThreads(0),
   theRootOutputFile(nullptr),
   theHeaderOutputTree(nullptr),
   theParticleDataTree(nullptr),
@@ -56,8 +132,36 @@ BDSOutputROOT::BDSOutputROOT(const G4String& fileName,
   theOptionsOutputTree(nullptr),
   theModelOutputTree(nullptr),
   theEventOutputTree(nullptr),
-  theRunOutputTree(nullptr)
-{;}
+  theRunOutputTree(nullptr),
+  eventPending(false),
+  stopWriting(false),
+  timeBlockedOnOutput(0)
+{
+  BDSGlobalConstants* globals = BDSGlobalConstants::Instance();
+  compressionAlgorithm = BDS::DetermineOutputCompressionType(globals->OutputCompressionAlgorithm());
+  G4String eventAlgorithm = globals->OutputEventCompressionAlgorithm();
+  eventCompressionAlgorithmSet = !eventAlgorithm.empty();
+  if (eventCompressionAlgorithmSet)
+    {eventCompressionAlgorithm = BDS::DetermineOutputCompressionType(eventAlgorithm);}
+  eventCompressionLevel = globals->OutputEventCompressionLevel();
+  CheckCompressionLevel(compressionLevel);
+  CheckCompressionLevel(eventCompressionLevel);
+  basketSize = globals->OutputBasketSize();
+  autoFlush  = globals->OutputAutoFlush();
+  asynchronous       = globals->OutputAsynchronous();
+  compressionThreads = globals->OutputCompressionThreads();
+  if (asynchronous)
+    {ROOT::EnableThreadSafety();}
+  if (compressionThreads > 0)
+    {
+#ifdef R__USE_IMT
+      if (!ROOT::IsImplicitMTEnabled())
+        {ROOT::EnableImplicitMT((UInt_t)compressionThreads);}
+#else
+      G4cout << __METHOD_NAME__ << "ROOT was built without implicit multithreading - outputCompressionThreads ignored" << G4endl;
+#endif
+    }
+}
 
 BDSOutputROOT::~BDSOutputROOT()
 {
@@ -72,11 +176,12 @@ void BDSOutputROOT::NewFile()
   theRootOutputFile = new TFile(newFileName,"RECREATE", "BDS output file");
   if (theRootOutputFile->IsZombie())
     {throw BDSException(__METHOD_NAME__, "Unable to open output file: \"" + newFileName +"\"");}
- 
-  if (compressionLevel > 9 || compressionLevel < -1)
-    {throw BDSException(__METHOD_NAME__, "invalid ROOT compression level (" + std::to_string(compressionLevel) + ") must be 0 - 9.");}
+
+  if (compressionAlgorithm != BDSOutputCompressionType::rootdefault)
+    {theRootOutputFile->SetCompressionAlgorithm(ROOTCompressionAlgorithm(compressionAlgorithm));}
   if (compressionLevel > -1)
     {theRootOutputFile->SetCompressionLevel(compressionLevel);}
+  timeBlockedOnOutput = 0;
   
   // root file - note this sets the current 'directory' to this file!
   theRootOutputFile->cd();
@@ -88,6 +193,12 @@ void BDSOutputROOT::NewFile()
   theModelOutputTree   = new TTree("Model","BDSIM model");              // model data tree
   theRunOutputTree     = new TTree("Run","BDSIM run histograms/information"); // run info tree
   theEventOutputTree   = new TTree("Event","BDSIM event");              // event data tree
+  if (autoFlush != 0)
+    {theEventOutputTree->SetAutoFlush(autoFlush);}
+  // a file recovered after a crash should end exactly at the last checkpoint,
+  // so no automatic saves of the tree in between
+  if (globals->CheckpointEveryNEvents() > 0)
+    {theEventOutputTree->SetAutoSave(0);}
 
   // Build branches for each object
   theHeaderOutputTree->Branch("Header.",       "BDSOutputROOTEventHeader",    headerOutput,     32000, 1);
@@ -100,65 +211,59 @@ void BDSOutputROOT::NewFile()
 
   // Branches for event...
   // Event info output
-  theEventOutputTree->Branch("Summary.",   "BDSOutputROOTEventInfo",evtInfo,32000,1);
+  EventBranch("Summary.", "BDSOutputROOTEventInfo", evtInfo, 32000, 1);
 
   // Build primary structures
   if (storePrimaries)
     {
-      theEventOutputTree->Branch("Primary.",       "BDSOutputROOTEventSampler",primary,       32000, 1);
-      theEventOutputTree->Branch("PrimaryGlobal.", "BDSOutputROOTEventCoords", primaryGlobal, 3200,  1);
+      EventBranch("Primary.",       "BDSOutputROOTEventSampler", primary,       32000, 1);
+      EventBranch("PrimaryGlobal.", "BDSOutputROOTEventCoords",  primaryGlobal, 3200,  1);
     }
 
   // Build loss and hit structures
   if (storeELoss)
-    {theEventOutputTree->Branch("Eloss.",          "BDSOutputROOTEventLoss",   eLoss,          4000, 1);}
+    {EventBranch("Eloss.",          "BDSOutputROOTEventLoss",   eLoss,          4000, 1);}
   if (storeELossVacuum)
-    {theEventOutputTree->Branch("ElossVacuum.",    "BDSOutputROOTEventLoss",   eLossVacuum,    4000, 1);}
+    {EventBranch("ElossVacuum.",    "BDSOutputROOTEventLoss",   eLossVacuum,    4000, 1);}
   if (storeELossTunnel)
-    {theEventOutputTree->Branch("ElossTunnel.",    "BDSOutputROOTEventLoss",   eLossTunnel,    4000, 1);}
+    {EventBranch("ElossTunnel.",    "BDSOutputROOTEventLoss",   eLossTunnel,    4000, 1);}
   if (storeELossWorld)
     {
-      theEventOutputTree->Branch("ElossWorld.",     "BDSOutputROOTEventLossWorld", eLossWorld,     4000, 1);
-      theEventOutputTree->Branch("ElossWorldExit.", "BDSOutputROOTEventLossWorld", eLossWorldExit, 4000, 1);
+      EventBranch("ElossWorld.",     "BDSOutputROOTEventLossWorld", eLossWorld,     4000, 1);
+      EventBranch("ElossWorldExit.", "BDSOutputROOTEventLossWorld", eLossWorldExit, 4000, 1);
     }
   if (storeELossWorldContents)
-    {theEventOutputTree->Branch("ElossWorldContents.", "BDSOutputROOTEventLossWorld", eLossWorldContents, 4000, 1);}
-  theEventOutputTree->Branch("PrimaryFirstHit.","BDSOutputROOTEventLoss",      pFirstHit,      4000, 2);
-  theEventOutputTree->Branch("PrimaryLastHit.", "BDSOutputROOTEventLoss",      pLastHit,       4000, 2);
+    {EventBranch("ElossWorldContents.", "BDSOutputROOTEventLossWorld", eLossWorldContents, 4000, 1);}
+  EventBranch("PrimaryFirstHit.","BDSOutputROOTEventLoss",      pFirstHit,      4000, 2);
+  EventBranch("PrimaryLastHit.", "BDSOutputROOTEventLoss",      pLastHit,       4000, 2);
   if (storeApertureImpacts)
-    {theEventOutputTree->Branch("ApertureImpacts.", "BDSOutputROOTEventAperture", apertureImpacts, 4000, 1);}
+    {EventBranch("ApertureImpacts.", "BDSOutputROOTEventAperture", apertureImpacts, 4000, 1);}
 
   // Build trajectory structures
   if (storeTrajectory)
-    {theEventOutputTree->Branch("Trajectory.", "BDSOutputROOTEventTrajectory", traj, 4000,  2);}
+    {EventBranch("Trajectory.", "BDSOutputROOTEventTrajectory", traj, 4000,  2);}
 
   // Build event histograms
-  theEventOutputTree->Branch("Histos.",     "BDSOutputROOTEventHistograms", evtHistos, 32000, 1);
+  EventBranch("Histos.",     "BDSOutputROOTEventHistograms", evtHistos, 32000, 1);
 
   // build sampler structures
   for (G4int i = 0; i < (G4int)samplerTrees.size(); ++i)
     {
-      auto samplerTreeLocal = samplerTrees.at(i);
-      auto samplerName      = samplerNames.at(i);
-      theEventOutputTree->Branch((samplerName+".").c_str(),
-                                 "BDSOutputROOTEventSampler",
-                                 samplerTreeLocal, 32000, globals->SamplersSplitLevel());
+      EventBranch(samplerNames.at(i) + ".",
+                  "BDSOutputROOTEventSampler",
+                  samplerTrees, i, 32000, globals->SamplersSplitLevel());
     }
   for (G4int i = 0; i < (G4int)samplerCTrees.size(); ++i)
     {
-      auto samplerTreeLocal = samplerCTrees.at(i);
-      auto samplerName      = samplerCNames.at(i);
-      theEventOutputTree->Branch((samplerName+".").c_str(),
-				 "BDSOutputROOTEventSamplerC",
-				 samplerTreeLocal, 32000, globals->SamplersSplitLevel());
+      EventBranch(samplerCNames.at(i) + ".",
+		  "BDSOutputROOTEventSamplerC",
+		  samplerCTrees, i, 32000, globals->SamplersSplitLevel());
     }
   for (G4int i = 0; i < (G4int)samplerSTrees.size(); ++i)
     {
-      auto samplerTreeLocal = samplerSTrees.at(i);
-      auto samplerName      = samplerSNames.at(i);
-      theEventOutputTree->Branch((samplerName+".").c_str(),
-				 "BDSOutputROOTEventSamplerS",
-				 samplerTreeLocal, 32000, globals->SamplersSplitLevel());
+      EventBranch(samplerSNames.at(i) + ".",
+		  "BDSOutputROOTEventSamplerS",
+		  samplerSTrees, i, 32000, globals->SamplersSplitLevel());
     }
   
   // build collimator structures
@@ -166,58 +271,200 @@ void BDSOutputROOT::NewFile()
     {
       for (G4int i = 0; i < (G4int) collimators.size(); ++i)
         {
-          auto collimatorLocal = collimators.at(i);
-          auto collimatorName  = collimatorNames.at(i);
-          // set the tree branches
-          theEventOutputTree->Branch((collimatorName + ".").c_str(),
-                                     "BDSOutputROOTEventCollimator",
-                                     collimatorLocal, 32000, globals->SamplersSplitLevel());
+          EventBranch(std::string(collimatorNames.at(i)) + ".",
+                      "BDSOutputROOTEventCollimator",
+                      collimators, i, 32000, globals->SamplersSplitLevel());
         }
     }
 
+  if (asynchronous)
+    {StartWriter();}
+
   FillHeader(); // this fills and then calls WriteHeader() pure virtual implemented here
 }
 
+template <class T>
+void BDSOutputROOT::EventBranch(const std::string& name,
+                                const char*        className,
+                                T*&                object,
+                                G4int              bufferSize,
+                                G4int              splitLevel)
+{
+  if (!asynchronous)
+    {
+      ConfigureEventBranch(theEventOutputTree->Branch(name.c_str(), className, object, EventBasketSize(bufferSize), splitLevel));
+      return;
+    }
+  eventBuffers.push_back(EventBuffer());
+  EventBuffer* buffer = &eventBuffers.back();
+  buffer->writeObject = NewEventBuffer(object);
+  buffer->swap = [&object, buffer]()
+                 {
+                   T* toWrite = object;
+                   object = static_cast<T*>(buffer->writeObject);
+                   buffer->writeObject = toWrite;
+                 };
+  buffer->deleteWriteObject = [buffer](){delete static_cast<T*>(buffer->writeObject);};
+  // bind to the address of the pointer so the branch follows it when it's swapped
+  ConfigureEventBranch(theEventOutputTree->Bronch(name.c_str(), className, &(buffer->writeObject), EventBasketSize(bufferSize), splitLevel));
+}
+
+template <class T>
+void BDSOutputROOT::EventBranch(const std::string& name,
+                                const char*        className,
+                                std::vector<T*>&   objects,
+                                G4int              index,
+                                G4int              bufferSize,
+                                G4int              splitLevel)
+{
+  if (!asynchronous)
+    {
+      ConfigureEventBranch(theEventOutputTree->Branch(name.c_str(), className, objects.at(index), EventBasketSize(bufferSize), splitLevel));
+      return;
+    }
+  eventBuffers.push_back(EventBuffer());
+  EventBuffer* buffer = &eventBuffers.back();
+  buffer->writeObject = NewEventBuffer(objects.at(index));
+  // the vector may be reallocated (link samplers) so look up the element each time
+  buffer->swap = [&objects, index, buffer]()
+                 {
+                   T* toWrite = objects[index];
+                   objects[index] = static_cast<T*>(buffer->writeObject);
+                   buffer->writeObject = toWrite;
+                 };
+  buffer->deleteWriteObject = [buffer](){delete static_cast<T*>(buffer->writeObject);};
+  ConfigureEventBranch(theEventOutputTree->Bronch(name.c_str(), className, &(buffer->writeObject), EventBasketSize(bufferSize), splitLevel));
+}
+
+void BDSOutputROOT::ConfigureEventBranch(TBranch* branch) const
+{
+  if (!branch)
+    {return;}
+  // these apply to all sub-branches too
+  if (eventCompressionAlgorithmSet)
+    {branch->SetCompressionAlgorithm(ROOTCompressionAlgorithm(eventCompressionAlgorithm));}
+  if (eventCompressionLevel > -1)
+    {branch->SetCompressionLevel(eventCompressionLevel);}
+}
+
+void BDSOutputROOT::StartWriter()
+{
+  if (writerThread.joinable())
+    {return;}
+  eventPending = false;
+  stopWriting  = false;
+  writerThread = std::thread(&BDSOutputROOT::WriterLoop, this);
+}
+
+void BDSOutputROOT::StopWriter()
+{
+  if (writerThread.joinable())
+    {
+      WaitForWriter();
+      {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        stopWriting = true;
+      }
+      writerCondition.notify_all();
+      writerThread.join();
+    }
+  for (auto& buffer : eventBuffers)
+    {buffer.deleteWriteObject();}
+  eventBuffers.clear();
+}
+
+void BDSOutputROOT::WaitForWriter()
+{
+  if (!writerThread.joinable())
+    {return;}
+  std::unique_lock<std::mutex> lock(writerMutex);
+  writerCondition.wait(lock, [this]{return !eventPending;});
+}
+
+void BDSOutputROOT::WriterLoop()
+{
+  std::unique_lock<std::mutex> lock(writerMutex);
+  while (true)
+    {
+      writerCondition.wait(lock, [this]{return eventPending || stopWriting;});
+      if (eventPending)
+	{
+	  lock.unlock();
+	  theEventOutputTree->Fill();
+	  lock.lock();
+	  eventPending = false;
+	  writerCondition.notify_all();
+	}
+      else if (stopWriting)
+	{break;}
+    }
+}
+
 void BDSOutputROOT::WriteHeader()
 {
+  WaitForWriter();
   theHeaderOutputTree->Fill();
 }
 
 void BDSOutputROOT::WriteHeaderEndOfFile()
 {
+  WaitForWriter();
   // there's no way to overwrite an entry in a ttree so we just add another entry with updated information
   theHeaderOutputTree->Fill();
 }
 
 void BDSOutputROOT::WriteParticleData()
 {
+  WaitForWriter();
   theParticleDataTree->Fill();
 }
 
 void BDSOutputROOT::WriteBeam()
 {
+  WaitForWriter();
   theBeamOutputTree->Fill();
 }
 
 void BDSOutputROOT::WriteOptions()
 {
+  WaitForWriter();
   theOptionsOutputTree->Fill();
 }
 
 void BDSOutputROOT::WriteModel()
 {
+  WaitForWriter();
   theModelOutputTree->Fill();
 }
 
 void BDSOutputROOT::WriteFileEventLevel()
 {
-  if (theRootOutputFile)
-    {theRootOutputFile->cd();}
-  theEventOutputTree->Fill();
+  auto start = std::chrono::steady_clock::now();
+  if (writerThread.joinable())
+    {
+      // the writer must have finished with the other set of structures before we swap
+      WaitForWriter();
+      for (auto& buffer : eventBuffers)
+	{buffer.swap();}
+      {
+	std::lock_guard<std::mutex> lock(writerMutex);
+	eventPending = true;
+      }
+      writerCondition.notify_all();
+    }
+  else
+    {
+      if (theRootOutputFile)
+	{theRootOutputFile->cd();}
+      theEventOutputTree->Fill();
+    }
+  std::chrono::duration<double> blocked = std::chrono::steady_clock::now() - start;
+  timeBlockedOnOutput += blocked.count();
 }
 
 void BDSOutputROOT::WriteFileRunLevel()
 {
+  WaitForWriter();
   if (theRootOutputFile)
     {theRootOutputFile->cd();}
   theRunOutputTree->Fill();
@@ -229,6 +476,19 @@ void BDSOutputROOT::WriteFileRunLevel()
     }
 }
 
+void BDSOutputROOT::WriteFileCheckpoint()
+{
+  WaitForWriter();
+  if (!theRootOutputFile)
+    {return;}
+  if (theRootOutputFile->IsOpen())
+    {
+      theRootOutputFile->cd();
+      theRootOutputFile->Write(nullptr, TObject::kOverwrite);
+      theRootOutputFile->Flush();
+    }
+}
+
 void BDSOutputROOT::CloseFile()
 {
   Close();
@@ -236,10 +496,13 @@ void BDSOutputROOT::CloseFile()
 
 void BDSOutputROOT::Close()
 {
+  StopWriter();
   if (theRootOutputFile)
     {
       if (theRootOutputFile->IsOpen())
 	{
+	  G4cout << __METHOD_NAME__ << "Time spent " << (asynchronous ? "waiting for" : "writing")
+		 << " event output: " << timeBlockedOnOutput << " s" << G4endl;
 	  theRootOutputFile->cd();
 	  theRootOutputFile->Write(0,TObject::kOverwrite);
 	  G4cout << __METHOD_NAME__ << "Data written to file: " << theRootOutputFile->GetName() << G4endl;
@@ -252,15 +515,14 @@ void BDSOutputROOT::Close()
 
 void BDSOutputROOT::UpdateSamplers()
 {
+  WaitForWriter();
   G4int nNewSamplers = BDSOutputStructures::UpdateSamplerStructures();
   G4int nSamplers = (G4int)samplerTrees.size();
   for (G4int i = nSamplers - nNewSamplers; i < nSamplers; ++i)
     {
-      auto samplerTreeLocal = samplerTrees.at(i);
-      auto samplerName      = samplerNames.at(i);
       // set tree branches
-      theEventOutputTree->Branch((samplerName+".").c_str(),
-				 "BDSOutputROOTEventSampler",
-				 samplerTreeLocal,32000,0);
+      EventBranch(samplerNames.at(i) + ".",
+		  "BDSOutputROOTEventSampler",
+		  samplerTrees, i, 32000, 0);
     }
 }
@@ -60,6 +60,7 @@ void BDSOutputROOTEventHeader::FlushLocal()
   nEventsInFileSkipped = 0;
   nEventsInFile = 0;
   distrFileLoopNTimes = 0;
+  nEventsResumed = 0;
   
 #ifndef __ROOTDOUBLE__
   doublePrecisionOutput = false;
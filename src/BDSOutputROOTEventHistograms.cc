@@ -162,13 +162,40 @@ G4int BDSOutputROOTEventHistograms::Create4DHistogram(const G4String& name,
                                                       unsigned int nxbins, G4double xmin, G4double xmax,
                                                       unsigned int nybins, G4double ymin, G4double ymax,
                                                       unsigned int nzbins, G4double zmin, G4double zmax,
-                                                      unsigned int nebins, G4double emin, G4double emax)
+                                                      unsigned int nebins, G4double emin, G4double emax,
+                                                      G4bool sparse)
 {
   std::string nameC   = (std::string)name;
   std::string titleC  = (std::string)title;
   std::string eScaleC = (std::string)eScale;
   
-  if(eScale == "linear")
+  if (sparse)
+    {// only non-zero bins are stored
+      if(eScale == "linear")
+        {
+          histograms4D.push_back(new BDSBH4D<boost_histogram_linear_sparse>(nameC, titleC, eScaleC,
+                                                                            nxbins, xmin, xmax,
+                                                                            nybins, ymin, ymax,
+                                                                            nzbins, zmin, zmax,
+                                                                            nebins, emin, emax));
+        }
+      else if(eScale == "log")
+        {
+          histograms4D.push_back(new BDSBH4D<boost_histogram_log_sparse>(nameC, titleC, eScaleC,
+                                                                         nxbins, xmin, xmax,
+                                                                         nybins, ymin, ymax,
+                                                                         nzbins, zmin, zmax,
+                                                                         nebins, emin, emax));
+        }
+      else if(eScale == "user")
+        {
+          histograms4D.push_back(new BDSBH4D<boost_histogram_variable_sparse>(nameC, titleC, eScaleC, eBinsEdges,
+                                                                              nxbins, xmin, xmax,
+                                                                              nybins, ymin, ymax,
+                                                                              nzbins, zmin, zmax));
+        }
+    }
+  else if(eScale == "linear")
     {
       histograms4D.push_back(new BDSBH4D<boost_histogram_linear>(nameC, titleC, eScaleC,
                                                                  nxbins, xmin, xmax,
@@ -200,7 +227,8 @@ G4int BDSOutputROOTEventHistograms::Create4DHistogram(const G4String&, const G4S
                                                       unsigned int, G4double, G4double,
                                                       unsigned int, G4double, G4double,
                                                       unsigned int, G4double, G4double,
-                                                      unsigned int, G4double, G4double)
+                                                      unsigned int, G4double, G4double,
+                                                      G4bool)
 {
   throw BDSException(__METHOD_NAME__, "BDSIM compiled without BOOST support -> no 4D histograms.");
 }
@@ -286,6 +314,34 @@ void BDSOutputROOTEventHistograms::AccumulateHistogram4D(G4int histoId,
   *histograms4D[histoId] += *otherHistogram;
 }
 
+G4bool BDSOutputROOTEventHistograms::AccumulateHistograms(const BDSOutputROOTEventHistograms* other)
+{
+  if (!other)
+    {return true;}
+  if (other->histograms1D.size() != histograms1D.size() ||
+      other->histograms2D.size() != histograms2D.size() ||
+      other->histograms3D.size() != histograms3D.size() ||
+      other->histograms4D.size() != histograms4D.size())
+    {return false;}
+  for (std::size_t i = 0; i < histograms1D.size(); i++)
+    {
+      if (histograms1D[i]->GetNbinsX() != other->histograms1D[i]->GetNbinsX())
+        {return false;}
+    }
+
+  for (std::size_t i = 0; i < histograms1D.size(); i++)
+    {histograms1D[i]->Add(other->histograms1D[i]);}
+  for (std::size_t i = 0; i < histograms2D.size(); i++)
+    {histograms2D[i]->Add(other->histograms2D[i]);}
+  for (std::size_t i = 0; i < histograms3D.size(); i++)
+    {histograms3D[i]->Add(other->histograms3D[i]);}
+#ifdef USE_BOOST
+  for (std::size_t i = 0; i < histograms4D.size(); i++)
+    {*histograms4D[i] += *other->histograms4D[i];}
+#endif
+  return true;
+}
+
 #endif
 
 void BDSOutputROOTEventHistograms::Flush()
@@ -189,19 +189,20 @@ G4int BDSOutputStructures::Create4DHistogram(const G4String& name,
 					     G4int nBinsX, G4double xMin, G4double xMax,
 					     G4int nBinsY, G4double yMin, G4double yMax,
 					     G4int nBinsZ, G4double zMin, G4double zMax,
-					     G4int nBinsE, G4double eMin, G4double eMax)
+					     G4int nBinsE, G4double eMin, G4double eMax,
+					     G4bool sparse)
 {
   G4int result = evtHistos->Create4DHistogram(name, title, eScale, eBinsEdges,
 					      nBinsX, xMin, xMax,
 					      nBinsY, yMin, yMax,
 					      nBinsZ, zMin, zMax,
-					      nBinsE, eMin, eMax);
+					      nBinsE, eMin, eMax, sparse);
   
   runHistos->Create4DHistogram(name, title, eScale, eBinsEdges,
 			       nBinsX, xMin, xMax,
 			       nBinsY, yMin, yMax,
 			       nBinsZ, zMin, zMax,
-			       nBinsE, eMin, eMax);
+			       nBinsE, eMin, eMax, sparse);
   return result;
 }
 
@@ -18,6 +18,8 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "BDSPSCellFlux4D.hh"
 #include "BDSHistBinMapper.hh"
+#include "BDSHitsCollectionScorerMesh.hh"
+#include "BDSScorerMeshStorage.hh"
 
 #ifdef USE_BOOST
 #include <boost/variant.hpp>
@@ -25,7 +27,11 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <iostream>
 
+#include "G4HCofThisEvent.hh"
+#include "G4ios.hh"
+#include "G4Step.hh"
 #include "G4String.hh"
+#include "G4TouchableHistory.hh"
 #include "G4Types.hh"
 
 BDSPSCellFlux4D::BDSPSCellFlux4D(const G4String&         name,
@@ -36,8 +42,13 @@ BDSPSCellFlux4D::BDSPSCellFlux4D(const G4String&         name,
   fDepthi(depi),
   fDepthj(depj),
   fDepthk(depk),
-  mapper(mapperIn)
-{;}
+  mapper(mapperIn),
+  HCID4D(-1),
+  storage(nullptr),
+  weighted(true)
+{
+  storage = new BDSScorerMeshStorage(BDSScorerMeshStorage::NBinsMapper(mapper), true);
+}
 
 BDSPSCellFlux4D::BDSPSCellFlux4D(const G4String&         name,
 				 const BDSHistBinMapper* mapperIn,
@@ -48,8 +59,68 @@ BDSPSCellFlux4D::BDSPSCellFlux4D(const G4String&         name,
   fDepthi(depi),
   fDepthj(depj),
   fDepthk(depk),
-  mapper(mapperIn)
-{;}
+  mapper(mapperIn),
+  HCID4D(-1),
+  storage(nullptr),
+  weighted(true)
+{
+  storage = new BDSScorerMeshStorage(BDSScorerMeshStorage::NBinsMapper(mapper), true);
+}
+
+BDSPSCellFlux4D::~BDSPSCellFlux4D()
+{
+  delete storage;
+}
+
+void BDSPSCellFlux4D::Initialize(G4HCofThisEvent* HCE)
+{
+  // the previous event's values have been written out by now
+  storage->Reset();
+  // the event deletes the collection but not the storage
+  auto hc = new BDSHitsCollectionScorerMesh(detector->GetName(), GetName(), storage, false);
+  if (HCID4D < 0)
+    {HCID4D = GetCollectionID(0);}
+  HCE->AddHitsCollection(HCID4D, hc);
+}
+
+void BDSPSCellFlux4D::clear()
+{
+  storage->Reset();
+}
+
+void BDSPSCellFlux4D::PrintAll()
+{
+  G4cout << " MultiFunctionalDet  " << detector->GetName() << G4endl
+         << " PrimitiveScorer " << GetName() << G4endl
+         << " Number of bins with entries " << storage->NTouched() << G4endl;
+}
+
+void BDSPSCellFlux4D::Weighted(G4bool flag)
+{
+  G4PSCellFlux3D::Weighted(flag);
+  weighted = flag;
+}
+
+G4bool BDSPSCellFlux4D::ProcessHits(G4Step* aStep, G4TouchableHistory*)
+{
+  // as per G4PSCellFlux::ProcessHits but accumulating into the mesh storage
+  G4double stepLength = aStep->GetStepLength();
+  if (stepLength == 0)
+    {return false;}
+
+  G4int idx = ((G4TouchableHistory*)(aStep->GetPreStepPoint()->GetTouchable()))->GetReplicaNumber(indexDepth);
+  G4double cubicVolume = ComputeVolume(aStep, idx);
+
+  G4double cellFlux = stepLength / cubicVolume;
+  if (weighted)
+    {cellFlux *= aStep->GetPreStepPoint()->GetWeight();}
+
+  G4int index = GetIndex(aStep);
+  if (index < 0 || index >= storage->NBins())
+    {return false;}
+  storage->Add(index, cellFlux);
+  return true;
+}
 
 G4int BDSPSCellFlux4D::GetIndex(G4Step* aStep)
 {
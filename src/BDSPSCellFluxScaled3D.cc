@@ -19,11 +19,13 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "BDSDebug.hh"
 #include "BDSException.hh"
 #include "BDSHistBinMapper.hh"
+#include "BDSHitsCollectionScorerMesh.hh"
 #include "BDSScorerConversionLoader.hh"
+#include "BDSScorerConversionTable.hh"
+#include "BDSScorerMeshStorage.hh"
 #include "BDSPSCellFluxScaled3D.hh"
 #include "BDSUtilities.hh"
 
-#include "G4PhysicsVector.hh"
 #include "G4String.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4Types.hh"
@@ -32,6 +34,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "G4VPVParameterisation.hh"
 #include "G4UnitsTable.hh"
 
+#include <cstddef>
 #include <fstream>
 #include <string>
 
@@ -50,7 +53,9 @@ BDSPSCellFluxScaled3D::BDSPSCellFluxScaled3D(const G4String&         scorerName,
                                              G4int depk):
   G4VPrimitiveScorer(scorerName),
   HCID3D(-1),
-  evtMap3D(nullptr),
+  storage(nullptr),
+  nBinsI(mapperIn ? (G4int)mapperIn->NBinsI() : ni),
+  nBinsJ(mapperIn ? (G4int)mapperIn->NBinsJ() : nj),
   fDepthi(depi),fDepthj(depj),fDepthk(depk),
   conversionFactor(nullptr),
   mapper(mapperIn)
@@ -60,6 +65,9 @@ BDSPSCellFluxScaled3D::BDSPSCellFluxScaled3D(const G4String&         scorerName,
   fNi = ni; // set base class members
   fNj = nj;
   fNk = nk;
+  G4int nBinsK = mapperIn ? (G4int)mapperIn->NBinsK() : nk;
+  std::size_t nBins = BDSScorerMeshStorage::NBinsRoot3D(nBinsI, nBinsJ, nBinsK);
+  storage = new BDSScorerMeshStorage(nBins, nBins > BDSScorerMeshStorage::maximumDenseBins);
 }
 
 BDSPSCellFluxScaled3D::BDSPSCellFluxScaled3D(const G4String&         scorerName,
@@ -82,7 +90,7 @@ BDSPSCellFluxScaled3D::BDSPSCellFluxScaled3D(const G4String&         scorerName,
     {
 #ifdef USE_GZSTREAM
       BDSScorerConversionLoader<igzstream> loader;
-      conversionFactor = loader.Load(filePath);
+      conversionFactor = loader.LoadTable(filePath);
 #else
       throw BDSException(__METHOD_NAME__, "Compressed file loading - but BDSIM not compiled with ZLIB.");
 #endif
@@ -90,13 +98,14 @@ BDSPSCellFluxScaled3D::BDSPSCellFluxScaled3D(const G4String&         scorerName,
   else
     {
       BDSScorerConversionLoader<std::ifstream> loader;
-      conversionFactor = loader.Load(filePath);
+      conversionFactor = loader.LoadTable(filePath);
     }
 }
 
 BDSPSCellFluxScaled3D::~BDSPSCellFluxScaled3D()
 {
   delete conversionFactor;
+  delete storage;
 }
 
 G4bool BDSPSCellFluxScaled3D::ProcessHits(G4Step* aStep, G4TouchableHistory*)
@@ -126,9 +135,15 @@ G4bool BDSPSCellFluxScaled3D::ProcessHits(G4Step* aStep, G4TouchableHistory*)
   G4double kineticEnergy = aStep->GetPreStepPoint()->GetKineticEnergy();
   G4double factor = GetConversionFactor(aStep->GetTrack()->GetDefinition()->GetPDGEncoding(), kineticEnergy);
   radiationQuantity = cellFlux * factor;
-  G4int index = GetIndex(aStep);
 
-  evtMap3D->add(index, radiationQuantity);
+  G4int i, j, k;
+  if (!ReplicaIndices(aStep, i, j, k))
+    {return false;}
+  G4int index = StorageIndex(i, j, k);
+  if (index >= storage->NBins())
+    {return false;}
+
+  storage->Add(index, radiationQuantity);
   return true;
 }
 
@@ -140,11 +155,13 @@ G4double BDSPSCellFluxScaled3D::GetConversionFactor(G4int  /*particleID*/,
 
 void BDSPSCellFluxScaled3D::Initialize(G4HCofThisEvent* HCE)
 {
-  evtMap3D = new G4THitsMap<G4double>(detector->GetName(),
-				      GetName());
+  // the previous event's values have been written out by now
+  storage->Reset();
+  // the event deletes the collection but not the storage
+  auto hc = new BDSHitsCollectionScorerMesh(detector->GetName(), GetName(), storage, true);
   if (HCID3D < 0)
     {HCID3D = GetCollectionID(0);}
-  HCE->AddHitsCollection(HCID3D, evtMap3D);
+  HCE->AddHitsCollection(HCID3D, hc);
 }
 
 void BDSPSCellFluxScaled3D::EndOfEvent(G4HCofThisEvent* /*HEC*/)
@@ -152,15 +169,29 @@ void BDSPSCellFluxScaled3D::EndOfEvent(G4HCofThisEvent* /*HEC*/)
 
 void BDSPSCellFluxScaled3D::clear()
 {
-  evtMap3D->clear();
+  storage->Reset();
 }
 
 G4int BDSPSCellFluxScaled3D::GetIndex(G4Step* aStep)
+{
+  G4int i, j, k;
+  ReplicaIndices(aStep, i, j, k);
+  G4int globalIndex = mapper->GlobalFromIJKLIndex(i,j,k); // x,y,z
+  //G4int oldResult = i*fNj*fNk+j*fNk+k;
+  return globalIndex;
+}
+
+G4int BDSPSCellFluxScaled3D::StorageIndex(G4int i, G4int j, G4int k) const
+{
+  return BDSScorerMeshStorage::RootGlobalBin3D(i, j, k, nBinsI, nBinsJ);
+}
+
+G4bool BDSPSCellFluxScaled3D::ReplicaIndices(G4Step* aStep, G4int& i, G4int& j, G4int& k) const
 {
   const G4VTouchable* touchable = aStep->GetPreStepPoint()->GetTouchable();
-  G4int i = touchable->GetReplicaNumber(fDepthi);
-  G4int j = touchable->GetReplicaNumber(fDepthj);
-  G4int k = touchable->GetReplicaNumber(fDepthk);
+  i = touchable->GetReplicaNumber(fDepthi);
+  j = touchable->GetReplicaNumber(fDepthj);
+  k = touchable->GetReplicaNumber(fDepthk);
   
   if (i<0 || j<0 || k<0)
     {
@@ -172,11 +203,9 @@ G4int BDSPSCellFluxScaled3D::GetIndex(G4Step* aStep)
 	 << touchable->GetVolume(fDepthj)->GetName() << ","
 	 << touchable->GetVolume(fDepthk)->GetName() << G4endl;
       G4Exception("BDSPSCellFluxScaled3D::GetIndex","DetPS0006",JustWarning,ED);
+      return false;
     }
-
-  G4int globalIndex = mapper->GlobalFromIJKLIndex(i,j,k); // x,y,z
-  //G4int oldResult = i*fNj*fNk+j*fNk+k;
-  return globalIndex;
+  return true;
 }
 
 void BDSPSCellFluxScaled3D::DefineUnitAndCategory() const
@@ -20,11 +20,11 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "BDSException.hh"
 #include "BDSHistBinMapper.hh"
 #include "BDSScorerConversionLoader.hh"
+#include "BDSScorerConversionTable.hh"
 #include "BDSPSCellFluxScaledPerParticle3D.hh"
 #include "BDSUtilities.hh"
 
 #include "globals.hh"
-#include "G4PhysicsVector.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4VSolid.hh"
 #include "G4VPhysicalVolume.hh"
@@ -33,6 +33,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include <fstream>
 #include <map>
 #include <string>
+#include <vector>
 
 #ifdef USE_GZSTREAM
 #include "src-external/gzstream/gzstream.h"
@@ -48,7 +49,8 @@ BDSPSCellFluxScaledPerParticle3D::BDSPSCellFluxScaledPerParticle3D(const G4Strin
                                                                    G4int depi,
                                                                    G4int depj,
                                                                    G4int depk):
-  BDSPSCellFluxScaled3D(scorerName, mapperIn, unitIn, ni, nj, nk, depi, depj, depk)
+  BDSPSCellFluxScaled3D(scorerName, mapperIn, unitIn, ni, nj, nk, depi, depj, depk),
+  pdgIDOffset(0)
 {
   G4String filePath = BDS::GetFullPath(pathname);
   if (filePath.back() != '/')
@@ -68,14 +70,14 @@ BDSPSCellFluxScaledPerParticle3D::BDSPSCellFluxScaledPerParticle3D(const G4Strin
       G4String compressedFile   = filePath + filePDG.first+".gz";
       if (BDS::FileExists(uncompressedFile))
 	{
-	  conversionFactors[filePDG.second] = loader.Load(uncompressedFile);
+	  conversionFactors[filePDG.second] = loader.LoadTable(uncompressedFile);
 	  G4cout << "Adding: " << uncompressedFile << G4endl;
 	}
       else if (BDS::FileExists(compressedFile))
 	{
 #ifdef USE_GZSTREAM
 	  BDSScorerConversionLoader<igzstream> loaderC;
-	  conversionFactors[filePDG.second] = loaderC.Load(compressedFile);
+	  conversionFactors[filePDG.second] = loaderC.LoadTable(compressedFile);
 	  G4cout << "Adding: " << compressedFile << G4endl;
 #else
 	  throw BDSException(__METHOD_NAME__, "Compressed file loading - but BDSIM not compiled with ZLIB.");
@@ -91,6 +93,13 @@ BDSPSCellFluxScaledPerParticle3D::BDSPSCellFluxScaledPerParticle3D(const G4Strin
       message += "Would result in a factor of 0 for all particles and all energies.";
       throw BDSException(__METHOD_NAME__, message);
     }
+
+  // map is ordered so first and last keys are the range of PDG IDs
+  pdgIDOffset = conversionFactors.begin()->first;
+  G4int range = conversionFactors.rbegin()->first - pdgIDOffset + 1;
+  conversionFactorsByPDGID.resize((std::size_t)range, nullptr);
+  for (const auto& pdgTable : conversionFactors)
+    {conversionFactorsByPDGID[(std::size_t)(pdgTable.first - pdgIDOffset)] = pdgTable.second;}
 }
 
 BDSPSCellFluxScaledPerParticle3D::~BDSPSCellFluxScaledPerParticle3D()
@@ -101,9 +110,9 @@ BDSPSCellFluxScaledPerParticle3D::~BDSPSCellFluxScaledPerParticle3D()
 
 G4double BDSPSCellFluxScaledPerParticle3D::GetConversionFactor(G4int particleID, G4double kineticEnergy) const
 {
-  auto search = conversionFactors.find(particleID);
-  if (search != conversionFactors.end())
-    {return search->second->Value(kineticEnergy);}
-  else
+  G4int index = particleID - pdgIDOffset;
+  if (index < 0 || index >= (G4int)conversionFactorsByPDGID.size())
     {return 0;}
+  const BDSScorerConversionTable* table = conversionFactorsByPDGID[(std::size_t)index];
+  return table ? table->Value(kineticEnergy) : 0;
 }
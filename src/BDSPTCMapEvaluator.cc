@@ -0,0 +1,160 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "BDSDebug.hh"
+#include "BDSException.hh"
+#include "BDSPTCMapEvaluator.hh"
+
+#include "G4Types.hh"
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <string>
+#include <vector>
+
+const std::size_t BDSPTCMapEvaluator::nCoordinates;
+const G4int       BDSPTCMapEvaluator::maxPower;
+const std::size_t BDSPTCMapEvaluator::blockSize;
+
+BDSPTCMapEvaluator::BDSPTCMapEvaluator(const std::array<std::vector<Term>, nCoordinates>& polynomials):
+  nTerms(0)
+{
+  highestPower.fill(0);
+  // std::map orders the monomials lexicographically by exponent so those that
+  // share the transverse powers are adjacent
+  std::map<std::array<G4int, nCoordinates>, std::array<G4double, nCoordinates> > monomials;
+  for (std::size_t output = 0; output < nCoordinates; output++)
+    {
+      for (const auto& term : polynomials[output])
+        {
+          std::array<G4int, nCoordinates> exponent = {term.nx, term.npx, term.ny, term.npy, term.ndeltaP};
+          for (std::size_t c = 0; c < nCoordinates; c++)
+            {
+              if (exponent[c] < 0 || exponent[c] > maxPower)
+                {throw BDSException(__METHOD_NAME__, "invalid power " + std::to_string(exponent[c]) + " in map - must be 0 to " + std::to_string(maxPower));}
+              highestPower[c] = std::max(highestPower[c], exponent[c]);
+            }
+          auto search = monomials.find(exponent);
+          if (search == monomials.end())
+            {
+              std::array<G4double, nCoordinates> coefficient;
+              coefficient.fill(0);
+              search = monomials.emplace(exponent, coefficient).first;
+            }
+          search->second[output] += term.coefficient;
+          nTerms++;
+        }
+    }
+
+  for (const auto& monomial : monomials)
+    {
+      const auto& exponent = monomial.first;
+      G4bool samePrefix = !exponents.empty() && std::equal(exponent.begin(), exponent.end() - 1, exponents.back().begin());
+      newPrefix.push_back(!samePrefix);
+      exponents.push_back(exponent);
+      coefficients.push_back(monomial.second);
+    }
+}
+
+void BDSPTCMapEvaluator::Evaluate(const G4double in[nCoordinates],
+                                  G4double       out[nCoordinates]) const
+{
+  G4double powers[nCoordinates][maxPower + 1];
+  for (std::size_t c = 0; c < nCoordinates; c++)
+    {
+      powers[c][0] = 1;
+      for (G4int k = 1; k <= highestPower[c]; k++)
+        {powers[c][k] = powers[c][k-1] * in[c];}
+      out[c] = 0;
+    }
+
+  G4double prefix = 1;
+  for (std::size_t m = 0; m < exponents.size(); m++)
+    {
+      const auto& e = exponents[m];
+      if (newPrefix[m])
+        {prefix = powers[0][e[0]] * powers[1][e[1]] * powers[2][e[2]] * powers[3][e[3]];}
+      G4double value = prefix * powers[4][e[4]];
+      const auto& coefficient = coefficients[m];
+      for (std::size_t c = 0; c < nCoordinates; c++)
+        {out[c] += coefficient[c] * value;}
+    }
+}
+
+void BDSPTCMapEvaluator::Evaluate(const G4double* in,
+                                  G4double*       out,
+                                  std::size_t     n) const
+{
+  // power tables per coordinate, each with a contiguous row of particles per power
+  std::array<std::size_t, nCoordinates> offset;
+  std::size_t rows = 0;
+  for (std::size_t c = 0; c < nCoordinates; c++)
+    {
+      offset[c] = rows * blockSize;
+      rows += (std::size_t)(highestPower[c] + 1);
+    }
+  std::vector<G4double> powers(rows * blockSize);
+  std::vector<G4double> prefix(blockSize);
+  std::vector<G4double> value(blockSize);
+
+  // in blocks of particles so the power tables stay in cache
+  for (std::size_t first = 0; first < n; first += blockSize)
+    {
+      std::size_t nb = std::min(blockSize, n - first);
+      for (std::size_t c = 0; c < nCoordinates; c++)
+        {
+          G4double* p = powers.data() + offset[c];
+          std::fill(p, p + nb, 1.0);
+          const G4double* coordinate = in + c * n + first;
+          for (G4int k = 1; k <= highestPower[c]; k++)
+            {
+              const G4double* previous = p + (std::size_t)(k-1) * blockSize;
+              G4double* current        = p + (std::size_t)k * blockSize;
+              for (std::size_t i = 0; i < nb; i++)
+                {current[i] = previous[i] * coordinate[i];}
+            }
+          std::fill(out + c * n + first, out + c * n + first + nb, 0.0);
+        }
+
+      for (std::size_t m = 0; m < exponents.size(); m++)
+        {
+          const auto& e = exponents[m];
+          if (newPrefix[m])
+            {
+              const G4double* p0 = powers.data() + offset[0] + (std::size_t)e[0] * blockSize;
+              const G4double* p1 = powers.data() + offset[1] + (std::size_t)e[1] * blockSize;
+              const G4double* p2 = powers.data() + offset[2] + (std::size_t)e[2] * blockSize;
+              const G4double* p3 = powers.data() + offset[3] + (std::size_t)e[3] * blockSize;
+              for (std::size_t i = 0; i < nb; i++)
+                {prefix[i] = p0[i] * p1[i] * p2[i] * p3[i];}
+            }
+          const G4double* p4 = powers.data() + offset[4] + (std::size_t)e[4] * blockSize;
+          for (std::size_t i = 0; i < nb; i++)
+            {value[i] = prefix[i] * p4[i];}
+          const auto& coefficient = coefficients[m];
+          for (std::size_t c = 0; c < nCoordinates; c++)
+            {
+              G4double  k = coefficient[c];
+              G4double* o = out + c * n + first;
+              for (std::size_t i = 0; i < nb; i++)
+                {o[i] += k * value[i];}
+            }
+        }
+    }
+}
@@ -29,6 +29,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "CLHEP/Units/SystemOfUnits.h"
 
+#include <array>
 #include <cmath>
 #include <fstream>
 #include <set>
@@ -44,16 +45,24 @@ BDSPTCOneTurnMap::BDSPTCOneTurnMap(const G4String& maptableFile,
   pxLastTurn(0),
   yLastTurn(0),
   pyLastTurn(0),
-  deltaPLastTurn(0)
+  deltaPLastTurn(0),
+  evaluator(LoadMapTable(BDS::GetFullPath(maptableFile)))
 {
   referenceMomentum = designParticle->Momentum();
   mass = designParticle->Mass();
+  G4cout << __METHOD_NAME__ << evaluator.NTerms() << " terms with "
+	 << evaluator.NMonomials() << " distinct monomials" << G4endl;
+#ifdef BDSDEBUG
+      G4cout << __METHOD_NAME__ << "> Loaded Map:" << maptableFile << G4endl;
+#endif
+}
 
-  G4String filePath = BDS::GetFullPath(maptableFile);
+std::array<std::vector<BDSPTCOneTurnMap::PTCMapTerm>, 5> BDSPTCOneTurnMap::LoadMapTable(const G4String& filePath)
+{
   G4cout << __METHOD_NAME__ << "Using map table " << filePath << G4endl;
   std::ifstream infile(filePath);
   if (!infile)
-    {throw BDSException(__METHOD_NAME__, "Failed to read maptable: \"" + maptableFile + "\"");}
+    {throw BDSException(__METHOD_NAME__, "Failed to read maptable: \"" + filePath + "\"");}
 
   // The columns of the maptable TFS (read into below with the stringstream).
   G4String name = "";
@@ -68,6 +77,8 @@ BDSPTCOneTurnMap::BDSPTCOneTurnMap(const G4String& maptableFile,
   G4int ndeltaP = 0;
   G4int nt = 0;
 
+  // x, px, y, py, deltaP in the order of N_VECTOR
+  std::array<std::vector<PTCMapTerm>, 5> terms;
   G4String line = "";
   while (std::getline(infile, line))
     {
@@ -80,28 +91,11 @@ BDSPTCOneTurnMap::BDSPTCOneTurnMap(const G4String& maptableFile,
 
       PTCMapTerm term{coefficient, nx, npx, ny, npy, ndeltaP};
 
-      switch (nVector)
-	{
-	case 1:
-	  {xTerms.push_back(term); break;}
-	case 2:
-	  {pxTerms.push_back(term); break;}
-	case 3:
-	  {yTerms.push_back(term);  break;}
-	case 4:
-	  {pyTerms.push_back(term); break;}
-	case 5:
-	  {deltaPTerms.push_back(term); break;}
-	default:
-	  {
-	    throw BDSException(__METHOD_NAME__, "Unrecognised PTC term index - maptable file is perhaps malformed.");
-	    break;
-	  }
-	}
+      if (nVector < 1 || nVector > 5)
+	{throw BDSException(__METHOD_NAME__, "Unrecognised PTC term index - maptable file is perhaps malformed.");}
+      terms[(std::size_t)(nVector - 1)].push_back(term);
     }
-#ifdef BDSDEBUG
-      G4cout << __METHOD_NAME__ << "> Loaded Map:" << maptableFile << G4endl;
-#endif
+  return terms;
 }
 
 void BDSPTCOneTurnMap::SetInitialPrimaryCoordinates(const BDSParticleCoordsFullGlobal& coords,
@@ -160,26 +154,14 @@ void BDSPTCOneTurnMap::GetThisTurn(G4double& x,
 #endif
 
       lastTurnNumber = turnsTaken;
-      xOut = Evaluate(xTerms,
-		      xLastTurn, pxLastTurn,
-		      yLastTurn, pyLastTurn,
-		      deltaPLastTurn);
-      pxOut = Evaluate(pxTerms,
-		       xLastTurn, pxLastTurn,
-		       yLastTurn, pyLastTurn,
-		       deltaPLastTurn);
-      yOut = Evaluate(yTerms,
-		      xLastTurn, pxLastTurn,
-		      yLastTurn, pyLastTurn,
-		      deltaPLastTurn);
-      pyOut = Evaluate(pyTerms,
-		       xLastTurn, pxLastTurn,
-		       yLastTurn, pyLastTurn,
-		       deltaPLastTurn);
-      deltaPOut = Evaluate(deltaPTerms,
-			   xLastTurn, pxLastTurn,
-			   yLastTurn, pyLastTurn,
-			   deltaPLastTurn);
+      const G4double in[5] = {xLastTurn, pxLastTurn, yLastTurn, pyLastTurn, deltaPLastTurn};
+      G4double out[5];
+      evaluator.Evaluate(in, out);
+      xOut      = out[0];
+      pxOut     = out[1];
+      yOut      = out[2];
+      pyOut     = out[3];
+      deltaPOut = out[4];
       // Cache results for next turn.  Do it here, before we convert to BDSIM coordinates.
       xLastTurn      = xOut;
       pxLastTurn     = pxOut;
@@ -244,26 +226,6 @@ void BDSPTCOneTurnMap::GetThisTurn(G4double& x,
 #endif
 }
 
-G4double BDSPTCOneTurnMap::Evaluate(std::vector<PTCMapTerm>& terms,
-				    G4double x,
-                                    G4double px,
-				    G4double y,
-				    G4double py,
-                                    G4double deltaP) const
-{
-  G4double result = 0;
-  for (const auto& term : terms)
-    {
-      result += (term.coefficient
-		 * std::pow(x, term.nx)
-		 * std::pow(px, term.npx)
-		 * std::pow(y, term.ny)
-		 * std::pow(py, term.npy)
-		 * std::pow(deltaP, term.ndeltaP));
-    }
-  return result;
-}
-
 G4bool BDSPTCOneTurnMap::ShouldApplyToPrimary(G4double momentum,
                                               G4int turnsTaken)
 {
@@ -24,6 +24,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "BDSImportanceFileLoader.hh"
 #include "BDSParallelWorldImportance.hh"
 #include "BDSUtilities.hh"
+#include "BDSWeightWindowFileLoader.hh"
 
 #include "globals.hh"
 #include "G4GeometryCell.hh"
@@ -32,23 +33,29 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "G4PVPlacement.hh"
 #include "G4VisAttributes.hh"
 #include "G4VPhysicalVolume.hh"
+#include "G4WeightWindowStore.hh"
+
+#include "CLHEP/Units/SystemOfUnits.h"
 
 #ifdef USE_GZSTREAM
 #include "src-external/gzstream/gzstream.h"
 #endif
 
 #include <iomanip>
+#include <limits>
 #include <map>
 #include <string>
 #include <fstream>
 
 BDSParallelWorldImportance::BDSParallelWorldImportance(G4String name,
                                                        G4String importanceWorldGeometryFile,
-                                                       G4String importanceValuesFile):
+                                                       G4String importanceValuesFile,
+                                                       G4String weightWindowFileIn):
   G4VUserParallelWorld("importanceWorld_" + name),
   imWorldPV(nullptr),
   imGeomFile(importanceWorldGeometryFile),
   imVolMap(importanceValuesFile),
+  weightWindowFile(weightWindowFileIn),
   componentName("importanceWorld")
 {
   userLimits = BDSGlobalConstants::Instance()->DefaultUserLimits();
@@ -61,6 +68,28 @@ BDSParallelWorldImportance::BDSParallelWorldImportance(G4String name,
 
 void BDSParallelWorldImportance::Construct()
 {
+  // load the cell weight windows instead of importance values if given
+  if (!weightWindowFile.empty())
+    {
+      G4String weightWindowFileFull = BDS::GetFullPath(weightWindowFile);
+      if (weightWindowFileFull.rfind("gz") != std::string::npos)
+        {
+#ifdef USE_GZSTREAM
+          BDSWeightWindowFileLoader<igzstream> loader;
+          imVolumesAndWindows = loader.Load(weightWindowFileFull);
+#else
+          throw BDSException(__METHOD_NAME__, "Compressed file loading - but BDSIM not compiled with ZLIB.");
+#endif
+        }
+      else
+        {
+          BDSWeightWindowFileLoader<std::ifstream> loader;
+          imVolumesAndWindows = loader.Load(weightWindowFileFull);
+        }
+      BuildWorld();
+      return;
+    }
+  
   // load the cell importance values
   G4String importanceMapFile = BDS::GetFullPath(imVolMap);
   if (importanceMapFile.rfind("gz") != std::string::npos)
@@ -181,7 +210,60 @@ void BDSParallelWorldImportance::AddIStore()
     }
 }
 
-G4double BDSParallelWorldImportance::GetCellImportanceValue(const G4String& cellName)
+void BDSParallelWorldImportance::AddWeightWindowStore()
+{
+  G4WeightWindowStore* wwStore = G4WeightWindowStore::GetInstance(imWorldPV->GetName());
+
+  // the world volume is a cell too - by default a window that leaves primaries of weight 1
+  // untouched, i.e. [1/upperLimitFactor, 1], unless given explicitly as "world"
+  G4GeometryCell gWorldVolumeCell(*imWorldPV, 0);
+  G4UpperEnergyToLowerWeightMap worldWindow;
+  auto worldSearch = imVolumesAndWindows.find("world");
+  if (worldSearch != imVolumesAndWindows.end())
+    {worldWindow.insert(worldSearch->second.begin(), worldSearch->second.end());}
+  else
+    {
+      G4double upperLimitFactor = BDSGlobalConstants::Instance()->WeightWindowUpperLimitFactor();
+      worldWindow[std::numeric_limits<G4double>::max()] = 1.0 / upperLimitFactor;
+    }
+  wwStore->AddUpperEboundLowerWeightPairs(gWorldVolumeCell, worldWindow);
+
+  for (const auto& cell : imVolumeStore)
+    {
+      G4String cellName = cell.GetPhysicalVolume().GetName();
+      const std::map<G4double, G4double>& window = GetCellWeightWindow(cellName);
+      if (wwStore->IsKnown(cell))
+        {
+          G4String message = "Geometry cell \"" + cellName + "\" already exists and has been previously\n";
+          message += "added to the weight window store.";
+          throw BDSException(__METHOD_NAME__, message);
+        }
+      G4UpperEnergyToLowerWeightMap cellWindow(window.begin(), window.end());
+      wwStore->AddUpperEboundLowerWeightPairs(cell, cellWindow);
+    }
+
+  // feedback - user controllable
+  if (verbosity > 0)
+    {
+      auto flagsCache(G4cout.flags());
+      G4cout << imVolumeStore;
+      for (const auto& cellAndWindow : imVolumesAndWindows)
+        {
+          G4cout << std::left << std::setw(25) << cellAndWindow.first;
+          for (const auto& ew : cellAndWindow.second)
+            {
+              if (ew.first < std::numeric_limits<G4double>::max())
+                {G4cout << " < " << ew.first / CLHEP::GeV << " GeV : " << ew.second << ",";}
+              else
+                {G4cout << " above : " << ew.second;}
+            }
+          G4cout << G4endl;
+        }
+      G4cout.flags(flagsCache);
+    }
+}
+
+G4String BDSParallelWorldImportance::PureCellName(const G4String& cellName) const
 {
   // strip off the prepended componentName that we introduce in the geometry factory
   // this is controlled by the member variable of this class above
@@ -206,6 +288,25 @@ G4double BDSParallelWorldImportance::GetCellImportanceValue(const G4String& cell
       std::size_t found = pureCellName.find("_pv_pv");
       pureCellName.erase(found+3, found+6);
     }
+  return pureCellName;
+}
+
+const std::map<G4double, G4double>& BDSParallelWorldImportance::GetCellWeightWindow(const G4String& cellName) const
+{
+  G4String pureCellName = PureCellName(cellName);
+  auto result = imVolumesAndWindows.find(pureCellName);
+  if (result == imVolumesAndWindows.end())
+    {
+      G4String message = "A weight window was not found for the cell \"" + pureCellName + "\" in \n";
+      message += "the importance world geometry.";
+      throw BDSException(__METHOD_NAME__, message);
+    }
+  return result->second;
+}
+
+G4double BDSParallelWorldImportance::GetCellImportanceValue(const G4String& cellName)
+{
+  G4String pureCellName = PureCellName(cellName);
 
   auto result = imVolumesAndValues.find(pureCellName);
   if (result != imVolumesAndValues.end())
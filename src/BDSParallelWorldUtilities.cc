@@ -40,9 +40,12 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "G4ImportanceBiasing.hh"
 #include "G4IStore.hh"
 #include "G4ParallelWorldPhysics.hh"
+#include "G4PlaceOfAction.hh"
 #include "G4VModularPhysicsList.hh"
 #include "G4VUserDetectorConstruction.hh"
 #include "G4VUserParallelWorld.hh"
+#include "G4WeightWindowAlgorithm.hh"
+#include "G4WeightWindowBiasing.hh"
 
 #include "globals.hh"
 
@@ -137,9 +140,11 @@ std::vector<G4VUserParallelWorld*> BDS::ConstructAndRegisterParallelWorlds(G4VUs
     {
       G4String importanceWorldGeometryFile = BDSGlobalConstants::Instance()->ImportanceWorldGeometryFile();
       G4String importanceVolumeMapFile     = BDSGlobalConstants::Instance()->ImportanceVolumeMapFile();
+      G4String weightWindowFile            = BDSGlobalConstants::Instance()->WeightWindowFile();
       auto importanceWorld = new BDSParallelWorldImportance("main",
 							    importanceWorldGeometryFile,
-							    importanceVolumeMapFile);
+							    importanceVolumeMapFile,
+							    weightWindowFile);
       acceleratorModel->RegisterParallelWorld(importanceWorld);
       massWorld->RegisterParallelWorld(importanceWorld);
       worldsRequiringPhysics.push_back(dynamic_cast<G4VUserParallelWorld*>(importanceWorld));
@@ -176,7 +181,12 @@ void BDS::AddIStore(const std::vector<G4VUserParallelWorld*>& worlds)
     BDSParallelWorldImportance* importanceWorld = BDS::GetImportanceSamplingWorld(worlds);
     //only add importance store if the world exists
     if (importanceWorld)
-      {importanceWorld->AddIStore();}
+      {
+        if (BDSGlobalConstants::Instance()->UseWeightWindows())
+          {importanceWorld->AddWeightWindowStore();}
+        else
+          {importanceWorld->AddIStore();}
+      }
     else
       {throw BDSException(__METHOD_NAME__, "Importance sampling world not found.");}
   }
@@ -189,7 +199,35 @@ void BDS::RegisterImportanceBiasing(const std::vector<G4VUserParallelWorld*>& wo
   // create world geometry sampler
   G4GeometrySampler* pgs = new G4GeometrySampler(importanceWorld->GetWorldVolume(), "neutron");
   pgs->SetParallel(true);
-  physList->RegisterPhysics(new G4ImportanceBiasing(pgs,importanceWorld->GetName()));
+
+  const BDSGlobalConstants* g = BDSGlobalConstants::Instance();
+  if (g->UseWeightWindows())
+    {
+      auto wwAlgorithm = new G4WeightWindowAlgorithm(g->WeightWindowUpperLimitFactor(),
+                                                     g->WeightWindowSurvivalFactor(),
+                                                     g->WeightWindowMaximumSplit());
+      G4PlaceOfAction placeOfAction = BDS::DeterminePlaceOfAction(g->WeightWindowPlaceOfAction());
+      physList->RegisterPhysics(new G4WeightWindowBiasing(pgs, wwAlgorithm, placeOfAction, importanceWorld->GetName()));
+    }
+  else
+    {physList->RegisterPhysics(new G4ImportanceBiasing(pgs,importanceWorld->GetName()));}
+}
+
+G4PlaceOfAction BDS::DeterminePlaceOfAction(const G4String& placeOfAction)
+{
+  G4String p = BDS::LowerCase(placeOfAction);
+  if (p == "boundary")
+    {return G4PlaceOfAction::onBoundary;}
+  else if (p == "collision")
+    {return G4PlaceOfAction::onCollision;}
+  else if (p == "boundaryandcollision")
+    {return G4PlaceOfAction::onBoundaryAndCollision;}
+  else
+    {
+      G4String msg = "unknown weightWindowPlaceOfAction \"" + placeOfAction + "\"\n";
+      msg += "it should be one of \"boundary\", \"collision\" or \"boundaryandcollision\"";
+      throw BDSException(__METHOD_NAME__, msg);
+    }
 }
 
 BDSParallelWorldImportance* BDS::GetImportanceSamplingWorld(const std::vector<G4VUserParallelWorld*>& worlds)
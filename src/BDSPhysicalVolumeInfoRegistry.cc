@@ -177,7 +177,7 @@ std::ostream& operator<< (std::ostream& out, BDSPhysicalVolumeInfoRegistry const
   return out;
 }
 
-const std::set<G4VPhysicalVolume*>* BDSPhysicalVolumeInfoRegistry::PVsForBeamlineElement(BDSBeamlineElement* element) const
+const std::set<G4VPhysicalVolume*>* BDSPhysicalVolumeInfoRegistry::PVsForBeamlineElement(const BDSBeamlineElement* element) const
 {
   auto search = pvsForAGivenElement.find(element);
   return search != pvsForAGivenElement.end() ? &search->second : nullptr;
@@ -89,6 +89,10 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "G4HadronicParameters.hh"
 #endif
 
+#if G4VERSION_NUMBER > 1039
+#include "G4FastSimulationPhysics.hh"
+#endif
+
 #include "parser/beam.h"
 #include "parser/fastlist.h"
 #include "parser/physicsbiasing.h"
@@ -528,6 +532,23 @@ void BDS::BuildMuonBiasing(G4VModularPhysicsList* physicsList)
     }
 }
 
+void BDS::RegisterMapTransportPhysics(G4VModularPhysicsList* physicsList,
+				      const BDSParticleDefinition* beamParticle)
+{
+#if G4VERSION_NUMBER > 1039
+  // ions defined through an ion definition share the GenericIon process manager
+  G4String particleName = beamParticle->IsAnIon() ? G4String("GenericIon") : beamParticle->Name();
+  G4cout << __METHOD_NAME__ << "activating fast simulation for \"" << particleName << "\"" << G4endl;
+  auto fastSimulationPhysics = new G4FastSimulationPhysics("mapTransport");
+  fastSimulationPhysics->ActivateFastSimulation(particleName);
+  physicsList->RegisterPhysics(fastSimulationPhysics);
+#else
+  (void)physicsList;
+  (void)beamParticle;
+  throw BDSException(__METHOD_NAME__, "option, mapTransport requires Geant4 10.4 or later.");
+#endif
+}
+
 void BDS::PrintDefinedParticles()
 {
   G4cout << __METHOD_NAME__ << "Defined particles: " << G4endl;
@@ -17,6 +17,7 @@ You should have received a copy of the GNU General Public License
 along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "BDSBunch.hh"
+#include "BDSCheckpoint.hh"
 #include "BDSDebug.hh"
 #include "BDSEventInfo.hh"
 #include "BDSException.hh"
@@ -49,12 +50,16 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "G4Run.hh"
 #include "G4RunManager.hh"
 
+#include <algorithm>
+
 BDSPrimaryGeneratorAction::BDSPrimaryGeneratorAction(BDSBunch*         bunchIn,
                                                      const GMAD::Beam& beam,
-                                                     G4bool            batchMode):
+                                                     G4bool            batchMode,
+                                                     const BDSCheckpoint* resumeCheckpoint):
   bunch(bunchIn),
   recreateFile(nullptr),
   eventOffset(0),
+  resume(false),
   ionPrimary(false),
   distrFileMatchLength(beam.distrFileMatchLength),
   ionCached(false),
@@ -77,12 +82,23 @@ BDSPrimaryGeneratorAction::BDSPrimaryGeneratorAction(BDSBunch*         bunchIn,
       eventOffset  = BDSGlobalConstants::Instance()->StartFromEvent();
       bunch->RecreateAdvanceToEvent(eventOffset);
     }
+  else if (resumeCheckpoint && resumeCheckpoint->Resuming())
+    {
+      resume      = true;
+      eventOffset = (G4int)resumeCheckpoint->NEventsResumed();
+      bunch->RecreateAdvanceToEvent(eventOffset);
+    }
 
   particleGun->SetParticleMomentumDirection(G4ThreeVector(0.,0.,1.));
   particleGun->SetParticlePosition(G4ThreeVector());
   particleGun->SetParticleTime(0);
-  
-  generatorFromFile = BDSPrimaryGeneratorFile::ConstructGenerator(beam, bunch, recreate, eventOffset, batchMode);
+
+  // an event generator file may have skipped events that didn't pass the filters
+  // so it is advanced to the position in the file it had at the checkpoint
+  G4int fileEventOffset = eventOffset;
+  if (resume)
+    {fileEventOffset = (G4int)std::max((G4long)0, resumeCheckpoint->DistrFileEventIndexResumed());}
+  generatorFromFile = BDSPrimaryGeneratorFile::ConstructGenerator(beam, bunch, recreate || resume, fileEventOffset, batchMode);
 }
 
 BDSPrimaryGeneratorAction::~BDSPrimaryGeneratorAction()
@@ -92,6 +108,11 @@ BDSPrimaryGeneratorAction::~BDSPrimaryGeneratorAction()
   delete generatorFromFile;
 }
 
+G4long BDSPrimaryGeneratorAction::DistrFileEventIndex() const
+{
+  return generatorFromFile ? generatorFromFile->CurrentFileEventIndex() : -1;
+}
+
 void BDSPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 {
   G4int thisEventID = anEvent->GetEventID();
@@ -105,6 +126,8 @@ void BDSPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
       BDSRandom::SetSeedState(recreateFile->SeedState(thisEventID + eventOffset));
       bunch->CalculateBunchIndex(thisEventID + eventOffset); // correct bunch index
     }
+  else if (resume)
+    {bunch->CalculateBunchIndex(thisEventID + eventOffset);}
 
   // save the seed state in a file to recover potentially unrecoverable events
   if (writeASCIISeedState)
@@ -22,6 +22,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "BDSDebug.hh"
 #include "BDSEventGeneratorFileType.hh"
 #include "BDSException.hh"
+#include "BDSFileOffsetIndex.hh"
 #include "BDSPrimaryGeneratorFileHEPMC.hh"
 #include "BDSParticleCoords.hh"
 #include "BDSParticleCoordsFull.hh"
@@ -42,6 +43,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "HepMC3/Attribute.h"
 #include "HepMC3/GenParticle.h"
+#include "HepMC3/GenRunInfo.h"
 #include "HepMC3/GenVertex.h"
 #include "HepMC3/Reader.h"
 #include "HepMC3/ReaderAscii.h"
@@ -58,10 +60,30 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "globals.hh"
 
 #include <cmath>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
 #include <utility>
 #include <vector>
 
 
+namespace
+{
+  /// HepMC3 readers only allow derived classes to set the run information.
+  template <class T>
+  class ReaderWithRunInfo: public T
+  {
+  public:
+    explicit ReaderWithRunInfo(std::istream& stream): T(stream) {;}
+    void SetRunInfo(const std::shared_ptr<HepMC3::GenRunInfo>& runInfo)
+    {
+      if (runInfo)
+        {this->set_run_info(runInfo);}
+    }
+  };
+}
+
 BDSPrimaryGeneratorFileHEPMC::BDSPrimaryGeneratorFileHEPMC(const G4String& distrType,
                                                            const G4String& fileNameIn,
                                                            BDSBunchEventGenerator* bunchIn,
@@ -71,6 +93,8 @@ BDSPrimaryGeneratorFileHEPMC::BDSPrimaryGeneratorFileHEPMC(const G4String& distr
   BDSPrimaryGeneratorFile(loopFileIn, bunchIn),
   hepmcEvent(nullptr),
   reader(nullptr),
+  indexedStream(nullptr),
+  fileIndex(nullptr),
   fileName(fileNameIn),
   removeUnstableWithoutDecay(removeUnstableWithoutDecayIn),
   warnAboutSkippedParticles(warnAboutSkippedParticlesIn)
@@ -79,6 +103,19 @@ BDSPrimaryGeneratorFileHEPMC::BDSPrimaryGeneratorFileHEPMC(const G4String& distr
   fileType = BDS::DetermineEventGeneratorFileType(ba.second);
   G4cout << __METHOD_NAME__ << "event generator file format to be " << fileType.ToString() << G4endl;
   referenceBeamMomentumOffset = bunch->ReferenceBeamMomentumOffset();
+  if (bunch->DistrFileIndex())
+    {
+      // events in the ascii formats start with an 'E' line - the other formats either have
+      // a mandatory header (LHEF), aren't line based or are already random access (ROOT)
+      if (fileType == BDSEventGeneratorFileType::hepmc2 || fileType == BDSEventGeneratorFileType::hepmc3)
+        {
+          auto isEventLine = [](const std::string& line){return line.size() > 1 && line[0] == 'E' && line[1] == ' ';};
+          fileIndex = new BDSFileOffsetIndex(fileName, "hepmc-ascii-event", isEventLine);
+          ReadHeader();
+        }
+      else
+        {BDS::Warning(__METHOD_NAME__, "distrFileIndex is only possible for hepmc2 and hepmc3 files - ignoring");}
+    }
   nEventsInFile = CountEventsInFile();
   bunch->SetNEventsInFile(nEventsInFile);
   OpenFile();
@@ -91,6 +128,8 @@ BDSPrimaryGeneratorFileHEPMC::~BDSPrimaryGeneratorFileHEPMC()
 {
   delete hepmcEvent;
   delete reader;
+  delete indexedStream;
+  delete fileIndex;
 }
 
 void BDSPrimaryGeneratorFileHEPMC::GeneratePrimaryVertex(G4Event* anEvent)
@@ -112,6 +151,11 @@ void BDSPrimaryGeneratorFileHEPMC::RecreateAdvanceToEvent(G4int eventOffset)
 
 void BDSPrimaryGeneratorFileHEPMC::OpenFile(G4bool usualPrintOut)
 {
+  if (fileIndex)
+    {
+      OpenFileAtEvent(0, usualPrintOut);
+      return;
+    }
   currentFileEventIndex = 0;
   endOfFileReached = false;
   if (usualPrintOut)
@@ -150,12 +194,81 @@ void BDSPrimaryGeneratorFileHEPMC::CloseFile()
     {reader->close();}
   delete reader;
   reader = nullptr;
+  delete indexedStream;
+  indexedStream = nullptr;
   currentFileEventIndex = 0;
   endOfFileReached = true;
 }
 
+void BDSPrimaryGeneratorFileHEPMC::OpenFileAtEvent(G4long eventIndex, G4bool usualPrintOut)
+{
+  if (reader)
+    {CloseFile();}
+  if (usualPrintOut)
+    {G4cout << __METHOD_NAME__ << "Opening file: " << fileName << " at event " << eventIndex << G4endl;}
+  indexedStream = new std::ifstream(fileName);
+  if (!indexedStream->good())
+    {throw BDSException(__METHOD_NAME__, "cannot open file \"" + fileName + "\"");}
+  // the reader starts after the header, so give it the run information parsed from it
+  if (eventIndex < fileIndex->NRecords())
+    {fileIndex->SeekToRecord(*indexedStream, eventIndex);}
+  else
+    {indexedStream->seekg(0, std::ios::end);}
+  switch (fileType.underlying())
+    {
+    case BDSEventGeneratorFileType::hepmc2:
+      {
+        auto readerAtEvent = new ReaderWithRunInfo<HepMC3::ReaderAsciiHepMC2>(*indexedStream);
+        readerAtEvent->SetRunInfo(headerRunInfo);
+        reader = readerAtEvent;
+        break;
+      }
+    case BDSEventGeneratorFileType::hepmc3:
+      {
+        auto readerAtEvent = new ReaderWithRunInfo<HepMC3::ReaderAscii>(*indexedStream);
+        readerAtEvent->SetRunInfo(headerRunInfo);
+        reader = readerAtEvent;
+        break;
+      }
+    default:
+      {throw BDSException(__METHOD_NAME__, "index only possible for hepmc2 and hepmc3 files");}
+    }
+  currentFileEventIndex = eventIndex;
+  endOfFileReached = false;
+}
+
+void BDSPrimaryGeneratorFileHEPMC::ReadHeader()
+{
+  if (fileIndex->NRecords() == 0)
+    {return;}
+  std::ifstream in(fileName);
+  if (!in.good())
+    {throw BDSException(__METHOD_NAME__, "cannot open file \"" + fileName + "\"");}
+  fileIndex->SeekToRecord(in, 0);
+  std::streamoff headerLength = (std::streamoff)in.tellg();
+  std::string header((std::size_t)headerLength, '\0');
+  in.seekg(0);
+  in.read(&header[0], headerLength);
+  if (!in.good())
+    {throw BDSException(__METHOD_NAME__, "unable to read the header of file \"" + fileName + "\"");}
+
+  // a reader on only the header parses the run information and then finds no event
+  std::istringstream headerStream(header);
+  HepMC3::Reader* headerReader = nullptr;
+  if (fileType == BDSEventGeneratorFileType::hepmc2)
+    {headerReader = new HepMC3::ReaderAsciiHepMC2(headerStream);}
+  else
+    {headerReader = new HepMC3::ReaderAscii(headerStream);}
+  HepMC3::GenEvent tempEvent;
+  headerReader->read_event(tempEvent);
+  headerRunInfo = headerReader->run_info();
+  delete headerReader;
+}
+
 G4long BDSPrimaryGeneratorFileHEPMC::CountEventsInFile()
 {
+  if (fileIndex)
+    {return fileIndex->NRecords();}
   G4cout << __METHOD_NAME__ << "counting number of events" << G4endl;
   OpenFile(false);
   G4long nEvents = 0;
@@ -234,9 +347,14 @@ void BDSPrimaryGeneratorFileHEPMC::SkipEvents(G4int nEventsToSkip)
       msg += ") in this file.";
       throw BDSException("BDSBunchUserFile::RecreateAdvanceToEvent>", msg);
     }
-  G4long nToSkipSinglePass = nAvailable % nEventsToSkip;
-  for (G4int i = 0; i < nToSkipSinglePass; i++)
-    {ReadSingleEvent();}
+  G4long nToSkipSinglePass = (G4long)nEventsToSkip % nEventsInFile;
+  if (fileIndex) // relative to the current event as for reading
+    {OpenFileAtEvent((currentFileEventIndex + nToSkipSinglePass) % nEventsInFile);}
+  else
+    {
+      for (G4int i = 0; i < nToSkipSinglePass; i++)
+        {ReadSingleEvent();}
+    }
 }
 
 void BDSPrimaryGeneratorFileHEPMC::HepMC2G4(const HepMC3::GenEvent* hepmcevt,
@@ -19,7 +19,9 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "BDSBunchEventGenerator.hh"
 #include "BDSDebug.hh"
 #include "BDSException.hh"
+#include "BDSGlobalConstants.hh"
 #include "BDSOutputLoaderSampler.hh"
+#include "BDSOutputROOTEventSampler.hh"
 #include "BDSPrimaryGeneratorFileSampler.hh"
 #include "BDSParticleCoords.hh"
 #include "BDSParticleCoordsFull.hh"
@@ -33,6 +35,8 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "G4Event.hh"
 #include "G4EventManager.hh"
 #include "G4LorentzVector.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4ParticleTable.hh"
 #include "G4PrimaryParticle.hh"
 #include "G4PrimaryVertex.hh"
 
@@ -40,6 +44,8 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "globals.hh"
 
+#include <algorithm>
+#include <string>
 #include <utility>
 
 BDSPrimaryGeneratorFileSampler::BDSPrimaryGeneratorFileSampler(const G4String& distrType,
@@ -52,7 +58,10 @@ BDSPrimaryGeneratorFileSampler::BDSPrimaryGeneratorFileSampler(const G4String& d
   reader(nullptr),
   fileName(fileNameIn),
   removeUnstableWithoutDecay(removeUnstableWithoutDecayIn),
-  warnAboutSkippedParticles(warnAboutSkippedParticlesIn)
+  warnAboutSkippedParticles(warnAboutSkippedParticlesIn),
+  preload(false),
+  preloaded(false),
+  nParticlesRemovedInPreload(0)
 {
   std::pair<G4String, G4String> ba = BDS::SplitOnColon(distrType); // before:after
   samplerName = ba.second;
@@ -65,6 +74,7 @@ BDSPrimaryGeneratorFileSampler::BDSPrimaryGeneratorFileSampler(const G4String& d
   G4cout << __METHOD_NAME__ << nEventsInFile << " events found in file" << G4endl;
   if (!bunch)
     {throw BDSException(__METHOD_NAME__, "must be constructed with a valid BDSBunchEventGenerator instance");}
+  preload = bunch->eventGeneratorPreload;
   SkipEvents(bunch->eventGeneratorNEventsSkip);
 }
 
@@ -80,6 +90,19 @@ void BDSPrimaryGeneratorFileSampler::GeneratePrimaryVertex(G4Event* anEvent)
 
   currentVertices.clear();
 
+  // preload on the first event as the offset into the file (skip, recreation) and
+  // the number of events to generate are only final by now
+  if (preload && !preloaded)
+    {
+      if (loopFile)
+        {Preload(0, nEventsInFile);}
+      else
+        {
+          G4long lastEvent = currentFileEventIndex + (G4long)BDSGlobalConstants::Instance()->NGenerate();
+          Preload(currentFileEventIndex, std::min(nEventsInFile, lastEvent));
+        }
+    }
+
   // currentFileEventIndex is zero counting by nEventsInFile will be 1 greater
   if (currentFileEventIndex >= nEventsInFile)
 	  {
@@ -155,7 +178,7 @@ void BDSPrimaryGeneratorFileSampler::ReadPrimaryParticlesDouble(G4long index)
       G4double yp = (G4double)sampler->yp[i];
       G4double zp = (G4double)sampler->zp[i];
       G4double p  = (G4double)sampler->p[i];
-      G4ThreeVector momentum = G4ThreeVector(xp,yp,zp) * p;
+      G4ThreeVector momentum = G4ThreeVector(xp,yp,zp) * p * CLHEP::GeV;
       G4double x = (G4double)sampler->x[i] * CLHEP::m;
       G4double y = (G4double)sampler->y[i] * CLHEP::m;
       G4double T = (G4double)sampler->T[i] * CLHEP::s;
@@ -167,9 +190,92 @@ void BDSPrimaryGeneratorFileSampler::ReadPrimaryParticlesDouble(G4long index)
     }
 }
 
+void BDSPrimaryGeneratorFileSampler::ReadPrimaryParticlesPreloaded(G4long index)
+{
+  vertices.clear();
+  const PreloadedEvents& pe = preloadedEvents;
+  std::size_t j = (std::size_t)(index - pe.firstEvent);
+  for (std::size_t i = pe.eventStart[j]; i < pe.eventStart[j+1]; i++)
+    {
+      auto g4prim = new G4PrimaryParticle(pe.definition[i], pe.px[i], pe.py[i], pe.pz[i]);
+      g4prim->SetWeight(pe.weight[i]);
+      vertices.emplace_back(DisplacedVertex{G4ThreeVector(pe.x[i], pe.y[i], 0), pe.T[i], g4prim});
+    }
+}
+
+const G4ParticleDefinition* BDSPrimaryGeneratorFileSampler::PreloadDefinition(G4int pdgID)
+{
+  auto search = preloadDefinitions.find(pdgID);
+  if (search != preloadDefinitions.end())
+    {return search->second;}
+  
+  // same filter as in ReadSingleEvent but done once per particle species
+  const G4ParticleDefinition* pd = G4ParticleTable::GetParticleTable()->FindParticle(pdgID);
+  if (pd && removeUnstableWithoutDecay)
+    {
+      if (!(pd->GetPDGStable()) && !pd->GetDecayTable())
+        {pd = nullptr;}
+    }
+  preloadDefinitions[pdgID] = pd;
+  return pd;
+}
+
+template <class U>
+void BDSPrimaryGeneratorFileSampler::AppendPreloaded(const BDSOutputROOTEventSampler<U>* sampler)
+{
+  PreloadedEvents& pe = preloadedEvents;
+  int n = sampler->n;
+  for (int i = 0; i < n; i++)
+    {
+      const G4ParticleDefinition* pd = PreloadDefinition((G4int)sampler->partID[i]);
+      if (!pd)
+        {
+          nParticlesRemovedInPreload++;
+          continue;
+        }
+      G4double p = (G4double)sampler->p[i] * CLHEP::GeV;
+      pe.definition.push_back(pd);
+      pe.x.push_back((G4double)sampler->x[i] * CLHEP::m);
+      pe.y.push_back((G4double)sampler->y[i] * CLHEP::m);
+      pe.T.push_back((G4double)sampler->T[i] * CLHEP::s);
+      pe.px.push_back((G4double)sampler->xp[i] * p);
+      pe.py.push_back((G4double)sampler->yp[i] * p);
+      pe.pz.push_back((G4double)sampler->zp[i] * p);
+      pe.weight.push_back((G4double)sampler->weight[i]);
+    }
+  pe.eventStart.push_back(pe.definition.size());
+}
+
+void BDSPrimaryGeneratorFileSampler::Preload(G4long firstEvent, G4long lastEvent)
+{
+  preloaded = true;
+  PreloadedEvents& pe = preloadedEvents;
+  pe.firstEvent = firstEvent;
+  pe.lastEvent  = std::max(firstEvent, lastEvent);
+  pe.eventStart.reserve((std::size_t)(pe.lastEvent - pe.firstEvent + 1));
+  pe.eventStart.push_back(0);
+  G4cout << __METHOD_NAME__ << "reading events [" << pe.firstEvent << ", " << pe.lastEvent << ") into memory" << G4endl;
+  
+  reader->SetCacheEntryRange(pe.firstEvent, pe.lastEvent);
+  G4bool doublePrecision = reader->DoublePrecision();
+  for (G4long i = pe.firstEvent; i < pe.lastEvent; i++)
+    {
+      if (doublePrecision)
+        {AppendPreloaded(reader->SamplerDataDouble(i));}
+      else
+        {AppendPreloaded(reader->SamplerDataFloat(i));}
+    }
+  G4cout << __METHOD_NAME__ << pe.definition.size() << " particles loaded";
+  if (nParticlesRemovedInPreload > 0)
+    {G4cout << ", " << nParticlesRemovedInPreload << " particles removed as they cannot be simulated";}
+  G4cout << G4endl;
+}
+
 void BDSPrimaryGeneratorFileSampler::ReadSingleEvent(G4long index, G4Event* anEvent)
 {
-  if (reader->DoublePrecision())
+  if (preloaded && index >= preloadedEvents.firstEvent && index < preloadedEvents.lastEvent)
+    {ReadPrimaryParticlesPreloaded(index);}
+  else if (reader->DoublePrecision())
     {ReadPrimaryParticlesDouble(index);}
   else
     {ReadPrimaryParticlesFloat(index);}
@@ -301,6 +407,6 @@ void BDSPrimaryGeneratorFileSampler::SkipEvents(G4long nEventsToSkip)
       msg += ") in this file.";
       throw BDSException("BDSBunchUserFile::RecreateAdvanceToEvent>", msg);
     }
-  G4long nToSkipSinglePass = nAvailable % nEventsToSkip;
+  G4long nToSkipSinglePass = nEventsToSkip % nEventsInFile;
   currentFileEventIndex = nToSkipSinglePass;
 }
@@ -0,0 +1,425 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "BDSDebug.hh"
+#include "BDSException.hh"
+#include "BDSParser.hh"
+#include "BDSRegionCutProfiler.hh"
+#include "BDSUtilities.hh"
+#include "BDSWarning.hh"
+
+#include "parser/region.h"
+
+#include "globals.hh"
+#include "G4Electron.hh"
+#include "G4EmParameters.hh"
+#include "G4Event.hh"
+#include "G4EventManager.hh"
+#include "G4Gamma.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4Positron.hh"
+#include "G4ProductionCuts.hh"
+#include "G4ProductionCutsTable.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4Step.hh"
+#include "G4StepPoint.hh"
+#include "G4Track.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VProcess.hh"
+
+#include "CLHEP/Units/SystemOfUnits.h"
+
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+
+const G4int BDSRegionCutProfiler::nSpecies;
+const G4int BDSRegionCutProfiler::nBins;
+
+namespace
+{
+  const G4double binLowestEnergy   = 100*CLHEP::eV;
+  const G4int    binsPerDecade     = 10;
+  const G4double maximumRangeCut   = 10*CLHEP::m;
+  const G4int    rangeStepsPerDecade = 20;
+}
+
+BDSRegionCutProfiler::BDSRegionCutProfiler(const G4String& outputFileNameIn,
+					   G4double        toleranceIn,
+					   const G4String& scoringRegionsIn):
+  outputFileName(outputFileNameIn),
+  tolerance(toleranceIn),
+  lastRegion(nullptr),
+  lastRegionIndex(-1),
+  currentEventID(-1),
+  currentTrackID(-1),
+  totalScored(0)
+{
+  if (tolerance < 0 || tolerance >= 1)
+    {throw BDSException(__METHOD_NAME__, "regionCutProfileTolerance must be in the range [0, 1)");}
+  for (const auto& name : BDS::SplitOnWhiteSpace(scoringRegionsIn))
+    {scoringRegionNames.insert(name);}
+  lastStepTime = std::chrono::steady_clock::now();
+
+  // processes whose secondaries are only produced above the production cut
+  cutLimitedProcessNames = {"eIoni", "eBrem", "muIoni", "muBrems", "hIoni", "hBrems",
+			    "ionIoni", "muPairProd", "hPairProd", "ePairProd"};
+  // optionally the discrete gamma processes also apply the cuts
+  if (G4EmParameters::Instance()->ApplyCuts())
+    {
+      for (const G4String name : {"compt", "phot", "conv"})
+	{cutLimitedProcessNames.insert(name);}
+    }
+}
+
+BDSRegionCutProfiler::~BDSRegionCutProfiler()
+{;}
+
+G4int BDSRegionCutProfiler::SpeciesIndex(G4int pdgID)
+{
+  switch (pdgID)
+    {
+    case 22:
+      {return 0;}
+    case 11:
+      {return 1;}
+    case -11:
+      {return 2;}
+    default:
+      {return -1;}
+    }
+}
+
+G4bool BDSRegionCutProfiler::CutLimitedProcess(const G4VProcess* process)
+{
+  if (!process)
+    {return false;}
+  auto search = cutLimitedProcesses.find(process);
+  if (search != cutLimitedProcesses.end())
+    {return search->second;}
+  G4bool result = cutLimitedProcessNames.count(process->GetProcessName()) > 0;
+  cutLimitedProcesses[process] = result;
+  return result;
+}
+
+G4int BDSRegionCutProfiler::Bin(G4double kineticEnergy)
+{
+  if (kineticEnergy < binLowestEnergy)
+    {return 0;}
+  G4int bin = 1 + (G4int)std::floor(binsPerDecade * std::log10(kineticEnergy / binLowestEnergy));
+  return std::min(bin, nBins - 1);
+}
+
+G4double BDSRegionCutProfiler::BinUpperEdge(G4int bin)
+{
+  if (bin >= nBins - 1)
+    {return std::numeric_limits<G4double>::max();}
+  return binLowestEnergy * std::pow(10.0, (G4double)bin / (G4double)binsPerDecade);
+}
+
+G4int BDSRegionCutProfiler::RegionIndex(const G4Region* region)
+{
+  if (region == lastRegion)
+    {return lastRegionIndex;}
+  G4int index = -1;
+  for (G4int i = 0; i < (G4int)regions.size(); i++)
+    {
+      if (regions[i].region == region)
+        {index = i; break;}
+    }
+  if (index < 0)
+    {
+      RegionData rd;
+      rd.region  = region;
+      rd.scoring = scoringRegionNames.count(region->GetName()) > 0;
+      regions.push_back(rd);
+      index = (G4int)regions.size() - 1;
+    }
+  lastRegion = region;
+  lastRegionIndex = index;
+  return index;
+}
+
+void BDSRegionCutProfiler::Step(const G4Step* step)
+{
+  auto now = std::chrono::steady_clock::now();
+  const G4Track* track = step->GetTrack();
+  
+  G4int eventID = G4EventManager::GetEventManager()->GetConstCurrentEvent()->GetEventID();
+  if (eventID != currentEventID)
+    {// don't attribute the time between events to this step
+      roots.clear();
+      currentEventID = eventID;
+      currentTrackID = -1;
+      lastStepTime   = now;
+    }
+  
+  G4int trackID = track->GetTrackID();
+  if (trackID != currentTrackID)
+    {
+      currentTrackID = trackID;
+      auto search = roots.find(trackID);
+      if (search != roots.end())
+        {currentRoot = search->second;}
+      else
+        {
+          Root root;
+          auto parentSearch = roots.find(track->GetParentID());
+          if (parentSearch != roots.end() && parentSearch->second.region >= 0)
+            {root = parentSearch->second;} // not produced -> neither are its descendants
+          else if (track->GetParentID() > 0)
+            {
+              G4int species = SpeciesIndex(track->GetParticleDefinition()->GetPDGEncoding());
+              const G4LogicalVolume* vertexLV = track->GetLogicalVolumeAtVertex();
+              // only secondaries that wouldn't be produced with a higher cut are roots
+              if (species >= 0 && vertexLV && vertexLV->GetRegion() && CutLimitedProcess(track->GetCreatorProcess()))
+                {
+                  root.region  = RegionIndex(vertexLV->GetRegion());
+                  root.species = species;
+                  root.bin     = Bin(track->GetVertexKineticEnergy());
+                  regions[root.region].bins[species][root.bin].nRoots++;
+                }
+            }
+          roots[trackID] = root;
+          currentRoot = root;
+        }
+    }
+
+  const G4StepPoint* preStepPoint = step->GetPreStepPoint();
+  const G4VPhysicalVolume* pv = preStepPoint->GetPhysicalVolume();
+  if (!pv)
+    {return;}
+  const G4Region* region = pv->GetLogicalVolume()->GetRegion();
+  if (!region)
+    {return;}
+  RegionData& rd = regions[RegionIndex(region)];
+  
+  G4double dt = std::chrono::duration<G4double>(now - lastStepTime).count();
+  lastStepTime = now;
+  rd.nSteps++;
+  rd.time += dt;
+  rd.materials.insert(preStepPoint->GetMaterial());
+
+  G4bool scored = scoringRegionNames.empty() ? preStepPoint->GetSensitiveDetector() != nullptr : rd.scoring;
+  G4double scoredHere = scored ? step->GetTotalEnergyDeposit() * preStepPoint->GetWeight() : 0;
+  rd.scored   += scoredHere;
+  totalScored += scoredHere;
+
+  if (currentRoot.region >= 0)
+    {
+      BinData& bd = regions[currentRoot.region].bins[currentRoot.species][currentRoot.bin];
+      bd.time   += dt;
+      bd.scored += scoredHere;
+    }
+}
+
+G4double BDSRegionCutProfiler::RangeForEnergy(const RegionData& rd,
+                                              G4int species,
+                                              G4double energy,
+                                              G4double currentCut) const
+{
+  const G4ParticleDefinition* particles[nSpecies] = {G4Gamma::Definition(),
+                                                      G4Electron::Definition(),
+                                                      G4Positron::Definition()};
+  G4ProductionCutsTable* cutsTable = G4ProductionCutsTable::GetProductionCutsTable();
+  G4double factor = std::pow(10.0, 1.0 / (G4double)rangeStepsPerDecade);
+  G4double result = currentCut;
+  for (G4double range = currentCut * factor; range <= maximumRangeCut; range *= factor)
+    {
+      G4bool ok = true;
+      for (const auto* material : rd.materials)
+        {
+          if (cutsTable->ConvertRangeToEnergy(particles[species], material, range) > energy)
+            {ok = false; break;}
+        }
+      if (!ok)
+        {break;}
+      result = range;
+    }
+  return result;
+}
+
+void BDSRegionCutProfiler::EndOfRun(G4int nEvents)
+{
+  G4double totalTime = 0;
+  for (const auto& rd : regions)
+    {totalTime += rd.time;}
+
+  auto flagsCache(G4cout.flags());
+  auto precisionCache = G4cout.precision();
+  G4cout << __METHOD_NAME__ << "region profile of " << nEvents << " events" << G4endl;
+  G4cout << std::left << std::setw(30) << "region" << std::right << std::setw(14) << "steps"
+         << std::setw(12) << "time (%)" << std::setw(12) << "scored (%)" << G4endl;
+  for (const auto& rd : regions)
+    {
+      G4cout << std::left << std::setw(30) << rd.region->GetName() << std::right << std::setw(14) << rd.nSteps
+             << std::setw(12) << std::setprecision(3) << (totalTime > 0 ? 100 * rd.time / totalTime : 0)
+             << std::setw(12) << (totalScored > 0 ? 100 * rd.scored / totalScored : 0)
+             << (rd.scoring ? " (scoring)" : "") << G4endl;
+    }
+  G4cout.flags(flagsCache);
+  G4cout.precision(precisionCache);
+
+  if (totalScored <= 0)
+    {
+      G4String msg = "no scored quantity was recorded in the pilot run - no cuts will be proposed.\n";
+      msg += "Check regionCutProfileScoringRegions or simulate more events.";
+      BDS::Warning(__METHOD_NAME__, msg);
+      return;
+    }
+
+  // greedy choice of the cut energy for each (region, species) - 'accepted' is the highest
+  // bin whose roots would no longer be produced. Steps jump to the next bin with any roots
+  // so the cut is never raised beyond what was seen in the pilot.
+  std::vector<std::array<G4int, nSpecies> > accepted(regions.size());
+  for (auto& a : accepted)
+    {a.fill(-1);}
+  G4double budget = tolerance * totalScored;
+  G4double timeSaved = 0;
+  G4double scoredRemoved = 0;
+  while (true)
+    {
+      G4int bestRegion  = -1;
+      G4int bestSpecies = -1;
+      G4int bestBin     = -1;
+      G4double bestRatio = -1;
+      G4double bestTime = 0;
+      G4double bestScored = 0;
+      for (G4int r = 0; r < (G4int)regions.size(); r++)
+        {
+          if (regions[r].scoring)
+            {continue;}
+          for (G4int s = 0; s < nSpecies; s++)
+            {
+              G4double dTime = 0;
+              G4double dScored = 0;
+              G4int b = accepted[r][s] + 1;
+              for (; b < nBins - 1; b++)
+                {
+                  const BinData& bd = regions[r].bins[s][b];
+                  dTime   += bd.time;
+                  dScored += bd.scored;
+                  if (bd.nRoots > 0)
+                    {break;}
+                }
+              if (b >= nBins - 1 || dScored > budget - scoredRemoved)
+                {continue;}
+              G4double ratio = dTime / (dScored + std::numeric_limits<G4double>::min());
+              if (ratio > bestRatio)
+                {
+                  bestRatio = ratio;
+                  bestRegion = r;
+                  bestSpecies = s;
+                  bestBin = b;
+                  bestTime = dTime;
+                  bestScored = dScored;
+                }
+            }
+        }
+      if (bestRegion < 0)
+        {break;}
+      accepted[bestRegion][bestSpecies] = bestBin;
+      timeSaved     += bestTime;
+      scoredRemoved += bestScored;
+    }
+
+  // convert to range cuts and write out
+  std::set<G4String> parserRegionNames;
+  for (const auto& r : BDSParser::Instance()->GetRegions())
+    {parserRegionNames.insert(G4String(r.name));}
+
+  const G4String cutNames[nSpecies] = {"prodCutPhotons", "prodCutElectrons", "prodCutPositrons"};
+  std::ofstream outFile(outputFileName);
+  if (!outFile.is_open())
+    {throw BDSException(__METHOD_NAME__, "unable to open file \"" + outputFileName + "\"");}
+  outFile << "! BDSIM proposed production cuts from a pilot run of " << nEvents << " events\n";
+  outFile << "! tolerance on the scored quantity: " << tolerance << "\n";
+  outFile << "! estimated fraction of the scored quantity removed: " << scoredRemoved / totalScored << "\n";
+  outFile << "! estimated fraction of the time saved: " << (totalTime > 0 ? timeSaved / totalTime : 0) << "\n";
+  outFile << "! only secondaries of processes that apply production cuts (e.g. eBrem, eIoni) are counted\n";
+  outFile << "! include this file at the end of the model to apply the cuts\n";
+
+  G4cout << __METHOD_NAME__ << "proposed cuts (m) - estimated time saved: " << std::setprecision(3)
+         << (totalTime > 0 ? 100 * timeSaved / totalTime : 0) << "%, scored quantity removed: "
+         << 100 * scoredRemoved / totalScored << "%" << G4endl;
+  std::set<G4String> regionsWritten;
+  G4bool worldChanged = false;
+  for (G4int r = 0; r < (G4int)regions.size(); r++)
+    {
+      const RegionData& rd = regions[r];
+      const G4String& name = rd.region->GetName();
+      G4bool isWorld = name == "DefaultRegionForTheWorld";
+      if (!isWorld && parserRegionNames.count(name) == 0)
+        {continue;} // not a region we can set from the input
+      G4ProductionCuts* cuts = rd.region->GetProductionCuts();
+      if (!cuts)
+        {continue;}
+      
+      std::array<G4double, nSpecies> newCuts;
+      G4bool changed = false;
+      for (G4int s = 0; s < nSpecies; s++)
+        {
+          G4double currentCut = cuts->GetProductionCut(s); // species index matches G4ProductionCutsIndex
+          newCuts[s] = currentCut;
+          if (accepted[r][s] >= 0)
+            {newCuts[s] = RangeForEnergy(rd, s, BinUpperEdge(accepted[r][s]), currentCut);}
+          changed = changed || newCuts[s] > currentCut;
+        }
+      
+      if (isWorld)
+        {
+          worldChanged = changed;
+          if (!changed)
+            {continue;}
+        }
+      regionsWritten.insert(name);
+      outFile << (isWorld ? G4String("option") : name);
+      outFile << (isWorld ? ", " : ": ");
+      for (G4int s = 0; s < nSpecies; s++)
+        {outFile << cutNames[s] << "=" << newCuts[s] / CLHEP::m << (s < nSpecies - 1 ? ", " : ";\n");}
+      G4cout << std::left << std::setw(30) << name << std::right;
+      for (G4int s = 0; s < nSpecies; s++)
+        {G4cout << " " << cutNames[s] << ": " << std::setw(10) << newCuts[s] / CLHEP::m;}
+      G4cout << G4endl;
+    }
+  
+  // the world cuts are the defaults for other regions, so write the current cuts of
+  // every other region explicitly so they aren't changed with it
+  if (worldChanged)
+    {
+      for (const auto& name : parserRegionNames)
+        {
+          if (regionsWritten.count(name) > 0)
+            {continue;}
+          const G4Region* region = G4RegionStore::GetInstance()->GetRegion(name, false);
+          if (!region || !region->GetProductionCuts())
+            {continue;}
+          outFile << name << ": ";
+          for (G4int s = 0; s < nSpecies; s++)
+            {outFile << cutNames[s] << "=" << region->GetProductionCuts()->GetProductionCut(s) / CLHEP::m << (s < nSpecies - 1 ? ", " : ";\n");}
+        }
+    }
+  outFile.close();
+  G4cout.flags(flagsCache);
+  G4cout.precision(precisionCache);
+  G4cout << __METHOD_NAME__ << "proposed cuts written to \"" << outputFileName << "\"" << G4endl;
+}
@@ -21,13 +21,16 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "BDSBeamline.hh"
 #include "BDSBunch.hh"
 #include "BDSBunchFileBased.hh"
+#include "BDSCheckpoint.hh"
 #include "BDSDebug.hh"
 #include "BDSEventAction.hh"
 #include "BDSEventInfo.hh"
 #include "BDSException.hh"
 #include "BDSGlobalConstants.hh"
+#include "BDSIntegrationDriverExact.hh"
 #include "BDSOutput.hh"
 #include "BDSParser.hh"
+#include "BDSRegionCutProfiler.hh"
 #include "BDSRunAction.hh"
 #include "BDSSamplerPlacementRecord.hh"
 #include "BDSSamplerRegistry.hh"
@@ -70,7 +73,9 @@ BDSRunAction::BDSRunAction(BDSOutput*      outputIn,
   cpuStartTime(std::clock_t()),
   eventAction(eventActionIn),
   trajectorySamplerID(trajectorySamplerIDIn),
-  nEventsRequested(0)
+  nEventsRequested(0),
+  regionCutProfiler(nullptr),
+  checkpoint(nullptr)
 {;}
 
 BDSRunAction::~BDSRunAction()
@@ -94,12 +99,6 @@ void BDSRunAction::BeginOfRunAction(const G4Run* aRun)
   
   info = new BDSEventInfo();
   
-  // save the random engine state
-  std::stringstream ss;
-  CLHEP::HepRandom::saveFullState(ss);
-  seedStateAtStart = ss.str();
-  info->SetSeedStateAtStart(seedStateAtStart);
-  
   // get the current time
   starttime = time(nullptr);
   info->SetStartTime(starttime);
@@ -111,6 +110,16 @@ void BDSRunAction::BeginOfRunAction(const G4Run* aRun)
   output->InitialiseGeometryDependent();
   output->NewFile();
 
+  // restore the random engine and the run histograms if resuming
+  if (checkpoint)
+    {checkpoint->BeginOfRun();}
+
+  // save the random engine state
+  std::stringstream ss;
+  CLHEP::HepRandom::saveFullState(ss);
+  seedStateAtStart = ss.str();
+  info->SetSeedStateAtStart(seedStateAtStart);
+
   // Write options now file open.
   const GMAD::OptionsBase* ob = BDSParser::Instance()->GetOptionsBase();
   output->FillOptions(ob);
@@ -132,6 +141,7 @@ void BDSRunAction::BeginOfRunAction(const G4Run* aRun)
   BDS::FixGeant105ThreshholdsForParticle(G4Electron::Definition());
 #endif
 
+  BDSIntegrationDriverExact::ResetStatistics();
   cpuStartTime = std::clock();
 }
 
@@ -178,6 +188,9 @@ void BDSRunAction::EndOfRunAction(const G4Run* aRun)
 
   // note difftime only calculates to the integer second
   G4cout << __METHOD_NAME__ << "Run Duration >> " << (int)duration << " s" << G4endl;
+  BDSIntegrationDriverExact::PrintStatistics(durationCPU);
+  if (regionCutProfiler)
+    {regionCutProfiler->EndOfRun(aRun->GetNumberOfEvent());}
 }
 
 void BDSRunAction::PrintAllProcessesForAllParticles() const
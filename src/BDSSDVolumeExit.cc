@@ -54,39 +54,49 @@ void BDSSDVolumeExit::Initialize(G4HCofThisEvent* HCE)
 G4bool BDSSDVolumeExit::ProcessHits(G4Step* aStep,
 				    G4TouchableHistory* /*th*/)
 {
-  G4StepPoint* postStepPoint = aStep->GetPostStepPoint();
-
-  if (postStepPoint->GetStepStatus() == statusToMatch)
+  if (aStep->GetPostStepPoint()->GetStepStatus() == statusToMatch)
     {
-      G4double totalEnergy           = postStepPoint->GetTotalEnergy();
-      G4double preStepKineticEnergy  = aStep->GetPreStepPoint()->GetKineticEnergy();
-      G4double postStepKineticEnergy = postStepPoint->GetKineticEnergy();
-      G4double stepLength            = aStep->GetStepLength();
-      G4ThreeVector position         = postStepPoint->GetPosition();
-      G4double T          = postStepPoint->GetGlobalTime();
-      G4Track* track      = aStep->GetTrack();
-      G4int    pdgID      = track->GetDefinition()->GetPDGEncoding();
-      G4int    trackID    = track->GetTrackID();
-      G4int    parentID   = track->GetParentID();
-      G4double weight     = track->GetWeight();
-      G4int    turnsTaken = BDSGlobalConstants::Instance()->TurnsTaken();
-      
-      BDSHitEnergyDepositionGlobal* hit = new BDSHitEnergyDepositionGlobal(totalEnergy,
-									   preStepKineticEnergy,
-									   postStepKineticEnergy,
-									   stepLength,
-									   position.x(),
-									   position.y(),
-									   position.z(),
-									   T,
-									   pdgID,
-									   trackID,
-									   parentID,
-									   weight,
-									   turnsTaken);
-      hits->insert(hit);
+      RecordExit(aStep);
       return true;
     }
   else
     {return false;}
 }
+
+void BDSSDVolumeExit::ProcessHitsForcedExit(const G4Step* step)
+{
+  if (hits) // only exists once initialised for an event
+    {RecordExit(step);}
+}
+
+void BDSSDVolumeExit::RecordExit(const G4Step* aStep)
+{
+  const G4StepPoint* postStepPoint = aStep->GetPostStepPoint();
+  G4double totalEnergy           = postStepPoint->GetTotalEnergy();
+  G4double preStepKineticEnergy  = aStep->GetPreStepPoint()->GetKineticEnergy();
+  G4double postStepKineticEnergy = postStepPoint->GetKineticEnergy();
+  G4double stepLength            = aStep->GetStepLength();
+  G4ThreeVector position         = postStepPoint->GetPosition();
+  G4double T          = postStepPoint->GetGlobalTime();
+  G4Track* track      = aStep->GetTrack();
+  G4int    pdgID      = track->GetDefinition()->GetPDGEncoding();
+  G4int    trackID    = track->GetTrackID();
+  G4int    parentID   = track->GetParentID();
+  G4double weight     = track->GetWeight();
+  G4int    turnsTaken = BDSGlobalConstants::Instance()->TurnsTaken();
+  
+  BDSHitEnergyDepositionGlobal* hit = new BDSHitEnergyDepositionGlobal(totalEnergy,
+								       preStepKineticEnergy,
+								       postStepKineticEnergy,
+								       stepLength,
+								       position.x(),
+								       position.y(),
+								       position.z(),
+								       T,
+								       pdgID,
+								       trackID,
+								       parentID,
+								       weight,
+								       turnsTaken);
+  hits->insert(hit);
+}
@@ -19,6 +19,7 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "BDSDebug.hh"
 #include "BDSException.hh"
 #include "BDSScorerConversionLoader.hh"
+#include "BDSScorerConversionTable.hh"
 
 #include "G4DataVector.hh"
 #include "G4PhysicsFreeVector.hh"
@@ -105,6 +106,16 @@ G4PhysicsVector* BDSScorerConversionLoader<T>::Load(const G4String& fileName,
   return results;
 }
 
+template <class T>
+BDSScorerConversionTable* BDSScorerConversionLoader<T>::LoadTable(const G4String& fileName,
+								  G4bool          silent)
+{
+  G4PhysicsVector* vector = Load(fileName, silent);
+  BDSScorerConversionTable* result = new BDSScorerConversionTable(vector);
+  delete vector;
+  return result;
+}
+
 template class BDSScorerConversionLoader<std::ifstream>;
 
 #ifdef USE_GZSTREAM
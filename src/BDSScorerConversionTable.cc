@@ -0,0 +1,79 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "BDSDebug.hh"
+#include "BDSException.hh"
+#include "BDSScorerConversionTable.hh"
+
+#include "G4PhysicsVector.hh"
+#include "G4Types.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <vector>
+
+BDSScorerConversionTable::BDSScorerConversionTable(const G4PhysicsVector* vector,
+                                                   G4int                  nGridBinsPerPoint):
+  eKMin(0),
+  eKMax(0),
+  logEKMin(0),
+  invGridBinWidth(0),
+  nGridBins(0),
+  useGrid(false)
+{
+  if (!vector)
+    {throw BDSException(__METHOD_NAME__, "no conversion factor vector supplied");}
+  std::size_t nPoints = vector->GetVectorLength();
+  if (nPoints < 2)
+    {throw BDSException(__METHOD_NAME__, "must be at least 2 points in Ek vs value vectors.");}
+
+  for (std::size_t i = 0; i < nPoints; i++)
+    {
+      energy.push_back(vector->Energy(i));
+      values.push_back((*vector)[i]);
+    }
+  eKMin = energy.front();
+  eKMax = energy.back();
+
+  useGrid = eKMin > 0 && eKMax > eKMin;
+  if (!useGrid)
+    {return;}
+
+  nGridBins = std::max(64, nGridBinsPerPoint * (G4int)nPoints);
+  logEKMin  = std::log(eKMin);
+  G4double gridBinWidth = (std::log(eKMax) - logEKMin) / (G4double)nGridBins;
+  invGridBinWidth = 1.0 / gridBinWidth;
+
+  gridStartIndex.resize((std::size_t)nGridBins, 0);
+  std::size_t i = 0;
+  for (G4int bin = 0; bin < nGridBins; bin++)
+    {
+      G4double lowerEdge = std::exp(logEKMin + bin * gridBinWidth);
+      while (i + 2 < nPoints && energy[i+1] < lowerEdge)
+        {i++;}
+      gridStartIndex[bin] = i;
+    }
+}
+
+std::size_t BDSScorerConversionTable::BinarySearch(G4double eK) const
+{
+  auto it = std::lower_bound(energy.begin(), energy.end(), eK);
+  std::size_t i = (std::size_t)std::distance(energy.begin(), it);
+  return i > 0 ? i - 1 : 0;
+}
@@ -87,6 +87,7 @@ BDSScorerMeshInfo::BDSScorerMeshInfo(const GMAD::ScorerMesh& mesh)
   eLow  =  mesh.eLow* CLHEP::GeV;
   eHigh =  mesh.eHigh* CLHEP::GeV;
   eScale = mesh.eScale;
+  sparseStorage = mesh.sparseStorage;
 
   extent = BDSExtent(xLow, xHigh,
                      yLow, yHigh,
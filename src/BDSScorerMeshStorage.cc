@@ -0,0 +1,135 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "BDSHistBinMapper.hh"
+#include "BDSScorerMeshStorage.hh"
+
+#include "G4Exception.hh"
+#include "G4ios.hh"
+#include "G4Types.hh"
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <vector>
+
+const G4int       BDSScorerMeshStorage::emptyKey;
+const std::size_t BDSScorerMeshStorage::maximumDenseBins;
+
+BDSScorerMeshStorage::BDSScorerMeshStorage(std::size_t nBinsIn,
+					   G4bool      sparseIn):
+  nBins(0),
+  sparse(sparseIn),
+  mask(0)
+{
+  if (nBinsIn > (std::size_t)INT_MAX)
+    {
+      G4ExceptionDescription ED;
+      ED << "scoring mesh has " << nBinsIn << " bins, but at most " << INT_MAX
+	 << " can be indexed - reduce the number of bins" << G4endl;
+      G4Exception("BDSScorerMeshStorage::BDSScorerMeshStorage", "BDSIM0001", FatalException, ED);
+    }
+  nBins = (G4int)nBinsIn;
+
+  if (sparse)
+    {
+      const std::size_t initialSlots = 1024;
+      keys.resize(initialSlots, emptyKey);
+      values.resize(initialSlots, 0);
+      mask = initialSlots - 1;
+    }
+  else
+    {
+      values.resize(nBinsIn, 0);
+      touched.resize(nBinsIn, 0);
+    }
+}
+
+void BDSScorerMeshStorage::Reset()
+{
+  if (sparse)
+    {
+      // find all the slots before emptying any as removing one would break
+      // the probe sequence of those after it
+      resetSlots.clear();
+      for (G4int index : touchedBins)
+	{resetSlots.push_back(Slot(index));}
+      for (std::size_t slot : resetSlots)
+	{
+	  keys[slot]   = emptyKey;
+	  values[slot] = 0;
+	}
+    }
+  else
+    {
+      for (G4int index : touchedBins)
+	{
+	  values[index]  = 0;
+	  touched[index] = 0;
+	}
+    }
+  touchedBins.clear();
+}
+
+void BDSScorerMeshStorage::AddSparse(G4int index, G4double value)
+{
+  std::size_t slot = Slot(index);
+  if (keys[slot] == emptyKey)
+    {
+      if (2 * (touchedBins.size() + 1) > keys.size())
+	{
+	  Grow();
+	  slot = Slot(index);
+	}
+      keys[slot] = index;
+      touchedBins.push_back(index);
+    }
+  values[slot] += value;
+}
+
+void BDSScorerMeshStorage::Grow()
+{
+  std::vector<G4double> oldValues;
+  std::vector<G4int>    oldKeys;
+  oldValues.swap(values);
+  oldKeys.swap(keys);
+  std::size_t nSlots = 2 * oldKeys.size();
+  keys.resize(nSlots, emptyKey);
+  values.resize(nSlots, 0);
+  mask = nSlots - 1;
+  for (std::size_t i = 0; i < oldKeys.size(); ++i)
+    {
+      if (oldKeys[i] == emptyKey)
+	{continue;}
+      std::size_t slot = Slot(oldKeys[i]);
+      keys[slot]   = oldKeys[i];
+      values[slot] = oldValues[i];
+    }
+}
+
+std::size_t BDSScorerMeshStorage::NBinsRoot3D(G4int nBinsI, G4int nBinsJ, G4int nBinsK)
+{
+  return (std::size_t)(nBinsI + 2) * (std::size_t)(nBinsJ + 2) * (std::size_t)(nBinsK + 2);
+}
+
+std::size_t BDSScorerMeshStorage::NBinsMapper(const BDSHistBinMapper* mapper)
+{
+  // the mapper returns these as G4double so convert each before multiplying
+  return (std::size_t)mapper->NBinsI() * (std::size_t)mapper->NBinsJ()
+    * (std::size_t)mapper->NBinsK() * (std::size_t)mapper->NBinsL();
+}
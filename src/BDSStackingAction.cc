@@ -31,9 +31,15 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 #include "G4Track.hh"
 #include "G4TrackStatus.hh"
 #include "G4ParticleDefinition.hh"
+#include "G4GeometryCell.hh"
+#include "G4Navigator.hh"
 #include "G4ParticleTypes.hh"
+#include "G4TransportationManager.hh"
 #include "G4VSensitiveDetector.hh"
 #include "G4Version.hh"
+#include "G4WeightWindowStore.hh"
+
+#include "Randomize.hh"
 
 #if G4VERSION_NUMBER > 1029
 #include "G4MultiSensitiveDetector.hh"
@@ -41,7 +47,10 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 
 G4double BDSStackingAction::energyKilled = 0;
 
-BDSStackingAction::BDSStackingAction(const BDSGlobalConstants* globals)
+BDSStackingAction::BDSStackingAction(const BDSGlobalConstants* globals):
+  weightWindowNavigator(nullptr),
+  weightWindowWorld(nullptr),
+  weightWindowStore(nullptr)
 {
   killNeutrinos     = globals->KillNeutrinos();
   stopSecondaries   = globals->StopSecondaries();
@@ -50,10 +59,14 @@ BDSStackingAction::BDSStackingAction(const BDSGlobalConstants* globals)
     {maxTracksPerEvent = LONG_MAX;}
   minimumEK = globals->MinimumKineticEnergy();
   particlesToExcludeFromCuts = globals->ParticlesToExcludeFromCutsAsSet();
+  rouletteSecondaries = globals->UseWeightWindows() && globals->WeightWindowRouletteSecondaries();
+  weightWindowSurvivalFactor = globals->WeightWindowSurvivalFactor();
 }
 
 BDSStackingAction::~BDSStackingAction()
-{;}
+{
+  delete weightWindowNavigator;
+}
 
 G4ClassificationOfNewTrack BDSStackingAction::ClassifyNewTrack(const G4Track * aTrack)
 {
@@ -90,6 +103,14 @@ G4ClassificationOfNewTrack BDSStackingAction::ClassifyNewTrack(const G4Track * a
   if (stopSecondaries && (aTrack->GetParentID() > 0))
     {classification = fKill;}
 
+  // Weight window roulette - this is a statistical kill (the weight is carried by the
+  // survivors) so there is no energy to account for - return here
+  if (rouletteSecondaries && classification == fUrgent && aTrack->GetParentID() > 0)
+    {
+      if (RouletteSecondary(aTrack))
+        {return fKill;}
+    }
+
   // Here we must take care of energy conservation. If we artificially kill the track
   // we should record its loss as energy deposition. Find if the volume is sensitive
   // and if so record the track there. Note a track is not a step and is a snap shot at
@@ -149,6 +170,48 @@ G4ClassificationOfNewTrack BDSStackingAction::ClassifyNewTrack(const G4Track * a
   return classification;
 }
 
+G4bool BDSStackingAction::RouletteSecondary(const G4Track* aTrack)
+{
+  // the weight window geometry sampler is only for neutrons
+  if (aTrack->GetParticleDefinition() != G4Neutron::Definition())
+    {return false;}
+
+  if (!weightWindowNavigator)
+    {// the importance world only exists after construction so prepare on first use
+      weightWindowWorld = G4TransportationManager::GetTransportationManager()->IsWorldExisting("importanceWorld_main");
+      if (!weightWindowWorld)
+        {
+          rouletteSecondaries = false;
+          return false;
+        }
+      // our own navigator so the state of the one used for tracking is not changed
+      weightWindowNavigator = new G4Navigator();
+      weightWindowNavigator->SetWorldVolume(weightWindowWorld);
+      weightWindowStore = G4WeightWindowStore::GetInstance(weightWindowWorld->GetName());
+    }
+
+  G4VPhysicalVolume* cellPV = weightWindowNavigator->LocateGlobalPointAndSetup(aTrack->GetPosition(), nullptr, false, true);
+  if (!cellPV)
+    {return false;} // outside the world
+  G4GeometryCell cell(*cellPV, 0);
+  if (!weightWindowStore->IsKnown(cell))
+    {return false;}
+
+  G4double lowerWeight = weightWindowStore->GetLowerWeight(cell, aTrack->GetKineticEnergy());
+  G4double weight = aTrack->GetWeight();
+  if (weight >= lowerWeight)
+    {return false;}
+
+  // same as G4WeightWindowAlgorithm - survivors are given the survival weight
+  G4double survivalWeight = lowerWeight * weightWindowSurvivalFactor;
+  if (G4UniformRand() < weight / survivalWeight)
+    {
+      const_cast<G4Track*>(aTrack)->SetWeight(survivalWeight);
+      return false;
+    }
+  return true;
+}
+
 void BDSStackingAction::NewStage()
 {
   // urgent stack empty, looking into the waiting stack
@@ -16,7 +16,9 @@ GNU General Public License for more details.
 You should have received a copy of the GNU General Public License
 along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 */
+#include "BDSRegionCutProfiler.hh"
 #include "BDSSteppingAction.hh"
+#include "BDSTrackingEnvelope.hh"
 #include "BDSUtilities.hh"
 
 #include "globals.hh"
@@ -32,15 +34,21 @@ along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
 BDSSteppingAction::BDSSteppingAction():
   verboseStep(false),
   verboseEventStart(false),
-  verboseEventStop(false)
+  verboseEventStop(false),
+  regionCutProfiler(nullptr),
+  trackingEnvelope(nullptr)
 {;}
 
 BDSSteppingAction::BDSSteppingAction(G4bool verboseStepIn,
 				     G4int  verboseEventStartIn,
-				     G4int  verboseEventStopIn):
+				     G4int  verboseEventStopIn,
+				     BDSRegionCutProfiler* regionCutProfilerIn,
+				     BDSTrackingEnvelope*  trackingEnvelopeIn):
   verboseStep(verboseStepIn),
   verboseEventStart(verboseEventStartIn),
-  verboseEventStop(verboseEventStopIn)
+  verboseEventStop(verboseEventStopIn),
+  regionCutProfiler(regionCutProfilerIn),
+  trackingEnvelope(trackingEnvelopeIn)
 {;}
 
 BDSSteppingAction::~BDSSteppingAction()
@@ -48,6 +56,10 @@ BDSSteppingAction::~BDSSteppingAction()
 
 void BDSSteppingAction::UserSteppingAction(const G4Step* step)
 {
+  if (regionCutProfiler)
+    {regionCutProfiler->Step(step);}
+  if (trackingEnvelope)
+    {trackingEnvelope->Step(step);}
   if (!verboseStep)
     {return;}
   G4int eventID = G4EventManager::GetEventManager()->GetConstCurrentEvent()->GetEventID();
@@ -55,7 +55,10 @@ BDSTrackingAction::BDSTrackingAction(G4bool batchMode,
 
 void BDSTrackingAction::PreUserTrackingAction(const G4Track* track)
 {
-  eventAction->IncrementNTracks();
+  // a track resumed after being suspended (e.g. by map transport) already has
+  // a track length and has been counted once
+  if (!(track->GetTrackLength() > 0))
+    {eventAction->IncrementNTracks();}
   G4int  eventIndex = eventAction->CurrentEventIndex();
   G4bool verboseSteppingThisEvent = BDS::VerboseThisEvent(eventIndex, verboseSteppingEventStart, verboseSteppingEventStop);
   G4bool primaryParticle  = track->GetParentID() == 0;
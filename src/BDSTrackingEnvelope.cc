@@ -0,0 +1,217 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "BDSAuxiliaryNavigator.hh"
+#include "BDSBeamline.hh"
+#include "BDSBeamlineElement.hh"
+#include "BDSDebug.hh"
+#include "BDSException.hh"
+#include "BDSExtent.hh"
+#include "BDSGlobalConstants.hh"
+#include "BDSPhysicalVolumeInfo.hh"
+#include "BDSPhysicalVolumeInfoRegistry.hh"
+#include "BDSSDManager.hh"
+#include "BDSSDVolumeExit.hh"
+#include "BDSStackingAction.hh"
+#include "BDSStep.hh"
+#include "BDSTiltOffset.hh"
+#include "BDSTrackingEnvelope.hh"
+#include "BDSUtilities.hh"
+#include "BDSWarning.hh"
+
+#include "globals.hh" // geant4 types / globals
+#include "G4Step.hh"
+#include "G4StepPoint.hh"
+#include "G4StepStatus.hh"
+#include "G4ThreeVector.hh"
+#include "G4Track.hh"
+#include "G4TrackStatus.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VTouchable.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+
+#include "CLHEP/Units/SystemOfUnits.h"
+
+BDSTrackingEnvelope::BDSTrackingEnvelope(G4double radiusIn,
+					 G4double sMinIn,
+					 G4double sMaxIn,
+					 G4bool   recordIn):
+  radius(radiusIn),
+  sMin(sMinIn),
+  sMax(sMaxIn),
+  useSLimits(sMaxIn > sMinIn),
+  record(recordIn),
+  auxNavigator(new BDSAuxiliaryNavigator()),
+  worldExit(nullptr),
+  initialised(false),
+  curvilinearRadius(0),
+  lastTrack(nullptr),
+  lastTrackID(-1),
+  lastInComponentInside(false),
+  lastTrackLength(0),
+  lastMargin(0)
+{
+  if (radius < 0)
+    {throw BDSException(__METHOD_NAME__, "trackingEnvelopeRadius must be >= 0");}
+  G4cout << __METHOD_NAME__ << "killing tracks outside the curvilinear geometry";
+  if (radius > 0)
+    {G4cout << ", with r > " << radius/CLHEP::m << " m";}
+  if (useSLimits)
+    {G4cout << ", or outside S = [" << sMin/CLHEP::m << ", " << sMax/CLHEP::m << "] m";}
+  G4cout << G4endl;
+}
+
+BDSTrackingEnvelope::~BDSTrackingEnvelope()
+{
+  delete auxNavigator;
+}
+
+void BDSTrackingEnvelope::Initialise()
+{
+  worldExit = BDSSDManager::Instance()->WorldExit();
+  // the curvilinear diameter may be reduced for bends during the construction
+  const BDSGlobalConstants* globals = BDSGlobalConstants::Instance();
+  curvilinearRadius = 0.5*globals->CurvilinearDiameter();
+  G4bool tunnel = globals->BuildTunnel() || globals->BuildTunnelStraight();
+  if (radius > curvilinearRadius && !tunnel)
+    {
+      G4String msg = "trackingEnvelopeRadius (" + std::to_string(radius/CLHEP::m) + " m) is larger than the";
+      msg += " curvilinear geometry (" + std::to_string(curvilinearRadius/CLHEP::m) + " m) - tracks will be";
+      msg += " killed on leaving the curvilinear geometry instead";
+      BDS::Warning(__METHOD_NAME__, msg);
+    }
+  initialised = true;
+}
+
+G4bool BDSTrackingEnvelope::Step(const G4Step* step)
+{
+  if (!initialised)
+    {Initialise();}
+  G4Track* track = step->GetTrack();
+  if (track->GetTrackStatus() != fAlive)
+    {return false;}
+  const G4StepPoint* postStepPoint = step->GetPostStepPoint();
+  if (postStepPoint->GetStepStatus() == fWorldBoundary)
+    {return false;} // leaving anyway and recorded as a world exit if required
+
+  // within a volume, nothing changes until the track has travelled beyond the
+  // margin to the limits found at the last check of this track
+  G4double trackLength = track->GetTrackLength();
+  G4bool sameTrack = track == lastTrack && track->GetTrackID() == lastTrackID && trackLength >= lastTrackLength;
+  if (sameTrack && postStepPoint->GetStepStatus() != fGeomBoundary)
+    {
+      if (lastInComponentInside || trackLength - lastTrackLength < lastMargin)
+	{return false;}
+    }
+
+  lastTrack       = track;
+  lastTrackID     = track->GetTrackID();
+  lastTrackLength = trackLength;
+  lastInComponentInside = InComponentInside(postStepPoint->GetTouchable());
+  if (lastInComponentInside)
+    {return false;}
+
+  if (!Outside(postStepPoint->GetPosition(), postStepPoint->GetMomentumDirection(), lastMargin))
+    {return false;}
+
+  // secondaries from this step are kept and will be killed on their first step if outside
+  track->SetTrackStatus(fStopAndKill);
+  if (record && worldExit)
+    {worldExit->ProcessHitsForcedExit(step);}
+  else
+    {BDSStackingAction::energyKilled += postStepPoint->GetTotalEnergy();}
+  return true;
+}
+
+G4bool BDSTrackingEnvelope::Outside(const G4ThreeVector& globalPosition,
+				    const G4ThreeVector& globalDirection,
+				    G4double&            marginOut) const
+{
+  BDSStep local = auxNavigator->ConvertToLocal(globalPosition, globalDirection, 0, true);
+  BDSPhysicalVolumeInfo* info = BDSPhysicalVolumeInfoRegistry::Instance()->GetInfo(local.VolumeForTransform());
+  if (!info)
+    {return true;} // outside the curvilinear (and bridge) volumes
+
+  G4ThreeVector localPosition = local.PreStepPoint();
+  marginOut = std::numeric_limits<G4double>::max();
+  if (radius > 0)
+    {
+      G4double r = localPosition.perp();
+      if (r > radius)
+	{return true;}
+      marginOut = radius - r;
+    }
+  if (useSLimits)
+    {
+      G4double s = info->GetSPos() + localPosition.z();
+      if (s < sMin || s > sMax)
+	{return true;}
+      marginOut = std::min({marginOut, s - sMin, sMax - s});
+    }
+  return false;
+}
+
+G4bool BDSTrackingEnvelope::InComponentInside(const G4VTouchable* touchable)
+{
+  if (!touchable)
+    {return false;}
+  BDSPhysicalVolumeInfoRegistry* registry = BDSPhysicalVolumeInfoRegistry::Instance();
+  // components are placed in the world, so search from the top of the hierarchy
+  for (G4int depth = touchable->GetHistoryDepth() - 1; depth >= 0; depth--)
+    {
+      G4VPhysicalVolume* pv = touchable->GetVolume(depth);
+      auto search = componentInside.find(pv);
+      if (search != componentInside.end())
+	{return search->second;}
+      BDSPhysicalVolumeInfo* info = registry->GetInfo(pv);
+      if (!info)
+	{continue;}
+      const BDSBeamline* beamline = info->GetBeamlineMassWorld();
+      G4int index = info->GetBeamlineMassWorldIndex();
+      G4bool inside = false;
+      if (beamline && index >= 0 && index < (G4int)beamline->size())
+	{inside = ElementInside(beamline->at(index));}
+      componentInside[pv] = inside;
+      return inside;
+    }
+  return false; // tunnel, world or other placements
+}
+
+G4bool BDSTrackingEnvelope::ElementInside(const BDSBeamlineElement* element) const
+{
+  if (!element)
+    {return false;}
+  if (useSLimits && (element->GetSPositionStart() < sMin || element->GetSPositionEnd() > sMax))
+    {return false;}
+
+  // the curvilinear geometry is narrower for bends
+  G4double limit = curvilinearRadius;
+  if (BDS::IsFinite(element->GetAngle()))
+    {limit = std::min(limit, 0.8*std::abs(element->GetArcLength()/element->GetAngle()));}
+  if (radius > 0)
+    {limit = std::min(limit, radius);}
+
+  G4double extentRadius = element->GetExtent().TransverseBoundingRadius();
+  if (const BDSTiltOffset* to = element->GetTiltOffset())
+    {extentRadius += std::hypot(to->GetXOffset(), to->GetYOffset());}
+  return extentRadius < limit;
+}
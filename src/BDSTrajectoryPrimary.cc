@@ -95,6 +95,9 @@ void BDSTrajectoryPrimary::MergeTrajectory(G4VTrajectory* secondTrajectory)
 	      delete lastPoint;
 	      lastPoint = new BDSTrajectoryPoint(*prim->LastPoint());
 	    }
+	  // a track resumed after a fast simulation model may only scatter afterwards
+	  if (!firstHit && prim->FirstHit())
+	    {firstHit = new BDSTrajectoryPoint(*prim->FirstHit());}
 	}
     }
 }
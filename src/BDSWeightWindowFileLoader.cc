@@ -0,0 +1,146 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "BDSDebug.hh"
+#include "BDSException.hh"
+#include "BDSWeightWindowFileLoader.hh"
+
+#include "globals.hh"
+#include "G4String.hh"
+
+#include "CLHEP/Units/SystemOfUnits.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef USE_GZSTREAM
+#include "src-external/gzstream/gzstream.h"
+#endif
+
+template <class T>
+BDSWeightWindowFileLoader<T>::BDSWeightWindowFileLoader()
+{;}
+
+template <class T>
+BDSWeightWindowFileLoader<T>::~BDSWeightWindowFileLoader()
+{;}
+
+template <class T>
+std::map<G4String, std::map<G4double, G4double> > BDSWeightWindowFileLoader<T>::Load(const G4String& fileName)
+{
+  T file;
+
+  file.open(fileName);
+  
+  // test if file is valid
+#ifdef USE_GZSTREAM
+  bool validFile = file.rdbuf()->is_open();
+#else
+  bool validFile = file.is_open();
+#endif
+
+  if (!validFile)
+    {throw BDSException(__METHOD_NAME__, "Cannot open file \"" + fileName + "\"");}
+  else
+    {G4cout << __METHOD_NAME__ << "loading \"" << fileName << "\"" << G4endl;}
+
+  std::string line;
+  std::map<G4String, std::map<G4double, G4double> > windows;
+  G4int lineNum = 0;
+  while (std::getline(file, line))
+    {
+      lineNum++;
+      // skip a line if it's only whitespace or a comment
+      if (std::all_of(line.begin(), line.end(), isspace))
+        {continue;}
+      std::size_t firstChar = line.find_first_not_of(" \t");
+      if (line[firstChar] == '#' || line[firstChar] == '!')
+        {continue;}
+
+      std::istringstream liness(line);
+      std::string volume;
+      liness >> volume;
+      std::vector<G4double> values;
+      std::string valueString;
+      while (liness >> valueString)
+        {
+          try
+            {values.push_back(std::stod(valueString));}
+          catch (...)
+            {
+              G4String message = "value \"" + valueString + "\" for cell \"" + volume + "\" on line ";
+              message += std::to_string(lineNum) + " must be numeric.";
+              throw BDSException(__METHOD_NAME__, message);
+            }
+        }
+
+      // must be pairs of (upper energy, lower weight) and a final lower weight
+      if (values.empty() || values.size() % 2 == 0)
+        {
+          G4String message = "cell \"" + volume + "\" on line " + std::to_string(lineNum) + " must have pairs of upper\n";
+          message += "energy bound and lower weight bound followed by a final lower weight bound.";
+          throw BDSException(__METHOD_NAME__, message);
+        }
+
+      std::map<G4double, G4double> window;
+      G4double previousEnergy = 0;
+      for (std::size_t i = 0; i + 1 < values.size(); i += 2)
+        {
+          G4double upperEnergy = values[i] * CLHEP::GeV;
+          if (upperEnergy <= previousEnergy)
+            {
+              G4String message = "energy bounds for cell \"" + volume + "\" on line " + std::to_string(lineNum);
+              message += " must be positive and increasing.";
+              throw BDSException(__METHOD_NAME__, message);
+            }
+          window[upperEnergy] = values[i+1];
+          previousEnergy = upperEnergy;
+        }
+      window[std::numeric_limits<G4double>::max()] = values.back();
+
+      for (const auto& ew : window)
+        {
+          if (ew.second <= 0)
+            {
+              G4String message = "lower weight bound for cell \"" + volume + "\" on line " + std::to_string(lineNum);
+              message += " must be greater than zero.";
+              throw BDSException(__METHOD_NAME__, message);
+            }
+        }
+      
+      windows[volume] = window;
+    }
+
+  file.close();
+
+  G4cout << __METHOD_NAME__ << "loaded " << windows.size() << " weight windows" << G4endl;
+
+  return windows;
+}
+
+template class BDSWeightWindowFileLoader<std::ifstream>;
+
+#ifdef USE_GZSTREAM
+template class BDSWeightWindowFileLoader<igzstream>;
+#endif
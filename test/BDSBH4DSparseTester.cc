@@ -0,0 +1,127 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "BDSBH4D.hh"
+#include "BDSBH4DBase.hh"
+#include "BDSBH4DTypeDefs.hh"
+#include "HistogramAccumulatorSparse.hh"
+
+#include "TRandom3.h"
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Compare dense and sparse storage for a 4D histogram as used for an energy
+ * resolved scoring mesh. For each, per-event histograms with a small number of
+ * filled bins are summed into a run histogram (as in bdsim) and their mean and
+ * error calculated (as in rebdsim). The time and approximate memory are printed
+ * and the results are required to be identical.
+ *
+ * usage: BDSBH4DSparseTester (nBinsXYZ nBinsE nEvents nFillsPerEvent)
+ */
+
+struct Result
+{
+  double      timeRun = 0;     ///< Time to fill and sum into the run histogram.
+  double      timeAnalysis = 0;///< Time to accumulate the mean and error.
+  std::size_t bytesEvent = 0;  ///< Memory of the event histogram.
+  std::size_t bytesRun = 0;    ///< Memory of the run histogram.
+  std::vector<std::pair<std::size_t, double> > runBins;
+  std::vector<std::pair<std::size_t, double> > meanBins;
+};
+
+Result Run(BDSBH4DBase* eventHist, BDSBH4DBase* runHist, int nEvents, int nFills)
+{
+  Result r;
+  TRandom3 rng(1234);
+  HistogramAccumulatorSparse acc(eventHist, 4, "mean", "mean");
+  double timeAnalysis = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < nEvents; i++)
+    {
+      eventHist->Reset_BDSBH4D();
+      for (int j = 0; j < nFills; j++)
+        {
+          // a shower-like spread about the centre with a falling energy spectrum
+          eventHist->Fill_BDSBH4D(rng.Gaus(0, 0.2), rng.Gaus(0, 0.2), rng.Gaus(0, 0.2), rng.Exp(0.1));
+        }
+      *runHist += *eventHist;
+      auto startA = std::chrono::steady_clock::now();
+      acc.Accumulate(eventHist);
+      timeAnalysis += std::chrono::duration<double>(std::chrono::steady_clock::now() - startA).count();
+    }
+  r.bytesEvent = eventHist->StorageBytes();
+  r.bytesRun   = runHist->StorageBytes();
+  auto startT = std::chrono::steady_clock::now();
+  BDSBH4DBase* mean = dynamic_cast<BDSBH4DBase*>(acc.Terminate());
+  timeAnalysis += std::chrono::duration<double>(std::chrono::steady_clock::now() - startT).count();
+  double total = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  r.timeAnalysis = timeAnalysis;
+  r.timeRun      = total - timeAnalysis;
+  runHist->NonZeroBins(r.runBins);
+  mean->NonZeroBins(r.meanBins);
+  mean->NonZeroErrorBins(r.meanBins);
+  return r;
+}
+
+void Print(const std::string& name, const Result& r)
+{
+  std::cout << name << " run: " << r.timeRun << " s, analysis: " << r.timeAnalysis << " s, "
+            << "event histogram: " << r.bytesEvent / 1048576.0 << " MB, "
+            << "run histogram: " << r.bytesRun / 1048576.0 << " MB" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+  unsigned int nBinsXYZ = argc > 1 ? (unsigned int)std::stoi(argv[1]) : 40;
+  unsigned int nBinsE   = argc > 2 ? (unsigned int)std::stoi(argv[2]) : 100;
+  int nEvents           = argc > 3 ? std::stoi(argv[3]) : 200;
+  int nFills            = argc > 4 ? std::stoi(argv[4]) : 100;
+
+  std::string name  = "h";
+  std::string title = "h";
+  std::string scale = "log";
+  std::cout << nBinsXYZ << "^3 x " << nBinsE << " bins, " << nEvents << " events with "
+            << nFills << " fills each" << std::endl;
+
+  BDSBH4DBase* denseEvent  = new BDSBH4D<boost_histogram_log>(name, title, scale, nBinsXYZ, -1, 1, nBinsXYZ, -1, 1, nBinsXYZ, -1, 1, nBinsE, 1e-3, 1);
+  BDSBH4DBase* denseRun    = denseEvent->Clone("denseRun");
+  Result dense = Run(denseEvent, denseRun, nEvents, nFills);
+  Print("dense ", dense);
+  delete denseEvent;
+  delete denseRun;
+
+  BDSBH4DBase* sparseEvent = new BDSBH4D<boost_histogram_log_sparse>(name, title, scale, nBinsXYZ, -1, 1, nBinsXYZ, -1, 1, nBinsXYZ, -1, 1, nBinsE, 1e-3, 1);
+  BDSBH4DBase* sparseRun   = sparseEvent->Clone("sparseRun");
+  Result sparse = Run(sparseEvent, sparseRun, nEvents, nFills);
+  Print("sparse", sparse);
+  delete sparseEvent;
+  delete sparseRun;
+
+  // sparse bins are visited in index order as are dense ones
+  bool same = dense.runBins == sparse.runBins && dense.meanBins == sparse.meanBins;
+  if (!same)
+    {std::cerr << "Dense and sparse results differ" << std::endl; return 1;}
+  std::cout << "Dense and sparse results are identical (" << sparse.runBins.size() << " filled bins)" << std::endl;
+  return 0;
+}
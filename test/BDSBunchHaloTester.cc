@@ -0,0 +1,146 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "BDSBunch.hh"
+#include "BDSBunchHalo.hh"
+#include "BDSBunchHaloDirect.hh"
+#include "BDSBunchType.hh"
+#include "BDSException.hh"
+#include "BDSParticleCoordsFull.hh"
+#include "BDSParticleCoordsFullGlobal.hh"
+#include "BDSParticleDefinition.hh"
+
+#include "parser/beam.h"
+
+#include "globals.hh"
+
+#include "CLHEP/Units/PhysicalConstants.h"
+#include "CLHEP/Units/SystemOfUnits.h"
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+/// Generation rate and simple moments for one halo generator.
+struct HaloBenchmarkResult
+{
+  G4double rate;   ///< Particles per second.
+  G4double meanX;  ///< <|x|> [m].
+  G4double meanXp; ///< <|xp|> [rad].
+  G4double meanY;  ///< <|y|> [m].
+  G4double meanYp; ///< <|yp|> [rad].
+};
+
+HaloBenchmarkResult Run(BDSBunch* bunch, G4int nParticles)
+{
+  HaloBenchmarkResult result = {0, 0, 0, 0, 0};
+  auto start = std::chrono::steady_clock::now();
+  for (G4int i = 0; i < nParticles; i++)
+    {
+      BDSParticleCoordsFull c = bunch->GetNextParticleLocal();
+      result.meanX  += std::abs(c.x / CLHEP::m);
+      result.meanXp += std::abs(c.xp);
+      result.meanY  += std::abs(c.y / CLHEP::m);
+      result.meanYp += std::abs(c.yp);
+    }
+  auto stop = std::chrono::steady_clock::now();
+  G4double duration = std::chrono::duration<G4double>(stop - start).count();
+  result.rate    = duration > 0 ? (G4double)nParticles / duration : 0;
+  result.meanX  /= (G4double)nParticles;
+  result.meanXp /= (G4double)nParticles;
+  result.meanY  /= (G4double)nParticles;
+  result.meanYp /= (G4double)nParticles;
+  return result;
+}
+
+G4bool Agree(G4double a, G4double b, G4double tolerance = 0.02)
+{return std::abs(a - b) <= tolerance * std::max(std::abs(a), std::abs(b));}
+
+int main(int argc, char** argv)
+{
+  // number of particles per configuration can be given as the first argument
+  G4int nParticles = argc > 1 ? std::stoi(argv[1]) : 20000;
+  
+  BDSParticleDefinition electron("e-", CLHEP::electron_mass_c2, -1, 1.0*CLHEP::GeV, 0, 0, 1);
+
+  // common optics and then a set of increasingly restrictive halo definitions
+  std::map<std::string, double> optics = {{"betx", 9.70}, {"bety", 46.96},
+                                          {"alfx", -0.55}, {"alfy", 2.31},
+                                          {"emitx", 5e-9}, {"emity", 4e-9}};
+  std::vector<std::pair<std::string, std::map<std::string, double> > > configurations = {
+    {"wide annulus", {{"haloNSigmaXInner", 1}, {"haloNSigmaXOuter", 5},
+                      {"haloNSigmaYInner", 1}, {"haloNSigmaYOuter", 5}}},
+    {"thin annulus", {{"haloNSigmaXInner", 5}, {"haloNSigmaXOuter", 5.2},
+                      {"haloNSigmaYInner", 5}, {"haloNSigmaYOuter", 5.2}}},
+    {"collimator cut", {{"haloNSigmaXInner", 4}, {"haloNSigmaXOuter", 6},
+                        {"haloNSigmaYInner", 1}, {"haloNSigmaYOuter", 6},
+                        {"haloXCutInner", 4.5}, {"haloXCutOuter", 5}}},
+    {"angle cut", {{"haloNSigmaXInner", 3}, {"haloNSigmaXOuter", 6},
+                   {"haloNSigmaYInner", 3}, {"haloNSigmaYOuter", 6},
+                   {"haloXpCutInner", 2}, {"haloYpCutInner", 2}}}
+  };
+  std::vector<std::string> weightFunctions = {"flat", "oneoverr", "exp"};
+  
+  G4bool allAgree = true;
+  try
+    {
+      std::cout << std::setw(16) << std::left << "configuration" << std::setw(10) << "weight"
+                << std::right << std::setw(14) << "halo [1/s]" << std::setw(14) << "direct [1/s]"
+                << std::setw(10) << "speedup" << std::setw(8) << "agree" << std::endl;
+      for (const auto& configuration : configurations)
+        {
+          for (const auto& weightFunction : weightFunctions)
+            {
+              GMAD::Beam beam;
+              for (const auto& kv : optics)
+                {beam.set_value(kv.first, kv.second);}
+              for (const auto& kv : configuration.second)
+                {beam.set_value(kv.first, kv.second);}
+              beam.set_value("haloPSWeightFunction", weightFunction);
+              beam.set_value("haloPSWeightParameter", 1.0);
+
+              BDSBunchHalo halo;
+              halo.SetOptions(&electron, beam, BDSBunchType::halo);
+              BDSBunchHaloDirect direct;
+              direct.SetOptions(&electron, beam, BDSBunchType::halodirect);
+              
+              HaloBenchmarkResult rh = Run(&halo, nParticles);
+              HaloBenchmarkResult rd = Run(&direct, nParticles);
+              G4bool agree = Agree(rh.meanX, rd.meanX) && Agree(rh.meanXp, rd.meanXp)
+                && Agree(rh.meanY, rd.meanY) && Agree(rh.meanYp, rd.meanYp);
+              allAgree = allAgree && agree;
+              std::cout << std::setw(16) << std::left << configuration.first
+                        << std::setw(10) << weightFunction << std::right
+                        << std::setw(14) << std::setprecision(4) << rh.rate
+                        << std::setw(14) << rd.rate
+                        << std::setw(10) << (rh.rate > 0 ? rd.rate / rh.rate : 0)
+                        << std::setw(8)  << (agree ? "yes" : "no") << std::endl;
+            }
+        }
+    }
+  catch (const BDSException& exception)
+    {
+      std::cerr << exception.what() << std::endl;
+      return 1;
+    }
+  return allAgree ? 0 : 1;
+}
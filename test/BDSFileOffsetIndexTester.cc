@@ -0,0 +1,186 @@
+/*
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway,
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "BDSException.hh"
+#include "BDSFileOffsetIndex.hh"
+
+#include "G4Types.hh"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * Read a line based file from the start and split it into records, then check
+ * that seeking to each record with BDSFileOffsetIndex returns exactly the same
+ * record and line number. This is done for a HepMC2 ascii file (events start with
+ * an 'E' line) given as an argument and for a file written here with a header,
+ * lines to ignore and windows line endings. Several strides are used so that
+ * seeks land both on and between the entries of the index, and the index is
+ * written to and reloaded from a sidecar file for the generated file.
+ */
+
+typedef BDSFileOffsetIndex::RecordPredicate Predicate;
+
+struct Record
+{
+  G4long      lineNumber; ///< Line number in the file of the first line of the record.
+  std::string text;       ///< All lines of the record.
+};
+
+/// Read the records of the file from the start.
+std::vector<Record> ReadSequentially(const std::string& fileName, const Predicate& isRecord, G4long nLinesIgnore);
+
+/// Read a record from the current position of the stream - up to the next record or end of the file.
+std::string ReadRecord(std::istream& stream, const Predicate& isRecord);
+
+/// Compare every record found through the index with those read sequentially.
+int Compare(const std::string& fileName, const std::string& key, const Predicate& isRecord,
+	    G4long nLinesIgnore, G4bool useSidecar, G4long stride, G4int nRecordsExpected = -1);
+
+void WriteTestFile(const std::string& fileName);
+
+int main(int argc, char** argv)
+{
+  if (argc < 2)
+    {std::cerr << "usage: " << argv[0] << " <hepmc2 ascii file>" << std::endl; return 1;}
+  int nBad = 0;
+  try
+    {
+      Predicate isEventLine = [](const std::string& line){return line.size() > 1 && line[0] == 'E' && line[1] == ' ';};
+      for (G4long stride : {1, 3, 100})
+	{nBad += Compare(argv[1], "hepmc-ascii-event", isEventLine, 0, false, stride);}
+
+      // records are lines starting with a digit - the first ones are ignored
+      const std::string testFileName = "fileoffsetindex-test.txt";
+      WriteTestFile(testFileName);
+      Predicate isDataLine = [](const std::string& line){return !line.empty() && line[0] >= '0' && line[0] <= '9';};
+      std::remove(BDSFileOffsetIndex::SidecarFileName(testFileName).c_str());
+      for (G4long stride : {1, 2, 7, 1000})
+	{nBad += Compare(testFileName, "test-data-line", isDataLine, 3, false, stride, 60);}
+      // the first writes the sidecar file and the second must read it
+      nBad += Compare(testFileName, "test-data-line", isDataLine, 3, true, 7, 60);
+      nBad += Compare(testFileName, "test-data-line", isDataLine, 3, true, 7, 60);
+      std::remove(BDSFileOffsetIndex::SidecarFileName(testFileName).c_str());
+      std::remove(testFileName.c_str());
+    }
+  catch (const BDSException& exception)
+    {std::cerr << exception.what() << std::endl; return 1;}
+
+  if (nBad > 0)
+    {std::cerr << nBad << " differences between indexed and sequential reading" << std::endl; return 1;}
+  std::cout << "Indexed seeks match sequential reading" << std::endl;
+  return 0;
+}
+
+std::vector<Record> ReadSequentially(const std::string& fileName, const Predicate& isRecord, G4long nLinesIgnore)
+{
+  std::ifstream in(fileName);
+  if (!in.good())
+    {throw BDSException("cannot open file \"" + fileName + "\"");}
+  std::vector<Record> records;
+  std::string line;
+  G4long lineNumber = 0;
+  while (std::getline(in, line))
+    {
+      if (lineNumber >= nLinesIgnore && isRecord(line))
+	{records.push_back({lineNumber, ""});}
+      if (!records.empty())
+	{records.back().text += line + "\n";}
+      lineNumber++;
+    }
+  return records;
+}
+
+std::string ReadRecord(std::istream& stream, const Predicate& isRecord)
+{
+  std::string text;
+  std::string line;
+  if (std::getline(stream, line))
+    {text += line + "\n";}
+  while (stream.peek() != EOF)
+    {
+      std::streampos position = stream.tellg();
+      std::getline(stream, line);
+      if (isRecord(line))
+	{stream.seekg(position); break;}
+      text += line + "\n";
+    }
+  return text;
+}
+
+int Compare(const std::string& fileName, const std::string& key, const Predicate& isRecord,
+	    G4long nLinesIgnore, G4bool useSidecar, G4long stride, G4int nRecordsExpected)
+{
+  std::vector<Record> records = ReadSequentially(fileName, isRecord, nLinesIgnore);
+  BDSFileOffsetIndex index(fileName, key, isRecord, nLinesIgnore, useSidecar, stride);
+  int nBad = 0;
+  if (index.NRecords() != (G4long)records.size())
+    {std::cout << "index has " << index.NRecords() << " records, file " << records.size() << std::endl; nBad++;}
+  if (nRecordsExpected >= 0 && (G4int)records.size() != nRecordsExpected)
+    {std::cout << "file has " << records.size() << " records, expected " << nRecordsExpected << std::endl; nBad++;}
+
+  std::ifstream stream(fileName);
+  // backwards and forwards on the same stream as the generators do when looping a file
+  std::vector<G4long> order;
+  for (G4long i = (G4long)records.size() - 1; i >= 0; i--)
+    {order.push_back(i);}
+  for (G4long i = 0; i < (G4long)records.size(); i++)
+    {order.push_back(i);}
+  for (G4long i : order)
+    {
+      G4long lineNumber = index.SeekToRecord(stream, i);
+      std::string text = ReadRecord(stream, isRecord);
+      if (lineNumber != records[i].lineNumber || text != records[i].text)
+	{
+	  std::cout << "record " << i << " at line " << lineNumber << " differs from line "
+		    << records[i].lineNumber << ":\n" << text << "expected:\n" << records[i].text << std::endl;
+	  nBad++;
+	}
+    }
+
+  G4bool threw = false;
+  try
+    {index.SeekToRecord(stream, (G4long)records.size());}
+  catch (const BDSException&)
+    {threw = true;}
+  if (!threw)
+    {std::cout << "no exception seeking beyond the last record" << std::endl; nBad++;}
+
+  std::cout << fileName << " stride " << stride << (useSidecar ? " with sidecar" : "")
+	    << ": " << records.size() << " records, " << nBad << " differences" << std::endl;
+  return nBad;
+}
+
+void WriteTestFile(const std::string& fileName)
+{
+  std::ofstream out(fileName);
+  out << "# header\n"
+      << "1 this line looks like a record but is ignored\n"
+      << "\n";
+  for (G4int i = 0; i < 60; i++)
+    {
+      out << i << " " << std::string((std::size_t)(i * 7 % 23), 'x');
+      out << (i % 5 == 0 ? "\r\n" : "\n"); // some windows line endings
+      for (G4int j = 0; j < i % 4; j++)
+	{out << "# comment " << j << "\n";}
+    }
+  out << "# trailing comment\n";
+}
@@ -0,0 +1,179 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "BDSBunchSixTrackLink.hh"
+#include "BDSException.hh"
+#include "BDSHitSamplerLink.hh"
+#include "BDSIMLink.hh"
+
+#include "G4Types.hh"
+
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/// Primary particle returned from the link: external particle ID -> (external parent ID, x).
+typedef std::map<int, std::pair<int, double> > PrimaryMap;
+
+/// Run the whole link bunch once and collect the returned primaries. Returns the
+/// number of events simulated.
+int RunBunch(BDSIMLink* bds, PrimaryMap& primaries, std::set<int>& secondaryParents);
+
+int main(int /*argc2*/, char** /*argv2*/)
+{
+  std::vector<std::string> arguments = {"theprogramnamenormally",
+                                        "--file=lhccrystals.gmad",
+                                        "--output=none",
+                                        "--batch"};
+  std::vector<char*> argv;
+  argv.reserve(arguments.size());
+  for (const auto& arg : arguments)
+    {argv.push_back((char*) arg.data());}
+  argv.push_back(nullptr);
+
+  // particles in the middle of a wide collimator that pass through untouched, with one
+  // invalid particle that should be skipped without affecting the others
+  const int n = 10;
+  const int invalidIndex = 5;
+  std::vector<double> x(n), y(n, 0), xp(n, 0), yp(n, 0), totalEnergy(n, 450);
+  std::vector<int> pdgID(n, 2212), externalParticleID(n), externalParentID(n);
+  for (int i = 0; i < n; i++)
+    {
+      x[i] = (i - n/2) * 1e-4;
+      externalParticleID[i] = 100 + i;
+      externalParentID[i]   = 200 + i;
+    }
+  pdgID[invalidIndex] = 999999;
+
+  BDSBunchSixTrackLink* stp = new BDSBunchSixTrackLink();
+  BDSIMLink* bds = new BDSIMLink(stp);
+  int result = 0;
+  try
+    {
+      bds->Initialise((int) argv.size() - 1, argv.data(), true, 100);
+      bds->AddLinkCollimatorJaw("TESTCOL", "CU", 1000, 15, 15, 0, 0, 0);
+      bds->SelectLinkElement("TESTCOL");
+
+      std::vector<PrimaryMap> primaries(2);
+      std::vector<std::set<int> > secondaryParents(2);
+      std::vector<int> primariesPerEvent = {1, 0}; // one per event, then all in one event
+      for (int run = 0; run < 2; run++)
+        {
+          bds->SetPrimariesPerEvent(primariesPerEvent[run]);
+          bds->SetParticles(n, x.data(), y.data(), xp.data(), yp.data(), totalEnergy.data(), pdgID.data(),
+                            nullptr, nullptr, nullptr, nullptr, externalParticleID.data(), externalParentID.data());
+          int nEventsExpected = run == 0 ? n : 1;
+          if (bds->NEventsForBunch() != nEventsExpected)
+            {
+              std::cerr << "run " << run << ": " << bds->NEventsForBunch() << " events for the bunch instead of "
+                        << nEventsExpected << std::endl;
+              result = 1;
+            }
+          RunBunch(bds, primaries[run], secondaryParents[run]);
+        }
+
+      for (int run = 0; run < 2; run++)
+        {
+          if ((int)primaries[run].size() != n - 1)
+            {
+              std::cerr << "run " << run << ": " << primaries[run].size() << " primaries returned instead of "
+                        << n - 1 << std::endl;
+              result = 1;
+            }
+          for (const auto& kv : primaries[run])
+            {
+              int i = kv.first - 100;
+              if (i < 0 || i >= n || i == invalidIndex)
+                {
+                  std::cerr << "run " << run << ": unexpected primary ID " << kv.first << std::endl;
+                  result = 1;
+                  continue;
+                }
+              if (kv.second.first != externalParentID[i])
+                {
+                  std::cerr << "run " << run << ": primary " << kv.first << " has parent ID " << kv.second.first
+                            << " instead of " << externalParentID[i] << std::endl;
+                  result = 1;
+                }
+              if (std::abs(kv.second.second - x[i]) > 1e-7) // 0.1 um
+                {
+                  std::cerr << "run " << run << ": primary " << kv.first << " returned at x = " << kv.second.second
+                            << " m instead of " << x[i] << " m" << std::endl;
+                  result = 1;
+                }
+            }
+          for (const auto& parent : secondaryParents[run])
+            {
+              if (parent < 100 || parent >= 100 + n)
+                {
+                  std::cerr << "run " << run << ": secondary with unknown parent ID " << parent << std::endl;
+                  result = 1;
+                }
+            }
+        }
+
+      // batching must give the same primaries as one particle per event
+      if (primaries[0] != primaries[1])
+        {
+          std::cerr << "returned primaries differ between one per event and batched events" << std::endl;
+          result = 1;
+        }
+    }
+  catch (const BDSException& exception)
+    {
+      std::cerr << std::endl << exception.what() << std::endl;
+      result = 1;
+    }
+  catch (const std::exception& exception)
+    {
+      std::cerr << std::endl << exception.what() << std::endl;
+      result = 1;
+    }
+  delete bds;
+  if (result == 0)
+    {std::cout << "Link batch test passed" << std::endl;}
+  return result;
+}
+
+int RunBunch(BDSIMLink* bds, PrimaryMap& primaries, std::set<int>& secondaryParents)
+{
+  bds->ClearSamplerHits();
+  int nEvents = bds->NEventsForBunch();
+  bds->BeamOn(nEvents);
+
+  const BDSHitsCollectionSamplerLink* hits = bds->SamplerHits();
+  int nHits = hits ? (int)hits->entries() : 0;
+  if (nHits == 0)
+    {return nEvents;}
+  std::vector<double> x(nHits);
+  std::vector<int> particleID(nHits), parentID(nHits);
+  int nReturned = bds->GetReturnedParticles(nHits, x.data(), nullptr, nullptr, nullptr, nullptr, nullptr,
+                                            nullptr, nullptr, nullptr, nullptr, particleID.data(), parentID.data());
+  for (int i = 0; i < nReturned; i++)
+    {
+      if ((*hits)[i]->parentID == 0)
+        {primaries[particleID[i]] = std::make_pair(parentID[i], x[i]);}
+      else
+        {secondaryParents.insert(parentID[i]);}
+    }
+  return nEvents;
+}
@@ -0,0 +1,134 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "TFile.h"
+#include "TLeaf.h"
+#include "TObjArray.h"
+#include "TTree.h"
+#include "TTreeFormula.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * Compare the output of the same run written with the synchronous and the
+ * asynchronous (outputAsynchronous) event writer. Every entry of every leaf of
+ * the Event and Header trees must be identical except for the timing and memory
+ * information that naturally differs between two runs.
+ *
+ * usage: BDSOutputAsynchronousTester <synchronous.root> <asynchronous.root>
+ */
+
+/// Compare every numerical or string leaf of a tree in both files. Returns the
+/// number of leaves that differ.
+int CompareTree(TFile* f1, TFile* f2, const std::string& treeName, const std::vector<std::string>& leavesToIgnore);
+
+int main(int argc, char** argv)
+{
+  if (argc != 3)
+    {std::cout << "usage: BDSOutputAsynchronousTester <synchronous.root> <asynchronous.root>" << std::endl; return 1;}
+
+  TFile* f1 = new TFile(argv[1], "READ");
+  TFile* f2 = new TFile(argv[2], "READ");
+  if (f1->IsZombie() || f2->IsZombie())
+    {std::cerr << "Couldn't open files " << argv[1] << " and " << argv[2] << std::endl; delete f1; delete f2; return 1;}
+
+  int nBad = 0;
+  nBad += CompareTree(f1, f2, "Event", {"Summary.startTime", "Summary.stopTime", "Summary.durationWall",
+                                        "Summary.durationCPU", "Summary.memoryUsageMb"});
+  nBad += CompareTree(f1, f2, "Header", {"Header.timeStamp"});
+
+  delete f1;
+  delete f2;
+  if (nBad > 0)
+    {std::cout << nBad << " leaves differ between the synchronous and asynchronous output" << std::endl;}
+  return nBad > 0 ? 1 : 0;
+}
+
+int CompareTree(TFile* f1, TFile* f2, const std::string& treeName, const std::vector<std::string>& leavesToIgnore)
+{
+  TTree* t1 = dynamic_cast<TTree*>(f1->Get(treeName.c_str()));
+  TTree* t2 = dynamic_cast<TTree*>(f2->Get(treeName.c_str()));
+  if (!t1 || !t2)
+    {std::cerr << "No " << treeName << " tree in one of the files" << std::endl; return 1;}
+  Long64_t nEntries = t1->GetEntries();
+  if (nEntries == 0 || nEntries != t2->GetEntries())
+    {
+      std::cerr << treeName << " tree entries differ: " << nEntries << " / " << t2->GetEntries() << std::endl;
+      return 1;
+    }
+
+  int nBad = 0;
+  int nCompared = 0;
+  std::set<std::string> seen;
+  TObjArray* leaves = t1->GetListOfLeaves();
+  for (int i = 0; i < leaves->GetEntriesFast(); i++)
+    {
+      TBranch* branch = static_cast<TLeaf*>(leaves->At(i))->GetBranch();
+      std::string name = branch->GetName();
+      if (branch->GetListOfBranches()->GetEntriesFast() > 0 || !seen.insert(name).second)
+	{continue;}
+      if (std::find(leavesToIgnore.begin(), leavesToIgnore.end(), name) != leavesToIgnore.end())
+	{continue;}
+      if (!t2->GetBranch(name.c_str()))
+	{std::cout << treeName << " leaf " << name << " missing in asynchronous output" << std::endl; nBad++; continue;}
+
+      TTreeFormula form1("form1", name.c_str(), t1);
+      TTreeFormula form2("form2", name.c_str(), t2);
+      if (form1.GetNdim() == 0)
+	{continue;} // not something a formula can evaluate - e.g. a histogram
+      bool isString = form1.IsString();
+      Long64_t failEntry = -1;
+      for (Long64_t entry = 0; entry < nEntries && failEntry < 0; entry++)
+	{
+	  t1->LoadTree(entry);
+	  t2->LoadTree(entry);
+	  int n1 = form1.GetNdata();
+	  int n2 = form2.GetNdata();
+	  if (n1 != n2)
+	    {failEntry = entry; break;}
+	  for (int j = 0; j < n1; j++)
+	    {
+	      bool same;
+	      if (isString)
+		{same = std::string(form1.EvalStringInstance(j)) == std::string(form2.EvalStringInstance(j));}
+	      else
+		{
+		  double v1 = form1.EvalInstance(j);
+		  double v2 = form2.EvalInstance(j);
+		  same = v1 == v2 || (std::isnan(v1) && std::isnan(v2));
+		}
+	      if (!same)
+		{failEntry = entry; break;}
+	    }
+	}
+      nCompared++;
+      if (failEntry >= 0)
+	{
+	  std::cout << treeName << " leaf " << name << " differs at entry " << failEntry << std::endl;
+	  nBad++;
+	}
+    }
+  std::cout << treeName << ": " << nEntries << " entries, " << nCompared << " leaves compared, "
+	    << nBad << " differ" << std::endl;
+  return nBad;
+}
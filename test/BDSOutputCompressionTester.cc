@@ -0,0 +1,265 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "BDSOutputROOTEventSampler.hh"
+
+#include "Compression.h"
+#include "RVersion.h"
+#include "TBranch.h"
+#include "TFile.h"
+#include "TObjArray.h"
+#include "TRandom3.h"
+#include "TROOT.h"
+#include "TTree.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * Benchmark for the output compression settings. A representative set of events
+ * with several samplers is written with each combination of compression algorithm,
+ * level, basket size and auto flush, then read back. The write time, read time and
+ * file size are printed for each. This only uses the sampler structure as that
+ * dominates the size of most outputs.
+ *
+ * With --check, a file written by BDSIM is instead checked to have been written
+ * with the given compression settings (as set by the outputCompressionAlgorithm,
+ * outputCompressionLevel, outputEventCompressionAlgorithm and outputEventCompressionLevel
+ * options). The Event tree settings are the same as the file ones if not given.
+ *
+ * usage: BDSOutputCompressionTester [nEvents] [nSamplers] [nHitsPerSampler]
+ *        BDSOutputCompressionTester --check <file.root> <algorithm> <level> [<eventAlgorithm> <eventLevel>]
+ */
+
+// ROOT's numbering of the compression algorithms - RCompressionSetting and ZSTD
+// were introduced in ROOT 6.20, but the values stored in the file are the same
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,20,0)
+const int algorithmZLIB = ROOT::RCompressionSetting::EAlgorithm::kZLIB;
+const int algorithmLZMA = ROOT::RCompressionSetting::EAlgorithm::kLZMA;
+const int algorithmLZ4  = ROOT::RCompressionSetting::EAlgorithm::kLZ4;
+const int algorithmZSTD = ROOT::RCompressionSetting::EAlgorithm::kZSTD;
+#else
+const int algorithmZLIB = 1;
+const int algorithmLZMA = 2;
+const int algorithmLZ4  = 4;
+#endif
+
+#ifdef __ROOTDOUBLE__
+typedef BDSOutputROOTEventSampler<double> SamplerType;
+#else
+typedef BDSOutputROOTEventSampler<float>  SamplerType;
+#endif
+
+struct Setting
+{
+  std::string name;
+  int  algorithm;  ///< ROOT compression algorithm value.
+  int  level;
+  int  basketSize;
+  long autoFlush;  ///< 0 for ROOT default.
+};
+
+void FillSampler(SamplerType* sampler, int nHits, TRandom3& rng);
+
+/// Check the file and the branches of each tree in a BDSIM output file were written
+/// with the expected compression settings. Returns the number of mismatches.
+int CheckFile(const std::string& fileName,
+	      const std::string& algorithm,
+	      int                level,
+	      const std::string& eventAlgorithm,
+	      int                eventLevel);
+
+int main(int argc, char** argv)
+{
+  if (argc > 1 && std::string(argv[1]) == "--check")
+    {
+      if (argc != 5 && argc != 7)
+	{
+	  std::cout << "usage: BDSOutputCompressionTester --check <file.root> <algorithm> <level> [<eventAlgorithm> <eventLevel>]" << std::endl;
+	  return 1;
+	}
+      int level = std::stoi(argv[4]);
+      std::string eventAlgorithm = argc == 7 ? argv[5] : argv[3];
+      int eventLevel = argc == 7 ? std::stoi(argv[6]) : level;
+      return CheckFile(argv[2], argv[3], level, eventAlgorithm, eventLevel) > 0 ? 1 : 0;
+    }
+
+  int nEvents  = argc > 1 ? std::stoi(argv[1]) : 200;
+  int nSampler = argc > 2 ? std::stoi(argv[2]) : 10;
+  int nHits    = argc > 3 ? std::stoi(argv[3]) : 100;
+
+  std::vector<Setting> settings = {
+    {"zlib-5",            algorithmZLIB, 5, 32000,  0},
+    {"zlib-1",            algorithmZLIB, 1, 32000,  0},
+    {"lz4-4",             algorithmLZ4,  4, 32000,  0},
+    {"lzma-6",            algorithmLZMA, 6, 32000,  0},
+    {"none",              algorithmZLIB, 0, 32000,  0},
+    {"lz4-4-basket256k",  algorithmLZ4,  4, 256000, 0},
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,20,0)
+    {"zstd-5",            algorithmZSTD, 5, 32000,  0},
+    {"zstd-5-flush1000",  algorithmZSTD, 5, 32000,  1000},
+#endif
+  };
+
+  std::vector<SamplerType*> samplers;
+  for (int i = 0; i < nSampler; i++)
+    {samplers.push_back(new SamplerType("S" + std::to_string(i)));}
+
+  std::cout << nEvents << " events, " << nSampler << " samplers, " << nHits << " hits per sampler" << std::endl;
+  std::cout << std::left  << std::setw(20) << "setting"
+	    << std::right << std::setw(12) << "write (s)"
+	    << std::setw(12) << "read (s)"
+	    << std::setw(14) << "size (MB)" << std::endl;
+
+  for (const auto& setting : settings)
+    {
+      std::string fileName = "compression_test_" + setting.name + ".root";
+      TRandom3 rng(1234); // same data for each setting
+
+      auto start = std::chrono::steady_clock::now();
+      TFile* f = new TFile(fileName.c_str(), "RECREATE");
+      f->SetCompressionAlgorithm(setting.algorithm);
+      f->SetCompressionLevel(setting.level);
+      TTree* tree = new TTree("Event", "Event");
+      if (setting.autoFlush != 0)
+	{tree->SetAutoFlush(setting.autoFlush);}
+      for (auto s : samplers)
+	{tree->Branch((s->samplerName + ".").c_str(), "BDSOutputROOTEventSampler", s, setting.basketSize, 1);}
+      for (int i = 0; i < nEvents; i++)
+	{
+	  for (auto s : samplers)
+	    {FillSampler(s, nHits, rng);}
+	  tree->Fill();
+	  for (auto s : samplers)
+	    {s->Flush();}
+	}
+      f->Write(nullptr, TObject::kOverwrite);
+      f->Close();
+      delete f;
+      std::chrono::duration<double> writeTime = std::chrono::steady_clock::now() - start;
+
+      start = std::chrono::steady_clock::now();
+      f = new TFile(fileName.c_str(), "READ");
+      tree = dynamic_cast<TTree*>(f->Get("Event"));
+      std::vector<SamplerType*> readSamplers(nSampler, nullptr);
+      for (int i = 0; i < nSampler; i++)
+	{tree->SetBranchAddress((samplers[i]->samplerName + ".").c_str(), &readSamplers[i]);}
+      long long nEntries = tree->GetEntries();
+      for (long long i = 0; i < nEntries; i++)
+	{tree->GetEntry(i);}
+      Long64_t size = f->GetSize();
+      f->Close();
+      delete f;
+      for (auto s : readSamplers)
+	{delete s;}
+      std::chrono::duration<double> readTime = std::chrono::steady_clock::now() - start;
+
+      std::cout << std::left  << std::setw(20) << setting.name
+		<< std::right << std::fixed << std::setprecision(3)
+		<< std::setw(12) << writeTime.count()
+		<< std::setw(12) << readTime.count()
+		<< std::setw(14) << (double)size / 1048576.0 << std::endl;
+      std::remove(fileName.c_str());
+    }
+
+  for (auto s : samplers)
+    {delete s;}
+  return 0;
+}
+
+void FillSampler(SamplerType* sampler, int nHits, TRandom3& rng)
+{
+  sampler->n = nHits;
+  for (int j = 0; j < nHits; j++)
+    {
+      double xp = rng.Gaus(0, 1e-4);
+      double yp = rng.Gaus(0, 1e-4);
+      sampler->energy.push_back(rng.Exp(100));
+      sampler->x.push_back(rng.Gaus(0, 1e-3));
+      sampler->y.push_back(rng.Gaus(0, 1e-3));
+      sampler->xp.push_back(xp);
+      sampler->yp.push_back(yp);
+      sampler->zp.push_back(std::sqrt(1 - xp*xp - yp*yp));
+      sampler->p.push_back(rng.Exp(100));
+      sampler->T.push_back(rng.Uniform(0, 10));
+      sampler->weight.push_back(1);
+      sampler->partID.push_back(rng.Uniform() < 0.8 ? 22 : 11);
+      sampler->parentID.push_back((int)rng.Uniform(0, 1000));
+      sampler->trackID.push_back(j + 1);
+      sampler->turnNumber.push_back(1);
+    }
+}
+
+int CheckFile(const std::string& fileName,
+	      const std::string& algorithm,
+	      int                level,
+	      const std::string& eventAlgorithm,
+	      int                eventLevel)
+{
+  const std::map<std::string, int> algorithms = {{"zlib", algorithmZLIB},
+						 {"lzma", algorithmLZMA},
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,20,0)
+						 {"zstd", algorithmZSTD},
+#endif
+						 {"lz4",  algorithmLZ4}};
+  auto fileSearch  = algorithms.find(algorithm);
+  auto eventSearch = algorithms.find(eventAlgorithm);
+  if (fileSearch == algorithms.end() || eventSearch == algorithms.end())
+    {std::cerr << "Unknown compression algorithm \"" << algorithm << "\" or \"" << eventAlgorithm << "\"" << std::endl; return 1;}
+
+  TFile* f = new TFile(fileName.c_str(), "READ");
+  if (f->IsZombie())
+    {std::cerr << "Couldn't open file " << fileName << std::endl; delete f; return 1;}
+
+  int nBad = 0;
+  auto check = [&nBad](const std::string& name, int algorithmFound, int levelFound, int algorithmExpected, int levelExpected)
+	       {
+		 bool ok = algorithmFound == algorithmExpected && levelFound == levelExpected;
+		 if (!ok)
+		   {
+		     std::cout << name << ": algorithm " << algorithmFound << " level " << levelFound
+			       << " but expected algorithm " << algorithmExpected << " level " << levelExpected << std::endl;
+		     nBad++;
+		   }
+	       };
+
+  check("File", f->GetCompressionAlgorithm(), f->GetCompressionLevel(), fileSearch->second, level);
+  for (const std::string treeName : {"Header", "Options", "Model", "Run", "Event"})
+    {
+      TTree* tree = dynamic_cast<TTree*>(f->Get(treeName.c_str()));
+      if (!tree)
+	{std::cout << "No " << treeName << " tree in file" << std::endl; nBad++; continue;}
+      bool isEvent = treeName == "Event";
+      TObjArray* branches = tree->GetListOfBranches();
+      for (int i = 0; i < branches->GetEntriesFast(); i++)
+	{
+	  TBranch* b = static_cast<TBranch*>(branches->At(i));
+	  check(treeName + "/" + b->GetName(), b->GetCompressionAlgorithm(), b->GetCompressionLevel(),
+		isEvent ? eventSearch->second : fileSearch->second, isEvent ? eventLevel : level);
+	}
+    }
+  delete f;
+  std::cout << fileName << ": " << nBad << " compression setting mismatches" << std::endl;
+  return nBad;
+}
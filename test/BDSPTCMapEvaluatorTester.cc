@@ -0,0 +1,133 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "BDSPTCMapEvaluator.hh"
+#include "BDSPTCOneTurnMap.hh"
+
+#include "G4Types.hh"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * Benchmark and check of BDSPTCMapEvaluator against evaluating each term of a PTC
+ * one turn map with std::pow as BDSPTCOneTurnMap did. Random coordinates of typical
+ * magnitudes are mapped with both methods, one particle at a time and in a batch. The
+ * program returns 1 if any coordinate differs by more than a few units of floating
+ * point rounding relative to the sum of the magnitudes of the terms.
+ *
+ * usage: BDSPTCMapEvaluatorTester [maptableFile] [nParticles]
+ */
+
+namespace
+{
+  G4double Reference(const std::vector<BDSPTCOneTurnMap::PTCMapTerm>& terms,
+                     const G4double in[5],
+                     G4double& magnitude)
+  {
+    G4double result = 0;
+    magnitude = 0;
+    for (const auto& term : terms)
+      {
+        G4double value = (term.coefficient
+                          * std::pow(in[0], term.nx)
+                          * std::pow(in[1], term.npx)
+                          * std::pow(in[2], term.ny)
+                          * std::pow(in[3], term.npy)
+                          * std::pow(in[4], term.ndeltaP));
+        result += value;
+        magnitude += std::abs(value);
+      }
+    return result;
+  }
+}
+
+int main(int argc, char** argv)
+{
+  std::string fileName = argc > 1 ? std::string(argv[1]) : "../examples/features/options/otm.dat";
+  long nParticles      = argc > 2 ? std::stol(argv[2]) : 20000;
+  std::size_t n = (std::size_t)nParticles;
+
+  auto polynomials = BDSPTCOneTurnMap::LoadMapTable(fileName);
+  BDSPTCMapEvaluator evaluator(polynomials);
+  std::cout << fileName << ": " << evaluator.NTerms() << " terms, "
+            << evaluator.NMonomials() << " distinct monomials" << std::endl;
+
+  // mm, mrad and per mille scale coordinates in PTC units
+  std::mt19937_64 rng(1234);
+  std::normal_distribution<G4double> transverse(0, 1e-3);
+  std::normal_distribution<G4double> deltaP(0, 1e-3);
+  std::vector<G4double> in(5*n);
+  for (std::size_t i = 0; i < n; i++)
+    {
+      for (std::size_t c = 0; c < 4; c++)
+        {in[c*n + i] = transverse(rng);}
+      in[4*n + i] = deltaP(rng);
+    }
+
+  std::vector<G4double> reference(5*n);
+  std::vector<G4double> magnitude(5*n);
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < n; i++)
+    {
+      const G4double coords[5] = {in[i], in[n+i], in[2*n+i], in[3*n+i], in[4*n+i]};
+      for (std::size_t c = 0; c < 5; c++)
+        {reference[c*n + i] = Reference(polynomials[c], coords, magnitude[c*n + i]);}
+    }
+  auto middle = std::chrono::steady_clock::now();
+  std::vector<G4double> single(5*n);
+  for (std::size_t i = 0; i < n; i++)
+    {
+      const G4double coords[5] = {in[i], in[n+i], in[2*n+i], in[3*n+i], in[4*n+i]};
+      G4double out[5];
+      evaluator.Evaluate(coords, out);
+      for (std::size_t c = 0; c < 5; c++)
+        {single[c*n + i] = out[c];}
+    }
+  auto middle2 = std::chrono::steady_clock::now();
+  std::vector<G4double> batch(5*n);
+  evaluator.Evaluate(in.data(), batch.data(), n);
+  auto end = std::chrono::steady_clock::now();
+
+  long nDifferent = 0;
+  G4double maxRelative = 0;
+  for (std::size_t j = 0; j < 5*n; j++)
+    {
+      G4double scale = std::max(magnitude[j], 1e-300);
+      G4double d = std::max(std::abs(single[j] - reference[j]), std::abs(batch[j] - reference[j])) / scale;
+      maxRelative = std::max(maxRelative, d);
+      if (d > 1e-14)
+        {nDifferent++;}
+    }
+
+  G4double tReference = std::chrono::duration<G4double>(middle - start).count();
+  G4double tSingle    = std::chrono::duration<G4double>(middle2 - middle).count();
+  G4double tBatch     = std::chrono::duration<G4double>(end - middle2).count();
+  std::cout << nParticles << " particles: std::pow per term " << tReference << " s, evaluator "
+            << tSingle << " s (speed up " << tReference / tSingle << "), batch " << tBatch
+            << " s (speed up " << tReference / tBatch << ")" << std::endl;
+  std::cout << "maximum difference relative to the sum of term magnitudes " << maxRelative
+            << ", values differing " << nDifferent << std::endl;
+  return nDifferent > 0 ? 1 : 0;
+}
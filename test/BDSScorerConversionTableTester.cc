@@ -0,0 +1,108 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "BDSScorerConversionLoader.hh"
+#include "BDSScorerConversionTable.hh"
+
+#include "G4PhysicsVector.hh"
+#include "G4Types.hh"
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * Benchmark and check of BDSScorerConversionTable against the G4PhysicsVector
+ * it is built from. For each conversion factor file, random kinetic energies
+ * distributed uniformly in log(Ek) (including some outside the range of the data)
+ * are looked up with both and the time taken printed. Files that are not present
+ * are skipped. The program returns 1 if any value differs or if no file could be
+ * loaded, e.g. because the directory is wrong.
+ *
+ * usage: BDSScorerConversionTableTester [conversionFactorDir] [nLookups]
+ */
+
+int main(int argc, char** argv)
+{
+  std::string dir = argc > 1 ? std::string(argv[1]) : "../examples/features/scoring/conversion_factors/";
+  long nLookups   = argc > 2 ? std::stol(argv[2]) : 10000000;
+  if (dir.back() != '/')
+    {dir += '/';}
+
+  const std::vector<std::string> files = {"protons.dat", "neutrons.dat", "photons.dat",
+                                          "electrons.dat", "positrons.dat", "crs_element.dat"};
+  int result = 0;
+  int nChecked = 0;
+  for (const auto& fileName : files)
+    {
+      std::string path = dir + fileName;
+      std::ifstream test(path);
+      if (!test.good())
+        {std::cout << "Skipping " << path << " - not found" << std::endl; continue;}
+      test.close();
+
+      BDSScorerConversionLoader<std::ifstream> loader;
+      G4PhysicsVector* vector = loader.Load(path, true);
+      BDSScorerConversionTable table(vector);
+
+      G4double eMin = vector->Energy(0);
+      G4double eMax = vector->GetMaxEnergy();
+      std::mt19937_64 rng(1234);
+      std::uniform_real_distribution<G4double> flat(std::log(eMin) - 0.5, std::log(eMax) + 0.5);
+      std::vector<G4double> energies((std::size_t)nLookups);
+      for (auto& e : energies)
+        {e = std::exp(flat(rng));}
+
+      G4double sumVector = 0;
+      auto start = std::chrono::steady_clock::now();
+      for (const auto& e : energies)
+        {sumVector += vector->Value(e);}
+      auto middle = std::chrono::steady_clock::now();
+      G4double sumTable = 0;
+      for (const auto& e : energies)
+        {sumTable += table.Value(e);}
+      auto end = std::chrono::steady_clock::now();
+
+      long nDifferent = 0;
+      for (std::size_t i = 0; i < energies.size(); i++)
+        {
+          G4double a = vector->Value(energies[i]);
+          G4double b = table.Value(energies[i]);
+          if (std::abs(a - b) > 1e-12 * std::abs(a))
+            {nDifferent++;}
+        }
+
+      G4double tVector = std::chrono::duration<G4double>(middle - start).count();
+      G4double tTable  = std::chrono::duration<G4double>(end - middle).count();
+      std::cout << fileName << " (" << table.NPoints() << " points): G4PhysicsVector "
+                << tVector << " s, table " << tTable << " s, speed up " << tVector / tTable
+                << ", checksum difference " << sumVector - sumTable
+                << ", values differing " << nDifferent << std::endl;
+      if (nDifferent > 0)
+        {result = 1;}
+      nChecked++;
+      delete vector;
+    }
+  if (nChecked == 0)
+    {std::cerr << "No conversion factor files loaded from " << dir << std::endl; return 1;}
+  return result;
+}
@@ -0,0 +1,323 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "BDSHistBinMapper.hh"
+#include "BDSScorerMeshStorage.hh"
+#ifdef USE_BOOST
+#include "BDSBH4D.hh"
+#include "BDSBH4DTypeDefs.hh"
+#endif
+
+#include "G4THitsMap.hh"
+#include "G4Types.hh"
+#include "G4Version.hh"
+
+#include "TH3D.h"
+
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * Fill known cells of a mesh scorer both into a G4THitsMap keyed by the
+ * BDSHistBinMapper global index (as the scorers used to) and into the
+ * BDSScorerMeshStorage with the layout used by the scorers now. Both are converted
+ * to the output histogram as BDSOutput does and are required to be identical.
+ *
+ * For 3D meshes, the storage index is the ROOT global bin of the TH3D, so every
+ * cell is also checked against TH3::GetBin. This is done for both dense and sparse
+ * storage. For 4D meshes (only with Boost), the sparse storage is indexed by the
+ * mapper global index including the energy under and overflow bins, so every cell
+ * including those must have a unique index within the storage. Two events are
+ * filled to check the reset between events. Finally, many random bins are filled
+ * in both kinds of storage so the hash table grows and they must agree.
+ */
+
+struct Cell
+{
+  G4int    i;
+  G4int    j;
+  G4int    k;
+  G4int    l; ///< Energy index from 0 (underflow) to nBinsE + 1 (overflow).
+  G4double value;
+};
+
+int Test3D(G4bool sparse);
+int TestDenseAndSparse();
+#ifdef USE_BOOST
+int Test4D();
+#endif
+
+/// Iterate a G4THitsMap the same way for each Geant4 version.
+template <typename F>
+void ForEachHit(const G4THitsMap<G4double>& hitsMap, F f)
+{
+#if G4VERSION < 1039
+  for (const auto& hit : *hitsMap.GetMap())
+#else
+  for (const auto& hit : hitsMap)
+#endif
+    {f(hit.first, *hit.second);}
+}
+
+int main()
+{
+  int nBad = Test3D(false);
+  nBad += Test3D(true);
+  nBad += TestDenseAndSparse();
+#ifdef USE_BOOST
+  nBad += Test4D();
+#else
+  std::cout << "No Boost - 4D mesh storage not tested" << std::endl;
+#endif
+  if (nBad > 0)
+    {std::cerr << nBad << " differences between the mesh storage and G4THitsMap" << std::endl; return 1;}
+  std::cout << "Mesh storage matches G4THitsMap" << std::endl;
+  return 0;
+}
+
+int Test3D(G4bool sparse)
+{
+  const G4int ni = 4;
+  const G4int nj = 3;
+  const G4int nk = 5;
+  BDSHistBinMapper mapper(ni, nj, nk, 1);
+  TH3D hist("mesh3D", "mesh3D", ni, 0, ni, nj, 0, nj, nk, 0, nk);
+  int nBad = 0;
+
+  // layout - every cell must map to the same TH3D bin either way
+  BDSScorerMeshStorage storage(BDSScorerMeshStorage::NBinsRoot3D(ni, nj, nk), sparse);
+  if (storage.NBins() != hist.GetNcells())
+    {std::cout << "3D storage has " << storage.NBins() << " bins, TH3D " << hist.GetNcells() << std::endl; nBad++;}
+  G4int x, y, z, e;
+  for (G4int i = 0; i < ni; i++)
+    {
+      for (G4int j = 0; j < nj; j++)
+	{
+	  for (G4int k = 0; k < nk; k++)
+	    {
+	      G4int rootBin = hist.GetBin(i + 1, j + 1, k + 1);
+	      mapper.IJKLFromGlobal(mapper.GlobalFromIJKLIndex(i, j, k), x, y, z, e);
+	      G4int oldBin = hist.GetBin(x + 1, y + 1, z + 1);
+	      G4int newBin = BDSScorerMeshStorage::RootGlobalBin3D(i, j, k, ni, nj);
+	      if (newBin != rootBin || oldBin != rootBin)
+		{
+		  std::cout << "3D cell (" << i << "," << j << "," << k << ") TH3D bin " << rootBin
+			    << " storage " << newBin << " mapper " << oldBin << std::endl;
+		  nBad++;
+		}
+	    }
+	}
+    }
+
+  // values - including repeated cells and the corners of the mesh
+  std::vector<std::vector<Cell> > events = {{{0,0,0,0, 1.5}, {3,2,4,0, 2.0}, {1,1,1,0, 0.25}, {1,1,1,0, 0.5}, {2,0,3,0, 7}},
+					    {{3,2,4,0, 3.0}, {0,2,1,0, 1e-3}, {0,2,1,0, 2e-3}}};
+  for (const auto& cells : events)
+    {
+      G4THitsMap<G4double> hitsMap("mesh", "mesh3D");
+      storage.Reset();
+      for (const auto& cell : cells)
+	{
+	  G4double value = cell.value;
+	  hitsMap.add(mapper.GlobalFromIJKLIndex(cell.i, cell.j, cell.k), value);
+	  storage.Add(BDSScorerMeshStorage::RootGlobalBin3D(cell.i, cell.j, cell.k, ni, nj), cell.value);
+	}
+
+      // as BDSOutput::FillScorerHitsIndividual for each kind
+      TH3D hOld(hist);
+      hOld.Reset();
+      ForEachHit(hitsMap, [&](G4int index, G4double value)
+		 {
+		   G4int a, b, c, d;
+		   mapper.IJKLFromGlobal(index, a, b, c, d);
+		   hOld.SetBinContent(hOld.GetBin(a + 1, b + 1, c + 1), value);
+		 });
+      TH3D hNew(hist);
+      hNew.Reset();
+      for (G4int bin : storage.TouchedBins())
+	{hNew.SetBinContent(bin, storage.Value(bin));}
+
+      std::set<G4int> distinct;
+      for (const auto& cell : cells)
+	{distinct.insert(mapper.GlobalFromIJKLIndex(cell.i, cell.j, cell.k));}
+      if (storage.NTouched() != (G4int)distinct.size())
+	{std::cout << "3D storage touched " << storage.NTouched() << " bins, expected " << distinct.size() << std::endl; nBad++;}
+      for (G4int bin = 0; bin < hist.GetNcells(); bin++)
+	{
+	  if (hOld.GetBinContent(bin) != hNew.GetBinContent(bin))
+	    {
+	      std::cout << "3D bin " << bin << " G4THitsMap " << hOld.GetBinContent(bin)
+			<< " storage " << hNew.GetBinContent(bin) << std::endl;
+	      nBad++;
+	    }
+	}
+    }
+  storage.Reset();
+  for (G4int bin = 0; bin < storage.NBins(); bin++)
+    {
+      if (storage.Value(bin) != 0)
+	{std::cout << "3D bin " << bin << " not zero after reset" << std::endl; nBad++;}
+    }
+  std::cout << "3D mesh " << (sparse ? "sparse" : "dense") << ": " << nBad << " differences" << std::endl;
+  return nBad;
+}
+
+int TestDenseAndSparse()
+{
+  const G4int nBins = 100000;
+  BDSScorerMeshStorage dense(nBins, false);
+  BDSScorerMeshStorage sparse(nBins, true);
+  int nBad = 0;
+  unsigned int seed = 1;
+  for (G4int event = 0; event < 10; event++)
+    {
+      dense.Reset();
+      sparse.Reset();
+      // alternate between many hits so the table grows and few after a reset
+      G4int nHits = event % 3 == 0 ? 50000 : 300;
+      for (G4int hit = 0; hit < nHits; hit++)
+	{
+	  seed = seed * 1103515245 + 12345; // simple repeatable generator
+	  G4int index = (G4int)((seed >> 8) % nBins);
+	  G4double value = (G4double)(seed % 100) / 3.0;
+	  dense.Add(index, value);
+	  sparse.Add(index, value);
+	}
+      if (dense.TouchedBins() != sparse.TouchedBins())
+	{std::cout << "event " << event << " touched bins differ" << std::endl; nBad++;}
+      for (G4int bin = 0; bin < nBins; bin++)
+	{
+	  if (dense.Value(bin) != sparse.Value(bin))
+	    {
+	      std::cout << "event " << event << " bin " << bin << " dense " << dense.Value(bin)
+			<< " sparse " << sparse.Value(bin) << std::endl;
+	      nBad++;
+	    }
+	}
+    }
+  std::cout << "dense and sparse storage: " << nBad << " differences" << std::endl;
+  return nBad;
+}
+
+#ifdef USE_BOOST
+int Test4D()
+{
+  const G4int ni = 3;
+  const G4int nj = 2;
+  const G4int nk = 4;
+  const G4int nE = 5;
+  std::string name  = "mesh4D";
+  std::string title = "mesh4D";
+  boost_histogram_axes_variant energyAxis = new boost_histogram_linear_axis(nE, 1, 6, "energy");
+  BDSHistBinMapper mapper(ni, nj, nk, nE, energyAxis);
+  int nBad = 0;
+
+  // layout - the mapper includes the energy under and overflow bins
+  BDSScorerMeshStorage storage(BDSScorerMeshStorage::NBinsMapper(&mapper), true);
+  if (storage.NBins() != ni * nj * nk * (nE + 2))
+    {std::cout << "4D storage has " << storage.NBins() << " bins, expected " << ni * nj * nk * (nE + 2) << std::endl; nBad++;}
+  std::set<G4int> indices;
+  G4int x, y, z, e;
+  for (G4int i = 0; i < ni; i++)
+    {
+      for (G4int j = 0; j < nj; j++)
+	{
+	  for (G4int k = 0; k < nk; k++)
+	    {
+	      for (G4int l = 0; l < nE + 2; l++)
+		{
+		  G4int index = mapper.GlobalFromIJKLIndex(i, j, k, l);
+		  mapper.IJKLFromGlobal(index, x, y, z, e);
+		  bool ok = index >= 0 && index < storage.NBins() && indices.insert(index).second;
+		  ok = ok && x == i && y == j && z == k && e == l;
+		  if (!ok)
+		    {
+		      std::cout << "4D cell (" << i << "," << j << "," << k << "," << l << ") index " << index
+				<< " out of range, repeated or not reversible" << std::endl;
+		      nBad++;
+		    }
+		}
+	    }
+	}
+    }
+
+  // values - energies as the scorer converts them, including under and overflow
+  auto energyIndex = [&energyAxis](double energy)
+		     {return boost::apply_visitor([&energy](auto&& one){return (decltype(one)(one))->index(energy);}, energyAxis) + 1;};
+  if (energyIndex(0.5) != 0 || energyIndex(100) != nE + 1)
+    {std::cout << "4D energy under and overflow not at index 0 and " << nE + 1 << std::endl; nBad++;}
+  std::vector<std::vector<std::pair<Cell, double> > > events = {{{{0,0,0,0, 1.5}, 0.5}, {{2,1,3,0, 2.0}, 100}, {{1,1,2,0, 0.25}, 3.2},
+								  {{1,1,2,0, 0.75}, 3.7}, {{1,0,1,0, 4}, 1.0}, {{1,0,1,0, 5}, 5.999}},
+								 {{{2,1,3,0, 3.0}, 1e6}, {{0,1,0,0, 1e-3}, 2.5}}};
+  for (const auto& cells : events)
+    {
+      G4THitsMap<G4double> hitsMap("mesh", "mesh4D");
+      storage.Reset();
+      for (const auto& cellEnergy : cells)
+	{
+	  const Cell& cell = cellEnergy.first;
+	  G4int l = energyIndex(cellEnergy.second);
+	  G4int index = mapper.GlobalFromIJKLIndex(cell.i, cell.j, cell.k, l);
+	  G4double value = cell.value;
+	  hitsMap.add(index, value);
+	  storage.Add(index, cell.value);
+	}
+
+      // as BDSOutput::FillScorerHitsIndividual for each kind
+      BDSBH4D<boost_histogram_linear> hOld(name, title, "linear", ni, 0, ni, nj, 0, nj, nk, 0, nk, nE, 1, 6);
+      BDSBH4D<boost_histogram_linear> hNew(name, title, "linear", ni, 0, ni, nj, 0, nj, nk, 0, nk, nE, 1, 6);
+      ForEachHit(hitsMap, [&](G4int index, G4double value)
+		 {
+		   G4int a, b, c, d;
+		   mapper.IJKLFromGlobal(index, a, b, c, d);
+		   hOld.Set_BDSBH4D(a, b, c, d - 1, value);
+		 });
+      for (G4int bin : storage.TouchedBins())
+	{
+	  mapper.IJKLFromGlobal(bin, x, y, z, e);
+	  hNew.Set_BDSBH4D(x, y, z, e - 1, storage.Value(bin));
+	}
+
+      for (G4int i = 0; i < ni; i++)
+	{
+	  for (G4int j = 0; j < nj; j++)
+	    {
+	      for (G4int k = 0; k < nk; k++)
+		{
+		  for (G4int l = -1; l <= nE; l++)
+		    {
+		      if (hOld.At(i, j, k, l) != hNew.At(i, j, k, l))
+			{
+			  std::cout << "4D bin (" << i << "," << j << "," << k << "," << l << ") G4THitsMap "
+				    << hOld.At(i, j, k, l) << " storage " << hNew.At(i, j, k, l) << std::endl;
+			  nBad++;
+			}
+		    }
+		}
+	    }
+	}
+    }
+  if (storage.NTouched() != 2)
+    {std::cout << "4D storage touched " << storage.NTouched() << " bins in the last event, expected 2" << std::endl; nBad++;}
+  delete boost::get<boost_histogram_linear_axis*>(energyAxis);
+  std::cout << "4D mesh: " << nBad << " differences" << std::endl;
+  return nBad;
+}
+#endif
@@ -0,0 +1,138 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "TFile.h"
+#include "TTree.h"
+#include "TTreeFormula.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+/**
+ * Compare a deep shielding energy deposition tally between an analogue and a biased
+ * (importance sampling or weight window) run of the same model. The tally is the
+ * weighted energy deposited in the world (ElossWorld) beyond tallyZ per event. The
+ * mean and its standard error are printed for each along with the figure of merit
+ * FOM = 1 / (R^2 T), where R is the relative error and T the summed event wall time.
+ * The two means must agree within nSigma of their combined error.
+ *
+ * usage: BDSWeightWindowTallyTester <analogue.root> <biased.root> [tallyZ (m)] [nSigma]
+ */
+
+struct Tally
+{
+  long long n    = 0;
+  double    mean = 0;
+  double    error = 0; ///< Standard error on the mean.
+  double    time  = 0; ///< Summed event wall time (s).
+  bool      ok    = false;
+};
+
+Tally Calculate(const std::string& fileName, double tallyZ);
+
+void Print(const std::string& name, const Tally& t);
+
+int main(int argc, char** argv)
+{
+  if (argc < 3 || argc > 5)
+    {std::cout << "usage: BDSWeightWindowTallyTester <analogue.root> <biased.root> [tallyZ (m)] [nSigma]" << std::endl; return 1;}
+  double tallyZ = argc > 3 ? std::stod(argv[3]) : 4.6;
+  double nSigma = argc > 4 ? std::stod(argv[4]) : 3;
+
+  Tally analogue = Calculate(argv[1], tallyZ);
+  Tally biased   = Calculate(argv[2], tallyZ);
+  if (!analogue.ok || !biased.ok)
+    {return 1;}
+
+  std::cout << "Energy deposited beyond z = " << tallyZ << " m per event" << std::endl;
+  std::cout << std::left << std::setw(10) << "case" << std::right
+	    << std::setw(8)  << "events"
+	    << std::setw(14) << "mean (GeV)"
+	    << std::setw(14) << "error (GeV)"
+	    << std::setw(10) << "R"
+	    << std::setw(10) << "T (s)"
+	    << std::setw(14) << "FOM" << std::endl;
+  Print("analogue", analogue);
+  Print("biased",   biased);
+
+  if (analogue.mean <= 0)
+    {std::cerr << "No energy deposited in the tally region in the analogue run - can't compare" << std::endl; return 1;}
+  double difference = std::abs(analogue.mean - biased.mean);
+  double combined   = std::sqrt(analogue.error*analogue.error + biased.error*biased.error);
+  std::cout << "Difference " << difference << " GeV = " << difference / combined << " sigma" << std::endl;
+  if (difference > nSigma * combined)
+    {std::cerr << "Tallies disagree by more than " << nSigma << " sigma" << std::endl; return 1;}
+  return 0;
+}
+
+Tally Calculate(const std::string& fileName, double tallyZ)
+{
+  Tally result;
+  TFile* f = new TFile(fileName.c_str(), "READ");
+  if (f->IsZombie())
+    {std::cerr << "Couldn't open file " << fileName << std::endl; delete f; return result;}
+  TTree* tree = dynamic_cast<TTree*>(f->Get("Event"));
+  if (!tree || !tree->GetBranch("ElossWorld."))
+    {std::cerr << "No Event tree with ElossWorld in " << fileName << std::endl; delete f; return result;}
+
+  std::string tallyExpression = "Sum$(ElossWorld.totalEnergy*ElossWorld.weight*(ElossWorld.Z>" + std::to_string(tallyZ) + "))";
+  TTreeFormula tally("tally", tallyExpression.c_str(), tree);
+  TTreeFormula duration("duration", "Summary.durationWall", tree);
+  double sum   = 0;
+  double sumSq = 0;
+  result.n = tree->GetEntries();
+  for (long long i = 0; i < result.n; i++)
+    {
+      tree->LoadTree(i);
+      tally.GetNdata();
+      double value = tally.EvalInstance(0);
+      sum   += value;
+      sumSq += value * value;
+      duration.GetNdata();
+      result.time += duration.EvalInstance(0);
+    }
+  if (result.n > 1)
+    {
+      double nD = (double)result.n;
+      result.mean = sum / nD;
+      double variance = (sumSq - nD * result.mean * result.mean) / (nD - 1);
+      result.error = std::sqrt(std::max(0.0, variance) / nD);
+      result.ok = true;
+    }
+  else
+    {std::cerr << "Too few events in " << fileName << std::endl;}
+  delete f;
+  return result;
+}
+
+void Print(const std::string& name, const Tally& t)
+{
+  double relError = t.mean > 0 ? t.error / t.mean : 0;
+  double fom = relError > 0 && t.time > 0 ? 1.0 / (relError * relError * t.time) : 0;
+  std::cout << std::left << std::setw(10) << name << std::right
+	    << std::setw(8)  << t.n
+	    << std::setw(14) << std::scientific << std::setprecision(4) << t.mean
+	    << std::setw(14) << t.error
+	    << std::setw(10) << std::fixed << std::setprecision(4) << relError
+	    << std::setw(10) << std::setprecision(1) << t.time
+	    << std::setw(14) << std::scientific << std::setprecision(4) << fom
+	    << std::defaultfloat << std::endl;
+}
@@ -0,0 +1,138 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "CompiledSelection.hh"
+
+#include "TBranch.h"
+#include "TFile.h"
+#include "TObjArray.h"
+#include "TTree.h"
+#include "TTreeFormula.h"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/// Evaluate a selection with TTreeFormula and the compiled version for every entry, check
+/// they agree and print the rate of each. Returns the number of entries that disagree.
+int CompareSelection(TTree* tree, const std::string& selection, int nRepeat);
+
+int main(int argc, char** argv)
+{
+  if (argc != 2)
+    {std::cout << "usage: CompiledSelectionTester <datafile>" << std::endl; return 1;}
+
+  TFile* f = new TFile(argv[1], "READ");
+  if (f->IsZombie())
+    {std::cerr << "Couldn't open file " << argv[1] << std::endl; return 1;}
+  TTree* tree = dynamic_cast<TTree*>(f->Get("Event"));
+  if (!tree)
+    {std::cerr << "No Event tree in file" << std::endl; delete f; return 1;}
+
+  // find the first sampler branch
+  std::string s;
+  TObjArray* branches = tree->GetListOfBranches();
+  for (int i = 0; i < branches->GetEntries(); i++)
+    {
+      TBranch* b = dynamic_cast<TBranch*>(branches->At(i));
+      if (b && std::string(b->GetClassName()).find("BDSOutputROOTEventSampler") != std::string::npos)
+        {s = b->GetName(); break;}
+    }
+  if (s.empty())
+    {std::cerr << "No sampler branch in file" << std::endl; delete f; return 1;}
+  if (s.back() == '.')
+    {s.pop_back();}
+  
+  std::vector<std::string> selections = {s + ".x > 0",
+                                         s + ".partID == 2212 || (" + s + ".x*" + s + ".x + " + s + ".y*" + s + ".y < 1e-6 && " + s + ".energy > 0)",
+                                         "sqrt(" + s + ".x*" + s + ".x+" + s + ".y*" + s + ".y) < 0.001 && abs(" + s + ".xp) < 1e-3",
+                                         "Primary.energy > 0 && " + s + ".n > 2",
+                                         s + ".x[0] > 0"}; // not compiled - checks fallback
+
+  // numbers are always doubles in TTreeFormula - integer division would differ for x < 0
+  // and for energy > 0 respectively
+  std::vector<std::string> literalSelections = {s + ".x > -1/2",
+                                                s + ".energy*(3/2) > 1.5*" + s + ".energy - 1e-9 && 2.*" + s + ".n/4 >= 0"};
+  
+  int nBad = 0;
+  for (const auto& selection : selections)
+    {nBad += CompareSelection(tree, selection, 20);}
+  for (const auto& selection : literalSelections)
+    {
+      nBad += CompareSelection(tree, selection, 20);
+      if (!CompiledSelection(selection, tree).Compiled())
+        {std::cerr << "Selection should have been compiled" << std::endl; nBad++;}
+    }
+
+  delete f;
+  return nBad > 0 ? 1 : 0;
+}
+
+int CompareSelection(TTree* tree, const std::string& selection, int nRepeat)
+{
+  std::cout << "Selection: \"" << selection << "\"" << std::endl;
+  Long64_t nEntries = tree->GetEntries();
+  
+  std::vector<bool> expected(nEntries);
+  TTreeFormula* formula = new TTreeFormula("testformula", selection.c_str(), tree);
+  formula->SetQuickLoad(true);
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < nRepeat; r++)
+    {
+      for (Long64_t i = 0; i < nEntries; i++)
+        {
+          tree->LoadTree(i);
+          int nInstances = formula->GetNdata();
+          bool pass = false;
+          for (int j = 0; j < nInstances && !pass; j++)
+            {pass = formula->EvalInstance(j) != 0;}
+          expected[i] = pass;
+        }
+    }
+  double tFormula = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  delete formula;
+
+  CompiledSelection compiled(selection, tree);
+  if (compiled.Compiled())
+    {std::cout << "Compiled as:\n" << compiled.Code() << std::endl;}
+  else
+    {std::cout << "Not compiled: " << compiled.Reason() << std::endl;}
+  
+  int nBad = 0;
+  CompiledSelectionReader reader(&compiled, tree);
+  start = std::chrono::steady_clock::now();
+  for (int r = 0; r < nRepeat; r++)
+    {
+      for (Long64_t i = 0; i < nEntries; i++)
+        {
+          bool pass = reader.Select(i);
+          if (r == 0 && pass != expected[i])
+            {
+              std::cerr << "Entry " << i << " differs: TTreeFormula " << expected[i] << ", compiled " << pass << std::endl;
+              nBad++;
+            }
+        }
+    }
+  double tCompiled = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  double nTotal = (double)(nEntries * nRepeat);
+  std::cout << "TTreeFormula : " << nTotal / tFormula  << " entries / s" << std::endl;
+  std::cout << "Compiled     : " << nTotal / tCompiled << " entries / s" << std::endl;
+  return nBad;
+}
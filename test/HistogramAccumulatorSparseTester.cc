@@ -0,0 +1,137 @@
+/* 
+Beam Delivery Simulation (BDSIM) Copyright (C) Royal Holloway, 
+University of London 2001 - 2024.
+
+This file is part of BDSIM.
+
+BDSIM is free software: you can redistribute it and/or modify 
+it under the terms of the GNU General Public License as published 
+by the Free Software Foundation version 3 of the License.
+
+BDSIM is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BDSIM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "HistogramAccumulator.hh"
+#include "HistogramAccumulatorSparse.hh"
+
+#include "TH1D.h"
+#include "TH2D.h"
+#include "TH3D.h"
+#include "TRandom3.h"
+
+#include <iostream>
+#include <string>
+
+/**
+ * Accumulate the same randomly and sparsely filled per-event histograms with
+ * HistogramAccumulator and HistogramAccumulatorSparse and check the mean and the
+ * error on the mean in every bin (including under and overflow) are bit-identical.
+ * This is done for 1, 2 and 3D histograms with a range of fill fractions including
+ * bins that are filled in only one event. Empty entries are also added between
+ * some of the events.
+ *
+ * usage: HistogramAccumulatorSparseTester [nEvents]
+ */
+
+/// Accumulate nEvents random events in both accumulators and return the number of
+/// bins that differ. fillProbability is the chance an event fills anything at all.
+int Compare(TH1* eventHist, int nDimensions, int nEvents, int nFills, double fillProbability, TRandom3& rng);
+
+int main(int argc, char** argv)
+{
+  int nEvents = argc > 1 ? std::stoi(argv[1]) : 1000;
+  TRandom3 rng(1234);
+  TH1::AddDirectory(false); // the accumulators make histograms of the same name each time
+
+  TH1D* h1 = new TH1D("h1", "h1", 100, -1, 1);
+  TH2D* h2 = new TH2D("h2", "h2", 40, -1, 1, 40, -1, 1);
+  TH3D* h3 = new TH3D("h3", "h3", 20, -1, 1, 20, -1, 1, 20, -1, 1);
+
+  int nBad = 0;
+  for (double fillProbability : {1.0, 0.1, 0.005})
+    {
+      nBad += Compare(h1, 1, nEvents, 5,  fillProbability, rng);
+      nBad += Compare(h2, 2, nEvents, 20, fillProbability, rng);
+      nBad += Compare(h3, 3, nEvents, 50, fillProbability, rng);
+    }
+
+  delete h1;
+  delete h2;
+  delete h3;
+  if (nBad > 0)
+    {std::cerr << nBad << " bins differ between the dense and sparse accumulators" << std::endl; return 1;}
+  std::cout << "Dense and sparse accumulators agree" << std::endl;
+  return 0;
+}
+
+int Compare(TH1* eventHist, int nDimensions, int nEvents, int nFills, double fillProbability, TRandom3& rng)
+{
+  std::string name = eventHist->GetName();
+  HistogramAccumulator       dense(eventHist,  nDimensions, name + "_dense",  name);
+  HistogramAccumulatorSparse sparse(eventHist, nDimensions, name + "_sparse", name);
+  for (int i = 0; i < nEvents; i++)
+    {
+      eventHist->Reset();
+      if (rng.Uniform() < fillProbability)
+	{
+	  for (int j = 0; j < nFills; j++)
+	    {
+	      // a narrow spread so most bins are empty in each event and some include overflow
+	      double x = rng.Gaus(0, 0.4);
+	      double y = rng.Gaus(0, 0.4);
+	      double z = rng.Gaus(0, 0.4);
+	      double w = rng.Exp(10);
+	      switch (nDimensions)
+		{
+		case 1:
+		  {eventHist->Fill(x, w); break;}
+		case 2:
+		  {dynamic_cast<TH2D*>(eventHist)->Fill(x, y, w); break;}
+		case 3:
+		  {dynamic_cast<TH3D*>(eventHist)->Fill(x, y, z, w); break;}
+		default:
+		  {break;}
+		}
+	    }
+	}
+      dense.Accumulate(eventHist);
+      sparse.Accumulate(eventHist);
+      if (i % 97 == 0)
+	{
+	  dense.AddNEmptyEntries(3);
+	  sparse.AddNEmptyEntries(3);
+	}
+    }
+  TH1* rDense  = dense.Terminate();
+  TH1* rSparse = sparse.Terminate();
+
+  int nBad = 0;
+  int nFilled = 0;
+  const int nBins = rDense->GetNcells();
+  for (int i = 0; i < nBins; i++)
+    {
+      double mean1 = rDense->GetBinContent(i);
+      double mean2 = rSparse->GetBinContent(i);
+      double err1  = rDense->GetBinError(i);
+      double err2  = rSparse->GetBinError(i);
+      if (mean1 != 0)
+	{nFilled++;}
+      if (mean1 != mean2 || err1 != err2)
+	{
+	  if (nBad < 10)
+	    {
+	      std::cout << name << " bin " << i << " mean " << mean1 << " / " << mean2
+			<< " error " << err1 << " / " << err2 << std::endl;
+	    }
+	  nBad++;
+	}
+    }
+  std::cout << nDimensions << "D, fill probability " << fillProbability << ": " << nFilled
+	    << " of " << nBins << " bins filled, " << nBad << " differ" << std::endl;
+  return nBad;
+}